@@ -61,16 +61,19 @@ class Contractor
   protected:
     void ContractGraph(const unsigned max_edge_id,
                        util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
-                       util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                       util::DeallocatingVector<ContractedEdge> &contracted_edge_list,
                        std::vector<EdgeWeight> &&node_weights,
+                       const std::vector<EdgeLength> &node_lengths,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
+    void ReadNodeLengths(const unsigned max_edge_id, std::vector<EdgeLength> &node_lengths) const;
     std::size_t
     WriteContractedGraph(unsigned number_of_edge_based_nodes,
-                         const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
+                         const util::DeallocatingVector<ContractedEdge> &contracted_edge_list);
+    void WriteEdgeLengths(const util::DeallocatingVector<ContractedEdge> &contracted_edge_list) const;
     void FindComponents(unsigned max_edge_id,
                         const util::DeallocatingVector<extractor::EdgeBasedEdge> &edges,
                         std::vector<extractor::EdgeBasedNode> &nodes) const;
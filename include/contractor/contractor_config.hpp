@@ -39,7 +39,7 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig() : requested_num_threads(0), use_edge_lengths(false) {}
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -47,6 +47,7 @@ struct ContractorConfig
         level_output_path = osrm_input_path.string() + ".level";
         core_output_path = osrm_input_path.string() + ".core";
         graph_output_path = osrm_input_path.string() + ".hsgr";
+        edge_lengths_output_path = osrm_input_path.string() + ".edge_lengths";
         edge_based_graph_path = osrm_input_path.string() + ".ebg";
         edge_segment_lookup_path = osrm_input_path.string() + ".edge_segment_lookup";
         edge_penalty_path = osrm_input_path.string() + ".edge_penalties";
@@ -63,6 +64,7 @@ struct ContractorConfig
     std::string level_output_path;
     std::string core_output_path;
     std::string graph_output_path;
+    std::string edge_lengths_output_path;
     std::string edge_based_graph_path;
 
     std::string edge_segment_lookup_path;
@@ -74,6 +76,9 @@ struct ContractorConfig
 
     unsigned requested_num_threads;
 
+    // Store the length of every edge of the contracted graph for /table distances
+    bool use_edge_lengths;
+
     // A percentage of vertices that will be contracted for the hierarchy.
     // Offers a trade-off between preprocessing and query time.
     // The remaining vertices form the core of the hierarchy
@@ -2,11 +2,11 @@
 #define GRAPH_CONTRACTOR_HPP
 
 #include "contractor/query_edge.hpp"
-#include "util/binary_heap.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/dynamic_graph.hpp"
 #include "util/integer_range.hpp"
 #include "util/percent.hpp"
+#include "util/search_heap.hpp"
 #include "util/simple_logger.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
@@ -37,22 +37,25 @@ class GraphContractor
     struct ContractorEdgeData
     {
         ContractorEdgeData()
-            : distance(0), id(0), originalEdges(0), shortcut(0), forward(0), backward(0),
-              is_original_via_node_ID(false)
+            : distance(0), length(0), id(0), originalEdges(0), shortcut(0), forward(0),
+              backward(0), is_original_via_node_ID(false)
         {
         }
         ContractorEdgeData(unsigned distance,
+                           unsigned length,
                            unsigned original_edges,
                            unsigned id,
                            bool shortcut,
                            bool forward,
                            bool backward)
-            : distance(distance), id(id),
+            : distance(distance), length(length), id(id),
               originalEdges(std::min((unsigned)1 << 28, original_edges)), shortcut(shortcut),
               forward(forward), backward(backward), is_original_via_node_ID(false)
         {
         }
         unsigned distance;
+        // length of the edge in decimeters, summed up along shortcuts
+        unsigned length;
         unsigned id;
         unsigned originalEdges : 28;
         bool shortcut : 1;
@@ -74,7 +77,7 @@ class GraphContractor
     //    using ContractorHeap = util::BinaryHeap<NodeID, NodeID, int, ContractorHeapData,
     //    ArrayStorage<NodeID, NodeID>
     //    >;
-    using ContractorHeap = util::BinaryHeap<NodeID,
+    using ContractorHeap = util::SearchHeap<NodeID,
                                             NodeID,
                                             int,
                                             ContractorHeapData,
@@ -145,6 +148,19 @@ class GraphContractor
                     ContainerT &input_edge_list,
                     std::vector<float> &&node_levels_,
                     std::vector<EdgeWeight> &&node_weights_)
+        : GraphContractor(
+              nodes, input_edge_list, std::move(node_levels_), std::move(node_weights_), {})
+    {
+    }
+
+    // node_lengths holds the length of every edge-based node in decimeters, the length of an
+    // edge-based edge is the length of its source node. Without lengths all edges have length 0.
+    template <class ContainerT>
+    GraphContractor(int nodes,
+                    ContainerT &input_edge_list,
+                    std::vector<float> &&node_levels_,
+                    std::vector<EdgeWeight> &&node_weights_,
+                    const std::vector<EdgeLength> &node_lengths)
         : node_levels(std::move(node_levels_)), node_weights(std::move(node_weights_))
     {
         std::vector<ContractorEdge> edges;
@@ -165,9 +181,11 @@ class GraphContractor
                     << static_cast<unsigned int>(diter->target);
             }
 #endif
+            const EdgeLength length = node_lengths.empty() ? 0 : node_lengths[diter->source];
             edges.emplace_back(diter->source,
                                diter->target,
                                static_cast<unsigned int>(std::max(diter->weight, 1)),
+                               length,
                                1,
                                diter->edge_id,
                                false,
@@ -177,6 +195,7 @@ class GraphContractor
             edges.emplace_back(diter->target,
                                diter->source,
                                static_cast<unsigned int>(std::max(diter->weight, 1)),
+                               length,
                                1,
                                diter->edge_id,
                                false,
@@ -211,23 +230,25 @@ class GraphContractor
             forward_edge.data.id = reverse_edge.data.id = id;
             forward_edge.data.originalEdges = reverse_edge.data.originalEdges = 1;
             forward_edge.data.distance = reverse_edge.data.distance = INVALID_EDGE_WEIGHT;
-            // remove parallel edges
+            forward_edge.data.length = reverse_edge.data.length = 0;
+            // remove parallel edges, the length is the one of the edge with the smallest weight
             while (i < edges.size() && edges[i].source == source && edges[i].target == target)
             {
-                if (edges[i].data.forward)
+                if (edges[i].data.forward && edges[i].data.distance < forward_edge.data.distance)
                 {
-                    forward_edge.data.distance =
-                        std::min(edges[i].data.distance, forward_edge.data.distance);
+                    forward_edge.data.distance = edges[i].data.distance;
+                    forward_edge.data.length = edges[i].data.length;
                 }
-                if (edges[i].data.backward)
+                if (edges[i].data.backward && edges[i].data.distance < reverse_edge.data.distance)
                 {
-                    reverse_edge.data.distance =
-                        std::min(edges[i].data.distance, reverse_edge.data.distance);
+                    reverse_edge.data.distance = edges[i].data.distance;
+                    reverse_edge.data.length = edges[i].data.length;
                 }
                 ++i;
             }
             // merge edges (s,t) and (t,s) into bidirectional edge
-            if (forward_edge.data.distance == reverse_edge.data.distance)
+            if (forward_edge.data.distance == reverse_edge.data.distance &&
+                forward_edge.data.length == reverse_edge.data.length)
             {
                 if ((int)forward_edge.data.distance != INVALID_EDGE_WEIGHT)
                 {
@@ -379,7 +400,8 @@ class GraphContractor
                         const NodeID target = contractor_graph->GetTarget(current_edge);
                         if (SPECIAL_NODEID == new_node_id_from_orig_id_map[source])
                         {
-                            external_edge_list.push_back({source, target, data});
+                            external_edge_list.push_back(
+                                {source, target, data, static_cast<EdgeLength>(data.length)});
                         }
                         else
                         {
@@ -646,6 +668,7 @@ class GraphContractor
                     BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.source, "Source id invalid");
                     BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.target, "Target id invalid");
                     new_edge.data.distance = data.distance;
+                    SetLength(new_edge, data.length);
                     new_edge.data.shortcut = data.shortcut;
                     if (!data.is_original_via_node_ID && !orig_node_id_from_new_node_id_map.empty())
                     {
@@ -675,6 +698,10 @@ class GraphContractor
     }
 
   private:
+    static void SetLength(QueryEdge &, const EdgeLength) {}
+
+    static void SetLength(ContractedEdge &edge, const EdgeLength length) { edge.length = length; }
+
     inline void RelaxNode(const NodeID node,
                           const NodeID forbidden_node,
                           const int distance,
@@ -821,6 +848,7 @@ class GraphContractor
                     continue;
 
                 const EdgeWeight path_distance = in_data.distance + out_data.distance;
+                const unsigned path_length = in_data.length + out_data.length;
                 if (target == source)
                 {
                     if (path_distance < node_weights[node])
@@ -847,6 +875,7 @@ class GraphContractor
                             inserted_edges.emplace_back(source,
                                                         target,
                                                         path_distance,
+                                                        path_length,
                                                         out_data.originalEdges +
                                                             in_data.originalEdges,
                                                         node,
@@ -857,6 +886,7 @@ class GraphContractor
                             inserted_edges.emplace_back(target,
                                                         source,
                                                         path_distance,
+                                                        path_length,
                                                         out_data.originalEdges +
                                                             in_data.originalEdges,
                                                         node,
@@ -897,6 +927,7 @@ class GraphContractor
                 if (target == node)
                     continue;
                 const int path_distance = in_data.distance + out_data.distance;
+                const unsigned path_length = in_data.length + out_data.length;
                 const int distance = heap.GetKey(target);
                 if (path_distance < distance)
                 {
@@ -912,6 +943,7 @@ class GraphContractor
                         inserted_edges.emplace_back(source,
                                                     target,
                                                     path_distance,
+                                                    path_length,
                                                     out_data.originalEdges + in_data.originalEdges,
                                                     node,
                                                     SHORTCUT_ARC,
@@ -921,6 +953,7 @@ class GraphContractor
                         inserted_edges.emplace_back(target,
                                                     source,
                                                     path_distance,
+                                                    path_length,
                                                     out_data.originalEdges + in_data.originalEdges,
                                                     node,
                                                     SHORTCUT_ARC,
@@ -952,6 +985,10 @@ class GraphContractor
                     {
                         continue;
                     }
+                    if (inserted_edges[other].data.length != inserted_edges[i].data.length)
+                    {
+                        continue;
+                    }
                     if (inserted_edges[other].data.shortcut != inserted_edges[i].data.shortcut)
                     {
                         continue;
@@ -1105,7 +1142,7 @@ class GraphContractor
     }
 
     std::shared_ptr<ContractorGraph> contractor_graph;
-    stxxl::vector<QueryEdge> external_edge_list;
+    stxxl::vector<ContractedEdge> external_edge_list;
     std::vector<NodeID> orig_node_id_from_new_node_id_map;
     std::vector<float> node_levels;
 
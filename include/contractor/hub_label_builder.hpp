@@ -0,0 +1,55 @@
+#ifndef CONTRACTOR_HUB_LABEL_BUILDER_HPP
+#define CONTRACTOR_HUB_LABEL_BUILDER_HPP
+
+#include "contractor/hub_label_config.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/// Derives hub labels from a fully contracted hierarchy (osrm-hublabel)
+///
+/// Every edge of the query graph points upwards in the hierarchy, so the label of a node is
+/// the union of the labels of its upward neighbours shifted by the edge weight. Nodes are
+/// processed top-down, entries that are not on a shortest path are pruned by querying the
+/// already finished labels of the hub.
+class HubLabelBuilder
+{
+  public:
+    using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+
+    struct Label
+    {
+        std::vector<NodeID> hubs;
+        std::vector<EdgeWeight> weights;
+    };
+
+    explicit HubLabelBuilder(const HubLabelConfig &config_) : config{config_} {}
+
+    HubLabelBuilder(const HubLabelBuilder &) = delete;
+    HubLabelBuilder &operator=(const HubLabelBuilder &) = delete;
+
+    int Run();
+
+    static void BuildLabels(const QueryGraph &graph,
+                            std::vector<Label> &forward_labels,
+                            std::vector<Label> &backward_labels);
+
+  private:
+    HubLabelConfig config;
+
+    bool HasCore() const;
+    void WriteLabels(unsigned checksum,
+                     const std::vector<Label> &forward_labels,
+                     const std::vector<Label> &backward_labels) const;
+};
+}
+}
+
+#endif // CONTRACTOR_HUB_LABEL_BUILDER_HPP
@@ -0,0 +1,36 @@
+#ifndef CONTRACTOR_HUB_LABEL_CONFIG_HPP
+#define CONTRACTOR_HUB_LABEL_CONFIG_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <string>
+
+namespace osrm
+{
+namespace contractor
+{
+
+struct HubLabelConfig
+{
+    HubLabelConfig() : requested_num_threads(0) {}
+
+    // Infer the input and output names from the path of the .osrm file
+    void UseDefaultOutputNames()
+    {
+        graph_path = osrm_input_path.string() + ".hsgr";
+        core_path = osrm_input_path.string() + ".core";
+        hub_labels_output_path = osrm_input_path.string() + ".hl";
+    }
+
+    boost::filesystem::path osrm_input_path;
+
+    std::string graph_path;
+    std::string core_path;
+    std::string hub_labels_output_path;
+
+    unsigned requested_num_threads;
+};
+}
+}
+
+#endif // CONTRACTOR_HUB_LABEL_CONFIG_HPP
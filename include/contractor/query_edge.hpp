@@ -53,6 +53,20 @@ struct QueryEdge
                 data.id == right.data.id);
     }
 };
+
+// Edge of the contracted graph with its length in decimeters, for shortcuts the sum of the lengths
+// of the skipped edges. Only osrm-contract --edge-lengths writes the lengths, next to the .hsgr.
+struct ContractedEdge : QueryEdge
+{
+    ContractedEdge() = default;
+
+    ContractedEdge(NodeID source, NodeID target, EdgeData data, EdgeLength length)
+        : QueryEdge(source, target, std::move(data)), length(length)
+    {
+    }
+
+    EdgeLength length = 0;
+};
 }
 }
 
@@ -0,0 +1,73 @@
+#ifndef ENGINE_API_FACILITIES_HPP
+#define ENGINE_API_FACILITIES_HPP
+
+#include "engine/api/base_api.hpp"
+#include "engine/api/facilities_parameters.hpp"
+#include "engine/api/json_factory.hpp"
+
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/routing_algorithms/nearest_facilities.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+class FacilitiesAPI final : public BaseAPI
+{
+  public:
+    FacilitiesAPI(const datafacade::BaseDataFacade &facade_,
+                  const FacilitiesParameters &parameters_)
+        : BaseAPI(facade_, parameters_), parameters(parameters_)
+    {
+    }
+
+    // results[i] holds the nearest facilities of the i-th source, facility ids are indices into
+    // facility_phantoms
+    void MakeResponse(const std::vector<std::vector<routing_algorithms::FacilityResult>> &results,
+                      const std::vector<PhantomNode> &source_phantoms,
+                      const std::vector<PhantomNode> &facility_phantoms,
+                      util::json::Object &response) const
+    {
+        BOOST_ASSERT(results.size() == source_phantoms.size());
+
+        util::json::Array sources;
+        util::json::Array facilities;
+        for (const auto i : util::irange<std::size_t>(0UL, source_phantoms.size()))
+        {
+            sources.values.push_back(MakeWaypoint(source_phantoms[i]));
+
+            util::json::Array nearest;
+            for (const auto &result : results[i])
+            {
+                BOOST_ASSERT(result.facility_id < facility_phantoms.size());
+                auto waypoint = MakeWaypoint(facility_phantoms[result.facility_id]);
+                waypoint.values["index"] = result.facility_id;
+                waypoint.values["duration"] = result.duration / 10.;
+                nearest.values.push_back(std::move(waypoint));
+            }
+            facilities.values.push_back(std::move(nearest));
+        }
+
+        response.values["sources"] = std::move(sources);
+        response.values["facilities"] = std::move(facilities);
+        response.values["code"] = "Ok";
+    }
+
+    const FacilitiesParameters &parameters;
+};
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
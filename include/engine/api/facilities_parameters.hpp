@@ -0,0 +1,99 @@
+/*
+
+Copyright (c) 2016, Project OSRM contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ENGINE_API_FACILITIES_PARAMETERS_HPP
+#define ENGINE_API_FACILITIES_PARAMETERS_HPP
+
+#include "engine/api/base_parameters.hpp"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+/**
+ * Parameters specific to the OSRM Facilities service.
+ *
+ * Holds member attributes:
+ *  - sources: indices into coordinates indicating sources, no sources means use all coordinates
+ *             that are not destinations
+ *  - destinations: indices into coordinates indicating the facilities to choose from
+ *  - number_of_results: number of nearest facilities that should be returned for every source
+ *  - facility_set: name of a facility set registered with osrm-routed, used instead of
+ *                  destinations
+ *
+ * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
+ *      NearestParameters, TripParameters, MatchParameters and TileParameters
+ */
+struct FacilitiesParameters : public BaseParameters
+{
+    std::vector<std::size_t> sources;
+    std::vector<std::size_t> destinations;
+    unsigned number_of_results = 1;
+    std::string facility_set;
+
+    bool IsValid() const
+    {
+        if (!BaseParameters::IsValid())
+            return false;
+
+        if (number_of_results < 1)
+            return false;
+
+        // Either a registered facility set or the facilities in the coordinates
+        if (facility_set.empty() == destinations.empty())
+            return false;
+
+        const auto not_in_range = [this](const std::size_t x) { return x >= coordinates.size(); };
+
+        if (std::any_of(begin(sources), end(sources), not_in_range))
+            return false;
+
+        if (std::any_of(begin(destinations), end(destinations), not_in_range))
+            return false;
+
+        // Without explicit sources at least one coordinate has to be left as source
+        if (sources.empty() && destinations.size() >= coordinates.size())
+            return false;
+
+        return true;
+    }
+};
+}
+}
+}
+
+#endif // ENGINE_API_FACILITIES_PARAMETERS_HPP
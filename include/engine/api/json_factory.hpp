@@ -36,7 +36,7 @@ namespace detail
 std::string instructionTypeToString(extractor::guidance::TurnType::Enum type);
 std::string instructionModifierToString(extractor::guidance::DirectionModifier::Enum modifier);
 
-util::json::Array coordinateToLonLat(const util::Coordinate coordinate);
+util::json::LonLat coordinateToLonLat(const util::Coordinate coordinate);
 
 std::string modeToString(const extractor::TravelMode mode);
 
@@ -56,16 +56,15 @@ util::json::Object makeGeoJSONGeometry(ForwardIter begin, ForwardIter end)
     if (num_coordinates > 1)
     {
         geojson.values["type"] = "LineString";
-        util::json::Array coordinates;
-        std::transform(
-            begin, end, std::back_inserter(coordinates.values), &detail::coordinateToLonLat);
+        util::json::LonLatArray coordinates;
+        coordinates.values.assign(begin, end);
         geojson.values["coordinates"] = std::move(coordinates);
     }
     else if (num_coordinates > 0)
     {
         geojson.values["type"] = "Point";
-        util::json::Array coordinates;
-        coordinates.values.push_back(detail::coordinateToLonLat(*begin));
+        util::json::LonLatArray coordinates;
+        coordinates.values.push_back(*begin);
         geojson.values["coordinates"] = std::move(coordinates);
     }
     return geojson;
@@ -5,12 +5,17 @@
 #include "engine/api/route_api.hpp"
 
 #include "engine/datafacade/datafacade_base.hpp"
+#include "engine/guidance/assemble_geometry.hpp"
 
 #include "engine/internal_route_result.hpp"
 #include "engine/map_matching/sub_matching.hpp"
 
+#include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -43,7 +48,7 @@ class MatchAPI final : public RouteAPI
             route.values["confidence"] = sub_matchings[index].confidence;
             routes.values.push_back(std::move(route));
         }
-        response.values["tracepoints"] = MakeTracepoints(sub_matchings);
+        response.values["tracepoints"] = MakeTracepoints(sub_matchings, sub_routes);
         response.values["matchings"] = std::move(routes);
         response.values["code"] = "Ok";
     }
@@ -54,8 +59,8 @@ class MatchAPI final : public RouteAPI
     // FIXME this logic is a little backwards. We should change the output format of the
     // map_matching
     // routing algorithm to be easier to consume here.
-    util::json::Array
-    MakeTracepoints(const std::vector<map_matching::SubMatching> &sub_matchings) const
+    util::json::Array MakeTracepoints(const std::vector<map_matching::SubMatching> &sub_matchings,
+                                      const std::vector<InternalRouteResult> &sub_routes) const
     {
         util::json::Array waypoints;
         waypoints.values.reserve(parameters.coordinates.size());
@@ -90,12 +95,66 @@ class MatchAPI final : public RouteAPI
             }
         }
 
+        // With tidy the points between two consecutive waypoints of a matching were dropped
+        // before matching. They are placed on the matched route between the two waypoints, at the
+        // same ratio as they are along the trace between the two trace points.
+        const constexpr auto NO_MATCHED_LEG = std::numeric_limits<std::size_t>::max();
+        std::vector<MatchedLeg> matched_legs;
+        std::vector<std::size_t> trace_idx_to_matched_leg(parameters.coordinates.size(),
+                                                          NO_MATCHED_LEG);
+        std::vector<double> leg_ratios(parameters.coordinates.size(), 0.);
+        if (parameters.tidy)
+        {
+            for (auto sub_matching_index :
+                 util::irange(0u, static_cast<unsigned>(sub_matchings.size())))
+            {
+                const auto &indices = sub_matchings[sub_matching_index].indices;
+                for (auto point_index = 1u; point_index < indices.size(); ++point_index)
+                {
+                    const auto first = indices[point_index - 1];
+                    const auto last = indices[point_index];
+                    if (last <= first + 1)
+                    {
+                        continue;
+                    }
+                    // the geometry of the leg is assembled once for all points dropped on it
+                    matched_legs.push_back(MakeMatchedLeg(
+                        sub_routes[sub_matching_index], sub_matching_index, point_index - 1));
+
+                    std::vector<double> lengths(1, 0.);
+                    for (auto trace_index = first + 1; trace_index <= last; ++trace_index)
+                    {
+                        lengths.push_back(lengths.back() +
+                                          util::coordinate_calculation::haversineDistance(
+                                              parameters.coordinates[trace_index - 1],
+                                              parameters.coordinates[trace_index]));
+                    }
+                    for (auto trace_index = first + 1; trace_index < last; ++trace_index)
+                    {
+                        trace_idx_to_matched_leg[trace_index] = matched_legs.size() - 1;
+                        leg_ratios[trace_index] =
+                            lengths.back() > 0 ? lengths[trace_index - first] / lengths.back()
+                                               : 0.;
+                    }
+                }
+            }
+        }
+
         for (auto trace_index : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             auto matching_index = trace_idx_to_matching_idx[trace_index];
             if (matching_index.NotMatched())
             {
-                waypoints.values.push_back(util::json::Null());
+                const auto matched_leg = trace_idx_to_matched_leg[trace_index];
+                if (matched_leg == NO_MATCHED_LEG)
+                {
+                    waypoints.values.push_back(util::json::Null());
+                }
+                else
+                {
+                    waypoints.values.push_back(MakeInterpolatedTracepoint(
+                        matched_legs[matched_leg], leg_ratios[trace_index]));
+                }
                 continue;
             }
             const auto &phantom =
@@ -109,6 +168,73 @@ class MatchAPI final : public RouteAPI
         return waypoints;
     }
 
+    // Matched geometry of a leg that points were dropped on
+    struct MatchedLeg
+    {
+        unsigned sub_matching_index;
+        unsigned leg_index;
+        guidance::LegGeometry geometry;
+        // length of the geometry from its first location up to each location
+        std::vector<double> lengths;
+        const std::vector<PathData> *path_data;
+        unsigned target_name_id;
+    };
+
+    MatchedLeg MakeMatchedLeg(const InternalRouteResult &sub_route,
+                              const unsigned sub_matching_index,
+                              const unsigned leg_index) const
+    {
+        BOOST_ASSERT(leg_index < sub_route.unpacked_path_segments.size());
+        const auto &phantoms = sub_route.segment_end_coordinates[leg_index];
+        const auto &path_data = sub_route.unpacked_path_segments[leg_index];
+
+        MatchedLeg leg;
+        leg.sub_matching_index = sub_matching_index;
+        leg.leg_index = leg_index;
+        leg.geometry = guidance::assembleGeometry(
+            BaseAPI::facade, path_data, phantoms.source_phantom, phantoms.target_phantom);
+        // annotations[i] is the part of the geometry from locations[i] to locations[i + 1]
+        leg.lengths.reserve(leg.geometry.locations.size());
+        leg.lengths.push_back(0.);
+        for (const auto &annotation : leg.geometry.annotations)
+        {
+            leg.lengths.push_back(leg.lengths.back() + annotation.distance);
+        }
+        leg.path_data = &path_data;
+        leg.target_name_id = phantoms.target_phantom.name_id;
+        return leg;
+    }
+
+    // Tracepoint of a dropped point, placed at ratio of the length of the matched geometry of
+    // the leg. It has no hint, since it was never snapped to the network.
+    util::json::Object MakeInterpolatedTracepoint(const MatchedLeg &leg, const double ratio) const
+    {
+        const auto &lengths = leg.lengths;
+        BOOST_ASSERT(lengths.size() >= 2);
+        const auto position = ratio * lengths.back();
+        // first segment that ends at or after the position
+        const std::size_t segment =
+            std::lower_bound(lengths.begin() + 1, lengths.end() - 1, position) -
+            (lengths.begin() + 1);
+        const auto segment_length = lengths[segment + 1] - lengths[segment];
+        const auto location = util::coordinate_calculation::interpolateLinear(
+            segment_length > 0 ? std::min((position - lengths[segment]) / segment_length, 1.)
+                               : 0.,
+            leg.geometry.locations[segment],
+            leg.geometry.locations[segment + 1]);
+        // the path data names the street leading to each turn, the last part is on the target
+        const auto name_id = segment < leg.path_data->size() ? (*leg.path_data)[segment].name_id
+                                                             : leg.target_name_id;
+
+        util::json::Object tracepoint;
+        tracepoint.values["location"] = json::detail::coordinateToLonLat(location);
+        tracepoint.values["name"] = BaseAPI::facade.GetNameForID(name_id);
+        tracepoint.values["matchings_index"] = leg.sub_matching_index;
+        tracepoint.values["leg_index"] = leg.leg_index;
+        tracepoint.values["interpolated"] = util::json::True();
+        return tracepoint;
+    }
+
     const MatchParameters &parameters;
 };
 
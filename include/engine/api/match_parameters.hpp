@@ -44,6 +44,8 @@ namespace api
  *
  * Holds member attributes:
  *  - timestamps: timestamp(s) for the corresponding input coordinate(s)
+ *  - tidy: drop near-duplicate, stationary and collinear points before matching and limit the
+ *          candidates per point, dropped points are interpolated in the tracepoints
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -67,6 +69,8 @@ struct MatchParameters : public RouteParameters
     }
 
     std::vector<unsigned> timestamps;
+    bool tidy = false;
+
     bool IsValid() const
     {
         return RouteParameters::IsValid() &&
@@ -16,10 +16,14 @@
 #include "engine/internal_route_result.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
 #include <iterator>
+#include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -40,15 +44,110 @@ class TableAPI final : public BaseAPI
                               const std::vector<PhantomNode> &phantoms,
                               util::json::Object &response) const
     {
-        auto number_of_sources = parameters.sources.size();
-        auto number_of_destinations = parameters.destinations.size();
-        ;
+        MakeWaypointsResponse(phantoms, response);
 
+        if (parameters.HasDurations())
+        {
+            const auto number_of_sources = parameters.sources.empty()
+                                               ? phantoms.size()
+                                               : parameters.sources.size();
+            const auto number_of_destinations = parameters.destinations.empty()
+                                                    ? phantoms.size()
+                                                    : parameters.destinations.size();
+            response.values["durations"] =
+                MakeTable(durations, number_of_sources, number_of_destinations);
+        }
+    }
+
+    // The streamed response renders the same document as MakeResponse in pieces: first
+    // everything up to the opening of the durations, then blocks of rows as they are computed
+    // and at last the closing, which holds the end of the durations and what follows them.
+    virtual void BeginStreamedResponse(const std::vector<PhantomNode> &phantoms,
+                                       std::vector<char> &output,
+                                       std::vector<char> &closing) const
+    {
+        BOOST_ASSERT(parameters.HasDurations());
+        // same keys in the same order as MakeResponse, so the object is rendered in its order
+        util::json::Object response;
+        MakeWaypointsResponse(phantoms, response);
+        response.values["durations"] = util::json::Array();
+        util::json::render(output, response);
+
+        // the key is unique, quotes inside of strings are escaped
+        const std::string durations_key = "\"durations\":[";
+        const auto durations = std::search(
+            output.begin(), output.end(), durations_key.begin(), durations_key.end());
+        BOOST_ASSERT(durations != output.end());
+        const auto rows = durations + durations_key.size();
+        BOOST_ASSERT(*rows == ']');
+        closing.assign(rows, output.end());
+        output.erase(rows, output.end());
+    }
+
+    // Appends the rows of a block of durations, first_row is the index of its first row
+    virtual void AppendStreamedRows(const std::vector<EdgeWeight> &durations,
+                                    const std::size_t first_row,
+                                    const std::size_t number_of_columns,
+                                    std::vector<char> &output) const
+    {
+        BOOST_ASSERT(number_of_columns > 0 && durations.size() % number_of_columns == 0);
+        for (auto row_begin = durations.begin(); row_begin != durations.end();
+             row_begin += number_of_columns)
+        {
+            if (first_row > 0 || row_begin != durations.begin())
+            {
+                output.push_back(',');
+            }
+            output.push_back('[');
+            for (auto entry = row_begin; entry != row_begin + number_of_columns; ++entry)
+            {
+                if (entry != row_begin)
+                {
+                    output.push_back(',');
+                }
+                AppendDuration(*entry, output);
+            }
+            output.push_back(']');
+        }
+    }
+
+    // Distances are given in decimeters, entries without a path are INVALID_EDGE_WEIGHT
+    virtual void AddDistances(const std::vector<EdgeLength> &distances,
+                              util::json::Object &response) const
+    {
+        const auto number_of_sources =
+            parameters.sources.empty() ? parameters.coordinates.size() : parameters.sources.size();
+        const auto number_of_destinations = parameters.destinations.empty()
+                                                ? parameters.coordinates.size()
+                                                : parameters.destinations.size();
+        response.values["distances"] =
+            MakeTable(distances, number_of_sources, number_of_destinations);
+    }
+
+    // Estimated absolute error of the durations, zero for exact entries. The estimate is derived
+    // from sampled points of each cell and is not a guaranteed bound.
+    virtual void
+    AddEstimatedDurationErrors(const std::vector<EdgeWeight> &estimated_duration_errors,
+                               util::json::Object &response) const
+    {
+        const auto number_of_sources =
+            parameters.sources.empty() ? parameters.coordinates.size() : parameters.sources.size();
+        const auto number_of_destinations = parameters.destinations.empty()
+                                                ? parameters.coordinates.size()
+                                                : parameters.destinations.size();
+        response.values["estimated_duration_errors"] =
+            MakeTable(estimated_duration_errors, number_of_sources, number_of_destinations);
+    }
+
+    // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
+    //  protected:
+    virtual void MakeWaypointsResponse(const std::vector<PhantomNode> &phantoms,
+                                       util::json::Object &response) const
+    {
         // symmetric case
         if (parameters.sources.empty())
         {
             response.values["sources"] = MakeWaypoints(phantoms);
-            number_of_sources = phantoms.size();
         }
         else
         {
@@ -58,20 +157,33 @@ class TableAPI final : public BaseAPI
         if (parameters.destinations.empty())
         {
             response.values["destinations"] = MakeWaypoints(phantoms);
-            number_of_destinations = phantoms.size();
         }
         else
         {
             response.values["destinations"] = MakeWaypoints(phantoms, parameters.destinations);
         }
-
-        response.values["durations"] =
-            MakeTable(durations, number_of_sources, number_of_destinations);
         response.values["code"] = "Ok";
     }
 
-    // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
-    //  protected:
+    // Durations are in deciseconds, rendered in seconds the same as a json::Number
+    static void AppendDuration(const EdgeWeight duration, std::vector<char> &output)
+    {
+        if (duration == INVALID_EDGE_WEIGHT)
+        {
+            const std::string null_string = "null";
+            output.insert(output.end(), null_string.begin(), null_string.end());
+            return;
+        }
+        BOOST_ASSERT(duration >= 0);
+        const auto seconds = std::to_string(duration / 10);
+        output.insert(output.end(), seconds.begin(), seconds.end());
+        if (duration % 10 != 0)
+        {
+            output.push_back('.');
+            output.push_back('0' + duration % 10);
+        }
+    }
+
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
         util::json::Array json_waypoints;
@@ -113,12 +225,12 @@ class TableAPI final : public BaseAPI
             std::transform(row_begin_iterator,
                            row_end_iterator,
                            json_row.values.begin(),
-                           [](const EdgeWeight duration) {
-                               if (duration == INVALID_EDGE_WEIGHT)
+                           [](const EdgeWeight value) {
+                               if (value == INVALID_EDGE_WEIGHT)
                                {
                                    return util::json::Value(util::json::Null());
                                }
-                               return util::json::Value(util::json::Number(duration / 10.));
+                               return util::json::Value(util::json::Number(value / 10.));
                            });
             json_table.values.push_back(std::move(json_row));
         }
@@ -30,6 +30,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/base_parameters.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <algorithm>
@@ -51,14 +53,32 @@ namespace api
  *             use all coordinates as sources
  *  - destinations: indices into coordinates indicating destinations for the Table service, no
  *                  destinations means use all coordinates as destinations
+ *  - max_duration: upper bound in seconds, longer durations are returned as null
+ *  - max_distance: upper bound in meters on the great circle distance between a source and a
+ *                  destination, pairs farther apart are returned as null. If distances are
+ *                  requested, the bound applies to them instead
+ *  - approximate: answer from the precomputed cell table where possible, see
+ *                 estimated_duration_errors
+ *  - annotations: return the durations, the distances in meters or both
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
 struct TableParameters : public BaseParameters
 {
+    enum class AnnotationsType
+    {
+        Duration = 0x01,
+        Distance = 0x02,
+        All = Duration | Distance
+    };
+
     std::vector<std::size_t> sources;
     std::vector<std::size_t> destinations;
+    boost::optional<double> max_duration;
+    boost::optional<double> max_distance;
+    bool approximate = false;
+    AnnotationsType annotations = AnnotationsType::Duration;
 
     TableParameters() = default;
     template <typename... Args>
@@ -70,6 +90,16 @@ struct TableParameters : public BaseParameters
     {
     }
 
+    bool HasDurations() const
+    {
+        return static_cast<int>(annotations) & static_cast<int>(AnnotationsType::Duration);
+    }
+
+    bool HasDistances() const
+    {
+        return static_cast<int>(annotations) & static_cast<int>(AnnotationsType::Distance);
+    }
+
     bool IsValid() const
     {
         if (!BaseParameters::IsValid())
@@ -97,6 +127,13 @@ struct TableParameters : public BaseParameters
         if (std::any_of(begin(destinations), end(destinations), not_in_range))
             return false;
 
+        // 4/ bounds have to be positive
+        if (max_duration && *max_duration < 0)
+            return false;
+
+        if (max_distance && *max_distance < 0)
+            return false;
+
         return true;
     }
 };
@@ -0,0 +1,77 @@
+#ifndef ENGINE_CLOSURE_OVERLAY_HPP
+#define ENGINE_CLOSURE_OVERLAY_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/incoming_edge_index.hpp"
+#include "storage/shared_datatype.hpp"
+#include "util/typedefs.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Sorted list of closed edge-based nodes
+using ClosedNodes = std::vector<NodeID>;
+
+/**
+ * Road closures published by osrm-closures into shared memory.
+ *
+ * The closure set is copied out of shared memory whenever osrm-closures publishes a new one,
+ * but shared memory is polled at most once per refresh interval. Queries work on an immutable
+ * snapshot, so an update never changes the closures in the middle of a request.
+ * Snapshots are published with std::atomic_store, queries never wait for a lock. The query that
+ * finds the refresh interval elapsed polls shared memory, concurrent queries keep using the
+ * current snapshot meanwhile.
+ *
+ * Every snapshot carries the incoming edges of its dataset, which the detour searches around
+ * closures need. They are indexed for the loaded dataset on construction. Closures published
+ * for a dataset osrm-datastore loaded later are only picked up once the queries see that
+ * dataset, the query that polls them then indexes it once.
+ */
+class ClosureOverlay
+{
+  public:
+    struct Closures
+    {
+        unsigned checksum;
+        ClosedNodes closed_nodes;
+        std::shared_ptr<const IncomingEdgeIndex> incoming_edges;
+    };
+
+    // The facade has to be locked for reading whenever GetClosures is called
+    explicit ClosureOverlay(
+        const datafacade::BaseDataFacade &facade,
+        const std::chrono::milliseconds refresh_interval = std::chrono::milliseconds(1000));
+
+    // Returns the current closures, or nullptr if none were published for the dataset with
+    // the given checksum
+    std::shared_ptr<const Closures> GetClosures(const unsigned dataset_checksum);
+
+  private:
+    void Refresh();
+
+    const datafacade::BaseDataFacade &facade;
+    const std::chrono::milliseconds refresh_interval;
+
+    // ticks of std::chrono::steady_clock
+    std::atomic<std::chrono::steady_clock::rep> last_refresh;
+    // held while polling shared memory, guards current_region, current_timestamp and
+    // incoming_edges
+    std::mutex refresh_mutex;
+    storage::SharedDataType current_region;
+    unsigned current_timestamp;
+    std::shared_ptr<const IncomingEdgeIndex> incoming_edges;
+    // only accessed through std::atomic_load and std::atomic_store
+    std::shared_ptr<const Closures> snapshot;
+};
+}
+}
+
+#endif // ENGINE_CLOSURE_OVERLAY_HPP
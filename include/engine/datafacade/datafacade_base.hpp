@@ -7,6 +7,7 @@
 #include "extractor/edge_based_node.hpp"
 #include "extractor/external_memory_node.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
+#include "extractor/original_edge_data.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
@@ -51,12 +52,24 @@ class BaseDataFacade
 
     virtual const EdgeData &GetEdgeData(const EdgeID e) const = 0;
 
+    // true if osrm-contract --edge-lengths stored the lengths of the edges
+    virtual bool HasEdgeLengths() const = 0;
+
+    // length of an edge in decimeters, only valid if HasEdgeLengths
+    virtual EdgeLength GetEdgeLength(const EdgeID e) const = 0;
+
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
     virtual EdgeID EndEdges(const NodeID n) const = 0;
 
     virtual EdgeRange GetAdjacentEdgeRange(const NodeID node) const = 0;
 
+    // hints the CPU to load the data of a node that is going to be settled later on
+    virtual void PrefetchNode(const NodeID n) const = 0;
+
+    // hints the CPU to load the edges of a node that is going to be settled next
+    virtual void PrefetchAdjacentEdges(const NodeID n) const = 0;
+
     // searches for a specific edge
     virtual EdgeID FindEdge(const NodeID from, const NodeID to) const = 0;
 
@@ -91,6 +104,10 @@ class BaseDataFacade
 
     virtual extractor::TravelMode GetTravelModeForEdgeID(const unsigned id) const = 0;
 
+    // Returns all annotations of an original edge (via node / geometry index, name id,
+    // turn instruction, travel mode and entry class) with a single lookup
+    virtual extractor::OriginalEdgeData GetOriginalEdgeData(const unsigned id) const = 0;
+
     virtual std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate south_west,
                                                  const util::Coordinate north_east) const = 0;
 
@@ -70,13 +70,11 @@ class InternalDataFacade final : public BaseDataFacade
     unsigned m_check_sum;
     unsigned m_number_of_nodes;
     std::unique_ptr<QueryGraph> m_query_graph;
+    util::ShM<EdgeLength, false>::vector m_edge_lengths;
     std::string m_timestamp;
 
     util::ShM<util::Coordinate, false>::vector m_coordinate_list;
-    util::ShM<NodeID, false>::vector m_via_node_list;
-    util::ShM<unsigned, false>::vector m_name_ID_list;
-    util::ShM<extractor::guidance::TurnInstruction, false>::vector m_turn_instruction_list;
-    util::ShM<extractor::TravelMode, false>::vector m_travel_mode_list;
+    util::ShM<extractor::OriginalEdgeData, false>::vector m_original_edge_data;
     util::ShM<char, false>::vector m_names_char_list;
     util::ShM<unsigned, false>::vector m_geometry_indices;
     util::ShM<extractor::CompressedEdgeContainer::CompressedEdge, false>::vector m_geometry_list;
@@ -94,8 +92,6 @@ class InternalDataFacade final : public BaseDataFacade
 
     // bearing classes by node based node
     util::ShM<BearingClassID, false>::vector m_bearing_class_id_table;
-    // entry class IDs by edge based egde
-    util::ShM<EntryClassID, false>::vector m_entry_class_id_list;
     // the look-up table for entry classes. An entry class lists the possibility of entry for all
     // available turns. For every turn, there is an associated entry class.
     util::ShM<util::guidance::EntryClass, false>::vector m_entry_class_table;
@@ -166,25 +162,33 @@ class InternalDataFacade final : public BaseDataFacade
         boost::filesystem::ifstream edges_input_stream(edges_file, std::ios::binary);
         unsigned number_of_edges = 0;
         edges_input_stream.read((char *)&number_of_edges, sizeof(unsigned));
-        m_via_node_list.resize(number_of_edges);
-        m_name_ID_list.resize(number_of_edges);
-        m_turn_instruction_list.resize(number_of_edges);
-        m_travel_mode_list.resize(number_of_edges);
-        m_entry_class_id_list.resize(number_of_edges);
-
-        extractor::OriginalEdgeData current_edge_data;
-        for (unsigned i = 0; i < number_of_edges; ++i)
+        m_original_edge_data.resize(number_of_edges);
+        if (number_of_edges > 0)
         {
-            edges_input_stream.read((char *)&(current_edge_data),
-                                    sizeof(extractor::OriginalEdgeData));
-            m_via_node_list[i] = current_edge_data.via_node;
-            m_name_ID_list[i] = current_edge_data.name_id;
-            m_turn_instruction_list[i] = current_edge_data.turn_instruction;
-            m_travel_mode_list[i] = current_edge_data.travel_mode;
-            m_entry_class_id_list[i] = current_edge_data.entry_classid;
+            edges_input_stream.read(reinterpret_cast<char *>(&m_original_edge_data[0]),
+                                    number_of_edges * sizeof(extractor::OriginalEdgeData));
         }
     }
 
+    void LoadEdgeLengths(const boost::filesystem::path &edge_lengths_file)
+    {
+        boost::filesystem::ifstream edge_lengths_stream(edge_lengths_file, std::ios::binary);
+        if (!edge_lengths_stream)
+        {
+            throw util::exception("Could not open " + edge_lengths_file.string() +
+                                  " for reading.");
+        }
+        unsigned number_of_lengths = 0;
+        edge_lengths_stream.read((char *)&number_of_lengths, sizeof(unsigned));
+        if (number_of_lengths != 0 && number_of_lengths != m_query_graph->GetNumberOfEdges())
+        {
+            throw util::exception(edge_lengths_file.string() + " does not match the .hsgr");
+        }
+        m_edge_lengths.resize(number_of_lengths);
+        edge_lengths_stream.read((char *)m_edge_lengths.data(),
+                                 sizeof(EdgeLength) * number_of_lengths);
+    }
+
     void LoadCoreInformation(const boost::filesystem::path &core_data_file)
     {
         std::ifstream core_stream(core_data_file.string().c_str(), std::ios::binary);
@@ -360,6 +364,7 @@ class InternalDataFacade final : public BaseDataFacade
 
         util::SimpleLogger().Write() << "loading graph data";
         LoadGraph(config.hsgr_data_path);
+        LoadEdgeLengths(config.edge_lengths_path);
 
         util::SimpleLogger().Write() << "loading edge information";
         LoadNodeAndEdgeInformation(config.nodes_data_path, config.edges_data_path);
@@ -406,6 +411,14 @@ class InternalDataFacade final : public BaseDataFacade
         return m_query_graph->GetEdgeData(e);
     }
 
+    bool HasEdgeLengths() const override final { return !m_edge_lengths.empty(); }
+
+    EdgeLength GetEdgeLength(const EdgeID e) const override final
+    {
+        BOOST_ASSERT(e < m_edge_lengths.size());
+        return m_edge_lengths[e];
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -415,6 +428,13 @@ class InternalDataFacade final : public BaseDataFacade
         return m_query_graph->GetAdjacentEdgeRange(node);
     }
 
+    void PrefetchNode(const NodeID n) const override final { m_query_graph->PrefetchNode(n); }
+
+    void PrefetchAdjacentEdges(const NodeID n) const override final
+    {
+        m_query_graph->PrefetchEdges(n);
+    }
+
     // searches for a specific edge
     EdgeID FindEdge(const NodeID from, const NodeID to) const override final
     {
@@ -441,12 +461,17 @@ class InternalDataFacade final : public BaseDataFacade
     extractor::guidance::TurnInstruction
     GetTurnInstructionForEdgeID(const unsigned id) const override final
     {
-        return m_turn_instruction_list.at(id);
+        return m_original_edge_data.at(id).turn_instruction;
     }
 
     extractor::TravelMode GetTravelModeForEdgeID(const unsigned id) const override final
     {
-        return m_travel_mode_list.at(id);
+        return m_original_edge_data.at(id).travel_mode;
+    }
+
+    extractor::OriginalEdgeData GetOriginalEdgeData(const unsigned id) const override final
+    {
+        return m_original_edge_data.at(id);
     }
 
     std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate south_west,
@@ -568,7 +593,7 @@ class InternalDataFacade final : public BaseDataFacade
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
     {
-        return m_name_ID_list.at(id);
+        return m_original_edge_data.at(id).name_id;
     }
 
     std::string GetNameForID(const unsigned name_id) const override final
@@ -593,7 +618,7 @@ class InternalDataFacade final : public BaseDataFacade
 
     virtual unsigned GetGeometryIndexForEdgeID(const unsigned id) const override final
     {
-        return m_via_node_list.at(id);
+        return m_original_edge_data.at(id).via_node;
     }
 
     virtual std::size_t GetCoreSize() const override final { return m_is_core_node.size(); }
@@ -707,7 +732,7 @@ class InternalDataFacade final : public BaseDataFacade
 
     EntryClassID GetEntryClassID(const EdgeID eid) const override final
     {
-        return m_entry_class_id_list.at(eid);
+        return m_original_edge_data.at(eid).entry_classid;
     }
 
     util::guidance::EntryClass GetEntryClass(const EntryClassID entry_class_id) const override final
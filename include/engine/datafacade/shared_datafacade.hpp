@@ -3,12 +3,14 @@
 
 // implements all data storage when shared memory _IS_ used
 
+#include "storage/dataset_image.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
+#include "extractor/original_edge_data.hpp"
 #include "extractor/profile_properties.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
@@ -67,19 +69,19 @@ class SharedDataFacade final : public BaseDataFacade
     storage::SharedDataType CURRENT_LAYOUT;
     storage::SharedDataType CURRENT_DATA;
     unsigned CURRENT_TIMESTAMP;
+    unsigned m_generation;
 
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
+    util::ShM<EdgeLength, true>::vector m_edge_lengths;
     std::unique_ptr<storage::SharedMemory> m_layout_memory;
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    std::unique_ptr<storage::MappedDatasetImage> m_image;
     std::string m_timestamp;
     extractor::ProfileProperties *m_profile_properties;
 
     util::ShM<util::Coordinate, true>::vector m_coordinate_list;
-    util::ShM<NodeID, true>::vector m_via_node_list;
-    util::ShM<unsigned, true>::vector m_name_ID_list;
-    util::ShM<extractor::guidance::TurnInstruction, true>::vector m_turn_instruction_list;
-    util::ShM<extractor::TravelMode, true>::vector m_travel_mode_list;
+    util::ShM<extractor::OriginalEdgeData, true>::vector m_original_edge_data;
     util::ShM<char, true>::vector m_names_char_list;
     util::ShM<unsigned, true>::vector m_name_begin_indices;
     util::ShM<unsigned, true>::vector m_geometry_indices;
@@ -99,8 +101,6 @@ class SharedDataFacade final : public BaseDataFacade
 
     // bearing classes by node based node
     util::ShM<BearingClassID, true>::vector m_bearing_class_id_table;
-    // entry class IDs
-    util::ShM<EntryClassID, true>::vector m_entry_class_id_list;
     // the look-up table for entry classes. An entry class lists the possibility of entry for all
     // available turns. Such a class id is stored with every edge.
     util::ShM<util::guidance::EntryClass, true>::vector m_entry_class_table;
@@ -109,6 +109,37 @@ class SharedDataFacade final : public BaseDataFacade
     std::shared_ptr<util::RangeTable<16, true>> m_bearing_ranges_table;
     util::ShM<DiscreteBearing, true>::vector m_bearing_values_table;
 
+    void LoadData()
+    {
+        const auto file_index_ptr = data_layout->GetBlockPtr<char>(
+            shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
+        file_index_path =
+            m_image ? m_image->GetFileIndexPath() : boost::filesystem::path(file_index_ptr);
+        if (!boost::filesystem::exists(file_index_path))
+        {
+            util::SimpleLogger().Write(logDEBUG) << "Leaf file name " << file_index_path.string();
+            throw util::exception("Could not load leaf index file. "
+                                  "Is any data loaded into shared memory?");
+        }
+
+        LoadGraph();
+        LoadChecksum();
+        LoadNodeAndEdgeInformation();
+        LoadGeometries();
+        LoadTimestamp();
+        LoadNames();
+        LoadCoreInformation();
+        LoadProfileProperties();
+        LoadRTree();
+        LoadIntersectionClasses();
+
+        util::SimpleLogger().Write() << "number of geometries: " << m_coordinate_list.size();
+        for (unsigned i = 0; i < m_coordinate_list.size(); ++i)
+        {
+            BOOST_ASSERT(GetCoordinateOfNode(i).IsValid());
+        }
+    }
+
     void LoadChecksum()
     {
         m_check_sum = *data_layout->GetBlockPtr<unsigned>(shared_memory,
@@ -160,6 +191,13 @@ class SharedDataFacade final : public BaseDataFacade
         util::ShM<GraphEdge, true>::vector edge_list(
             graph_edges_ptr, data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_LIST]);
         m_query_graph.reset(new QueryGraph(node_list, edge_list));
+
+        auto edge_lengths_ptr = data_layout->GetBlockPtr<EdgeLength>(
+            shared_memory, storage::SharedDataLayout::GRAPH_EDGE_LENGTHS);
+        util::ShM<EdgeLength, true>::vector edge_lengths(
+            edge_lengths_ptr,
+            data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_LENGTHS]);
+        m_edge_lengths = std::move(edge_lengths);
     }
 
     void LoadNodeAndEdgeInformation()
@@ -170,41 +208,12 @@ class SharedDataFacade final : public BaseDataFacade
             coordinate_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::COORDINATE_LIST]);
 
-        auto travel_mode_list_ptr = data_layout->GetBlockPtr<extractor::TravelMode>(
-            shared_memory, storage::SharedDataLayout::TRAVEL_MODE);
-        util::ShM<extractor::TravelMode, true>::vector travel_mode_list(
-            travel_mode_list_ptr, data_layout->num_entries[storage::SharedDataLayout::TRAVEL_MODE]);
-        m_travel_mode_list = std::move(travel_mode_list);
-
-        auto turn_instruction_list_ptr =
-            data_layout->GetBlockPtr<extractor::guidance::TurnInstruction>(
-                shared_memory, storage::SharedDataLayout::TURN_INSTRUCTION);
-        util::ShM<extractor::guidance::TurnInstruction, true>::vector turn_instruction_list(
-            turn_instruction_list_ptr,
-            data_layout->num_entries[storage::SharedDataLayout::TURN_INSTRUCTION]);
-        m_turn_instruction_list = std::move(turn_instruction_list);
-
-        auto name_id_list_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::NAME_ID_LIST);
-        util::ShM<unsigned, true>::vector name_id_list(
-            name_id_list_ptr, data_layout->num_entries[storage::SharedDataLayout::NAME_ID_LIST]);
-        m_name_ID_list = std::move(name_id_list);
-
-        auto entry_class_id_list_ptr = data_layout->GetBlockPtr<EntryClassID>(
-            shared_memory, storage::SharedDataLayout::ENTRY_CLASSID);
-        typename util::ShM<EntryClassID, true>::vector entry_class_id_list(
-            entry_class_id_list_ptr,
-            data_layout->num_entries[storage::SharedDataLayout::ENTRY_CLASSID]);
-        m_entry_class_id_list = std::move(entry_class_id_list);
-    }
-
-    void LoadViaNodeList()
-    {
-        auto via_node_list_ptr = data_layout->GetBlockPtr<NodeID>(
-            shared_memory, storage::SharedDataLayout::VIA_NODE_LIST);
-        util::ShM<NodeID, true>::vector via_node_list(
-            via_node_list_ptr, data_layout->num_entries[storage::SharedDataLayout::VIA_NODE_LIST]);
-        m_via_node_list = std::move(via_node_list);
+        auto original_edge_data_ptr = data_layout->GetBlockPtr<extractor::OriginalEdgeData>(
+            shared_memory, storage::SharedDataLayout::ORIGINAL_EDGE_DATA);
+        util::ShM<extractor::OriginalEdgeData, true>::vector original_edge_data(
+            original_edge_data_ptr,
+            data_layout->num_entries[storage::SharedDataLayout::ORIGINAL_EDGE_DATA]);
+        m_original_edge_data = std::move(original_edge_data);
     }
 
     void LoadNames()
@@ -341,16 +350,39 @@ class SharedDataFacade final : public BaseDataFacade
         CURRENT_LAYOUT = storage::LAYOUT_NONE;
         CURRENT_DATA = storage::DATA_NONE;
         CURRENT_TIMESTAMP = 0;
+        m_generation = 0;
 
         // load data
         CheckAndReloadFacade();
     }
 
+    // Maps a dataset image written by osrm-datastore --write-image instead of shared memory. The
+    // data never changes, CheckAndReloadFacade must not be called.
+    explicit SharedDataFacade(const boost::filesystem::path &image_path)
+        : data_timestamp_ptr(nullptr), CURRENT_LAYOUT(storage::LAYOUT_NONE),
+          CURRENT_DATA(storage::DATA_NONE), CURRENT_TIMESTAMP(0), m_generation(0)
+    {
+        m_image = util::make_unique<storage::MappedDatasetImage>(image_path);
+        data_layout = m_image->GetLayout();
+        shared_memory = m_image->GetData();
+        LoadData();
+    }
+
+    // True if osrm-datastore published data that is not loaded yet
+    bool HasUpdates() const
+    {
+        return CURRENT_LAYOUT != data_timestamp_ptr->layout ||
+               CURRENT_DATA != data_timestamp_ptr->data ||
+               CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp;
+    }
+
+    // Changes with every reload, so a query can tell whether the data changed while it did not
+    // hold the data lock
+    unsigned GetGeneration() const { return m_generation; }
+
     void CheckAndReloadFacade()
     {
-        if (CURRENT_LAYOUT != data_timestamp_ptr->layout ||
-            CURRENT_DATA != data_timestamp_ptr->data ||
-            CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp)
+        if (HasUpdates())
         {
             // Get exclusive lock
             util::SimpleLogger().Write(logDEBUG) << "Updates available, getting exclusive lock";
@@ -388,35 +420,8 @@ class SharedDataFacade final : public BaseDataFacade
                 m_large_memory.reset(storage::makeSharedMemory(CURRENT_DATA));
                 shared_memory = (char *)(m_large_memory->Ptr());
 
-                const auto file_index_ptr = data_layout->GetBlockPtr<char>(
-                    shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
-                file_index_path = boost::filesystem::path(file_index_ptr);
-                if (!boost::filesystem::exists(file_index_path))
-                {
-                    util::SimpleLogger().Write(logDEBUG) << "Leaf file name "
-                                                         << file_index_path.string();
-                    throw util::exception("Could not load leaf index file. "
-                                          "Is any data loaded into shared memory?");
-                }
-
-                LoadGraph();
-                LoadChecksum();
-                LoadNodeAndEdgeInformation();
-                LoadGeometries();
-                LoadTimestamp();
-                LoadViaNodeList();
-                LoadNames();
-                LoadCoreInformation();
-                LoadProfileProperties();
-                LoadRTree();
-                LoadIntersectionClasses();
-
-                util::SimpleLogger().Write() << "number of geometries: "
-                                             << m_coordinate_list.size();
-                for (unsigned i = 0; i < m_coordinate_list.size(); ++i)
-                {
-                    BOOST_ASSERT(GetCoordinateOfNode(i).IsValid());
-                }
+                LoadData();
+                ++m_generation;
             }
             util::SimpleLogger().Write(logDEBUG) << "Releasing exclusive lock";
         }
@@ -439,6 +444,14 @@ class SharedDataFacade final : public BaseDataFacade
         return m_query_graph->GetEdgeData(e);
     }
 
+    bool HasEdgeLengths() const override final { return !m_edge_lengths.empty(); }
+
+    EdgeLength GetEdgeLength(const EdgeID e) const override final
+    {
+        BOOST_ASSERT(e < m_edge_lengths.size());
+        return m_edge_lengths[e];
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -448,6 +461,13 @@ class SharedDataFacade final : public BaseDataFacade
         return m_query_graph->GetAdjacentEdgeRange(node);
     }
 
+    void PrefetchNode(const NodeID n) const override final { m_query_graph->PrefetchNode(n); }
+
+    void PrefetchAdjacentEdges(const NodeID n) const override final
+    {
+        m_query_graph->PrefetchEdges(n);
+    }
+
     // searches for a specific edge
     EdgeID FindEdge(const NodeID from, const NodeID to) const override final
     {
@@ -504,18 +524,23 @@ class SharedDataFacade final : public BaseDataFacade
 
     virtual unsigned GetGeometryIndexForEdgeID(const unsigned id) const override final
     {
-        return m_via_node_list.at(id);
+        return m_original_edge_data.at(id).via_node;
     }
 
     extractor::guidance::TurnInstruction
     GetTurnInstructionForEdgeID(const unsigned id) const override final
     {
-        return m_turn_instruction_list.at(id);
+        return m_original_edge_data.at(id).turn_instruction;
     }
 
     extractor::TravelMode GetTravelModeForEdgeID(const unsigned id) const override final
     {
-        return m_travel_mode_list.at(id);
+        return m_original_edge_data.at(id).travel_mode;
+    }
+
+    extractor::OriginalEdgeData GetOriginalEdgeData(const unsigned id) const override final
+    {
+        return m_original_edge_data.at(id);
     }
 
     std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate south_west,
@@ -637,7 +662,7 @@ class SharedDataFacade final : public BaseDataFacade
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
     {
-        return m_name_ID_list.at(id);
+        return m_original_edge_data.at(id).name_id;
     }
 
     std::string GetNameForID(const unsigned name_id) const override final
@@ -743,7 +768,7 @@ class SharedDataFacade final : public BaseDataFacade
 
     EntryClassID GetEntryClassID(const EdgeID eid) const override final
     {
-        return m_entry_class_id_list.at(eid);
+        return m_original_edge_data.at(eid).entry_classid;
     }
 
     util::guidance::EntryClass GetEntryClass(const EntryClassID entry_class_id) const override final
@@ -2,6 +2,7 @@
 #define ENGINE_HPP
 
 #include "storage/shared_barriers.hpp"
+#include "engine/response_writer.hpp"
 #include "engine/status.hpp"
 #include "util/json_container.hpp"
 
@@ -18,6 +19,8 @@ namespace json
 {
 struct Object;
 }
+class HubLabels;
+class CellTable;
 }
 
 // Fwd decls
@@ -32,6 +35,7 @@ struct NearestParameters;
 struct TripParameters;
 struct MatchParameters;
 struct TileParameters;
+struct FacilitiesParameters;
 }
 namespace plugins
 {
@@ -41,6 +45,7 @@ class NearestPlugin;
 class TripPlugin;
 class MatchPlugin;
 class TilePlugin;
+class FacilitiesPlugin;
 }
 // End fwd decls
 
@@ -48,6 +53,7 @@ namespace datafacade
 {
 class BaseDataFacade;
 }
+class ClosureOverlay;
 
 class Engine final
 {
@@ -65,10 +71,14 @@ class Engine final
 
     Status Route(const api::RouteParameters &parameters, util::json::Object &result);
     Status Table(const api::TableParameters &parameters, util::json::Object &result);
+    Status Table(const api::TableParameters &parameters,
+                 util::json::Object &result,
+                 const ResponseWriter &writer);
     Status Nearest(const api::NearestParameters &parameters, util::json::Object &result);
     Status Trip(const api::TripParameters &parameters, util::json::Object &result);
     Status Match(const api::MatchParameters &parameters, util::json::Object &result);
     Status Tile(const api::TileParameters &parameters, std::string &result);
+    Status Facilities(const api::FacilitiesParameters &parameters, util::json::Object &result);
 
   private:
     std::unique_ptr<EngineLock> lock;
@@ -79,8 +89,12 @@ class Engine final
     std::unique_ptr<plugins::TripPlugin> trip_plugin;
     std::unique_ptr<plugins::MatchPlugin> match_plugin;
     std::unique_ptr<plugins::TilePlugin> tile_plugin;
+    std::unique_ptr<plugins::FacilitiesPlugin> facilities_plugin;
 
     std::unique_ptr<datafacade::BaseDataFacade> query_data_facade;
+    std::unique_ptr<util::HubLabels> hub_labels;
+    std::unique_ptr<util::CellTable> cell_table;
+    std::unique_ptr<ClosureOverlay> closures;
 };
 }
 }
@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <map>
 #include <string>
 
 namespace osrm
@@ -52,7 +53,12 @@ namespace engine
  *  - Table
  *  - Match
  *
- * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * In addition, shared memory can be used for datasets loaded with osrm-datastore, or a dataset
+ * image written by osrm-datastore --write-image can be mapped directly.
+ *
+ * Optionally hub labels created by osrm-hublabel can be given to answer table queries.
+ * Routes can be made to avoid road closures published by osrm-closures.
+ * Facility sets can be registered by name so the facilities service can reuse their searches.
  *
  * \see OSRM, StorageConfig
  */
@@ -66,6 +72,11 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     bool use_shared_memory = true;
+    boost::filesystem::path image_path;
+    boost::filesystem::path hub_labels_path;
+    boost::filesystem::path cell_table_path;
+    bool use_closures = false;
+    std::map<std::string, boost::filesystem::path> facility_set_paths;
 };
 }
 }
@@ -4,6 +4,7 @@
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
@@ -317,13 +318,38 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
     {
-        std::vector<PhantomNodeWithDistance> distance_and_phantoms(results.size());
+        std::vector<util::Coordinate> segment_sources(results.size());
+        std::vector<util::Coordinate> segment_targets(results.size());
         std::transform(results.begin(),
                        results.end(),
-                       distance_and_phantoms.begin(),
-                       [this, &input_coordinate](const EdgeData &data) {
-                           return MakePhantomNode(input_coordinate, data);
-                       });
+                       segment_sources.begin(),
+                       [this](const EdgeData &data) { return coordinates[data.u]; });
+        std::transform(results.begin(),
+                       results.end(),
+                       segment_targets.begin(),
+                       [this](const EdgeData &data) { return coordinates[data.v]; });
+
+        std::vector<double> distances(results.size());
+        std::vector<util::Coordinate> points_on_segment(results.size());
+        std::vector<double> ratios(results.size());
+        util::coordinate_calculation::perpendicularDistances(segment_sources.data(),
+                                                             segment_targets.data(),
+                                                             results.size(),
+                                                             input_coordinate,
+                                                             distances.data(),
+                                                             points_on_segment.data(),
+                                                             ratios.data());
+
+        std::vector<PhantomNodeWithDistance> distance_and_phantoms;
+        distance_and_phantoms.reserve(results.size());
+        for (const auto index : util::irange<std::size_t>(0UL, results.size()))
+        {
+            distance_and_phantoms.push_back(MakePhantomNode(input_coordinate,
+                                                            results[index],
+                                                            distances[index],
+                                                            points_on_segment[index],
+                                                            ratios[index]));
+        }
         return distance_and_phantoms;
     }
 
@@ -338,7 +364,16 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                                 input_coordinate,
                                                                 point_on_segment,
                                                                 ratio);
+        return MakePhantomNode(
+            input_coordinate, data, current_perpendicular_distance, point_on_segment, ratio);
+    }
 
+    PhantomNodeWithDistance MakePhantomNode(const util::Coordinate input_coordinate,
+                                            const EdgeData &data,
+                                            const double current_perpendicular_distance,
+                                            const util::Coordinate point_on_segment,
+                                            double ratio) const
+    {
         // Find the node-based-edge that this belongs to, and directly
         // calculate the forward_weight, forward_offset, reverse_weight, reverse_offset
 
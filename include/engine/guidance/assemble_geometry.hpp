@@ -10,7 +10,9 @@
 #include "engine/phantom_node.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -41,40 +43,44 @@ LegGeometry assembleGeometry(const DataFacadeT &facade,
 
     // segment 0 first and last
     geometry.segment_offsets.push_back(0);
+    geometry.locations.reserve(leg_data.size() + 2);
     geometry.locations.push_back(source_node.location);
+    for (const auto &path_point : leg_data)
+    {
+        geometry.locations.push_back(facade.GetCoordinateOfNode(path_point.turn_via_node));
+    }
+    geometry.locations.push_back(target_node.location);
+
+    // distances[i] is the length of the segment leading to locations[i + 1]
+    std::vector<double> distances(geometry.locations.size() - 1);
+    util::coordinate_calculation::haversineDistances(geometry.locations.data(),
+                                                     geometry.locations.data() + 1,
+                                                     distances.size(),
+                                                     distances.data());
 
     auto cumulative_distance = 0.;
-    auto current_distance = 0.;
-    auto prev_coordinate = geometry.locations.front();
-    for (const auto &path_point : leg_data)
+    for (const auto index : util::irange<std::size_t>(0UL, leg_data.size()))
     {
-        auto coordinate = facade.GetCoordinateOfNode(path_point.turn_via_node);
-        current_distance =
-            util::coordinate_calculation::haversineDistance(prev_coordinate, coordinate);
-        cumulative_distance += current_distance;
+        const auto &path_point = leg_data[index];
+        cumulative_distance += distances[index];
 
         // all changes to this check have to be matched with assemble_steps
         if (path_point.turn_instruction.type != extractor::guidance::TurnType::NoTurn)
         {
             geometry.segment_distances.push_back(cumulative_distance);
-            geometry.segment_offsets.push_back(geometry.locations.size());
+            geometry.segment_offsets.push_back(index + 1);
             cumulative_distance = 0.;
         }
 
-        prev_coordinate = coordinate;
         geometry.annotations.emplace_back(
-            LegGeometry::Annotation{current_distance, path_point.duration_until_turn / 10.});
-        geometry.locations.push_back(std::move(coordinate));
+            LegGeometry::Annotation{distances[index], path_point.duration_until_turn / 10.});
     }
-    current_distance =
-        util::coordinate_calculation::haversineDistance(prev_coordinate, target_node.location);
-    cumulative_distance += current_distance;
+    cumulative_distance += distances.back();
     // segment leading to the target node
     geometry.segment_distances.push_back(cumulative_distance);
     geometry.annotations.emplace_back(
-        LegGeometry::Annotation{current_distance, target_node.forward_weight / 10.});
-    geometry.segment_offsets.push_back(geometry.locations.size());
-    geometry.locations.push_back(target_node.location);
+        LegGeometry::Annotation{distances.back(), target_node.forward_weight / 10.});
+    geometry.segment_offsets.push_back(geometry.locations.size() - 1);
 
     BOOST_ASSERT(geometry.segment_distances.size() == geometry.segment_offsets.size() - 1);
     BOOST_ASSERT(geometry.locations.size() > geometry.segment_distances.size());
@@ -0,0 +1,89 @@
+#ifndef ENGINE_INCOMING_EDGE_INDEX_HPP
+#define ENGINE_INCOMING_EDGE_INDEX_HPP
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Original edges of the contracted graph are only stored at one of their nodes. For every node
+ * this holds the (node, edge) pairs of the original edges stored at other nodes that point to
+ * it, so a search over the original edges can relax an edge from both of its nodes.
+ *
+ * Building the index reads every edge of the graph once, so it is built when the dataset is
+ * loaded and not while a query runs.
+ */
+class IncomingEdgeIndex
+{
+  public:
+    // (node the edge is stored at, edge)
+    using IncomingEdge = std::pair<NodeID, EdgeID>;
+
+    template <class DataFacadeT>
+    explicit IncomingEdgeIndex(const DataFacadeT &facade)
+        : checksum(facade.GetCheckSum()), offsets(facade.GetNumberOfNodes() + 1, 0)
+    {
+        forEachOriginalEdge(facade, [&](const NodeID, const NodeID target, const EdgeID) {
+            ++offsets[target + 1];
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        edges.resize(offsets.back());
+        std::vector<std::uint32_t> positions(offsets.begin(), offsets.end() - 1);
+        forEachOriginalEdge(facade,
+                            [&](const NodeID node, const NodeID target, const EdgeID edge) {
+                                edges[positions[target]++] = std::make_pair(node, edge);
+                            });
+    }
+
+    // checksum of the dataset the index was built for
+    unsigned GetCheckSum() const { return checksum; }
+
+    std::size_t GetNumberOfNodes() const { return offsets.size() - 1; }
+
+    util::range<std::uint32_t> GetIncomingEdgeRange(const NodeID node) const
+    {
+        return util::irange(offsets[node], offsets[node + 1]);
+    }
+
+    const IncomingEdge &GetIncomingEdge(const std::uint32_t position) const
+    {
+        return edges[position];
+    }
+
+  private:
+    // calls callback(node, target, edge) for the original edges, loops are left out
+    template <class DataFacadeT, class Callback>
+    static void forEachOriginalEdge(const DataFacadeT &facade, Callback &&callback)
+    {
+        for (const auto node : util::irange(0u, facade.GetNumberOfNodes()))
+        {
+            for (const auto edge : facade.GetAdjacentEdgeRange(node))
+            {
+                const auto target = facade.GetTarget(edge);
+                if (!facade.GetEdgeData(edge).shortcut && target != node)
+                {
+                    callback(node, target, edge);
+                }
+            }
+        }
+    }
+
+    unsigned checksum;
+    std::vector<std::uint32_t> offsets;
+    std::vector<IncomingEdge> edges;
+};
+}
+}
+
+#endif // ENGINE_INCOMING_EDGE_INDEX_HPP
@@ -1,14 +1,23 @@
 #ifndef HIDDEN_MARKOV_MODEL
 #define HIDDEN_MARKOV_MODEL
 
+#include "engine/phantom_node.hpp"
 #include "util/integer_range.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/math/constants/constants.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
+#include <algorithm>
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -37,6 +46,32 @@ struct EmissionLogProbability
     {
         return -0.5 * (log_2_pi + (distance / sigma_z) * (distance / sigma_z)) - log_sigma_z;
     }
+
+    // log_probabilities[i] = operator()(distances[i]), two at a time with SSE2. The operations
+    // are the same as in the scalar version, so are the results.
+    void operator()(const double *distances,
+                    const std::size_t number_of_distances,
+                    double *log_probabilities) const
+    {
+        std::size_t index = 0;
+#if defined(__SSE2__)
+        const __m128d sigma = _mm_set1_pd(sigma_z);
+        const __m128d log_sigma = _mm_set1_pd(log_sigma_z);
+        const __m128d log_two_pi = _mm_set1_pd(log_2_pi);
+        const __m128d minus_half = _mm_set1_pd(-0.5);
+        for (; index + 2 <= number_of_distances; index += 2)
+        {
+            const __m128d normed = _mm_div_pd(_mm_loadu_pd(distances + index), sigma);
+            const __m128d sum = _mm_add_pd(log_two_pi, _mm_mul_pd(normed, normed));
+            _mm_storeu_pd(log_probabilities + index,
+                          _mm_sub_pd(_mm_mul_pd(minus_half, sum), log_sigma));
+        }
+#endif
+        for (; index < number_of_distances; ++index)
+        {
+            log_probabilities[index] = (*this)(distances[index]);
+        }
+    }
 };
 
 struct TransitionLogProbability
@@ -48,73 +83,128 @@ struct TransitionLogProbability
     double operator()(const double d_t) const { return -log_beta - d_t / beta; }
 };
 
-template <class CandidateLists> struct HiddenMarkovModel
+// Index of the first maximal value like std::max_element, the values must not be NaN
+inline std::size_t maxElementIndex(const double *values, const std::size_t number_of_values)
 {
-    std::vector<std::vector<double>> viterbi;
-    std::vector<std::vector<std::pair<unsigned, unsigned>>> parents;
-    std::vector<std::vector<float>> path_distances;
-    std::vector<std::vector<bool>> pruned;
-    std::vector<bool> breakage;
-
-    const CandidateLists &candidates_list;
-    const std::vector<std::vector<double>> &emission_log_probabilities;
-
-    HiddenMarkovModel(const CandidateLists &candidates_list,
-                      const std::vector<std::vector<double>> &emission_log_probabilities)
-        : breakage(candidates_list.size()), candidates_list(candidates_list),
-          emission_log_probabilities(emission_log_probabilities)
+    BOOST_ASSERT(number_of_values > 0);
+
+    double max_value = values[0];
+    std::size_t index = 1;
+#if defined(__SSE2__)
+    if (number_of_values >= 2)
     {
-        viterbi.resize(candidates_list.size());
-        parents.resize(candidates_list.size());
-        path_distances.resize(candidates_list.size());
-        pruned.resize(candidates_list.size());
-        breakage.resize(candidates_list.size());
-        for (const auto i : util::irange<std::size_t>(0UL, candidates_list.size()))
+        __m128d max = _mm_loadu_pd(values);
+        for (index = 2; index + 2 <= number_of_values; index += 2)
         {
-            const auto &num_candidates = candidates_list[i].size();
-            // add empty vectors
-            if (num_candidates > 0)
-            {
-                viterbi[i].resize(num_candidates);
-                parents[i].resize(num_candidates);
-                path_distances[i].resize(num_candidates);
-                pruned[i].resize(num_candidates);
-            }
+            max = _mm_max_pd(max, _mm_loadu_pd(values + index));
         }
-
-        Clear(0);
+        max = _mm_max_sd(max, _mm_unpackhi_pd(max, max));
+        max_value = _mm_cvtsd_f64(max);
     }
+#endif
+    for (; index < number_of_values; ++index)
+    {
+        max_value = std::max(max_value, values[index]);
+    }
+    return std::distance(values, std::find(values, values + number_of_values, max_value));
+}
 
-    void Clear(std::size_t initial_timestamp)
+// Viterbi lattice over the candidates of a trace. The states of all trace points are stored
+// back to back in flat arrays, the states of trace point t are offsets[t] to offsets[t + 1].
+// A model is kept per thread and reused by all requests, Reset only ever grows the buffers.
+struct HiddenMarkovModel
+{
+    std::vector<std::size_t> offsets;
+    std::vector<double> distances;
+    std::vector<double> emission_log_probabilities;
+    std::vector<double> viterbi;
+    std::vector<std::pair<unsigned, unsigned>> parents;
+    std::vector<float> path_distances;
+    std::vector<std::uint8_t> pruned;
+    std::vector<std::uint8_t> breakage;
+
+    // Lays out the lattice for the candidates and clears it, the emission log probabilities of
+    // the candidate distances have to be filled in before calling initialize
+    void Reset(const std::vector<std::vector<PhantomNodeWithDistance>> &candidates_list)
     {
-        BOOST_ASSERT(viterbi.size() == parents.size() && parents.size() == path_distances.size() &&
-                     path_distances.size() == pruned.size() && pruned.size() == breakage.size());
+        offsets.resize(candidates_list.size() + 1);
+        offsets[0] = 0;
+        for (const auto t : util::irange<std::size_t>(0UL, candidates_list.size()))
+        {
+            offsets[t + 1] = offsets[t] + candidates_list[t].size();
+        }
 
-        for (const auto t : util::irange(initial_timestamp, viterbi.size()))
+        const auto number_of_states = offsets.back();
+        distances.resize(number_of_states);
+        for (const auto t : util::irange<std::size_t>(0UL, candidates_list.size()))
         {
-            std::fill(viterbi[t].begin(), viterbi[t].end(), IMPOSSIBLE_LOG_PROB);
-            std::fill(parents[t].begin(), parents[t].end(), std::make_pair(0u, 0u));
-            std::fill(path_distances[t].begin(), path_distances[t].end(), 0);
-            std::fill(pruned[t].begin(), pruned[t].end(), true);
+            std::transform(candidates_list[t].begin(),
+                           candidates_list[t].end(),
+                           distances.begin() + offsets[t],
+                           [](const PhantomNodeWithDistance &candidate) {
+                               return candidate.distance;
+                           });
         }
+        emission_log_probabilities.resize(number_of_states);
+        viterbi.resize(number_of_states);
+        parents.resize(number_of_states);
+        path_distances.resize(number_of_states);
+        pruned.resize(number_of_states);
+        breakage.resize(candidates_list.size());
+
+        Clear(0);
+    }
+
+    std::size_t GetNumberOfTimestamps() const { return breakage.size(); }
+
+    std::size_t GetNumberOfStates(const std::size_t timestamp) const
+    {
+        return offsets[timestamp + 1] - offsets[timestamp];
+    }
+
+    // position of a candidate of a trace point in the flat arrays
+    std::size_t GetState(const std::size_t timestamp, const std::size_t candidate) const
+    {
+        BOOST_ASSERT(offsets[timestamp] + candidate <= offsets[timestamp + 1]);
+        return offsets[timestamp] + candidate;
+    }
+
+    // candidate of a trace point with the highest viterbi value
+    std::size_t GetMaxCandidate(const std::size_t timestamp) const
+    {
+        return maxElementIndex(viterbi.data() + offsets[timestamp], GetNumberOfStates(timestamp));
+    }
+
+    void Clear(std::size_t initial_timestamp)
+    {
+        BOOST_ASSERT(offsets.size() == breakage.size() + 1);
+        BOOST_ASSERT(viterbi.size() == offsets.back() && parents.size() == viterbi.size() &&
+                     path_distances.size() == viterbi.size() && pruned.size() == viterbi.size());
+
+        const auto initial_state = offsets[initial_timestamp];
+        std::fill(viterbi.begin() + initial_state, viterbi.end(), IMPOSSIBLE_LOG_PROB);
+        std::fill(parents.begin() + initial_state, parents.end(), std::make_pair(0u, 0u));
+        std::fill(path_distances.begin() + initial_state, path_distances.end(), 0);
+        std::fill(pruned.begin() + initial_state, pruned.end(), true);
         std::fill(breakage.begin() + initial_timestamp, breakage.end(), true);
     }
 
     std::size_t initialize(std::size_t initial_timestamp)
     {
-        auto num_points = candidates_list.size();
+        auto num_points = GetNumberOfTimestamps();
         do
         {
             BOOST_ASSERT(initial_timestamp < num_points);
 
-            for (const auto s : util::irange<std::size_t>(0UL, viterbi[initial_timestamp].size()))
+            for (const auto s :
+                 util::irange<std::size_t>(0UL, GetNumberOfStates(initial_timestamp)))
             {
-                viterbi[initial_timestamp][s] = emission_log_probabilities[initial_timestamp][s];
-                parents[initial_timestamp][s] = std::make_pair(initial_timestamp, s);
-                pruned[initial_timestamp][s] = viterbi[initial_timestamp][s] < MINIMAL_LOG_PROB;
+                const auto state = GetState(initial_timestamp, s);
+                viterbi[state] = emission_log_probabilities[state];
+                parents[state] = std::make_pair(initial_timestamp, s);
+                pruned[state] = viterbi[state] < MINIMAL_LOG_PROB;
 
-                breakage[initial_timestamp] =
-                    breakage[initial_timestamp] && pruned[initial_timestamp][s];
+                breakage[initial_timestamp] = breakage[initial_timestamp] && pruned[state];
             }
 
             ++initial_timestamp;
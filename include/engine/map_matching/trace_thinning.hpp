@@ -0,0 +1,122 @@
+#ifndef ENGINE_MAP_MATCHING_TRACE_THINNING_HPP
+#define ENGINE_MAP_MATCHING_TRACE_THINNING_HPP
+
+#include "engine/phantom_node.hpp"
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace map_matching
+{
+
+// Points closer than this to the last kept point are duplicates or stationary
+const constexpr double THINNING_MIN_DISTANCE = 5.;
+// Points closer than this to the line between their kept neighbours are collinear
+const constexpr double THINNING_COLLINEAR_TOLERANCE = 2.;
+// Kept points are never farther apart than this, which keeps the transition searches short
+const constexpr double THINNING_MAX_DISTANCE = 150.;
+// Kept points are never farther apart in time than this, so no trace splits are introduced
+const constexpr unsigned THINNING_MAX_TIME = 30;
+
+// Candidates farther away than this multiple of the distance of the nearest candidate are
+// dropped, the slack keeps all close candidates of points that lie right on a road
+const constexpr double CANDIDATE_DISTANCE_RATIO = 3.;
+const constexpr double CANDIDATE_DISTANCE_SLACK = 10.;
+
+// Returns the indices of the points of a trace that are worth matching. Near-duplicate and
+// stationary points are dropped, so are collinear points on straight stretches. The first and
+// the last point are always kept.
+inline std::vector<std::size_t> thinTrace(const std::vector<util::Coordinate> &coordinates,
+                                          const std::vector<unsigned> &timestamps)
+{
+    BOOST_ASSERT(timestamps.empty() || timestamps.size() == coordinates.size());
+
+    std::vector<std::size_t> kept_indices;
+    if (coordinates.empty())
+    {
+        return kept_indices;
+    }
+
+    kept_indices.push_back(0);
+    const auto last_index = coordinates.size() - 1;
+    for (std::size_t index = 1; index < last_index; ++index)
+    {
+        const auto anchor = kept_indices.back();
+        const auto next = index + 1;
+
+        if (!timestamps.empty() && timestamps[next] - timestamps[anchor] > THINNING_MAX_TIME)
+        {
+            kept_indices.push_back(index);
+            continue;
+        }
+
+        if (util::coordinate_calculation::haversineDistance(coordinates[anchor],
+                                                            coordinates[index]) <
+            THINNING_MIN_DISTANCE)
+        {
+            continue;
+        }
+
+        // the point can be skipped if it and all points skipped since the anchor are close to
+        // the line from the anchor to the next point
+        bool is_collinear = util::coordinate_calculation::haversineDistance(
+                                coordinates[anchor], coordinates[next]) <= THINNING_MAX_DISTANCE;
+        for (auto skipped = anchor + 1; is_collinear && skipped <= index; ++skipped)
+        {
+            is_collinear = util::coordinate_calculation::perpendicularDistance(
+                               coordinates[anchor], coordinates[next], coordinates[skipped]) <
+                           THINNING_COLLINEAR_TOLERANCE;
+        }
+
+        if (!is_collinear)
+        {
+            kept_indices.push_back(index);
+        }
+    }
+
+    if (last_index > 0)
+    {
+        kept_indices.push_back(last_index);
+    }
+    return kept_indices;
+}
+
+// Expects the candidates to be sorted by distance
+inline void pruneCandidates(std::vector<PhantomNodeWithDistance> &candidates)
+{
+    if (candidates.empty())
+    {
+        return;
+    }
+
+    BOOST_ASSERT(std::is_sorted(
+        candidates.begin(),
+        candidates.end(),
+        [](const PhantomNodeWithDistance &lhs, const PhantomNodeWithDistance &rhs) {
+            return lhs.distance < rhs.distance;
+        }));
+
+    const auto nearest_distance = candidates.front().distance;
+    const auto max_distance = std::max(nearest_distance * CANDIDATE_DISTANCE_RATIO,
+                                       nearest_distance + CANDIDATE_DISTANCE_SLACK);
+    candidates.erase(std::find_if(candidates.begin(),
+                                  candidates.end(),
+                                  [max_distance](const PhantomNodeWithDistance &candidate) {
+                                      return candidate.distance > max_distance;
+                                  }),
+                     candidates.end());
+}
+}
+}
+}
+
+#endif
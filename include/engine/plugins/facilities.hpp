@@ -0,0 +1,66 @@
+#ifndef FACILITIES_HPP
+#define FACILITIES_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/api/facilities_parameters.hpp"
+#include "engine/routing_algorithms/nearest_facilities.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/coordinate.hpp"
+#include "util/json_container.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+class FacilitiesPlugin final : public BasePlugin
+{
+  public:
+    // facility_set_paths maps set names to CSV files with one lon,lat pair per line
+    explicit FacilitiesPlugin(
+        datafacade::BaseDataFacade &facade,
+        const int max_locations_facilities,
+        const std::map<std::string, boost::filesystem::path> &facility_set_paths = {});
+
+    Status HandleRequest(const api::FacilitiesParameters &params, util::json::Object &result);
+
+  private:
+    struct SnappedFacilities
+    {
+        std::vector<PhantomNode> phantoms;
+        routing_algorithms::FacilityBuckets buckets;
+    };
+
+    struct FacilitySet
+    {
+        std::vector<util::Coordinate> coordinates;
+        // snapped on first use, rebuilt if the shared memory dataset changes
+        unsigned checksum = 0;
+        std::shared_ptr<const SnappedFacilities> snapped;
+    };
+
+    std::shared_ptr<const SnappedFacilities> GetFacilitySet(const std::string &name);
+
+    SearchEngineData heaps;
+    routing_algorithms::NearestFacilitiesRouting<datafacade::BaseDataFacade> nearest_facilities;
+    int max_locations_facilities;
+
+    std::mutex facility_sets_mutex;
+    std::map<std::string, FacilitySet> facility_sets;
+};
+}
+}
+}
+
+#endif // FACILITIES_HPP
@@ -4,6 +4,7 @@
 #include "engine/api/base_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/query_trace.hpp"
 #include "engine/status.hpp"
 
 #include "util/coordinate.hpp"
@@ -114,6 +115,7 @@ class BasePlugin
     GetPhantomNodesInRange(const api::BaseParameters &parameters,
                            const std::vector<double> radiuses) const
     {
+        ScopedTraceStage stage("snapping");
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
@@ -154,6 +156,7 @@ class BasePlugin
     std::vector<std::vector<PhantomNodeWithDistance>>
     GetPhantomNodes(const api::BaseParameters &parameters, unsigned number_of_results)
     {
+        ScopedTraceStage stage("snapping");
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
@@ -218,6 +221,7 @@ class BasePlugin
 
     std::vector<PhantomNodePair> GetPhantomNodes(const api::BaseParameters &parameters)
     {
+        ScopedTraceStage stage("snapping");
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
@@ -4,9 +4,16 @@
 #include "engine/plugins/plugin_base.hpp"
 
 #include "engine/api/table_parameters.hpp"
+#include "engine/response_writer.hpp"
+#include "engine/routing_algorithms/hub_label_table.hpp"
+#include "engine/routing_algorithms/approximate_table.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <vector>
 
 namespace osrm
 {
@@ -19,14 +26,49 @@ class TablePlugin final : public BasePlugin
 {
   public:
     explicit TablePlugin(datafacade::BaseDataFacade &facade,
-                         const int max_locations_distance_table);
+                         const int max_locations_distance_table,
+                         const util::HubLabels *hub_labels = nullptr,
+                         const util::CellTable *cell_table = nullptr);
 
     Status HandleRequest(const api::TableParameters &params, util::json::Object &result);
 
+    // Renders the response through the writer, errors are returned in result
+    Status HandleRequest(const api::TableParameters &params,
+                         util::json::Object &result,
+                         const ResponseWriter &writer);
+
   private:
+    // Checks everything that can be checked before snapping the coordinates
+    Status ValidateRequest(const api::TableParameters &params, util::json::Object &result);
+
+    std::vector<EdgeWeight> ComputeTable(const std::vector<PhantomNode> &phantom_nodes,
+                                         const std::vector<std::size_t> &source_indices,
+                                         const std::vector<std::size_t> &target_indices,
+                                         const EdgeWeight max_weight,
+                                         std::vector<EdgeLength> *length_table = nullptr);
+
+    // Fills the wanted entries of result_table, returns false if no table could be computed
+    bool ComputePartialTable(const std::vector<PhantomNode> &phantom_nodes,
+                             const std::vector<std::size_t> &sources,
+                             const std::vector<std::size_t> &targets,
+                             const std::vector<bool> &wanted,
+                             const EdgeWeight max_weight,
+                             std::vector<EdgeWeight> &result_table,
+                             std::vector<EdgeLength> *length_table = nullptr);
+
+    bool ComputeApproximateTable(const std::vector<PhantomNode> &phantom_nodes,
+                                 const api::TableParameters &params,
+                                 const EdgeWeight max_weight,
+                                 std::vector<EdgeWeight> &result_table,
+                                 std::vector<EdgeWeight> &estimated_duration_errors);
+
     SearchEngineData heaps;
     routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade> distance_table;
     int max_locations_distance_table;
+    // optional, tables are computed with CH searches if not available
+    const util::HubLabels *hub_labels;
+    // optional, approximate tables are rejected if not available
+    const util::CellTable *cell_table;
 };
 }
 }
@@ -2,10 +2,12 @@
 #define VIA_ROUTE_HPP
 
 #include "engine/api/route_api.hpp"
+#include "engine/closure_overlay.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/plugins/plugin_base.hpp"
 
 #include "engine/routing_algorithms/alternative_path.hpp"
+#include "engine/routing_algorithms/closure_aware_path.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/search_engine_data.hpp"
@@ -32,10 +34,15 @@ class ViaRoutePlugin final : public BasePlugin
     routing_algorithms::ShortestPathRouting<datafacade::BaseDataFacade> shortest_path;
     routing_algorithms::AlternativeRouting<datafacade::BaseDataFacade> alternative_path;
     routing_algorithms::DirectShortestPathRouting<datafacade::BaseDataFacade> direct_shortest_path;
+    routing_algorithms::ClosureAwarePathRouting<datafacade::BaseDataFacade> closure_aware_path;
     int max_locations_viaroute;
+    // optional, routes ignore closures if not available
+    ClosureOverlay *closures;
 
   public:
-    explicit ViaRoutePlugin(datafacade::BaseDataFacade &facade, int max_locations_viaroute);
+    explicit ViaRoutePlugin(datafacade::BaseDataFacade &facade,
+                            int max_locations_viaroute,
+                            ClosureOverlay *closures = nullptr);
 
     Status HandleRequest(const api::RouteParameters &route_parameters,
                          util::json::Object &json_result);
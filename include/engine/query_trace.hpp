@@ -0,0 +1,139 @@
+#ifndef ENGINE_QUERY_TRACE_HPP
+#define ENGINE_QUERY_TRACE_HPP
+
+#include "util/heap_statistics.hpp"
+#include "util/typedefs.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// What a query spent its time on: the wall time of its stages and the searches run on each heap
+struct QueryTrace
+{
+    struct Stage
+    {
+        std::string name;
+        std::uint32_t count;
+        double milliseconds;
+    };
+
+    struct Heap
+    {
+        std::string name;
+        std::uint64_t number_of_searches;
+        std::uint64_t number_of_settled_nodes;
+        // only filled if the settled nodes are recorded, in the order they were settled
+        std::vector<NodeID> settled_nodes;
+    };
+
+    std::vector<Stage> stages;
+    std::vector<Heap> heaps;
+    // more nodes were settled than could be recorded
+    bool settled_nodes_truncated = false;
+};
+
+// Traces the queries run by the calling thread while it is alive. The heaps are picked up when
+// SearchEngineData hands them out, so searches on other threads, e.g. the parallel legs of long
+// routes, are not part of the trace. The heaps count searches and settled nodes only while they
+// are part of a trace.
+class ScopedQueryTrace
+{
+  public:
+    // Records up to max_settled_nodes settled nodes over all heaps, none if it is 0
+    ScopedQueryTrace(QueryTrace &trace, const std::size_t max_settled_nodes);
+    ~ScopedQueryTrace();
+
+    ScopedQueryTrace(const ScopedQueryTrace &) = delete;
+    ScopedQueryTrace &operator=(const ScopedQueryTrace &) = delete;
+
+    // The innermost trace of the calling thread or nullptr
+    static ScopedQueryTrace *Current();
+
+    template <typename HeapT> void AddHeap(const char *name, HeapT &heap)
+    {
+        for (const auto &traced_heap : traced_heaps)
+        {
+            if (traced_heap->heap == &heap)
+            {
+                return;
+            }
+        }
+
+        std::unique_ptr<TracedHeap> traced_heap(new TracedHeap);
+        traced_heap->heap = &heap;
+        traced_heap->statistics.name = name;
+        if (record_settled_nodes)
+        {
+            traced_heap->counters.settled_nodes = &traced_heap->statistics.settled_nodes;
+            traced_heap->counters.limit = &settled_node_limit;
+        }
+        traced_heap->heap_statistics = &heap.GetStatistics();
+        traced_heap->outer_counters = traced_heap->heap_statistics->Attach(&traced_heap->counters);
+        traced_heaps.push_back(std::move(traced_heap));
+    }
+
+    void AddStage(const char *name, const double milliseconds);
+
+  private:
+    struct TracedHeap
+    {
+        const void *heap;
+        QueryTrace::Heap statistics;
+        util::HeapCounters counters;
+        util::HeapStatistics *heap_statistics;
+        // counters of an outer trace of the heap, they are attached again when this trace ends
+        util::HeapCounters *outer_counters;
+    };
+
+    QueryTrace &trace;
+    const bool record_settled_nodes;
+    util::SettledNodeLimit settled_node_limit;
+    ScopedQueryTrace *const outer_trace;
+    std::vector<std::unique_ptr<TracedHeap>> traced_heaps;
+};
+
+// Adds the wall time of its scope to a stage of the current trace, if there is one. Stages may
+// nest, e.g. unpacking is part of the search.
+class ScopedTraceStage
+{
+  public:
+    explicit ScopedTraceStage(const char *name)
+        : name(name), trace(ScopedQueryTrace::Current())
+    {
+        if (trace != nullptr)
+        {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTraceStage()
+    {
+        if (trace != nullptr)
+        {
+            const std::chrono::duration<double, std::milli> duration =
+                std::chrono::steady_clock::now() - start;
+            trace->AddStage(name, duration.count());
+        }
+    }
+
+    ScopedTraceStage(const ScopedTraceStage &) = delete;
+    ScopedTraceStage &operator=(const ScopedTraceStage &) = delete;
+
+  private:
+    const char *name;
+    ScopedQueryTrace *trace;
+    std::chrono::steady_clock::time_point start;
+};
+}
+}
+
+#endif // ENGINE_QUERY_TRACE_HPP
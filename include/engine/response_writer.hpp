@@ -0,0 +1,17 @@
+#ifndef ENGINE_RESPONSE_WRITER_HPP
+#define ENGINE_RESPONSE_WRITER_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Receives a rendered response piece by piece, the pieces concatenated form the whole response
+using ResponseWriter = std::function<void(const char *data, std::size_t size)>;
+}
+}
+
+#endif // ENGINE_RESPONSE_WRITER_HPP
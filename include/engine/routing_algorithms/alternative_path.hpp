@@ -63,6 +63,12 @@ class AlternativeRouting final
 
     void operator()(const PhantomNodes &phantom_node_pair, InternalRouteResult &raw_route_data)
     {
+        if (super::facade->GetCoreSize() > 0)
+        {
+            CoreAlternativeSearch(phantom_node_pair, raw_route_data);
+            return;
+        }
+
         std::vector<NodeID> alternative_path;
         std::vector<NodeID> via_node_candidate_list;
         std::vector<SearchSpaceEdge> forward_search_space;
@@ -91,39 +97,7 @@ class AlternativeRouting final
                          ? -phantom_node_pair.source_phantom.GetReverseWeightPlusOffset()
                          : 0);
 
-        if (phantom_node_pair.source_phantom.forward_segment_id.enabled)
-        {
-            BOOST_ASSERT(phantom_node_pair.source_phantom.forward_segment_id.id !=
-                         SPECIAL_SEGMENTID);
-            forward_heap1.Insert(phantom_node_pair.source_phantom.forward_segment_id.id,
-                                 -phantom_node_pair.source_phantom.GetForwardWeightPlusOffset(),
-                                 phantom_node_pair.source_phantom.forward_segment_id.id);
-        }
-        if (phantom_node_pair.source_phantom.reverse_segment_id.enabled)
-        {
-            BOOST_ASSERT(phantom_node_pair.source_phantom.reverse_segment_id.id !=
-                         SPECIAL_SEGMENTID);
-            forward_heap1.Insert(phantom_node_pair.source_phantom.reverse_segment_id.id,
-                                 -phantom_node_pair.source_phantom.GetReverseWeightPlusOffset(),
-                                 phantom_node_pair.source_phantom.reverse_segment_id.id);
-        }
-
-        if (phantom_node_pair.target_phantom.forward_segment_id.enabled)
-        {
-            BOOST_ASSERT(phantom_node_pair.target_phantom.forward_segment_id.id !=
-                         SPECIAL_SEGMENTID);
-            reverse_heap1.Insert(phantom_node_pair.target_phantom.forward_segment_id.id,
-                                 phantom_node_pair.target_phantom.GetForwardWeightPlusOffset(),
-                                 phantom_node_pair.target_phantom.forward_segment_id.id);
-        }
-        if (phantom_node_pair.target_phantom.reverse_segment_id.enabled)
-        {
-            BOOST_ASSERT(phantom_node_pair.target_phantom.reverse_segment_id.id !=
-                         SPECIAL_SEGMENTID);
-            reverse_heap1.Insert(phantom_node_pair.target_phantom.reverse_segment_id.id,
-                                 phantom_node_pair.target_phantom.GetReverseWeightPlusOffset(),
-                                 phantom_node_pair.target_phantom.reverse_segment_id.id);
-        }
+        InsertPhantomNodes(phantom_node_pair, forward_heap1, reverse_heap1);
 
         // search from s and t till new_min/(1+epsilon) > length_of_shortest_path
         while (0 < (forward_heap1.Size() + reverse_heap1.Size()))
@@ -323,8 +297,76 @@ class AlternativeRouting final
             }
         }
 
-        // Unpack shortest path and alternative, if they exist
-        if (INVALID_EDGE_WEIGHT != upper_bound_to_shortest_path_distance)
+        std::vector<NodeID> packed_alternate_path;
+        if (SPECIAL_NODEID != selected_via_node)
+        {
+            // retrieve alternate path
+            RetrievePackedAlternatePath(forward_heap1,
+                                        reverse_heap1,
+                                        forward_heap2,
+                                        reverse_heap2,
+                                        s_v_middle,
+                                        v_t_middle,
+                                        packed_alternate_path);
+        }
+
+        UnpackShortestAndAlternatePath(phantom_node_pair,
+                                       packed_shortest_path,
+                                       upper_bound_to_shortest_path_distance,
+                                       packed_alternate_path,
+                                       length_of_via_path,
+                                       raw_route_data);
+    }
+
+  private:
+    void InsertPhantomNodes(const PhantomNodes &phantom_node_pair,
+                            QueryHeap &forward_heap,
+                            QueryHeap &reverse_heap) const
+    {
+        if (phantom_node_pair.source_phantom.forward_segment_id.enabled)
+        {
+            BOOST_ASSERT(phantom_node_pair.source_phantom.forward_segment_id.id !=
+                         SPECIAL_SEGMENTID);
+            forward_heap.Insert(phantom_node_pair.source_phantom.forward_segment_id.id,
+                                -phantom_node_pair.source_phantom.GetForwardWeightPlusOffset(),
+                                phantom_node_pair.source_phantom.forward_segment_id.id);
+        }
+        if (phantom_node_pair.source_phantom.reverse_segment_id.enabled)
+        {
+            BOOST_ASSERT(phantom_node_pair.source_phantom.reverse_segment_id.id !=
+                         SPECIAL_SEGMENTID);
+            forward_heap.Insert(phantom_node_pair.source_phantom.reverse_segment_id.id,
+                                -phantom_node_pair.source_phantom.GetReverseWeightPlusOffset(),
+                                phantom_node_pair.source_phantom.reverse_segment_id.id);
+        }
+
+        if (phantom_node_pair.target_phantom.forward_segment_id.enabled)
+        {
+            BOOST_ASSERT(phantom_node_pair.target_phantom.forward_segment_id.id !=
+                         SPECIAL_SEGMENTID);
+            reverse_heap.Insert(phantom_node_pair.target_phantom.forward_segment_id.id,
+                                phantom_node_pair.target_phantom.GetForwardWeightPlusOffset(),
+                                phantom_node_pair.target_phantom.forward_segment_id.id);
+        }
+        if (phantom_node_pair.target_phantom.reverse_segment_id.enabled)
+        {
+            BOOST_ASSERT(phantom_node_pair.target_phantom.reverse_segment_id.id !=
+                         SPECIAL_SEGMENTID);
+            reverse_heap.Insert(phantom_node_pair.target_phantom.reverse_segment_id.id,
+                                phantom_node_pair.target_phantom.GetReverseWeightPlusOffset(),
+                                phantom_node_pair.target_phantom.reverse_segment_id.id);
+        }
+    }
+
+    // Unpack shortest path and alternative, if they exist
+    void UnpackShortestAndAlternatePath(const PhantomNodes &phantom_node_pair,
+                                        const std::vector<NodeID> &packed_shortest_path,
+                                        const int length_of_shortest_path,
+                                        const std::vector<NodeID> &packed_alternate_path,
+                                        const int length_of_alternate_path,
+                                        InternalRouteResult &raw_route_data) const
+    {
+        if (INVALID_EDGE_WEIGHT != length_of_shortest_path)
         {
             BOOST_ASSERT(!packed_shortest_path.empty());
             raw_route_data.unpacked_path_segments.resize(1);
@@ -343,21 +385,11 @@ class AlternativeRouting final
                 phantom_node_pair,
                 // -- unpacked output
                 raw_route_data.unpacked_path_segments.front());
-            raw_route_data.shortest_path_length = upper_bound_to_shortest_path_distance;
+            raw_route_data.shortest_path_length = length_of_shortest_path;
         }
 
-        if (SPECIAL_NODEID != selected_via_node)
+        if (!packed_alternate_path.empty())
         {
-            std::vector<NodeID> packed_alternate_path;
-            // retrieve alternate path
-            RetrievePackedAlternatePath(forward_heap1,
-                                        reverse_heap1,
-                                        forward_heap2,
-                                        reverse_heap2,
-                                        s_v_middle,
-                                        v_t_middle,
-                                        packed_alternate_path);
-
             raw_route_data.alt_source_traversed_in_reverse.push_back(
                 (packed_alternate_path.front() !=
                  phantom_node_pair.source_phantom.forward_segment_id.id));
@@ -371,7 +403,7 @@ class AlternativeRouting final
                               phantom_node_pair,
                               raw_route_data.unpacked_alternative);
 
-            raw_route_data.alternative_path_length = length_of_via_path;
+            raw_route_data.alternative_path_length = length_of_alternate_path;
         }
         else
         {
@@ -379,7 +411,419 @@ class AlternativeRouting final
         }
     }
 
-  private:
+    // Alternative routes on a dataset with an uncontracted core.
+    //
+    // Below the core we run the regular CH search that collects the core entry points, both
+    // searches continue in the core as plain Dijkstra searches. Distances of the core nodes that
+    // were settled from both sides are exact, these are the via node candidates. The forward
+    // search stops once no core path over its settled nodes can be shorter than
+    // (1+epsilon) times the shortest path, and vice versa.
+    //
+    // Instead of the T-test we check local optimality with plateaus: the part of a via path that
+    // lies in both shortest path trees is a shortest path itself. A plateau of length
+    // epsilon * shortest path around the via node passes the same test as the T-test.
+    // All candidates on one plateau share the same via path, so every plateau is checked once.
+    void CoreAlternativeSearch(const PhantomNodes &phantom_node_pair,
+                               InternalRouteResult &raw_route_data)
+    {
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+
+        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
+        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
+        QueryHeap &forward_core_heap = *(engine_working_data.forward_heap_2);
+        QueryHeap &reverse_core_heap = *(engine_working_data.reverse_heap_2);
+
+        InsertPhantomNodes(phantom_node_pair, forward_heap, reverse_heap);
+        BOOST_ASSERT(forward_heap.Size() > 0);
+        BOOST_ASSERT(reverse_heap.Size() > 0);
+
+        int upper_bound_to_shortest_path_distance = INVALID_EDGE_WEIGHT;
+        NodeID middle_node = SPECIAL_NODEID;
+        const EdgeWeight min_edge_offset = std::min(0, forward_heap.MinKey());
+
+        // CH search below the core, the core nodes are only collected
+        const bool constexpr STALLING_ENABLED = true;
+        const bool constexpr DO_NOT_FORCE_LOOPS = false;
+        while (0 < (forward_heap.Size() + reverse_heap.Size()))
+        {
+            if (!forward_heap.Empty())
+            {
+                if (facade->IsCoreNode(forward_heap.Min()))
+                {
+                    const NodeID node = forward_heap.DeleteMin();
+                    forward_core_heap.Insert(node, forward_heap.GetKey(node), node);
+                }
+                else
+                {
+                    super::RoutingStep(forward_heap,
+                                       reverse_heap,
+                                       middle_node,
+                                       upper_bound_to_shortest_path_distance,
+                                       min_edge_offset,
+                                       true,
+                                       STALLING_ENABLED,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS);
+                }
+            }
+            if (!reverse_heap.Empty())
+            {
+                if (facade->IsCoreNode(reverse_heap.Min()))
+                {
+                    const NodeID node = reverse_heap.DeleteMin();
+                    reverse_core_heap.Insert(node, reverse_heap.GetKey(node), node);
+                }
+                else
+                {
+                    super::RoutingStep(reverse_heap,
+                                       forward_heap,
+                                       middle_node,
+                                       upper_bound_to_shortest_path_distance,
+                                       min_edge_offset,
+                                       false,
+                                       STALLING_ENABLED,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS);
+                }
+            }
+        }
+
+        std::vector<NodeID> via_node_candidate_list;
+        std::vector<SearchSpaceEdge> forward_search_space;
+        std::vector<SearchSpaceEdge> reverse_search_space;
+
+        // every core path starts at an entry point, so its length is at least the smallest
+        // entry distance of the other side
+        const int min_forward_entry_distance =
+            forward_core_heap.Empty() ? 0 : forward_core_heap.MinKey();
+        const int min_reverse_entry_distance =
+            reverse_core_heap.Empty() ? 0 : reverse_core_heap.MinKey();
+        const auto continue_search = [&](const QueryHeap &heap, const int other_entry_distance) {
+            return !heap.Empty() &&
+                   (INVALID_EDGE_WEIGHT == upper_bound_to_shortest_path_distance ||
+                    heap.MinKey() + other_entry_distance <=
+                        upper_bound_to_shortest_path_distance * (1 + VIAPATH_EPSILON));
+        };
+        while (!forward_core_heap.Empty() && !reverse_core_heap.Empty())
+        {
+            const bool continue_forward =
+                continue_search(forward_core_heap, min_reverse_entry_distance);
+            const bool continue_reverse =
+                continue_search(reverse_core_heap, min_forward_entry_distance);
+            if (!continue_forward && !continue_reverse)
+            {
+                break;
+            }
+            if (continue_forward)
+            {
+                CoreRoutingStep<true>(forward_core_heap,
+                                      reverse_core_heap,
+                                      &middle_node,
+                                      &upper_bound_to_shortest_path_distance,
+                                      via_node_candidate_list,
+                                      forward_search_space);
+            }
+            if (continue_reverse)
+            {
+                CoreRoutingStep<false>(forward_core_heap,
+                                       reverse_core_heap,
+                                       &middle_node,
+                                       &upper_bound_to_shortest_path_distance,
+                                       via_node_candidate_list,
+                                       reverse_search_space);
+            }
+        }
+
+        if (INVALID_EDGE_WEIGHT == upper_bound_to_shortest_path_distance)
+        {
+            return;
+        }
+
+        // the middle node of a path below the core was found by the CH search
+        const bool path_is_in_core = facade->IsCoreNode(middle_node);
+        const QueryHeap &middle_forward_heap = path_is_in_core ? forward_core_heap : forward_heap;
+        const QueryHeap &middle_reverse_heap = path_is_in_core ? reverse_core_heap : reverse_heap;
+
+        std::vector<NodeID> packed_shortest_path;
+        const bool path_is_a_loop =
+            upper_bound_to_shortest_path_distance !=
+            middle_forward_heap.GetKey(middle_node) + middle_reverse_heap.GetKey(middle_node);
+        if (path_is_a_loop)
+        {
+            // Self Loop
+            packed_shortest_path.push_back(middle_node);
+            packed_shortest_path.push_back(middle_node);
+        }
+        else if (path_is_in_core)
+        {
+            RetrievePackedCorePath(forward_heap,
+                                   reverse_heap,
+                                   forward_core_heap,
+                                   reverse_core_heap,
+                                   middle_node,
+                                   packed_shortest_path);
+        }
+        else
+        {
+            super::RetrievePackedPathFromHeap(
+                forward_heap, reverse_heap, middle_node, packed_shortest_path);
+        }
+
+        // this set is is used as an indicator if a node is on the shortest path
+        const std::unordered_set<NodeID> nodes_in_path(packed_shortest_path.begin(),
+                                                       packed_shortest_path.end());
+
+        const auto forward_sharing = ApproximateCoreSharing(
+            forward_heap, forward_core_heap, forward_search_space, nodes_in_path);
+        const auto reverse_sharing = ApproximateCoreSharing(
+            reverse_heap, reverse_core_heap, reverse_search_space, nodes_in_path);
+
+        std::sort(begin(via_node_candidate_list), end(via_node_candidate_list));
+        auto unique_end = std::unique(begin(via_node_candidate_list), end(via_node_candidate_list));
+        via_node_candidate_list.resize(unique_end - begin(via_node_candidate_list));
+
+        const int T_threshold =
+            static_cast<int>(VIAPATH_EPSILON * upper_bound_to_shortest_path_distance);
+        std::unordered_set<NodeID> checked_plateaus;
+        std::vector<RankedCandidateNode> ranked_candidates_list;
+        for (const NodeID node : via_node_candidate_list)
+        {
+            if (node == middle_node)
+                continue;
+
+            const int length_of_via_path =
+                forward_core_heap.GetKey(node) + reverse_core_heap.GetKey(node);
+            const bool length_passes =
+                (length_of_via_path <
+                 upper_bound_to_shortest_path_distance * (1 + VIAPATH_EPSILON));
+            if (!length_passes)
+            {
+                continue;
+            }
+
+            // walk the plateau through node to both of its ends
+            NodeID plateau_begin = node;
+            for (NodeID parent = forward_core_heap.GetData(plateau_begin).parent;
+                 parent != plateau_begin && IsSettled(reverse_core_heap, parent) &&
+                 reverse_core_heap.GetData(parent).parent == plateau_begin;
+                 parent = forward_core_heap.GetData(plateau_begin).parent)
+            {
+                plateau_begin = parent;
+            }
+            if (!checked_plateaus.insert(plateau_begin).second)
+            {
+                continue;
+            }
+            NodeID plateau_end = node;
+            for (NodeID parent = reverse_core_heap.GetData(plateau_end).parent;
+                 parent != plateau_end && IsSettled(forward_core_heap, parent) &&
+                 forward_core_heap.GetData(parent).parent == plateau_end;
+                 parent = reverse_core_heap.GetData(plateau_end).parent)
+            {
+                plateau_end = parent;
+            }
+            const int length_of_plateau =
+                forward_core_heap.GetKey(plateau_end) - forward_core_heap.GetKey(plateau_begin);
+
+            const auto fwd_iterator = forward_sharing.find(node);
+            const int fwd_sharing =
+                (fwd_iterator != forward_sharing.end()) ? fwd_iterator->second : 0;
+            const auto rev_iterator = reverse_sharing.find(node);
+            const int rev_sharing =
+                (rev_iterator != reverse_sharing.end()) ? rev_iterator->second : 0;
+            const int sharing_of_via_path = fwd_sharing + rev_sharing;
+
+            const bool sharing_passes =
+                (sharing_of_via_path <= upper_bound_to_shortest_path_distance * VIAPATH_GAMMA);
+            const bool stretch_passes =
+                (length_of_via_path - sharing_of_via_path) <
+                ((1. + VIAPATH_ALPHA) *
+                 (upper_bound_to_shortest_path_distance - sharing_of_via_path));
+            const bool plateau_passes = length_of_plateau >= T_threshold;
+
+            if (sharing_passes && stretch_passes && plateau_passes)
+            {
+                ranked_candidates_list.emplace_back(node, length_of_via_path, sharing_of_via_path);
+            }
+        }
+
+        std::vector<NodeID> packed_alternate_path;
+        int length_of_via_path = INVALID_EDGE_WEIGHT;
+        if (!ranked_candidates_list.empty())
+        {
+            const auto &selected_candidate =
+                *std::min_element(ranked_candidates_list.begin(), ranked_candidates_list.end());
+            RetrievePackedCorePath(forward_heap,
+                                   reverse_heap,
+                                   forward_core_heap,
+                                   reverse_core_heap,
+                                   selected_candidate.node,
+                                   packed_alternate_path);
+            length_of_via_path = selected_candidate.length;
+        }
+
+        UnpackShortestAndAlternatePath(phantom_node_pair,
+                                       packed_shortest_path,
+                                       upper_bound_to_shortest_path_distance,
+                                       packed_alternate_path,
+                                       length_of_via_path,
+                                       raw_route_data);
+    }
+
+    static bool IsSettled(const QueryHeap &heap, const NodeID node)
+    {
+        return heap.WasInserted(node) && heap.WasRemoved(node);
+    }
+
+    // plain Dijkstra step inside the core, without stalling and without pruning, the caller
+    // decides when to stop. Nodes that are settled from both sides are via node candidates.
+    template <bool is_forward_directed>
+    void CoreRoutingStep(QueryHeap &heap1,
+                         QueryHeap &heap2,
+                         NodeID *middle_node,
+                         int *upper_bound_to_shortest_path_distance,
+                         std::vector<NodeID> &search_space_intersection,
+                         std::vector<SearchSpaceEdge> &search_space) const
+    {
+        QueryHeap &forward_heap = (is_forward_directed ? heap1 : heap2);
+        QueryHeap &reverse_heap = (is_forward_directed ? heap2 : heap1);
+
+        const NodeID node = forward_heap.DeleteMin();
+        const int distance = forward_heap.GetKey(node);
+
+        search_space.emplace_back(forward_heap.GetData(node).parent, node);
+
+        if (reverse_heap.WasInserted(node))
+        {
+            if (reverse_heap.WasRemoved(node))
+            {
+                search_space_intersection.emplace_back(node);
+            }
+            const int new_distance = reverse_heap.GetKey(node) + distance;
+            if (new_distance < *upper_bound_to_shortest_path_distance)
+            {
+                if (new_distance >= 0)
+                {
+                    *middle_node = node;
+                    *upper_bound_to_shortest_path_distance = new_distance;
+                }
+                else
+                {
+                    // check whether there is a loop present at the node
+                    const auto loop_distance = super::GetLoopWeight(node);
+                    const int new_distance_with_loop = new_distance + loop_distance;
+                    if (loop_distance != INVALID_EDGE_WEIGHT && new_distance_with_loop >= 0 &&
+                        new_distance_with_loop < *upper_bound_to_shortest_path_distance)
+                    {
+                        *middle_node = node;
+                        *upper_bound_to_shortest_path_distance = new_distance_with_loop;
+                    }
+                }
+            }
+        }
+
+        for (auto edge : facade->GetAdjacentEdgeRange(node))
+        {
+            const EdgeData &data = facade->GetEdgeData(edge);
+            const bool edge_is_forward_directed =
+                (is_forward_directed ? data.forward : data.backward);
+            if (edge_is_forward_directed)
+            {
+                const NodeID to = facade->GetTarget(edge);
+                const int edge_weight = data.distance;
+
+                BOOST_ASSERT(edge_weight > 0);
+                const int to_distance = distance + edge_weight;
+
+                // New Node discovered -> Add to Heap + Node Info Storage
+                if (!forward_heap.WasInserted(to))
+                {
+                    forward_heap.Insert(to, to_distance, node);
+                }
+                // Found a shorter Path -> Update distance
+                else if (to_distance < forward_heap.GetKey(to))
+                {
+                    // new parent
+                    forward_heap.GetData(to).parent = node;
+                    // decreased distance
+                    forward_heap.DecreaseKey(to, to_distance);
+                }
+            }
+        }
+    }
+
+    // packed path <s,..,v,..,t> of a core node v through both core search trees and the CH search
+    // trees below the core
+    void RetrievePackedCorePath(const QueryHeap &forward_heap,
+                                const QueryHeap &reverse_heap,
+                                const QueryHeap &forward_core_heap,
+                                const QueryHeap &reverse_core_heap,
+                                const NodeID via_node,
+                                std::vector<NodeID> &packed_path) const
+    {
+        const auto retrieve_path_to_root = [&](const QueryHeap &heap, const QueryHeap &core_heap) {
+            NodeID entry_point = via_node;
+            while (entry_point != core_heap.GetData(entry_point).parent)
+            {
+                entry_point = core_heap.GetData(entry_point).parent;
+                packed_path.emplace_back(entry_point);
+            }
+            super::RetrievePackedPathFromSingleHeap(heap, entry_point, packed_path);
+        };
+
+        retrieve_path_to_root(forward_heap, forward_core_heap);
+        std::reverse(packed_path.begin(), packed_path.end());
+        packed_path.emplace_back(via_node);
+        retrieve_path_to_root(reverse_heap, reverse_core_heap);
+    }
+
+    // sweep over the core search space in settle order, every node shares as much with the
+    // shortest path as its parent unless it is on the shortest path itself. For the entry points
+    // we follow the CH search tree below the core until it joins the shortest path.
+    std::unordered_map<NodeID, int>
+    ApproximateCoreSharing(const QueryHeap &heap,
+                           const QueryHeap &core_heap,
+                           const std::vector<SearchSpaceEdge> &search_space,
+                           const std::unordered_set<NodeID> &nodes_in_path) const
+    {
+        std::unordered_map<NodeID, int> approximated_sharing;
+        for (const SearchSpaceEdge &current_edge : search_space)
+        {
+            const NodeID u = current_edge.first;
+            const NodeID v = current_edge.second;
+
+            if (nodes_in_path.find(v) != nodes_in_path.end())
+            {
+                approximated_sharing.emplace(v, core_heap.GetKey(v));
+            }
+            else if (u != v)
+            {
+                const auto sharing_of_u_iterator = approximated_sharing.find(u);
+                if (sharing_of_u_iterator != approximated_sharing.end())
+                {
+                    approximated_sharing.emplace(v, sharing_of_u_iterator->second);
+                }
+            }
+            else
+            {
+                NodeID current_node = v;
+                while (nodes_in_path.find(current_node) == nodes_in_path.end() &&
+                       current_node != heap.GetData(current_node).parent)
+                {
+                    current_node = heap.GetData(current_node).parent;
+                }
+                if (nodes_in_path.find(current_node) != nodes_in_path.end())
+                {
+                    approximated_sharing.emplace(v, heap.GetKey(current_node));
+                }
+            }
+        }
+        return approximated_sharing;
+    }
+
     // unpack alternate <s,..,v,..,t> by exploring search spaces from v
     void RetrievePackedAlternatePath(const QueryHeap &forward_heap1,
                                      const QueryHeap &reverse_heap1,
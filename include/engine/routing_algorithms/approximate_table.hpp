@@ -0,0 +1,121 @@
+#ifndef APPROXIMATE_TABLE_HPP
+#define APPROXIMATE_TABLE_HPP
+
+#include "engine/phantom_node.hpp"
+#include "util/cell_table.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+struct ApproximateTableResult
+{
+    std::vector<EdgeWeight> durations;
+    // absolute error of each duration, estimated from sampled points of the cells
+    std::vector<EdgeWeight> errors;
+    // entries that can not be approximated and have to be computed exactly
+    std::vector<bool> needs_exact;
+};
+
+/// Approximates duration tables with the precomputed durations between the cells containing
+/// source and target. The error of an approximation is estimated as the sum of the radii of both
+/// cells. Pairs whose estimated error exceeds MAX_RELATIVE_ERROR of the duration are not
+/// approximated, nor are pairs in the same or in adjacent cells, so the exact neighbourhood of a
+/// cell grows with its radius. Pairs without a duration between their cells are searched as well.
+class ApproximateTable final
+{
+  public:
+    static constexpr double MAX_RELATIVE_ERROR = 0.05;
+
+    explicit ApproximateTable(const util::CellTable &cell_table) : cell_table(cell_table) {}
+
+    ApproximateTableResult operator()(const std::vector<PhantomNode> &phantom_nodes,
+                                      const std::vector<std::size_t> &source_indices,
+                                      const std::vector<std::size_t> &target_indices) const
+    {
+        const auto grid_cells_of = [&](const std::vector<std::size_t> &indices) {
+            std::vector<std::uint32_t> grid_cells;
+            if (indices.empty())
+            {
+                for (const auto &phantom : phantom_nodes)
+                {
+                    grid_cells.push_back(cell_table.GetGridCell(phantom.location));
+                }
+            }
+            else
+            {
+                for (const auto index : indices)
+                {
+                    grid_cells.push_back(cell_table.GetGridCell(phantom_nodes[index].location));
+                }
+            }
+            return grid_cells;
+        };
+        const auto source_cells = grid_cells_of(source_indices);
+        const auto target_cells = grid_cells_of(target_indices);
+
+        const auto number_of_entries = source_cells.size() * target_cells.size();
+        ApproximateTableResult result;
+        result.durations.resize(number_of_entries, INVALID_EDGE_WEIGHT);
+        result.errors.resize(number_of_entries, INVALID_EDGE_WEIGHT);
+        result.needs_exact.resize(number_of_entries, false);
+
+        for (const auto row : util::irange<std::size_t>(0UL, source_cells.size()))
+        {
+            const auto source_grid_cell = source_cells[row];
+            const auto source_cell = cell_table.GetCell(source_grid_cell);
+            for (const auto column : util::irange<std::size_t>(0UL, target_cells.size()))
+            {
+                const auto index = row * target_cells.size() + column;
+                const auto target_grid_cell = target_cells[column];
+                const auto target_cell = cell_table.GetCell(target_grid_cell);
+
+                if (source_cell == util::INVALID_CELL_ID || target_cell == util::INVALID_CELL_ID ||
+                    cell_table.AreNeighbours(source_grid_cell, target_grid_cell))
+                {
+                    result.needs_exact[index] = true;
+                    continue;
+                }
+
+                const auto source_radius = cell_table.GetRadius(source_cell);
+                const auto target_radius = cell_table.GetRadius(target_cell);
+                const auto duration = cell_table.GetDuration(source_cell, target_cell);
+                // the representatives might not be connected while the phantoms are
+                if (source_radius == INVALID_EDGE_WEIGHT || target_radius == INVALID_EDGE_WEIGHT ||
+                    duration == INVALID_EDGE_WEIGHT)
+                {
+                    result.needs_exact[index] = true;
+                    continue;
+                }
+
+                const auto error = source_radius + target_radius;
+                if (error > MAX_RELATIVE_ERROR * duration)
+                {
+                    result.needs_exact[index] = true;
+                    continue;
+                }
+                result.durations[index] = duration;
+                result.errors[index] = error;
+            }
+        }
+
+        return result;
+    }
+
+  private:
+    const util::CellTable &cell_table;
+};
+}
+}
+}
+
+#endif // APPROXIMATE_TABLE_HPP
@@ -0,0 +1,535 @@
+#ifndef CLOSURE_AWARE_PATH_HPP
+#define CLOSURE_AWARE_PATH_HPP
+
+#include "engine/closure_overlay.hpp"
+#include "engine/incoming_edge_index.hpp"
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+/// Shortest path routing that avoids closed edge-based nodes.
+///
+/// Every leg is first answered by the regular CH search. Only if the unpacked leg runs over a
+/// closure, the leg is repaired by a second search that does not settle closed nodes and skips
+/// all shortcuts that contain one. Whether a shortcut contains a closure is found by unpacking
+/// it lazily, the result is cached for the duration of the query.
+/// The hierarchy was built with the closed nodes in place, so a repaired leg always avoids the
+/// closures but is not guaranteed to be the shortest such leg.
+/// Skipping shortcuts can disconnect the hierarchy, e.g. if the only detour runs below a
+/// shortcut over a closure. If the repair search finds no leg, or the repaired leg still unpacks
+/// to a closure, the leg is searched by a bidirectional Dijkstra over the original edges.
+/// The Dijkstra only looks for detours up to twice the weight of the leg without closures plus
+/// ten minutes and settles at most a million nodes, so it stays in the region around the leg.
+/// If it finds no detour within these bounds, there is no route.
+/// Like DirectShortestPathRouting, legs are computed independently of each other.
+template <class DataFacadeT>
+class ClosureAwarePathRouting final
+    : public BasicRoutingInterface<DataFacadeT, ClosureAwarePathRouting<DataFacadeT>>
+{
+    using super = BasicRoutingInterface<DataFacadeT, ClosureAwarePathRouting<DataFacadeT>>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    using EdgeData = typename DataFacadeT::EdgeData;
+    // (from, to) of a shortcut in path direction -> contains a closed node
+    using ClosureCache = std::unordered_map<std::uint64_t, bool>;
+
+    // bounds of the fallback search, see the class comment
+    static constexpr double MAX_DETOUR_FACTOR = 2.;
+    static constexpr EdgeWeight MAX_DETOUR_ADDITION = 6000;
+    static constexpr std::size_t MAX_FALLBACK_SETTLED_NODES = 1000000;
+
+    SearchEngineData &engine_working_data;
+
+  public:
+    ClosureAwarePathRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~ClosureAwarePathRouting() {}
+
+    // The incoming edges have to be indexed for the dataset of the facade
+    void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
+                    const ClosedNodes &closed_nodes,
+                    const IncomingEdgeIndex &incoming_edges,
+                    InternalRouteResult &raw_route_data) const
+    {
+        BOOST_ASSERT(incoming_edges.GetCheckSum() == super::facade->GetCheckSum());
+        BOOST_ASSERT(incoming_edges.GetNumberOfNodes() == super::facade->GetNumberOfNodes());
+
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
+        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
+
+        raw_route_data.shortest_path_length = 0;
+        raw_route_data.unpacked_path_segments.resize(phantom_nodes_vector.size());
+
+        for (const auto leg : util::irange<std::size_t>(0UL, phantom_nodes_vector.size()))
+        {
+            const auto &phantom_node_pair = phantom_nodes_vector[leg];
+
+            int distance = INVALID_EDGE_WEIGHT;
+            std::vector<NodeID> packed_leg;
+
+            InitializeHeaps(forward_heap, reverse_heap, phantom_node_pair);
+            SearchLeg(forward_heap, reverse_heap, distance, packed_leg);
+
+            if (INVALID_EDGE_WEIGHT != distance && UsesClosure(packed_leg, closed_nodes))
+            {
+                const auto max_weight = static_cast<EdgeWeight>(
+                    std::min<double>(distance * MAX_DETOUR_FACTOR + MAX_DETOUR_ADDITION,
+                                     INVALID_EDGE_WEIGHT));
+                packed_leg.clear();
+                InitializeHeaps(forward_heap, reverse_heap, phantom_node_pair);
+                RepairSearch(forward_heap, reverse_heap, closed_nodes, distance, packed_leg);
+
+                // unpacking picks the shortest of parallel edges, which might be another
+                // shortcut than the one the repair search relaxed
+                if (INVALID_EDGE_WEIGHT == distance || UsesClosure(packed_leg, closed_nodes))
+                {
+                    packed_leg.clear();
+                    InitializeHeaps(forward_heap, reverse_heap, phantom_node_pair);
+                    FallbackSearch(forward_heap,
+                                   reverse_heap,
+                                   closed_nodes,
+                                   incoming_edges,
+                                   max_weight,
+                                   distance,
+                                   packed_leg);
+                }
+            }
+
+            if (INVALID_EDGE_WEIGHT == distance)
+            {
+                raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
+                raw_route_data.alternative_path_length = INVALID_EDGE_WEIGHT;
+                return;
+            }
+
+            BOOST_ASSERT_MSG(!packed_leg.empty(), "packed path empty");
+            raw_route_data.shortest_path_length += distance;
+            raw_route_data.source_traversed_in_reverse.push_back(
+                (packed_leg.front() != phantom_node_pair.source_phantom.forward_segment_id.id));
+            raw_route_data.target_traversed_in_reverse.push_back(
+                (packed_leg.back() != phantom_node_pair.target_phantom.forward_segment_id.id));
+
+            super::UnpackPath(packed_leg.begin(),
+                              packed_leg.end(),
+                              phantom_node_pair,
+                              raw_route_data.unpacked_path_segments[leg]);
+        }
+    }
+
+  private:
+    static bool IsClosed(const ClosedNodes &closed_nodes, const NodeID node)
+    {
+        return std::binary_search(closed_nodes.begin(), closed_nodes.end(), node);
+    }
+
+    void InitializeHeaps(QueryHeap &forward_heap,
+                         QueryHeap &reverse_heap,
+                         const PhantomNodes &phantom_node_pair) const
+    {
+        const auto &source_phantom = phantom_node_pair.source_phantom;
+        const auto &target_phantom = phantom_node_pair.target_phantom;
+        BOOST_ASSERT(source_phantom.IsValid());
+        BOOST_ASSERT(target_phantom.IsValid());
+
+        forward_heap.Clear();
+        reverse_heap.Clear();
+
+        if (source_phantom.forward_segment_id.enabled)
+        {
+            forward_heap.Insert(source_phantom.forward_segment_id.id,
+                                -source_phantom.GetForwardWeightPlusOffset(),
+                                source_phantom.forward_segment_id.id);
+        }
+        if (source_phantom.reverse_segment_id.enabled)
+        {
+            forward_heap.Insert(source_phantom.reverse_segment_id.id,
+                                -source_phantom.GetReverseWeightPlusOffset(),
+                                source_phantom.reverse_segment_id.id);
+        }
+
+        if (target_phantom.forward_segment_id.enabled)
+        {
+            reverse_heap.Insert(target_phantom.forward_segment_id.id,
+                                target_phantom.GetForwardWeightPlusOffset(),
+                                target_phantom.forward_segment_id.id);
+        }
+        if (target_phantom.reverse_segment_id.enabled)
+        {
+            reverse_heap.Insert(target_phantom.reverse_segment_id.id,
+                                target_phantom.GetReverseWeightPlusOffset(),
+                                target_phantom.reverse_segment_id.id);
+        }
+    }
+
+    void SearchLeg(QueryHeap &forward_heap,
+                   QueryHeap &reverse_heap,
+                   int &distance,
+                   std::vector<NodeID> &packed_leg) const
+    {
+        const bool constexpr DO_NOT_FORCE_LOOPS =
+            false; // prevents forcing of loops, since offsets are set correctly
+
+        if (super::facade->GetCoreSize() > 0)
+        {
+            engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                super::facade->GetNumberOfNodes());
+            QueryHeap &forward_core_heap = *(engine_working_data.forward_heap_2);
+            QueryHeap &reverse_core_heap = *(engine_working_data.reverse_heap_2);
+            forward_core_heap.Clear();
+            reverse_core_heap.Clear();
+
+            super::SearchWithCore(forward_heap,
+                                  reverse_heap,
+                                  forward_core_heap,
+                                  reverse_core_heap,
+                                  distance,
+                                  packed_leg,
+                                  DO_NOT_FORCE_LOOPS,
+                                  DO_NOT_FORCE_LOOPS);
+        }
+        else
+        {
+            super::Search(forward_heap,
+                          reverse_heap,
+                          distance,
+                          packed_leg,
+                          DO_NOT_FORCE_LOOPS,
+                          DO_NOT_FORCE_LOOPS);
+        }
+    }
+
+    // The segments the phantom nodes are snapped to are always usable
+    bool UsesClosure(const std::vector<NodeID> &packed_leg, const ClosedNodes &closed_nodes) const
+    {
+        std::vector<NodeID> unpacked_leg;
+        for (const auto index : util::irange<std::size_t>(1UL, packed_leg.size()))
+        {
+            super::UnpackEdge(packed_leg[index - 1], packed_leg[index], unpacked_leg);
+        }
+
+        return std::any_of(unpacked_leg.begin(), unpacked_leg.end(), [&](const NodeID node) {
+            return node != packed_leg.front() && node != packed_leg.back() &&
+                   IsClosed(closed_nodes, node);
+        });
+    }
+
+    // Checks the edge from -> to in path direction, resolving it the same way UnpackEdge does
+    bool ContainsClosedNode(const NodeID from,
+                            const NodeID to,
+                            const ClosedNodes &closed_nodes,
+                            ClosureCache &cache) const
+    {
+        EdgeID smaller_edge_id = SPECIAL_EDGEID;
+        EdgeWeight edge_weight = std::numeric_limits<EdgeWeight>::max();
+        for (const auto edge_id : super::facade->GetAdjacentEdgeRange(from))
+        {
+            const auto &data = super::facade->GetEdgeData(edge_id);
+            if (super::facade->GetTarget(edge_id) == to && data.distance < edge_weight &&
+                data.forward)
+            {
+                smaller_edge_id = edge_id;
+                edge_weight = data.distance;
+            }
+        }
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            for (const auto edge_id : super::facade->GetAdjacentEdgeRange(to))
+            {
+                const auto &data = super::facade->GetEdgeData(edge_id);
+                if (super::facade->GetTarget(edge_id) == from && data.distance < edge_weight &&
+                    data.backward)
+                {
+                    smaller_edge_id = edge_id;
+                    edge_weight = data.distance;
+                }
+            }
+        }
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            BOOST_ASSERT_MSG(false, "shortcut can not be unpacked");
+            return true;
+        }
+
+        const EdgeData &data = super::facade->GetEdgeData(smaller_edge_id);
+        if (!data.shortcut)
+        {
+            // the end points are checked by the caller
+            return false;
+        }
+
+        const auto key = (static_cast<std::uint64_t>(from) << 32) | to;
+        const auto cached = cache.find(key);
+        if (cached != cache.end())
+        {
+            return cached->second;
+        }
+
+        const NodeID middle_node_id = data.id;
+        const bool contains_closure =
+            IsClosed(closed_nodes, middle_node_id) ||
+            ContainsClosedNode(from, middle_node_id, closed_nodes, cache) ||
+            ContainsClosedNode(middle_node_id, to, closed_nodes, cache);
+        cache.emplace(key, contains_closure);
+        return contains_closure;
+    }
+
+    // Same as BasicRoutingInterface::RoutingStep without stalling and forced loops, but closed
+    // nodes and shortcuts over them are never relaxed
+    void RepairStep(QueryHeap &forward_heap,
+                    QueryHeap &reverse_heap,
+                    const ClosedNodes &closed_nodes,
+                    ClosureCache &cache,
+                    NodeID &middle_node_id,
+                    std::int32_t &upper_bound,
+                    const std::int32_t min_edge_offset,
+                    const bool forward_direction) const
+    {
+        const NodeID node = forward_heap.DeleteMin();
+        const std::int32_t distance = forward_heap.GetKey(node);
+
+        if (reverse_heap.WasInserted(node))
+        {
+            const std::int32_t new_distance = reverse_heap.GetKey(node) + distance;
+            if (new_distance >= 0 && new_distance < upper_bound)
+            {
+                middle_node_id = node;
+                upper_bound = new_distance;
+            }
+        }
+
+        BOOST_ASSERT(min_edge_offset <= 0);
+        if (distance + min_edge_offset > upper_bound)
+        {
+            forward_heap.DeleteAll();
+            return;
+        }
+
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const EdgeData &data = super::facade->GetEdgeData(edge);
+            if (!(forward_direction ? data.forward : data.backward))
+            {
+                continue;
+            }
+
+            const NodeID to = super::facade->GetTarget(edge);
+            if (IsClosed(closed_nodes, to))
+            {
+                continue;
+            }
+            if (data.shortcut)
+            {
+                const NodeID path_from = forward_direction ? node : to;
+                const NodeID path_to = forward_direction ? to : node;
+                if (IsClosed(closed_nodes, data.id) ||
+                    ContainsClosedNode(path_from, data.id, closed_nodes, cache) ||
+                    ContainsClosedNode(data.id, path_to, closed_nodes, cache))
+                {
+                    continue;
+                }
+            }
+
+            const int to_distance = distance + data.distance;
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_distance, node);
+            }
+            else if (to_distance < forward_heap.GetKey(to))
+            {
+                forward_heap.GetData(to).parent = node;
+                forward_heap.DecreaseKey(to, to_distance);
+            }
+        }
+    }
+
+    void RepairSearch(QueryHeap &forward_heap,
+                      QueryHeap &reverse_heap,
+                      const ClosedNodes &closed_nodes,
+                      int &distance,
+                      std::vector<NodeID> &packed_leg) const
+    {
+        ClosureCache cache;
+        NodeID middle = SPECIAL_NODEID;
+        distance = INVALID_EDGE_WEIGHT;
+
+        const auto min_edge_offset = std::min(0, forward_heap.MinKey());
+        while (0 < (forward_heap.Size() + reverse_heap.Size()))
+        {
+            if (!forward_heap.Empty())
+            {
+                RepairStep(forward_heap,
+                           reverse_heap,
+                           closed_nodes,
+                           cache,
+                           middle,
+                           distance,
+                           min_edge_offset,
+                           true);
+            }
+            if (!reverse_heap.Empty())
+            {
+                RepairStep(reverse_heap,
+                           forward_heap,
+                           closed_nodes,
+                           cache,
+                           middle,
+                           distance,
+                           min_edge_offset,
+                           false);
+            }
+        }
+
+        if (SPECIAL_NODEID == middle)
+        {
+            distance = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        super::RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_leg);
+    }
+
+    // Dijkstra step over original edges in both storage directions. Meeting points are checked
+    // on relaxation, so the search can stop once the keys of both heaps add up to the best leg.
+    void FallbackStep(QueryHeap &forward_heap,
+                      QueryHeap &reverse_heap,
+                      const ClosedNodes &closed_nodes,
+                      const IncomingEdgeIndex &incoming_edges,
+                      NodeID &middle_node_id,
+                      std::int32_t &upper_bound,
+                      const bool forward_direction) const
+    {
+        const NodeID node = forward_heap.DeleteMin();
+        const std::int32_t distance = forward_heap.GetKey(node);
+
+        const auto update_middle = [&](const NodeID to, const std::int32_t to_distance) {
+            if (reverse_heap.WasInserted(to))
+            {
+                const std::int32_t new_distance = reverse_heap.GetKey(to) + to_distance;
+                if (new_distance >= 0 && new_distance < upper_bound)
+                {
+                    middle_node_id = to;
+                    upper_bound = new_distance;
+                }
+            }
+        };
+        const auto relax = [&](const NodeID to, const EdgeWeight weight) {
+            if (IsClosed(closed_nodes, to))
+            {
+                return;
+            }
+            const int to_distance = distance + weight;
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_distance, node);
+            }
+            else if (to_distance < forward_heap.GetKey(to))
+            {
+                forward_heap.GetData(to).parent = node;
+                forward_heap.DecreaseKey(to, to_distance);
+            }
+            else
+            {
+                return;
+            }
+            update_middle(to, to_distance);
+        };
+
+        // source and target phantom can share a node
+        update_middle(node, distance);
+
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const EdgeData &data = super::facade->GetEdgeData(edge);
+            if (!data.shortcut && (forward_direction ? data.forward : data.backward))
+            {
+                relax(super::facade->GetTarget(edge), data.distance);
+            }
+        }
+        for (const auto position : incoming_edges.GetIncomingEdgeRange(node))
+        {
+            const auto &incoming = incoming_edges.GetIncomingEdge(position);
+            const EdgeData &data = super::facade->GetEdgeData(incoming.second);
+            // the edge is stored at the other node, so its directions are swapped
+            if (forward_direction ? data.backward : data.forward)
+            {
+                relax(incoming.first, data.distance);
+            }
+        }
+    }
+
+    // Only finds legs lighter than max_weight
+    void FallbackSearch(QueryHeap &forward_heap,
+                        QueryHeap &reverse_heap,
+                        const ClosedNodes &closed_nodes,
+                        const IncomingEdgeIndex &incoming_edges,
+                        const EdgeWeight max_weight,
+                        int &distance,
+                        std::vector<NodeID> &packed_leg) const
+    {
+        NodeID middle = SPECIAL_NODEID;
+        distance = max_weight;
+
+        std::size_t number_of_settled_nodes = 0;
+        while (!forward_heap.Empty() && !reverse_heap.Empty() &&
+               forward_heap.MinKey() + reverse_heap.MinKey() < distance &&
+               number_of_settled_nodes < MAX_FALLBACK_SETTLED_NODES)
+        {
+            if (forward_heap.MinKey() <= reverse_heap.MinKey())
+            {
+                FallbackStep(forward_heap,
+                             reverse_heap,
+                             closed_nodes,
+                             incoming_edges,
+                             middle,
+                             distance,
+                             true);
+            }
+            else
+            {
+                FallbackStep(reverse_heap,
+                             forward_heap,
+                             closed_nodes,
+                             incoming_edges,
+                             middle,
+                             distance,
+                             false);
+            }
+            ++number_of_settled_nodes;
+        }
+
+        if (SPECIAL_NODEID == middle)
+        {
+            distance = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        super::RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_leg);
+    }
+};
+}
+}
+}
+
+#endif // CLOSURE_AWARE_PATH_HPP
@@ -0,0 +1,130 @@
+#ifndef HUB_LABEL_TABLE_HPP
+#define HUB_LABEL_TABLE_HPP
+
+#include "engine/phantom_node.hpp"
+#include "util/hub_labels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+/// Computes duration tables by intersecting hub labels instead of running CH searches.
+/// Produces the same table as ManyToManyRouting, except for the rare case of a source and a
+/// target on the same segment with the target behind the source: answering that needs the
+/// loop around the segment and the caller has to fall back to the CH search.
+class HubLabelTable final
+{
+    struct Seed
+    {
+        util::HubLabel label;
+        EdgeWeight offset;
+    };
+
+  public:
+    explicit HubLabelTable(const util::HubLabels &hub_labels) : hub_labels(hub_labels) {}
+
+    // Returns an empty table if at least one entry could not be answered from the labels
+    std::vector<EdgeWeight> operator()(const std::vector<PhantomNode> &phantom_nodes,
+                                       const std::vector<std::size_t> &source_indices,
+                                       const std::vector<std::size_t> &target_indices) const
+    {
+        std::vector<std::vector<Seed>> sources;
+        std::vector<std::vector<Seed>> targets;
+
+        const auto add_seeds = [&](const PhantomNode &phantom, const bool is_source) {
+            std::vector<Seed> seeds;
+            // offsets as inserted into the heaps by ManyToManyRouting
+            if (phantom.forward_segment_id.enabled)
+            {
+                const auto node = phantom.forward_segment_id.id;
+                const auto offset = phantom.GetForwardWeightPlusOffset();
+                seeds.push_back(is_source ? Seed{hub_labels.GetForwardLabel(node), -offset}
+                                          : Seed{hub_labels.GetBackwardLabel(node), offset});
+            }
+            if (phantom.reverse_segment_id.enabled)
+            {
+                const auto node = phantom.reverse_segment_id.id;
+                const auto offset = phantom.GetReverseWeightPlusOffset();
+                seeds.push_back(is_source ? Seed{hub_labels.GetForwardLabel(node), -offset}
+                                          : Seed{hub_labels.GetBackwardLabel(node), offset});
+            }
+            return seeds;
+        };
+
+        if (source_indices.empty())
+        {
+            for (const auto &phantom : phantom_nodes)
+                sources.push_back(add_seeds(phantom, true));
+        }
+        else
+        {
+            for (const auto index : source_indices)
+                sources.push_back(add_seeds(phantom_nodes[index], true));
+        }
+
+        if (target_indices.empty())
+        {
+            for (const auto &phantom : phantom_nodes)
+                targets.push_back(add_seeds(phantom, false));
+        }
+        else
+        {
+            for (const auto index : target_indices)
+                targets.push_back(add_seeds(phantom_nodes[index], false));
+        }
+
+        std::vector<EdgeWeight> result_table(sources.size() * targets.size(),
+                                             std::numeric_limits<EdgeWeight>::max());
+
+        for (std::size_t row = 0; row < sources.size(); ++row)
+        {
+            for (std::size_t column = 0; column < targets.size(); ++column)
+            {
+                auto &entry = result_table[row * targets.size() + column];
+                for (const auto &source : sources[row])
+                {
+                    for (const auto &target : targets[column])
+                    {
+                        const auto weight = util::intersectHubLabels(source.label, target.label);
+                        if (weight == INVALID_EDGE_WEIGHT)
+                        {
+                            continue;
+                        }
+
+                        const std::int64_t total =
+                            static_cast<std::int64_t>(weight) + source.offset + target.offset;
+                        if (total < 0)
+                        {
+                            return {};
+                        }
+                        if (total < entry)
+                        {
+                            entry = static_cast<EdgeWeight>(total);
+                        }
+                    }
+                }
+            }
+        }
+
+        return result_table;
+    }
+
+  private:
+    const util::HubLabels &hub_labels;
+};
+}
+}
+}
+
+#endif // HUB_LABEL_TABLE_HPP
@@ -3,13 +3,20 @@
 
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
+#include "util/simd_kernels.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -24,21 +31,42 @@ class ManyToManyRouting final
     : public BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>
 {
     using super = BasicRoutingInterface<DataFacadeT, ManyToManyRouting<DataFacadeT>>;
-    using QueryHeap = SearchEngineData::QueryHeap;
     SearchEngineData &engine_working_data;
 
     struct NodeBucket
     {
         unsigned target_id; // essentially a row in the distance matrix
         EdgeWeight distance;
-        NodeBucket(const unsigned target_id, const EdgeWeight distance)
+        NodeBucket(const unsigned target_id, const EdgeWeight distance, const EdgeLength)
             : target_id(target_id), distance(distance)
         {
         }
     };
 
+    struct NodeBucketWithLength : NodeBucket
+    {
+        EdgeLength length;
+        NodeBucketWithLength(const unsigned target_id,
+                             const EdgeWeight distance,
+                             const EdgeLength length)
+            : NodeBucket(target_id, distance, length), length(length)
+        {
+        }
+    };
+
+    // Lengths are only carried through the searches if they are requested, so duration tables
+    // keep the smaller buckets and heap entries.
+    template <bool with_lengths>
+    using QueryHeap = typename std::conditional<with_lengths,
+                                                SearchEngineData::ManyToManyQueryHeap,
+                                                SearchEngineData::QueryHeap>::type;
+
     // FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-    using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+    template <bool with_lengths>
+    using SearchSpaceWithBuckets = std::unordered_map<
+        NodeID,
+        std::vector<typename std::conditional<with_lengths, NodeBucketWithLength, NodeBucket>::
+                        type>>;
 
   public:
     ManyToManyRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
@@ -46,78 +74,196 @@ class ManyToManyRouting final
     {
     }
 
+    // Entries longer than max_weight are INVALID_EDGE_WEIGHT. Both the bucket filling and the
+    // forward searches stop once no path within the bound can be found anymore.
+    // If requested, length_table is filled with the lengths in decimeters of the paths in the
+    // result table, summed up from the edge lengths of the contracted graph. Entries without a
+    // path are undefined.
     std::vector<EdgeWeight> operator()(const std::vector<PhantomNode> &phantom_nodes,
                                        const std::vector<std::size_t> &source_indices,
-                                       const std::vector<std::size_t> &target_indices) const
+                                       const std::vector<std::size_t> &target_indices,
+                                       const EdgeWeight max_weight = INVALID_EDGE_WEIGHT,
+                                       std::vector<EdgeLength> *length_table = nullptr) const
     {
+        const auto number_of_sources =
+            source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+        std::vector<EdgeWeight> result_table;
+        if (length_table != nullptr)
+        {
+            SearchRowBlocks<true>(phantom_nodes,
+                                  source_indices,
+                                  target_indices,
+                                  max_weight,
+                                  number_of_sources,
+                                  [&](const std::size_t,
+                                      std::vector<EdgeWeight> &weights,
+                                      std::vector<EdgeLength> &lengths) {
+                                      result_table = std::move(weights);
+                                      *length_table = std::move(lengths);
+                                  });
+        }
+        else
+        {
+            ForEachRowBlock(phantom_nodes,
+                            source_indices,
+                            target_indices,
+                            max_weight,
+                            number_of_sources,
+                            [&](const std::size_t, std::vector<EdgeWeight> &weights) {
+                                result_table = std::move(weights);
+                            });
+        }
+        return result_table;
+    }
+
+    // Same as above without lengths, but the rows of the table are computed in blocks of
+    // rows_per_block rows. The buckets of the targets are filled once, then
+    // handler(first_row, weights) is called for every block of forward searches. Only one block
+    // of the table is in memory at a time, the handler may move the vector out.
+    template <typename RowBlockHandler>
+    void ForEachRowBlock(const std::vector<PhantomNode> &phantom_nodes,
+                         const std::vector<std::size_t> &source_indices,
+                         const std::vector<std::size_t> &target_indices,
+                         const EdgeWeight max_weight,
+                         const std::size_t rows_per_block,
+                         RowBlockHandler &&handler) const
+    {
+        SearchRowBlocks<false>(
+            phantom_nodes,
+            source_indices,
+            target_indices,
+            max_weight,
+            rows_per_block,
+            [&handler](const std::size_t first_row,
+                       std::vector<EdgeWeight> &weights,
+                       std::vector<EdgeLength> &) { handler(first_row, weights); });
+    }
+
+  private:
+    // handler(first_row, weights, lengths) gets the lengths of a block only if with_lengths is set
+    template <bool with_lengths, typename RowBlockHandler>
+    void SearchRowBlocks(const std::vector<PhantomNode> &phantom_nodes,
+                         const std::vector<std::size_t> &source_indices,
+                         const std::vector<std::size_t> &target_indices,
+                         const EdgeWeight max_weight,
+                         const std::size_t rows_per_block,
+                         RowBlockHandler &&handler) const
+    {
+        using WithLengths = std::integral_constant<bool, with_lengths>;
         const auto number_of_sources =
             source_indices.empty() ? phantom_nodes.size() : source_indices.size();
         const auto number_of_targets =
             target_indices.empty() ? phantom_nodes.size() : target_indices.size();
-        const auto number_of_entries = number_of_sources * number_of_targets;
-        std::vector<EdgeWeight> result_table(number_of_entries,
-                                             std::numeric_limits<EdgeWeight>::max());
+        BOOST_ASSERT(rows_per_block > 0 || number_of_sources == 0);
+        std::vector<EdgeWeight> result_table;
+        std::vector<EdgeLength> result_lengths;
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
+        QueryHeap<with_lengths> &query_heap = GetQueryHeap(WithLengths{});
 
-        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+        SearchSpaceWithBuckets<with_lengths> search_space_with_buckets;
 
-        SearchSpaceWithBuckets search_space_with_buckets;
+        // A path found by the forward search is s + t, where s >= -source offset and t >= 0.
+        // The backward search can stop at max_weight + largest source offset, the forward
+        // search at max_weight.
+        EdgeWeight max_target_weight = max_weight;
+        if (max_weight != INVALID_EDGE_WEIGHT)
+        {
+            EdgeWeight max_source_offset = 0;
+            const auto update_source_offset = [&](const PhantomNode &phantom) {
+                if (phantom.forward_segment_id.enabled)
+                {
+                    max_source_offset =
+                        std::max(max_source_offset, phantom.GetForwardWeightPlusOffset());
+                }
+                if (phantom.reverse_segment_id.enabled)
+                {
+                    max_source_offset =
+                        std::max(max_source_offset, phantom.GetReverseWeightPlusOffset());
+                }
+            };
+            if (source_indices.empty())
+            {
+                std::for_each(phantom_nodes.begin(), phantom_nodes.end(), update_source_offset);
+            }
+            else
+            {
+                for (const auto index : source_indices)
+                {
+                    update_source_offset(phantom_nodes[index]);
+                }
+            }
+            max_target_weight = static_cast<EdgeWeight>(
+                std::min<std::int64_t>(static_cast<std::int64_t>(max_weight) + max_source_offset,
+                                       INVALID_EDGE_WEIGHT));
+        }
 
         unsigned column_idx = 0;
         const auto search_target_phantom = [&](const PhantomNode &phantom) {
             query_heap.Clear();
             // insert target(s) at distance 0
+            const auto length_offsets =
+                with_lengths ? GetLengthOffsets(phantom) : std::pair<EdgeLength, EdgeLength>{};
 
             if (phantom.forward_segment_id.enabled)
             {
                 query_heap.Insert(phantom.forward_segment_id.id,
                                   phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
+                                  MakeHeapData(phantom.forward_segment_id.id,
+                                               length_offsets.first,
+                                               WithLengths{}));
             }
             if (phantom.reverse_segment_id.enabled)
             {
                 query_heap.Insert(phantom.reverse_segment_id.id,
                                   phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
+                                  MakeHeapData(phantom.reverse_segment_id.id,
+                                               length_offsets.second,
+                                               WithLengths{}));
             }
 
             // explore search space
-            while (!query_heap.Empty())
+            while (!query_heap.Empty() && query_heap.MinKey() <= max_target_weight)
             {
-                BackwardRoutingStep(column_idx, query_heap, search_space_with_buckets);
+                BackwardRoutingStep<with_lengths>(
+                    column_idx, query_heap, search_space_with_buckets);
             }
             ++column_idx;
         };
 
-        // for each source do forward search
+        // for each source do forward search, row_idx is the row within the current block
         unsigned row_idx = 0;
         const auto search_source_phantom = [&](const PhantomNode &phantom) {
             query_heap.Clear();
             // insert target(s) at distance 0
+            const auto length_offsets =
+                with_lengths ? GetLengthOffsets(phantom) : std::pair<EdgeLength, EdgeLength>{};
 
             if (phantom.forward_segment_id.enabled)
             {
                 query_heap.Insert(phantom.forward_segment_id.id,
                                   -phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
+                                  MakeHeapData(phantom.forward_segment_id.id,
+                                               -length_offsets.first,
+                                               WithLengths{}));
             }
             if (phantom.reverse_segment_id.enabled)
             {
                 query_heap.Insert(phantom.reverse_segment_id.id,
                                   -phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
+                                  MakeHeapData(phantom.reverse_segment_id.id,
+                                               -length_offsets.second,
+                                               WithLengths{}));
             }
 
             // explore search space
-            while (!query_heap.Empty())
+            while (!query_heap.Empty() && query_heap.MinKey() <= max_weight)
             {
-                ForwardRoutingStep(row_idx,
-                                   number_of_targets,
-                                   query_heap,
-                                   search_space_with_buckets,
-                                   result_table);
+                ForwardRoutingStep<with_lengths>(row_idx,
+                                                 number_of_targets,
+                                                 query_heap,
+                                                 search_space_with_buckets,
+                                                 result_table,
+                                                 result_lengths);
             }
             ++row_idx;
         };
@@ -138,144 +284,202 @@ class ManyToManyRouting final
             }
         }
 
-        if (source_indices.empty())
+        for (std::size_t first_row = 0; first_row < number_of_sources;
+             first_row += rows_per_block)
         {
-            for (const auto &phantom : phantom_nodes)
+            const auto last_row = std::min(first_row + rows_per_block, number_of_sources);
+            const auto number_of_entries = (last_row - first_row) * number_of_targets;
+            result_table.assign(number_of_entries, std::numeric_limits<EdgeWeight>::max());
+            if (with_lengths)
             {
-                search_source_phantom(phantom);
+                result_lengths.assign(number_of_entries, 0);
             }
-        }
-        else
-        {
-            for (const auto index : source_indices)
+
+            row_idx = 0;
+            for (const auto row : util::irange(first_row, last_row))
             {
-                const auto &phantom = phantom_nodes[index];
-                search_source_phantom(phantom);
+                search_source_phantom(
+                    phantom_nodes[source_indices.empty() ? row : source_indices[row]]);
             }
-        }
 
-        return result_table;
+            if (max_weight != INVALID_EDGE_WEIGHT)
+            {
+                std::replace_if(
+                    result_table.begin(),
+                    result_table.end(),
+                    [max_weight](const EdgeWeight weight) { return weight > max_weight; },
+                    INVALID_EDGE_WEIGHT);
+            }
+
+            handler(first_row, result_table, result_lengths);
+        }
     }
 
+    template <bool with_lengths>
     void ForwardRoutingStep(const unsigned row_idx,
                             const unsigned number_of_targets,
-                            QueryHeap &query_heap,
-                            const SearchSpaceWithBuckets &search_space_with_buckets,
-                            std::vector<EdgeWeight> &result_table) const
+                            QueryHeap<with_lengths> &query_heap,
+                            const SearchSpaceWithBuckets<with_lengths> &search_space_with_buckets,
+                            std::vector<EdgeWeight> &result_table,
+                            std::vector<EdgeLength> &result_lengths) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int source_distance = query_heap.GetKey(node);
+        const EdgeLength source_length = GetLength(query_heap.GetData(node));
 
         // check if each encountered node has an entry
         const auto bucket_iterator = search_space_with_buckets.find(node);
         // iterate bucket if there exists one
         if (bucket_iterator != search_space_with_buckets.end())
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            RelaxBucket(node,
+                        source_distance,
+                        source_length,
+                        bucket_iterator->second,
+                        row_idx * number_of_targets,
+                        result_table,
+                        result_lengths);
+        }
+        if (super::template StallAtNode<true>(node, source_distance, query_heap))
+        {
+            return;
+        }
+        super::template RelaxOutgoingEdges<true>(node, source_distance, query_heap);
+    }
+
+    // Durations only: the buckets are pairs of a column and a weight, which the SIMD kernel
+    // relaxes. Paths with a negative weight need the loop weight of the node and are left to
+    // the scalar loop.
+    void RelaxBucket(const NodeID node,
+                     const EdgeWeight source_distance,
+                     const EdgeLength,
+                     const std::vector<NodeBucket> &buckets,
+                     const std::size_t row_offset,
+                     std::vector<EdgeWeight> &result_table,
+                     std::vector<EdgeLength> &) const
+    {
+        static_assert(std::is_standard_layout<NodeBucket>::value &&
+                          sizeof(NodeBucket) == 2 * sizeof(std::int32_t),
+                      "the kernel reads the buckets as pairs of column and weight");
+        auto *const row = result_table.data() + row_offset;
+        if (!util::simd::getKernels().relax_bucket(
+                reinterpret_cast<const std::int32_t *>(buckets.data()),
+                buckets.size(),
+                source_distance,
+                row))
+        {
+            return;
+        }
+
+        const EdgeWeight loop_weight = super::GetLoopWeight(node);
+        if (loop_weight == INVALID_EDGE_WEIGHT)
+        {
+            return;
+        }
+        for (const auto &current_bucket : buckets)
+        {
+            const EdgeWeight new_distance = source_distance + current_bucket.distance;
+            const EdgeWeight new_distance_with_loop = new_distance + loop_weight;
+            auto &current_distance = row[current_bucket.target_id];
+            if (new_distance < 0 && new_distance_with_loop >= 0 &&
+                new_distance_with_loop < current_distance)
             {
-                // get target id from bucket entry
-                const unsigned column_idx = current_bucket.target_id;
-                const int target_distance = current_bucket.distance;
-                auto &current_distance = result_table[row_idx * number_of_targets + column_idx];
-                // check if new distance is better
-                const EdgeWeight new_distance = source_distance + target_distance;
-                if (new_distance < 0)
-                {
-                    const EdgeWeight loop_weight = super::GetLoopWeight(node);
-                    const int new_distance_with_loop = new_distance + loop_weight;
-                    if (loop_weight != INVALID_EDGE_WEIGHT && new_distance_with_loop >= 0)
-                    {
-                        current_distance = std::min(current_distance, new_distance_with_loop);
-                    }
-                }
-                else if (new_distance < current_distance)
-                {
-                    result_table[row_idx * number_of_targets + column_idx] = new_distance;
-                }
+                current_distance = new_distance_with_loop;
             }
         }
-        if (StallAtNode<true>(node, source_distance, query_heap))
+    }
+
+    void RelaxBucket(const NodeID node,
+                     const EdgeWeight source_distance,
+                     const EdgeLength source_length,
+                     const std::vector<NodeBucketWithLength> &buckets,
+                     const std::size_t row_offset,
+                     std::vector<EdgeWeight> &result_table,
+                     std::vector<EdgeLength> &result_lengths) const
+    {
+        for (const auto &current_bucket : buckets)
         {
-            return;
+            // get target id from bucket entry
+            const unsigned column_idx = current_bucket.target_id;
+            const int target_distance = current_bucket.distance;
+            const auto index = row_offset + column_idx;
+            auto &current_distance = result_table[index];
+            // check if new distance is better
+            const EdgeWeight new_distance = source_distance + target_distance;
+            const EdgeLength new_length = source_length + current_bucket.length;
+            if (new_distance < 0)
+            {
+                const EdgeWeight loop_weight = super::GetLoopWeight(node);
+                const int new_distance_with_loop = new_distance + loop_weight;
+                if (loop_weight != INVALID_EDGE_WEIGHT && new_distance_with_loop >= 0 &&
+                    new_distance_with_loop < current_distance)
+                {
+                    current_distance = new_distance_with_loop;
+                    result_lengths[index] = std::max(new_length + super::GetLoopLength(node), 0);
+                }
+            }
+            else if (new_distance < current_distance)
+            {
+                current_distance = new_distance;
+                result_lengths[index] = std::max(new_length, 0);
+            }
         }
-        RelaxOutgoingEdges<true>(node, source_distance, query_heap);
     }
 
+    template <bool with_lengths>
     void BackwardRoutingStep(const unsigned column_idx,
-                             QueryHeap &query_heap,
-                             SearchSpaceWithBuckets &search_space_with_buckets) const
+                             QueryHeap<with_lengths> &query_heap,
+                             SearchSpaceWithBuckets<with_lengths> &search_space_with_buckets) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int target_distance = query_heap.GetKey(node);
+        const EdgeLength target_length = GetLength(query_heap.GetData(node));
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(column_idx, target_distance);
+        search_space_with_buckets[node].emplace_back(column_idx, target_distance, target_length);
 
-        if (StallAtNode<false>(node, target_distance, query_heap))
+        if (super::template StallAtNode<false>(node, target_distance, query_heap))
         {
             return;
         }
 
-        RelaxOutgoingEdges<false>(node, target_distance, query_heap);
+        super::template RelaxOutgoingEdges<false>(node, target_distance, query_heap);
     }
 
-    template <bool forward_direction>
-    inline void
-    RelaxOutgoingEdges(const NodeID node, const EdgeWeight distance, QueryHeap &query_heap) const
+    SearchEngineData::QueryHeap &GetQueryHeap(std::false_type) const
     {
-        for (auto edge : super::facade->GetAdjacentEdgeRange(node))
-        {
-            const auto &data = super::facade->GetEdgeData(edge);
-            const bool direction_flag = (forward_direction ? data.forward : data.backward);
-            if (direction_flag)
-            {
-                const NodeID to = super::facade->GetTarget(edge);
-                const int edge_weight = data.distance;
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        return *(engine_working_data.forward_heap_1);
+    }
 
-                BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
-                const int to_distance = distance + edge_weight;
+    SearchEngineData::ManyToManyQueryHeap &GetQueryHeap(std::true_type) const
+    {
+        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        return *(engine_working_data.many_to_many_heap);
+    }
 
-                // New Node discovered -> Add to Heap + Node Info Storage
-                if (!query_heap.WasInserted(to))
-                {
-                    query_heap.Insert(to, to_distance, node);
-                }
-                // Found a shorter Path -> Update distance
-                else if (to_distance < query_heap.GetKey(to))
-                {
-                    // new parent
-                    query_heap.GetData(to).parent = node;
-                    query_heap.DecreaseKey(to, to_distance);
-                }
-            }
-        }
+    static HeapData MakeHeapData(const NodeID parent, const EdgeLength, std::false_type)
+    {
+        return {parent};
     }
 
-    // Stalling
-    template <bool forward_direction>
-    inline bool
-    StallAtNode(const NodeID node, const EdgeWeight distance, QueryHeap &query_heap) const
+    static ManyToManyHeapData
+    MakeHeapData(const NodeID parent, const EdgeLength length, std::true_type)
     {
-        for (auto edge : super::facade->GetAdjacentEdgeRange(node))
-        {
-            const auto &data = super::facade->GetEdgeData(edge);
-            const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
-            if (reverse_flag)
-            {
-                const NodeID to = super::facade->GetTarget(edge);
-                const int edge_weight = data.distance;
-                BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
-                if (query_heap.WasInserted(to))
-                {
-                    if (query_heap.GetKey(to) + edge_weight < distance)
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
-        return false;
+        return {parent, length};
+    }
+
+    static EdgeLength GetLength(const HeapData &) { return 0; }
+    static EdgeLength GetLength(const ManyToManyHeapData &data) { return data.length; }
+
+    // Lengths in decimeters from the start of the forward and reverse node to the phantom node
+    std::pair<EdgeLength, EdgeLength> GetLengthOffsets(const PhantomNode &phantom) const
+    {
+        const auto offsets = super::GetPhantomLengthOffsets(phantom);
+        return {static_cast<EdgeLength>(std::round(offsets.first * 10.)),
+                static_cast<EdgeLength>(std::round(offsets.second * 10.))};
     }
 };
 }
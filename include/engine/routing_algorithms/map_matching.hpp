@@ -8,7 +8,6 @@
 #include "engine/map_matching/sub_matching.hpp"
 
 #include "util/coordinate_calculation.hpp"
-#include "util/for_each_pair.hpp"
 #include "util/json_logger.hpp"
 
 #include <cstddef>
@@ -29,7 +28,7 @@ namespace routing_algorithms
 
 using CandidateList = std::vector<PhantomNodeWithDistance>;
 using CandidateLists = std::vector<CandidateList>;
-using HMM = map_matching::HiddenMarkovModel<CandidateLists>;
+using HMM = map_matching::HiddenMarkovModel;
 using SubMatchingList = std::vector<map_matching::SubMatching>;
 
 constexpr static const unsigned MAX_BROKEN_STATES = 10;
@@ -108,51 +107,41 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             }
         }();
 
-        std::vector<std::vector<double>> emission_log_probabilities(trace_coordinates.size());
+        engine_working_data.InitializeHiddenMarkovModelThreadLocalStorage();
+        HMM &model = *(engine_working_data.hidden_markov_model);
+        model.Reset(candidates_list);
+
         if (trace_gps_precision.empty())
         {
-            for (auto t = 0UL; t < candidates_list.size(); ++t)
-            {
-                emission_log_probabilities[t].resize(candidates_list[t].size());
-                std::transform(candidates_list[t].begin(),
-                               candidates_list[t].end(),
-                               emission_log_probabilities[t].begin(),
-                               [this](const PhantomNodeWithDistance &candidate) {
-                                   return default_emission_log_probability(candidate.distance);
-                               });
-            }
+            default_emission_log_probability(model.distances.data(),
+                                             model.distances.size(),
+                                             model.emission_log_probabilities.data());
         }
         else
         {
             for (auto t = 0UL; t < candidates_list.size(); ++t)
             {
-                emission_log_probabilities[t].resize(candidates_list[t].size());
+                const auto first_state = model.GetState(t, 0);
+                const auto number_of_states = model.GetNumberOfStates(t);
                 if (trace_gps_precision[t])
                 {
                     map_matching::EmissionLogProbability emission_log_probability(
                         *trace_gps_precision[t]);
-                    std::transform(
-                        candidates_list[t].begin(),
-                        candidates_list[t].end(),
-                        emission_log_probabilities[t].begin(),
-                        [&emission_log_probability](const PhantomNodeWithDistance &candidate) {
-                            return emission_log_probability(candidate.distance);
-                        });
+                    emission_log_probability(model.distances.data() + first_state,
+                                             number_of_states,
+                                             model.emission_log_probabilities.data() +
+                                                 first_state);
                 }
                 else
                 {
-                    std::transform(candidates_list[t].begin(),
-                                   candidates_list[t].end(),
-                                   emission_log_probabilities[t].begin(),
-                                   [this](const PhantomNodeWithDistance &candidate) {
-                                       return default_emission_log_probability(candidate.distance);
-                                   });
+                    default_emission_log_probability(model.distances.data() + first_state,
+                                                     number_of_states,
+                                                     model.emission_log_probabilities.data() +
+                                                         first_state);
                 }
             }
         }
 
-        HMM model(candidates_list, emission_log_probabilities);
-
         std::size_t initial_timestamp = model.initialize(0);
         if (initial_timestamp == map_matching::INVALID_STATE)
         {
@@ -223,15 +212,21 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             BOOST_ASSERT(!prev_unbroken_timestamps.empty());
             const std::size_t prev_unbroken_timestamp = prev_unbroken_timestamps.back();
 
-            const auto &prev_viterbi = model.viterbi[prev_unbroken_timestamp];
-            const auto &prev_pruned = model.pruned[prev_unbroken_timestamp];
+            const auto prev_first_state = model.GetState(prev_unbroken_timestamp, 0);
+            const auto prev_number_of_states = model.GetNumberOfStates(prev_unbroken_timestamp);
+            const auto *prev_viterbi = model.viterbi.data() + prev_first_state;
+            const auto *prev_pruned = model.pruned.data() + prev_first_state;
             const auto &prev_unbroken_timestamps_list = candidates_list[prev_unbroken_timestamp];
             const auto &prev_coordinate = trace_coordinates[prev_unbroken_timestamp];
 
-            auto &current_viterbi = model.viterbi[t];
-            auto &current_pruned = model.pruned[t];
-            auto &current_parents = model.parents[t];
-            auto &current_lengths = model.path_distances[t];
+            const auto current_first_state = model.GetState(t, 0);
+            const auto current_number_of_states = model.GetNumberOfStates(t);
+            const auto *current_emission_log_probabilities =
+                model.emission_log_probabilities.data() + current_first_state;
+            auto *current_viterbi = model.viterbi.data() + current_first_state;
+            auto *current_pruned = model.pruned.data() + current_first_state;
+            auto *current_parents = model.parents.data() + current_first_state;
+            auto *current_lengths = model.path_distances.data() + current_first_state;
             const auto &current_timestamps_list = candidates_list[t];
             const auto &current_coordinate = trace_coordinates[t];
 
@@ -242,16 +237,16 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                 ((haversine_distance + max_distance_delta) * 0.25) * 10;
 
             // compute d_t for this timestamp and the next one
-            for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
+            for (const auto s : util::irange<std::size_t>(0UL, prev_number_of_states))
             {
                 if (prev_pruned[s])
                 {
                     continue;
                 }
 
-                for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
+                for (const auto s_prime : util::irange<std::size_t>(0UL, current_number_of_states))
                 {
-                    const double emission_pr = emission_log_probabilities[t][s_prime];
+                    const double emission_pr = current_emission_log_probabilities[s_prime];
                     double new_value = prev_viterbi[s] + emission_pr;
                     if (current_viterbi[s_prime] > new_value)
                     {
@@ -354,12 +349,7 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             }
 
             // loop through the columns, and only compare the last entry
-            const auto max_element_iter =
-                std::max_element(model.viterbi[parent_timestamp_index].begin(),
-                                 model.viterbi[parent_timestamp_index].end());
-
-            std::size_t parent_candidate_index =
-                std::distance(model.viterbi[parent_timestamp_index].begin(), max_element_iter);
+            std::size_t parent_candidate_index = model.GetMaxCandidate(parent_timestamp_index);
 
             std::deque<std::pair<std::size_t, std::size_t>> reconstructed_indices;
             while (parent_timestamp_index > sub_matching_begin)
@@ -370,7 +360,8 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                 }
 
                 reconstructed_indices.emplace_front(parent_timestamp_index, parent_candidate_index);
-                const auto &next = model.parents[parent_timestamp_index][parent_candidate_index];
+                const auto &next =
+                    model.parents[model.GetState(parent_timestamp_index, parent_candidate_index)];
                 // make sure we can never get stuck in this loop
                 if (parent_timestamp_index == next.first)
                 {
@@ -387,7 +378,8 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             }
 
             auto matching_distance = 0.0;
-            auto trace_distance = 0.0;
+            std::vector<util::Coordinate> matched_coordinates;
+            matched_coordinates.reserve(reconstructed_indices.size());
             matching.nodes.reserve(reconstructed_indices.size());
             matching.indices.reserve(reconstructed_indices.size());
             for (const auto idx : reconstructed_indices)
@@ -398,16 +390,18 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                 matching.indices.push_back(timestamp_index);
                 matching.nodes.push_back(
                     candidates_list[timestamp_index][location_index].phantom_node);
-                matching_distance += model.path_distances[timestamp_index][location_index];
+                matching_distance +=
+                    model.path_distances[model.GetState(timestamp_index, location_index)];
+                matched_coordinates.push_back(trace_coordinates[timestamp_index]);
             }
-            util::for_each_pair(
-                reconstructed_indices,
-                [&trace_distance,
-                 &trace_coordinates](const std::pair<std::size_t, std::size_t> &prev,
-                                     const std::pair<std::size_t, std::size_t> &curr) {
-                    trace_distance += util::coordinate_calculation::haversineDistance(
-                        trace_coordinates[prev.first], trace_coordinates[curr.first]);
-                });
+
+            std::vector<double> trace_distances(matched_coordinates.size() - 1);
+            util::coordinate_calculation::haversineDistances(matched_coordinates.data(),
+                                                             matched_coordinates.data() + 1,
+                                                             trace_distances.size(),
+                                                             trace_distances.data());
+            const auto trace_distance =
+                std::accumulate(trace_distances.begin(), trace_distances.end(), 0.0);
 
             matching.confidence = confidence(trace_distance, matching_distance);
 
@@ -0,0 +1,229 @@
+#ifndef NEAREST_FACILITIES_ROUTING_HPP
+#define NEAREST_FACILITIES_ROUTING_HPP
+
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Backward search spaces of a set of facilities, as used by ManyToManyRouting for its targets.
+// They only depend on the facilities and can be reused for any number of sources.
+struct FacilityBuckets
+{
+    struct NodeBucket
+    {
+        unsigned facility_id;
+        EdgeWeight distance;
+        NodeBucket(const unsigned facility_id, const EdgeWeight distance)
+            : facility_id(facility_id), distance(distance)
+        {
+        }
+    };
+
+    std::unordered_map<NodeID, std::vector<NodeBucket>> search_space;
+    std::size_t number_of_facilities = 0;
+};
+
+struct FacilityResult
+{
+    unsigned facility_id;
+    EdgeWeight duration;
+};
+
+/// One-to-many search that returns the nearest facilities by duration. The forward search stops
+/// as soon as no unsettled node can improve on the k-th best facility found so far, instead of
+/// exploring the whole upward search space like a table query does.
+template <class DataFacadeT>
+class NearestFacilitiesRouting final
+    : public BasicRoutingInterface<DataFacadeT, NearestFacilitiesRouting<DataFacadeT>>
+{
+    using super = BasicRoutingInterface<DataFacadeT, NearestFacilitiesRouting<DataFacadeT>>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+  public:
+    NearestFacilitiesRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    FacilityBuckets BuildBuckets(const std::vector<PhantomNode> &phantom_nodes,
+                                 const std::vector<std::size_t> &facility_indices) const
+    {
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+
+        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+
+        FacilityBuckets buckets;
+        buckets.number_of_facilities = facility_indices.size();
+
+        unsigned facility_id = 0;
+        for (const auto index : facility_indices)
+        {
+            const auto &phantom = phantom_nodes[index];
+            query_heap.Clear();
+
+            if (phantom.forward_segment_id.enabled)
+            {
+                query_heap.Insert(phantom.forward_segment_id.id,
+                                  phantom.GetForwardWeightPlusOffset(),
+                                  phantom.forward_segment_id.id);
+            }
+            if (phantom.reverse_segment_id.enabled)
+            {
+                query_heap.Insert(phantom.reverse_segment_id.id,
+                                  phantom.GetReverseWeightPlusOffset(),
+                                  phantom.reverse_segment_id.id);
+            }
+
+            while (!query_heap.Empty())
+            {
+                BackwardRoutingStep(facility_id, query_heap, buckets);
+            }
+            ++facility_id;
+        }
+
+        return buckets;
+    }
+
+    // Returns at most number_of_results facilities ordered by duration
+    std::vector<FacilityResult> operator()(const PhantomNode &source,
+                                           const FacilityBuckets &buckets,
+                                           const unsigned number_of_results) const
+    {
+        BOOST_ASSERT(number_of_results > 0);
+
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+
+        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+        query_heap.Clear();
+
+        if (source.forward_segment_id.enabled)
+        {
+            query_heap.Insert(source.forward_segment_id.id,
+                              -source.GetForwardWeightPlusOffset(),
+                              source.forward_segment_id.id);
+        }
+        if (source.reverse_segment_id.enabled)
+        {
+            query_heap.Insert(source.reverse_segment_id.id,
+                              -source.GetReverseWeightPlusOffset(),
+                              source.reverse_segment_id.id);
+        }
+
+        // best duration per reached facility and the same entries ordered by duration
+        std::unordered_map<unsigned, EdgeWeight> best_durations;
+        std::set<std::pair<EdgeWeight, unsigned>> ranking;
+
+        while (!query_heap.Empty())
+        {
+            // bucket distances are never negative, so no path through an unsettled node can be
+            // shorter than the smallest key in the heap
+            if (ranking.size() >= number_of_results &&
+                query_heap.MinKey() >= std::next(ranking.begin(), number_of_results - 1)->first)
+            {
+                break;
+            }
+            ForwardRoutingStep(query_heap, buckets, best_durations, ranking);
+        }
+
+        std::vector<FacilityResult> results;
+        for (const auto &entry : ranking)
+        {
+            if (results.size() == number_of_results)
+            {
+                break;
+            }
+            results.push_back(FacilityResult{entry.second, entry.first});
+        }
+        return results;
+    }
+
+  private:
+    void ForwardRoutingStep(QueryHeap &query_heap,
+                            const FacilityBuckets &buckets,
+                            std::unordered_map<unsigned, EdgeWeight> &best_durations,
+                            std::set<std::pair<EdgeWeight, unsigned>> &ranking) const
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const int source_distance = query_heap.GetKey(node);
+
+        const auto bucket_iterator = buckets.search_space.find(node);
+        if (bucket_iterator != buckets.search_space.end())
+        {
+            for (const auto &current_bucket : bucket_iterator->second)
+            {
+                EdgeWeight new_distance = source_distance + current_bucket.distance;
+                if (new_distance < 0)
+                {
+                    const EdgeWeight loop_weight = super::GetLoopWeight(node);
+                    if (loop_weight == INVALID_EDGE_WEIGHT || new_distance + loop_weight < 0)
+                    {
+                        continue;
+                    }
+                    new_distance += loop_weight;
+                }
+
+                const auto facility_id = current_bucket.facility_id;
+                const auto best_iterator = best_durations.find(facility_id);
+                if (best_iterator == best_durations.end())
+                {
+                    best_durations.emplace(facility_id, new_distance);
+                    ranking.emplace(new_distance, facility_id);
+                }
+                else if (new_distance < best_iterator->second)
+                {
+                    ranking.erase(std::make_pair(best_iterator->second, facility_id));
+                    ranking.emplace(new_distance, facility_id);
+                    best_iterator->second = new_distance;
+                }
+            }
+        }
+
+        if (super::template StallAtNode<true>(node, source_distance, query_heap))
+        {
+            return;
+        }
+        super::template RelaxOutgoingEdges<true>(node, source_distance, query_heap);
+    }
+
+    void BackwardRoutingStep(const unsigned facility_id,
+                             QueryHeap &query_heap,
+                             FacilityBuckets &buckets) const
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const int target_distance = query_heap.GetKey(node);
+
+        // store settled nodes in search space bucket
+        buckets.search_space[node].emplace_back(facility_id, target_distance);
+
+        if (super::template StallAtNode<false>(node, target_distance, query_heap))
+        {
+            return;
+        }
+
+        super::template RelaxOutgoingEdges<false>(node, target_distance, query_heap);
+    }
+};
+}
+}
+}
+
+#endif // NEAREST_FACILITIES_ROUTING_HPP
@@ -3,8 +3,10 @@
 
 #include "extractor/guidance/turn_instruction.hpp"
 #include "engine/internal_route_result.hpp"
+#include "engine/query_trace.hpp"
 #include "engine/search_engine_data.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/prefetch.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
@@ -84,6 +86,13 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         const NodeID node = forward_heap.DeleteMin();
         const std::int32_t distance = forward_heap.GetKey(node);
 
+        // The new minimum is most likely settled next. Its node entry was prefetched when it was
+        // inserted, so its edges can be loaded while this node is processed.
+        if (util::PREFETCHING_ENABLED && !forward_heap.Empty())
+        {
+            facade->PrefetchAdjacentEdges(forward_heap.Min());
+        }
+
         if (reverse_heap.WasInserted(node))
         {
             const std::int32_t new_distance = reverse_heap.GetKey(node) + distance;
@@ -175,6 +184,10 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                 if (!forward_heap.WasInserted(to))
                 {
                     forward_heap.Insert(to, to_distance, node);
+                    if (util::PREFETCHING_ENABLED)
+                    {
+                        facade->PrefetchNode(to);
+                    }
                 }
                 // Found a shorter Path -> Update distance
                 else if (to_distance < forward_heap.GetKey(to))
@@ -182,6 +195,10 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                     // new parent
                     forward_heap.GetData(to).parent = node;
                     forward_heap.DecreaseKey(to, to_distance);
+                    if (util::PREFETCHING_ENABLED)
+                    {
+                        facade->PrefetchNode(to);
+                    }
                 }
             }
         }
@@ -205,12 +222,181 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         return loop_weight;
     }
 
+    // Length in decimeters of the loop edge at node that GetLoopWeight picks
+    inline EdgeLength GetLoopLength(NodeID node) const
+    {
+        EdgeWeight loop_weight = INVALID_EDGE_WEIGHT;
+        EdgeLength loop_length = 0;
+        for (auto edge : facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade->GetEdgeData(edge);
+            if (data.forward && facade->GetTarget(edge) == node && data.distance < loop_weight)
+            {
+                loop_weight = data.distance;
+                loop_length = facade->GetEdgeLength(edge);
+            }
+        }
+        return loop_length;
+    }
+
+    // Heap data of a node reached from parent over an edge. The many-to-many heap data also
+    // sums up the edge lengths.
+    HeapData ReachedHeapData(const NodeID parent, const HeapData &, const EdgeID) const
+    {
+        return {parent};
+    }
+
+    ManyToManyHeapData ReachedHeapData(const NodeID parent,
+                                       const ManyToManyHeapData &parent_data,
+                                       const EdgeID edge) const
+    {
+        return {parent, parent_data.length + facade->GetEdgeLength(edge)};
+    }
+
+    // Relaxes the edges of a settled node in a search that only goes upwards, like the searches
+    // of the many-to-many and nearest facilities routing
+    template <bool forward_direction, typename HeapT>
+    void RelaxOutgoingEdges(const NodeID node, const EdgeWeight distance, HeapT &query_heap) const
+    {
+        const auto node_data = query_heap.GetData(node);
+        for (auto edge : facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade->GetEdgeData(edge);
+            const bool direction_flag = (forward_direction ? data.forward : data.backward);
+            if (direction_flag)
+            {
+                const NodeID to = facade->GetTarget(edge);
+                const int edge_weight = data.distance;
+
+                BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
+                const int to_distance = distance + edge_weight;
+
+                // New Node discovered -> Add to Heap + Node Info Storage
+                if (!query_heap.WasInserted(to))
+                {
+                    query_heap.Insert(to, to_distance, ReachedHeapData(node, node_data, edge));
+                }
+                // Found a shorter Path -> Update distance
+                else if (to_distance < query_heap.GetKey(to))
+                {
+                    // new parent
+                    query_heap.GetData(to) = ReachedHeapData(node, node_data, edge);
+                    query_heap.DecreaseKey(to, to_distance);
+                }
+            }
+        }
+    }
+
+    // Stalling for the same searches: node is not on a shortest path if a node in the heap
+    // reaches it with a smaller weight
+    template <bool forward_direction, typename HeapT>
+    bool StallAtNode(const NodeID node, const EdgeWeight distance, HeapT &query_heap) const
+    {
+        for (auto edge : facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade->GetEdgeData(edge);
+            const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
+            if (reverse_flag)
+            {
+                const NodeID to = facade->GetTarget(edge);
+                const int edge_weight = data.distance;
+                BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
+                if (query_heap.WasInserted(to))
+                {
+                    if (query_heap.GetKey(to) + edge_weight < distance)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Lengths in meters from the start of the forward and of the reverse edge-based node of the
+    // phantom node to its location, the counterpart of the weight offsets for edge lengths.
+    //
+    // U---v---w---x---y---Z
+    //            s
+    // The forward geometry is (v, ..., Z), the reverse geometry (y, ..., U), s is on segment 2.
+    std::pair<double, double> GetPhantomLengthOffsets(const PhantomNode &phantom) const
+    {
+        std::vector<NodeID> forward_geometry;
+        std::vector<NodeID> reverse_geometry;
+        facade->GetUncompressedGeometry(phantom.forward_packed_geometry_id, forward_geometry);
+        facade->GetUncompressedGeometry(phantom.reverse_packed_geometry_id, reverse_geometry);
+        BOOST_ASSERT(!reverse_geometry.empty());
+        BOOST_ASSERT(phantom.fwd_segment_position < forward_geometry.size());
+
+        std::vector<util::Coordinate> coordinates;
+        coordinates.reserve(forward_geometry.size() + 1);
+        coordinates.push_back(facade->GetCoordinateOfNode(reverse_geometry.back()));
+        for (const auto node : forward_geometry)
+        {
+            coordinates.push_back(facade->GetCoordinateOfNode(node));
+        }
+
+        std::vector<double> distances(coordinates.size() - 1);
+        util::coordinate_calculation::haversineDistances(
+            coordinates.data(), coordinates.data() + 1, distances.size(), distances.data());
+
+        const double length_before =
+            std::accumulate(
+                distances.begin(), distances.begin() + phantom.fwd_segment_position, 0.) +
+            util::coordinate_calculation::haversineDistance(
+                coordinates[phantom.fwd_segment_position], phantom.location);
+        const double total_length = std::accumulate(distances.begin(), distances.end(), 0.);
+        return {length_before, std::max(total_length - length_before, 0.)};
+    }
+
+    // Sum of the edge lengths along a packed path in decimeters. Between two nodes the edge with
+    // the smallest weight is used, just like UnpackPath does.
+    EdgeLength GetPackedPathLength(const std::vector<NodeID> &packed_path) const
+    {
+        EdgeLength length = 0;
+        for (std::size_t index = 1; index < packed_path.size(); ++index)
+        {
+            const NodeID from = packed_path[index - 1];
+            const NodeID to = packed_path[index];
+            EdgeWeight edge_weight = INVALID_EDGE_WEIGHT;
+            EdgeLength edge_length = 0;
+            // upwards edge found by the forward search
+            for (const auto edge : facade->GetAdjacentEdgeRange(from))
+            {
+                const auto &data = facade->GetEdgeData(edge);
+                if (data.forward && facade->GetTarget(edge) == to && data.distance < edge_weight)
+                {
+                    edge_weight = data.distance;
+                    edge_length = facade->GetEdgeLength(edge);
+                }
+            }
+            // downwards edge found by the reverse search
+            if (edge_weight == INVALID_EDGE_WEIGHT)
+            {
+                for (const auto edge : facade->GetAdjacentEdgeRange(to))
+                {
+                    const auto &data = facade->GetEdgeData(edge);
+                    if (data.backward && facade->GetTarget(edge) == from &&
+                        data.distance < edge_weight)
+                    {
+                        edge_weight = data.distance;
+                        edge_length = facade->GetEdgeLength(edge);
+                    }
+                }
+            }
+            BOOST_ASSERT_MSG(edge_weight != INVALID_EDGE_WEIGHT, "edge id invalid");
+            length += edge_length;
+        }
+        return length;
+    }
+
     template <typename RandomIter>
     void UnpackPath(RandomIter packed_path_begin,
                     RandomIter packed_path_end,
                     const PhantomNodes &phantom_node_pair,
                     std::vector<PathData> &unpacked_path) const
     {
+        ScopedTraceStage stage("unpacking");
         const bool start_traversed_in_reverse =
             (*packed_path_begin != phantom_node_pair.source_phantom.forward_segment_id.id);
         const bool target_traversed_in_reverse =
@@ -287,21 +473,21 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
             else
             {
                 BOOST_ASSERT_MSG(!ed.shortcut, "original edge flagged as shortcut");
-                unsigned name_index = facade->GetNameIndexFromEdgeID(ed.id);
-                const auto turn_instruction = facade->GetTurnInstructionForEdgeID(ed.id);
+                // fetch all annotations of the original edge with a single lookup
+                const auto edge_data = facade->GetOriginalEdgeData(ed.id);
+                const unsigned name_index = edge_data.name_id;
+                const auto turn_instruction = edge_data.turn_instruction;
                 const extractor::TravelMode travel_mode =
                     (unpacked_path.empty() && start_traversed_in_reverse)
                         ? phantom_node_pair.source_phantom.backward_travel_mode
-                        : facade->GetTravelModeForEdgeID(ed.id);
+                        : edge_data.travel_mode;
 
                 std::vector<NodeID> id_vector;
-                facade->GetUncompressedGeometry(facade->GetGeometryIndexForEdgeID(ed.id),
-                                                id_vector);
+                facade->GetUncompressedGeometry(edge_data.via_node, id_vector);
                 BOOST_ASSERT(id_vector.size() > 0);
 
                 std::vector<EdgeWeight> weight_vector;
-                facade->GetUncompressedWeights(facade->GetGeometryIndexForEdgeID(ed.id),
-                                               weight_vector);
+                facade->GetUncompressedWeights(edge_data.via_node, weight_vector);
                 BOOST_ASSERT(weight_vector.size() > 0);
 
                 auto total_weight = std::accumulate(weight_vector.begin(), weight_vector.end(), 0);
@@ -331,7 +517,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                                  INVALID_ENTRY_CLASSID});
                 }
                 BOOST_ASSERT(unpacked_path.size() > 0);
-                unpacked_path.back().entry_classid = facade->GetEntryClassID(ed.id);
+                unpacked_path.back().entry_classid = edge_data.entry_classid;
                 unpacked_path.back().turn_instruction = turn_instruction;
                 unpacked_path.back().duration_until_turn += (ed.distance - total_weight);
             }
@@ -816,9 +1002,36 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                    target_phantom.GetReverseWeightPlusOffset();
     }
 
+    // Uses the lengths stored with the edges of the contracted graph if there are any, otherwise
+    // the path is unpacked
     double GetPathDistance(const std::vector<NodeID> &packed_path,
                            const PhantomNode &source_phantom,
                            const PhantomNode &target_phantom) const
+    {
+        if (!facade->HasEdgeLengths())
+        {
+            return GetUnpackedPathDistance(packed_path, source_phantom, target_phantom);
+        }
+
+        BOOST_ASSERT(!packed_path.empty());
+        const bool start_traversed_in_reverse =
+            packed_path.front() != source_phantom.forward_segment_id.id;
+        const bool target_traversed_in_reverse =
+            packed_path.back() != target_phantom.forward_segment_id.id;
+
+        const auto source_offsets = GetPhantomLengthOffsets(source_phantom);
+        const auto target_offsets = GetPhantomLengthOffsets(target_phantom);
+
+        const double distance =
+            GetPackedPathLength(packed_path) / 10. -
+            (start_traversed_in_reverse ? source_offsets.second : source_offsets.first) +
+            (target_traversed_in_reverse ? target_offsets.second : target_offsets.first);
+        return std::max(distance, 0.);
+    }
+
+    double GetUnpackedPathDistance(const std::vector<NodeID> &packed_path,
+                                   const PhantomNode &source_phantom,
+                                   const PhantomNode &target_phantom) const
     {
         std::vector<PathData> unpacked_path;
         PhantomNodes nodes;
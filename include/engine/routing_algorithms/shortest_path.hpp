@@ -11,6 +11,12 @@
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -26,6 +32,8 @@ class ShortestPathRouting final
     using QueryHeap = SearchEngineData::QueryHeap;
     SearchEngineData &engine_working_data;
     const static constexpr bool DO_NOT_FORCE_LOOP = false;
+    // below this number of legs the sequential search is faster than spawning tasks
+    const static constexpr std::size_t MIN_LEGS_FOR_PARALLEL_SEARCH = 4;
 
   public:
     ShortestPathRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
@@ -267,6 +275,93 @@ class ShortestPathRouting final
         }
     }
 
+    // If we can turn around at every via point, the best leg does not depend on the direction
+    // we arrived at its source: SearchWithUTurn seeds both source nodes with the same distance.
+    // So all legs can be searched at the same time, every task uses the heaps of its thread.
+    // The DP over the via point directions then reduces to adding up the leg distances, the
+    // direction a leg leaves its source is decided by the leg itself.
+    void ParallelSearchWithUTurn(const std::vector<PhantomNodes> &phantom_nodes_vector,
+                                 InternalRouteResult &raw_route_data) const
+    {
+        const auto number_of_legs = phantom_nodes_vector.size();
+        std::vector<int> leg_distances(number_of_legs, INVALID_EDGE_WEIGHT);
+        std::vector<std::vector<NodeID>> packed_legs(number_of_legs);
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_legs, 1),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+
+                QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
+                QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
+                QueryHeap &forward_core_heap = *(engine_working_data.forward_heap_2);
+                QueryHeap &reverse_core_heap = *(engine_working_data.reverse_heap_2);
+
+                for (auto leg = range.begin(); leg != range.end(); ++leg)
+                {
+                    const auto &source_phantom = phantom_nodes_vector[leg].source_phantom;
+                    const auto &target_phantom = phantom_nodes_vector[leg].target_phantom;
+
+                    // the sequential DP can leave a via point in every enabled direction,
+                    // since SearchWithUTurn reaches all enabled target nodes of a leg
+                    const bool search_from_forward_node = source_phantom.forward_segment_id.enabled;
+                    const bool search_from_reverse_node = source_phantom.reverse_segment_id.enabled;
+                    const bool search_to_forward_node = target_phantom.forward_segment_id.enabled;
+                    const bool search_to_reverse_node = target_phantom.reverse_segment_id.enabled;
+
+                    if (!(search_from_forward_node || search_from_reverse_node) ||
+                        !(search_to_forward_node || search_to_reverse_node))
+                    {
+                        continue;
+                    }
+
+                    SearchWithUTurn(forward_heap,
+                                    reverse_heap,
+                                    forward_core_heap,
+                                    reverse_core_heap,
+                                    search_from_forward_node,
+                                    search_from_reverse_node,
+                                    search_to_forward_node,
+                                    search_to_reverse_node,
+                                    source_phantom,
+                                    target_phantom,
+                                    0,
+                                    0,
+                                    leg_distances[leg],
+                                    packed_legs[leg]);
+                }
+            });
+
+        std::vector<NodeID> total_packed_path;
+        std::vector<std::size_t> packed_leg_begin;
+        int total_distance = 0;
+        for (const auto leg : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            if (INVALID_EDGE_WEIGHT == leg_distances[leg] || packed_legs[leg].empty())
+            {
+                raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
+                raw_route_data.alternative_path_length = INVALID_EDGE_WEIGHT;
+                return;
+            }
+
+            packed_leg_begin.push_back(total_packed_path.size());
+            total_packed_path.insert(
+                total_packed_path.end(), packed_legs[leg].begin(), packed_legs[leg].end());
+            total_distance += leg_distances[leg];
+        }
+        // insert sentinel
+        packed_leg_begin.push_back(total_packed_path.size());
+
+        UnpackLegs(phantom_nodes_vector,
+                   total_packed_path,
+                   packed_leg_begin,
+                   total_distance,
+                   raw_route_data);
+    }
+
     void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
                     const boost::optional<bool> continue_straight_at_waypoint,
                     InternalRouteResult &raw_route_data) const
@@ -275,6 +370,12 @@ class ShortestPathRouting final
             !(continue_straight_at_waypoint ? *continue_straight_at_waypoint
                                             : super::facade->GetContinueStraightDefault());
 
+        if (allow_uturn_at_waypoint && phantom_nodes_vector.size() >= MIN_LEGS_FOR_PARALLEL_SEARCH)
+        {
+            ParallelSearchWithUTurn(phantom_nodes_vector, raw_route_data);
+            return;
+        }
+
         engine_working_data.InitializeOrClearFirstThreadLocalStorage(
             super::facade->GetNumberOfNodes());
         engine_working_data.InitializeOrClearSecondThreadLocalStorage(
@@ -3,7 +3,8 @@
 
 #include <boost/thread/tss.hpp>
 
-#include "util/binary_heap.hpp"
+#include "engine/map_matching/hidden_markov_model.hpp"
+#include "util/search_heap.hpp"
 #include "util/typedefs.hpp"
 
 namespace osrm
@@ -17,24 +18,47 @@ struct HeapData
     /* explicit */ HeapData(NodeID p) : parent(p) {}
 };
 
+// The many to many searches also track the length of the path in decimeters
+struct ManyToManyHeapData : HeapData
+{
+    EdgeLength length;
+    ManyToManyHeapData(NodeID p, EdgeLength length) : HeapData(p), length(length) {}
+};
+
 struct SearchEngineData
 {
     using QueryHeap =
-        util::BinaryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+        util::SearchHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
+    using ManyToManyQueryHeap = util::SearchHeap<NodeID,
+                                                 NodeID,
+                                                 int,
+                                                 ManyToManyHeapData,
+                                                 util::UnorderedMapStorage<NodeID, int>>;
+    using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
+
+    using HiddenMarkovModelPtr = boost::thread_specific_ptr<map_matching::HiddenMarkovModel>;
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
     static SearchEngineHeapPtr reverse_heap_2;
     static SearchEngineHeapPtr forward_heap_3;
     static SearchEngineHeapPtr reverse_heap_3;
+    static ManyToManyHeapPtr many_to_many_heap;
+    static HiddenMarkovModelPtr hidden_markov_model;
 
     void InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    void InitializeOrClearManyToManyThreadLocalStorage(const unsigned number_of_nodes);
+
+    // the model keeps its buffers between requests, it is laid out anew by Reset
+    void InitializeHiddenMarkovModelThreadLocalStorage();
 };
 }
 }
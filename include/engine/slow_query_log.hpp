@@ -0,0 +1,71 @@
+#ifndef ENGINE_SLOW_QUERY_LOG_HPP
+#define ENGINE_SLOW_QUERY_LOG_HPP
+
+#include "engine/query_trace.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// A query captured by osrm-routed because it was slow or sampled
+struct SlowQueryRecord
+{
+    // assigned by the log, increasing over the lifetime of the log file
+    std::uint64_t sequence_number = 0;
+    // seconds since the epoch
+    std::uint64_t timestamp = 0;
+    // base path of the dataset that answered the query, empty for shared memory and images
+    std::string dataset;
+    std::string service;
+    // everything after the service in the URL, e.g. 13.38,52.51;13.39,52.52?steps=true
+    std::string query;
+    double milliseconds = 0;
+    bool sampled = false;
+    // the settled nodes did not fit into a slot of the log and were dropped
+    bool truncated = false;
+    QueryTrace trace;
+};
+
+// Bounded ring buffer of query records in a single file. The file holds a header followed by a
+// fixed number of equally sized slots, record n is written into slot n % number_of_slots and
+// overwrites the oldest record. Records which do not fit into a slot lose their settled nodes.
+class SlowQueryLog
+{
+  public:
+    // Opens the log for writing, a log with a different layout is replaced
+    SlowQueryLog(const boost::filesystem::path &path,
+                 const std::uint32_t number_of_slots,
+                 const std::uint64_t slot_size);
+
+    SlowQueryLog(const SlowQueryLog &) = delete;
+    SlowQueryLog &operator=(const SlowQueryLog &) = delete;
+
+    // Safe to call from several threads
+    void Write(SlowQueryRecord record);
+
+    // Upper bound of the settled nodes a slot holds, so the trace can stop recording there
+    std::uint64_t GetMaxSettledNodes() const;
+
+    // All records of the log, oldest first
+    static std::vector<SlowQueryRecord> Read(const boost::filesystem::path &path);
+
+  private:
+    std::mutex write_mutex;
+    boost::filesystem::fstream log_stream;
+    std::uint32_t number_of_slots;
+    std::uint64_t slot_size;
+    std::uint64_t next_sequence_number;
+};
+}
+}
+
+#endif // ENGINE_SLOW_QUERY_LOG_HPP
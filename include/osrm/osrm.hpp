@@ -31,6 +31,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include "engine/response_writer.hpp"
+
 #include <memory>
 #include <string>
 
@@ -38,12 +40,14 @@ namespace osrm
 {
 namespace json = util::json;
 using engine::EngineConfig;
+using engine::ResponseWriter;
 using engine::api::RouteParameters;
 using engine::api::TableParameters;
 using engine::api::NearestParameters;
 using engine::api::TripParameters;
 using engine::api::MatchParameters;
 using engine::api::TileParameters;
+using engine::api::FacilitiesParameters;
 
 /**
  * Represents a Open Source Routing Machine with access to its services.
@@ -56,6 +60,7 @@ using engine::api::TileParameters;
  *  - Trip: shortest round trip between coordinates
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
+ *  - Facilities: nearest facilities by travel time
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
  */
@@ -94,6 +99,23 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result);
 
+    /**
+     * Distance tables for coordinates, streamed while they are computed.
+     *
+     * Tables with durations only are computed and rendered in blocks of rows, so the memory of
+     * a query is bounded by the block size. The writer receives consecutive pieces of the JSON
+     * response, all other tables are rendered at once and handed to the writer in one piece.
+     *
+     * \param parameters table query specific parameters
+     * \param result holds the error if the query failed, nothing is written in that case
+     * \param writer receives the rendered response
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters, json::Object and ResponseWriter
+     */
+    Status Table(const TableParameters &parameters,
+                 json::Object &result,
+                 const ResponseWriter &writer);
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -130,6 +152,15 @@ class OSRM final
      */
     Status Tile(const TileParameters &parameters, std::string &result);
 
+    /**
+     * Facilities: nearest facilities by travel time
+     *
+     * \param parameters facilities query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, FacilitiesParameters and json::Object
+     */
+    Status Facilities(const FacilitiesParameters &parameters, json::Object &result);
+
   private:
     std::unique_ptr<engine::Engine> engine_;
 };
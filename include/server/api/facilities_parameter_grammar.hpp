@@ -0,0 +1,80 @@
+#ifndef FACILITIES_PARAMETERS_GRAMMAR_HPP
+#define FACILITIES_PARAMETERS_GRAMMAR_HPP
+
+#include "server/api/base_parameters_grammar.hpp"
+#include "engine/api/facilities_parameters.hpp"
+
+#include <boost/spirit/include/phoenix.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+namespace
+{
+namespace ph = boost::phoenix;
+namespace qi = boost::spirit::qi;
+}
+
+template <typename Iterator = std::string::iterator,
+          typename Signature = void(engine::api::FacilitiesParameters &)>
+struct FacilitiesParametersGrammar final : public BaseParametersGrammar<Iterator, Signature>
+{
+    using BaseGrammar = BaseParametersGrammar<Iterator, Signature>;
+
+    FacilitiesParametersGrammar() : BaseGrammar(root_rule)
+    {
+#ifdef BOOST_HAS_LONG_LONG
+        if (std::is_same<std::size_t, unsigned long long>::value)
+            size_t_ = qi::ulong_long;
+        else
+            size_t_ = qi::ulong_;
+#else
+        size_t_ = qi::ulong_;
+#endif
+
+        sources_rule =
+            qi::lit("sources=") >
+            (size_t_ %
+             ';')[ph::bind(&engine::api::FacilitiesParameters::sources, qi::_r1) = qi::_1];
+
+        destinations_rule =
+            qi::lit("destinations=") >
+            (size_t_ %
+             ';')[ph::bind(&engine::api::FacilitiesParameters::destinations, qi::_r1) = qi::_1];
+
+        number_rule = qi::lit("number=") >
+                      qi::uint_[ph::bind(&engine::api::FacilitiesParameters::number_of_results,
+                                         qi::_r1) = qi::_1];
+
+        facility_set_rule =
+            qi::lit("facility_set=") >
+            qi::as_string[+qi::char_("a-zA-Z0-9_-")]
+                         [ph::bind(&engine::api::FacilitiesParameters::facility_set, qi::_r1) =
+                              qi::_1];
+
+        facilities_rule = sources_rule(qi::_r1) | destinations_rule(qi::_r1) |
+                          number_rule(qi::_r1) | facility_set_rule(qi::_r1);
+
+        root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
+                    -('?' > (facilities_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
+    }
+
+  private:
+    qi::rule<Iterator, Signature> root_rule;
+    qi::rule<Iterator, Signature> facilities_rule;
+    qi::rule<Iterator, Signature> sources_rule;
+    qi::rule<Iterator, Signature> destinations_rule;
+    qi::rule<Iterator, Signature> number_rule;
+    qi::rule<Iterator, Signature> facility_set_rule;
+    qi::rule<Iterator, std::size_t()> size_t_;
+};
+}
+}
+}
+
+#endif
@@ -33,13 +33,19 @@ struct MatchParametersGrammar final : public RouteParametersGrammar<Iterator, Si
             (qi::uint_ %
              ';')[ph::bind(&engine::api::MatchParameters::timestamps, qi::_r1) = qi::_1];
 
+        tidy_rule = qi::lit("tidy=") >
+                    qi::bool_[ph::bind(&engine::api::MatchParameters::tidy, qi::_r1) = qi::_1];
+
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
-                    -('?' > (timestamps_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
+                    -('?' > (timestamps_rule(qi::_r1) | tidy_rule(qi::_r1) |
+                             BaseGrammar::base_rule(qi::_r1)) %
+                                '&');
     }
 
   private:
     qi::rule<Iterator, Signature> root_rule;
     qi::rule<Iterator, Signature> timestamps_rule;
+    qi::rule<Iterator, Signature> tidy_rule;
 };
 }
 }
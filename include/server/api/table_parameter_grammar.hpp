@@ -48,7 +48,31 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
             (qi::lit("all") |
              (size_t_ % ';')[ph::bind(&engine::api::TableParameters::sources, qi::_r1) = qi::_1]);
 
-        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1);
+        max_duration_rule =
+            qi::lit("max_duration=") >
+            qi::double_[ph::bind(&engine::api::TableParameters::max_duration, qi::_r1) = qi::_1];
+
+        max_distance_rule =
+            qi::lit("max_distance=") >
+            qi::double_[ph::bind(&engine::api::TableParameters::max_distance, qi::_r1) = qi::_1];
+
+        approximate_rule =
+            qi::lit("approximate=") >
+            qi::bool_[ph::bind(&engine::api::TableParameters::approximate, qi::_r1) = qi::_1];
+
+        annotations_type.add("duration", engine::api::TableParameters::AnnotationsType::Duration)(
+            "distance", engine::api::TableParameters::AnnotationsType::Distance)(
+            "duration,distance", engine::api::TableParameters::AnnotationsType::All)(
+            "distance,duration", engine::api::TableParameters::AnnotationsType::All);
+
+        annotations_rule =
+            qi::lit("annotations=") >
+            annotations_type[ph::bind(&engine::api::TableParameters::annotations, qi::_r1) =
+                                 qi::_1];
+
+        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1) |
+                     max_duration_rule(qi::_r1) | max_distance_rule(qi::_r1) |
+                     approximate_rule(qi::_r1) | annotations_rule(qi::_r1);
 
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (table_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
@@ -59,7 +83,12 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
     qi::rule<Iterator, Signature> table_rule;
     qi::rule<Iterator, Signature> sources_rule;
     qi::rule<Iterator, Signature> destinations_rule;
+    qi::rule<Iterator, Signature> max_duration_rule;
+    qi::rule<Iterator, Signature> max_distance_rule;
+    qi::rule<Iterator, Signature> approximate_rule;
+    qi::rule<Iterator, Signature> annotations_rule;
     qi::rule<Iterator, std::size_t()> size_t_;
+    qi::symbols<char, engine::api::TableParameters::AnnotationsType> annotations_type;
 };
 }
 }
@@ -24,6 +24,8 @@ class reply
         internal_server_error = 500
     } status;
 
+    // chunked replies are sent as HTTP/1.1, all others as HTTP/1.0
+    bool chunked;
     std::vector<header> headers;
     std::vector<boost::asio::const_buffer> to_buffers();
     std::vector<boost::asio::const_buffer> headers_to_buffers();
@@ -18,6 +18,8 @@ struct request
     std::string referrer;
     std::string agent;
     boost::asio::ip::address endpoint;
+    unsigned http_major_version = 1;
+    unsigned http_minor_version = 0;
 };
 }
 }
@@ -0,0 +1,64 @@
+#ifndef REPLY_STREAM_HPP
+#define REPLY_STREAM_HPP
+
+#include "server/http/compression_type.hpp"
+#include "server/http/reply.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// Sends a reply while its content is still being computed. Nothing is sent before Start, so a
+// request can still be answered with a regular reply until then. HTTP/1.1 clients get the
+// content in chunks, HTTP/1.0 clients until the connection is closed. The socket is written
+// synchronously, which bounds the buffered content by the size of a single Write. The engine
+// releases the shared memory while a piece is written. A client that does not take a piece
+// within 30 seconds aborts the stream, so it holds the thread of its request at most that long.
+class ReplyStream
+{
+  public:
+    ReplyStream(boost::asio::ip::tcp::socket &socket,
+                const http::compression_type compression,
+                const bool chunked);
+    ReplyStream(const ReplyStream &) = delete;
+    ReplyStream &operator=(const ReplyStream &) = delete;
+
+    bool IsStarted() const { return started; }
+
+    // Sends the status line and the headers of the reply, its content is not sent.
+    // All three throw boost::system::system_error if the client is gone or too slow.
+    void Start(http::reply &reply);
+
+    void Write(const char *data, const std::size_t size);
+
+    // Sends what is left in the compressor and the end of the chunked content
+    void Finish();
+
+  private:
+    struct CompressedSink;
+
+    // never throws, as it is called from the compressor, errors are kept for ThrowOnError
+    void WriteChunk(const char *data, const std::size_t size);
+    // writes all buffers unless the send timeout expires first, which sets error to timed_out
+    void Send(std::vector<boost::asio::const_buffer> buffers);
+    void ThrowOnError() const;
+
+    boost::asio::ip::tcp::socket &socket;
+    const http::compression_type compression;
+    const bool chunked;
+    bool started;
+    boost::system::error_code error;
+    std::unique_ptr<boost::iostreams::filtering_ostream> compressor;
+};
+}
+}
+
+#endif // REPLY_STREAM_HPP
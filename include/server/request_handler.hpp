@@ -3,6 +3,8 @@
 
 #include "server/service_handler.hpp"
 
+#include <map>
+#include <memory>
 #include <string>
 
 namespace osrm
@@ -16,6 +18,8 @@ class reply;
 struct request;
 }
 
+class ReplyStream;
+
 class RequestHandler
 {
 
@@ -24,12 +28,23 @@ class RequestHandler
     RequestHandler(const RequestHandler &) = delete;
     RequestHandler &operator=(const RequestHandler &) = delete;
 
-    void RegisterServiceHandler(std::unique_ptr<ServiceHandler> service_handler);
+    // Requests with an unregistered profile go to the service handler of the empty profile
+    void RegisterServiceHandler(const std::string &profile,
+                                std::unique_ptr<ServiceHandler> service_handler);
+
+    // Streamed responses are sent through the reply stream, current_reply is only filled if the
+    // reply stream was not started
+    void HandleRequest(const http::request &current_request,
+                       http::reply &current_reply,
+                       ReplyStream &reply_stream);
 
-    void HandleRequest(const http::request &current_request, http::reply &current_reply);
+    // Request counts and mean latencies per profile
+    void WriteMetrics() const;
 
   private:
-    std::unique_ptr<ServiceHandler> service_handler;
+    ServiceHandler *GetServiceHandler(const std::string &profile) const;
+
+    std::map<std::string, std::unique_ptr<ServiceHandler>> service_handlers;
 };
 }
 }
@@ -86,11 +86,14 @@ class Server
 
     void Stop() { io_service.stop(); }
 
-    void RegisterServiceHandler(std::unique_ptr<ServiceHandler> service_handler_)
+    void RegisterServiceHandler(const std::string &profile,
+                                std::unique_ptr<ServiceHandler> service_handler_)
     {
-        request_handler.RegisterServiceHandler(std::move(service_handler_));
+        request_handler.RegisterServiceHandler(profile, std::move(service_handler_));
     }
 
+    void WriteMetrics() const { request_handler.WriteMetrics(); }
+
   private:
     void HandleAccept(const boost::system::error_code &e)
     {
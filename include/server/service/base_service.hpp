@@ -1,6 +1,7 @@
 #ifndef SERVER_SERVICE_BASE_SERVICE_HPP
 #define SERVER_SERVICE_BASE_SERVICE_HPP
 
+#include "engine/response_writer.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/coordinate.hpp"
@@ -28,6 +29,16 @@ class BaseService
     virtual engine::Status
     RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) = 0;
 
+    // Services that can stream their response render it through the writer on success.
+    // All others fill result like RunQuery and write nothing.
+    virtual engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                             std::string &query,
+                                             ResultT &result,
+                                             const engine::ResponseWriter &)
+    {
+        return RunQuery(prefix_length, query, result);
+    }
+
     virtual unsigned GetVersion() = 0;
 
   protected:
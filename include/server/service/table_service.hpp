@@ -25,6 +25,11 @@ class TableService final : public BaseService
     engine::Status
     RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) final override;
 
+    engine::Status RunStreamingQuery(std::size_t prefix_length,
+                                     std::string &query,
+                                     ResultT &result,
+                                     const engine::ResponseWriter &writer) final override;
+
     unsigned GetVersion() final override { return 1; }
 };
 }
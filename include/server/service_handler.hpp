@@ -3,8 +3,17 @@
 
 #include "server/service/base_service.hpp"
 
+#include "engine/slow_query_log.hpp"
+#include "util/performance_counters.hpp"
+
 #include "osrm/osrm.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 
 namespace osrm
@@ -23,17 +32,64 @@ namespace api
 struct ParsedURL;
 }
 
+// Hardware events of the queries of a service, only counted with ENABLE_PERF_COUNTERS
+struct ServicePerformance
+{
+    std::uint64_t number_of_queries = 0;
+    util::PerformanceCounterValues events;
+};
+
+// Queries slower than the threshold and a random sample of all queries are written into the log
+// together with their trace
+struct SlowQueryCapture
+{
+    std::shared_ptr<engine::SlowQueryLog> log;
+    double threshold_milliseconds;
+    double sample_rate;
+    bool record_settled_nodes;
+};
+
+struct ServiceMetrics
+{
+    std::uint64_t number_of_requests;
+    std::uint64_t number_of_errors;
+    std::uint64_t total_microseconds;
+    std::map<std::string, ServicePerformance> performance_per_service;
+};
+
+// Services of a single dataset
 class ServiceHandler
 {
   public:
     ServiceHandler(osrm::EngineConfig &config);
     using ResultT = service::BaseService::ResultT;
 
-    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result);
+    // Streamed responses are rendered through the writer, see BaseService::RunStreamingQuery
+    engine::Status
+    RunQuery(api::ParsedURL parsed_url, ResultT &result, const engine::ResponseWriter &writer);
+
+    ServiceMetrics GetMetrics() const;
+
+    // Every query is traced while capturing, only slow and sampled ones are written
+    void EnableSlowQueryCapture(SlowQueryCapture capture);
 
   private:
+    void CaptureSlowQuery(const api::ParsedURL &parsed_url,
+                          const double milliseconds,
+                          engine::QueryTrace trace) const;
+
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
     OSRM routing_machine;
+    // base path of the dataset, empty if it is loaded from shared memory or an image
+    std::string dataset;
+    SlowQueryCapture slow_query_capture;
+
+    std::atomic<std::uint64_t> number_of_requests{0};
+    std::atomic<std::uint64_t> number_of_errors{0};
+    std::atomic<std::uint64_t> total_microseconds{0};
+
+    mutable std::mutex performance_mutex;
+    std::map<std::string, ServicePerformance> performance_per_service;
 };
 }
 }
@@ -0,0 +1,321 @@
+#ifndef DATASET_IMAGE_HPP
+#define DATASET_IMAGE_HPP
+
+#include "storage/shared_datatype.hpp"
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
+#include "util/io.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+// A dataset image holds the SharedDataLayout and the data block exactly as osrm-datastore lays
+// them out in shared memory, canaries included:
+//
+//   fingerprint | header | layout | zero padding | data block
+//
+// The data block starts at a page boundary so it can be mapped directly. Compressed images
+// store the data block as independently deflated blocks instead, so they can be inflated in
+// parallel:
+//
+//   fingerprint | header | layout | block index | compressed blocks
+const constexpr std::uint64_t IMAGE_DATA_OFFSET = 4096;
+// uncompressed size of the blocks of compressed images
+const constexpr std::uint32_t IMAGE_BLOCK_SIZE = 4 * 1024 * 1024;
+// Images refer to the .fileIndex by its file name, the leaf file ships in the same directory as
+// the image. The path block is padded to this size so a loader can store the resolved path.
+const constexpr std::uint64_t IMAGE_FILE_INDEX_PATH_SIZE = 4096;
+
+struct DatasetImageHeader
+{
+    // uncompressed bytes per block, 0 for images that are not compressed
+    std::uint32_t block_size;
+    std::uint32_t reserved;
+    std::uint64_t number_of_blocks;
+};
+
+struct CompressedImageBlock
+{
+    // absolute position in the image file
+    std::uint64_t offset;
+    std::uint64_t size;
+    // of the uncompressed block
+    std::uint32_t crc;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(util::FingerPrint) + sizeof(DatasetImageHeader) + sizeof(SharedDataLayout) <=
+                  IMAGE_DATA_OFFSET,
+              "layout does not fit in front of the image data");
+
+// block_size 0 writes the data block as is, otherwise it is compressed in blocks of block_size
+inline void writeDatasetImage(const boost::filesystem::path &image_path,
+                              const SharedDataLayout &layout,
+                              const char *data,
+                              const std::uint32_t block_size = 0)
+{
+    boost::filesystem::ofstream image_stream(image_path, std::ios::binary);
+    if (!image_stream)
+    {
+        throw util::exception("Could not open " + image_path.string() + " for writing.");
+    }
+
+    const auto data_size = layout.GetSizeOfLayout();
+
+    DatasetImageHeader header{block_size, 0, 0};
+    if (block_size > 0)
+    {
+        header.number_of_blocks = (data_size + block_size - 1) / block_size;
+    }
+
+    util::writeFingerprint(image_stream);
+    image_stream.write(reinterpret_cast<const char *>(&header), sizeof(DatasetImageHeader));
+    image_stream.write(reinterpret_cast<const char *>(&layout), sizeof(SharedDataLayout));
+
+    if (block_size == 0)
+    {
+        const std::vector<char> padding(IMAGE_DATA_OFFSET - sizeof(util::FingerPrint) -
+                                            sizeof(DatasetImageHeader) - sizeof(SharedDataLayout),
+                                        0);
+        image_stream.write(padding.data(), padding.size());
+        image_stream.write(data, data_size);
+    }
+    else
+    {
+        std::vector<std::vector<char>> compressed_blocks(header.number_of_blocks);
+        std::vector<CompressedImageBlock> block_index(header.number_of_blocks);
+        const auto compress_block = [&](const std::uint64_t block) {
+            const auto block_begin = block * block_size;
+            const auto size = std::min<std::uint64_t>(block_size, data_size - block_begin);
+            const auto *block_data = reinterpret_cast<const Bytef *>(data + block_begin);
+
+            auto compressed_size = compressBound(size);
+            compressed_blocks[block].resize(compressed_size);
+            if (compress2(reinterpret_cast<Bytef *>(compressed_blocks[block].data()),
+                          &compressed_size,
+                          block_data,
+                          size,
+                          Z_DEFAULT_COMPRESSION) != Z_OK)
+            {
+                throw util::exception("Failed to compress " + image_path.string());
+            }
+            compressed_blocks[block].resize(compressed_size);
+            block_index[block].crc = crc32(crc32(0L, Z_NULL, 0), block_data, size);
+        };
+        tbb::parallel_for(std::uint64_t{0}, header.number_of_blocks, compress_block);
+
+        std::uint64_t offset = sizeof(util::FingerPrint) + sizeof(DatasetImageHeader) +
+                               sizeof(SharedDataLayout) +
+                               header.number_of_blocks * sizeof(CompressedImageBlock);
+        for (const auto block : util::irange<std::uint64_t>(0, header.number_of_blocks))
+        {
+            block_index[block].offset = offset;
+            block_index[block].size = compressed_blocks[block].size();
+            offset += compressed_blocks[block].size();
+        }
+
+        image_stream.write(reinterpret_cast<const char *>(block_index.data()),
+                           block_index.size() * sizeof(CompressedImageBlock));
+        for (const auto &compressed_block : compressed_blocks)
+        {
+            image_stream.write(compressed_block.data(), compressed_block.size());
+        }
+    }
+
+    if (!image_stream)
+    {
+        throw util::exception("Failed to write " + image_path.string());
+    }
+}
+
+inline DatasetImageHeader readDatasetImageHeader(const boost::filesystem::path &image_path,
+                                                 std::istream &image_stream,
+                                                 SharedDataLayout &layout)
+{
+    if (!util::readAndCheckFingerprint(image_stream))
+    {
+        throw util::exception("Fingerprint of " + image_path.string() + " does not match");
+    }
+
+    DatasetImageHeader header;
+    image_stream.read(reinterpret_cast<char *>(&header), sizeof(DatasetImageHeader));
+    image_stream.read(reinterpret_cast<char *>(&layout), sizeof(SharedDataLayout));
+    if (!image_stream ||
+        (header.block_size == 0 &&
+         boost::filesystem::file_size(image_path) != IMAGE_DATA_OFFSET + layout.GetSizeOfLayout()))
+    {
+        throw util::exception(image_path.string() + " is corrupt");
+    }
+    return header;
+}
+
+// Inflates the blocks of a compressed image in parallel and checks them against their CRCs
+inline void readCompressedDatasetImage(const boost::filesystem::path &image_path,
+                                       std::istream &image_stream,
+                                       const DatasetImageHeader &header,
+                                       const SharedDataLayout &layout,
+                                       char *data)
+{
+    const auto data_size = layout.GetSizeOfLayout();
+    if (header.number_of_blocks != (data_size + header.block_size - 1) / header.block_size)
+    {
+        throw util::exception(image_path.string() + " is corrupt");
+    }
+
+    std::vector<CompressedImageBlock> block_index(header.number_of_blocks);
+    image_stream.read(reinterpret_cast<char *>(block_index.data()),
+                      block_index.size() * sizeof(CompressedImageBlock));
+    if (!image_stream)
+    {
+        throw util::exception("Failed to read " + image_path.string());
+    }
+
+    // the compressed blocks are stored back to back directly behind the index
+    const std::uint64_t first_offset = image_stream.tellg();
+    const std::uint64_t compressed_size = boost::filesystem::file_size(image_path) - first_offset;
+    std::vector<char> compressed_data(compressed_size);
+    image_stream.read(compressed_data.data(), compressed_size);
+    if (!image_stream)
+    {
+        throw util::exception("Failed to read " + image_path.string());
+    }
+
+    const auto inflate_block = [&](const std::uint64_t block) {
+        const auto &entry = block_index[block];
+        if (entry.offset < first_offset ||
+            entry.offset - first_offset + entry.size > compressed_size)
+        {
+            throw util::exception(image_path.string() + " is corrupt");
+        }
+
+        const auto block_begin = block * header.block_size;
+        const auto size = std::min<std::uint64_t>(header.block_size, data_size - block_begin);
+        auto *block_data = reinterpret_cast<Bytef *>(data + block_begin);
+        const auto *compressed_block =
+            reinterpret_cast<const Bytef *>(&compressed_data[entry.offset - first_offset]);
+
+        uLongf inflated_size = size;
+        const auto result = uncompress(block_data, &inflated_size, compressed_block, entry.size);
+        if (result != Z_OK || inflated_size != size ||
+            crc32(crc32(0L, Z_NULL, 0), block_data, size) != entry.crc)
+        {
+            throw util::exception("Block " + std::to_string(block) + " of " + image_path.string() +
+                                  " is corrupt");
+        }
+    };
+    tbb::parallel_for(std::uint64_t{0}, header.number_of_blocks, inflate_block);
+}
+
+// Resolves the leaf file of an image against the directory of the image
+inline boost::filesystem::path resolveImageFileIndexPath(const boost::filesystem::path &image_path,
+                                                         SharedDataLayout &layout,
+                                                         char *data)
+{
+    const boost::filesystem::path file_name(
+        layout.GetBlockPtr<char>(data, SharedDataLayout::FILE_INDEX_PATH));
+    return boost::filesystem::absolute(image_path).parent_path() / file_name;
+}
+
+// Reads the data block into memory given by allocate_data, with a single sequential read
+inline void readDatasetImage(const boost::filesystem::path &image_path,
+                             SharedDataLayout &layout,
+                             const std::function<char *(std::uint64_t)> &allocate_data)
+{
+    boost::filesystem::ifstream image_stream(image_path, std::ios::binary);
+    if (!image_stream)
+    {
+        throw util::exception("Could not open " + image_path.string() + " for reading.");
+    }
+
+    const auto header = readDatasetImageHeader(image_path, image_stream, layout);
+
+    char *data = allocate_data(layout.GetSizeOfLayout());
+    if (header.block_size > 0)
+    {
+        readCompressedDatasetImage(image_path, image_stream, header, layout, data);
+        return;
+    }
+
+    image_stream.seekg(IMAGE_DATA_OFFSET);
+    image_stream.read(data, layout.GetSizeOfLayout());
+    if (!image_stream)
+    {
+        throw util::exception("Failed to read " + image_path.string());
+    }
+}
+
+// Maps the data block of a dataset image copy-on-write, pages are loaded on first access.
+// Compressed images can not be mapped and are inflated into process memory instead.
+class MappedDatasetImage
+{
+  public:
+    explicit MappedDatasetImage(const boost::filesystem::path &image_path) : image_path(image_path)
+    {
+        boost::filesystem::ifstream image_stream(image_path, std::ios::binary);
+        if (!image_stream)
+        {
+            throw util::exception("Could not open " + image_path.string() + " for reading.");
+        }
+        const auto header = readDatasetImageHeader(image_path, image_stream, layout);
+
+        if (header.block_size > 0)
+        {
+            inflated_data.resize(layout.GetSizeOfLayout());
+            readCompressedDatasetImage(
+                image_path, image_stream, header, layout, inflated_data.data());
+            return;
+        }
+
+        mapping = boost::interprocess::file_mapping(image_path.string().c_str(),
+                                                    boost::interprocess::read_only);
+        region = boost::interprocess::mapped_region(mapping,
+                                                    boost::interprocess::copy_on_write,
+                                                    IMAGE_DATA_OFFSET,
+                                                    layout.GetSizeOfLayout());
+    }
+
+    SharedDataLayout *GetLayout() { return &layout; }
+
+    char *GetData()
+    {
+        if (!inflated_data.empty())
+        {
+            return inflated_data.data();
+        }
+        return static_cast<char *>(region.get_address());
+    }
+
+    boost::filesystem::path GetFileIndexPath()
+    {
+        return resolveImageFileIndexPath(image_path, layout, GetData());
+    }
+
+  private:
+    boost::filesystem::path image_path;
+    SharedDataLayout layout;
+    boost::interprocess::file_mapping mapping;
+    boost::interprocess::mapped_region region;
+    std::vector<char> inflated_data;
+};
+}
+}
+
+#endif // DATASET_IMAGE_HPP
@@ -23,14 +23,10 @@ struct SharedDataLayout
         NAME_OFFSETS = 0,
         NAME_BLOCKS,
         NAME_CHAR_LIST,
-        NAME_ID_LIST,
-        VIA_NODE_LIST,
+        ORIGINAL_EDGE_DATA,
         GRAPH_NODE_LIST,
         GRAPH_EDGE_LIST,
         COORDINATE_LIST,
-        TURN_INSTRUCTION,
-        ENTRY_CLASSID,
-        TRAVEL_MODE,
         R_SEARCH_TREE,
         GEOMETRIES_INDEX,
         GEOMETRIES_LIST,
@@ -48,6 +44,7 @@ struct SharedDataLayout
         BEARING_BLOCKS,
         BEARING_VALUES,
         ENTRY_CLASS,
+        GRAPH_EDGE_LENGTHS,
         NUM_BLOCKS
     };
 
@@ -127,7 +124,10 @@ enum SharedDataType
     LAYOUT_2,
     DATA_2,
     LAYOUT_NONE,
-    DATA_NONE
+    DATA_NONE,
+    CURRENT_CLOSURES,
+    CLOSURES_1,
+    CLOSURES_2
 };
 
 struct SharedDataTimestamp
@@ -136,6 +136,20 @@ struct SharedDataTimestamp
     SharedDataType data;
     unsigned timestamp;
 };
+
+// Points to the closure region written last by osrm-closures
+struct SharedClosuresTimestamp
+{
+    SharedDataType region;
+    unsigned timestamp;
+};
+
+// Start of a closure region, followed by number_of_closed_nodes sorted edge-based node ids
+struct SharedClosuresHeader
+{
+    unsigned checksum;
+    std::uint32_t number_of_closed_nodes;
+};
 }
 }
 
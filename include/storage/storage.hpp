@@ -28,10 +28,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef STORAGE_HPP
 #define STORAGE_HPP
 
+#include "storage/shared_datatype.hpp"
 #include "storage/storage_config.hpp"
 
 #include <boost/filesystem/path.hpp>
 
+#include <cstdint>
+#include <functional>
 #include <string>
 
 namespace osrm
@@ -43,8 +46,20 @@ class Storage
   public:
     Storage(StorageConfig config);
     int Run();
+    // loads a dataset image written by WriteImage into shared memory
+    int RunFromImage(const boost::filesystem::path &image_path);
+    // writes the shared memory layout and data block to a file instead of shared memory
+    void WriteImage(const boost::filesystem::path &image_path, const bool compress);
 
   private:
+    int Publish(const std::function<void(SharedDataLayout &, SharedDataType)> &load);
+    // file_index_path is stored as the location of the leaf file, in a block of at least
+    // file_index_path_size bytes
+    void PopulateData(SharedDataLayout &layout,
+                      const boost::filesystem::path &file_index_path,
+                      const std::uint64_t file_index_path_size,
+                      const std::function<char *(std::uint64_t)> &allocate_data);
+
     StorageConfig config;
 };
 }
@@ -55,6 +55,7 @@ struct StorageConfig final
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
     boost::filesystem::path hsgr_data_path;
+    boost::filesystem::path edge_lengths_path;
     boost::filesystem::path nodes_data_path;
     boost::filesystem::path edges_data_path;
     boost::filesystem::path core_data_path;
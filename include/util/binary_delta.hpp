@@ -0,0 +1,289 @@
+#ifndef OSRM_UTIL_BINARY_DELTA_HPP
+#define OSRM_UTIL_BINARY_DELTA_HPP
+
+#include "util/exception.hpp"
+
+#include <boost/crc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Block level delta between two versions of a binary file, in the spirit of rsync: the blocks of
+// the old file are indexed by a rolling checksum, the new file is scanned byte by byte and every
+// block found in the old file becomes a copy instruction. Everything else is stored literally.
+//
+// A delta is a BinaryDeltaHeader followed by instructions, each starting with its
+// BinaryDeltaInstruction. Copy is followed by the offset in the old file and the length, Literal
+// by the length and the bytes, End terminates the delta.
+struct BinaryDeltaHeader
+{
+    std::uint64_t old_size;
+    std::uint64_t new_size;
+    std::uint32_t old_crc;
+    std::uint32_t new_crc;
+};
+
+enum class BinaryDeltaInstruction : std::uint8_t
+{
+    Copy,
+    Literal,
+    End
+};
+
+const constexpr std::size_t DEFAULT_DELTA_BLOCK_SIZE = 4096;
+
+inline std::uint32_t computeCRC32(const char *data, const std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+namespace detail
+{
+// rsync's weak checksum, can be moved along the data one byte at a time
+class RollingChecksum
+{
+  public:
+    RollingChecksum(const char *data, const std::size_t size) : size(size) { Reset(data); }
+
+    void Reset(const char *data)
+    {
+        a = 0;
+        b = 0;
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            const auto value = static_cast<unsigned char>(data[index]);
+            a += value;
+            b += static_cast<std::uint32_t>(size - index) * value;
+        }
+    }
+
+    void Roll(const char removed, const char added)
+    {
+        a = a - static_cast<unsigned char>(removed) + static_cast<unsigned char>(added);
+        b = b - static_cast<std::uint32_t>(size) * static_cast<unsigned char>(removed) + a;
+    }
+
+    std::uint32_t Get() const { return (a & 0xffff) | (b << 16); }
+
+  private:
+    std::size_t size;
+    std::uint32_t a;
+    std::uint32_t b;
+};
+
+class BinaryDeltaWriter
+{
+  public:
+    explicit BinaryDeltaWriter(std::ostream &delta_stream) : delta_stream(delta_stream) {}
+
+    // adjacent copies are merged into one instruction
+    void Copy(const std::uint64_t offset, const std::uint64_t length)
+    {
+        if (copy_length > 0 && copy_offset + copy_length == offset)
+        {
+            copy_length += length;
+            return;
+        }
+        FlushCopy();
+        copy_offset = offset;
+        copy_length = length;
+    }
+
+    void Literal(const char *data, const std::uint64_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        FlushCopy();
+        Write(BinaryDeltaInstruction::Literal);
+        Write(length);
+        delta_stream.write(data, length);
+    }
+
+    void End()
+    {
+        FlushCopy();
+        Write(BinaryDeltaInstruction::End);
+    }
+
+  private:
+    void FlushCopy()
+    {
+        if (copy_length == 0)
+        {
+            return;
+        }
+        Write(BinaryDeltaInstruction::Copy);
+        Write(copy_offset);
+        Write(copy_length);
+        copy_length = 0;
+    }
+
+    template <typename T> void Write(const T value)
+    {
+        delta_stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    std::ostream &delta_stream;
+    std::uint64_t copy_offset = 0;
+    std::uint64_t copy_length = 0;
+};
+}
+
+// Writes the instructions that turn old_data into new_data
+inline void writeBinaryDelta(const char *old_data,
+                             const std::size_t old_size,
+                             const char *new_data,
+                             const std::size_t new_size,
+                             std::ostream &delta_stream,
+                             const std::size_t block_size = DEFAULT_DELTA_BLOCK_SIZE)
+{
+    const BinaryDeltaHeader header{
+        old_size, new_size, computeCRC32(old_data, old_size), computeCRC32(new_data, new_size)};
+    delta_stream.write(reinterpret_cast<const char *>(&header), sizeof(BinaryDeltaHeader));
+
+    // only the blocks at multiples of block_size are indexed, the new file is searched at every
+    // offset so shifted data is found as well
+    std::unordered_map<std::uint32_t, std::vector<std::uint64_t>> old_blocks;
+    for (std::size_t offset = 0; offset + block_size <= old_size; offset += block_size)
+    {
+        old_blocks[detail::RollingChecksum(old_data + offset, block_size).Get()].push_back(offset);
+    }
+
+    detail::BinaryDeltaWriter writer(delta_stream);
+    std::size_t literal_begin = 0;
+    std::size_t position = 0;
+    if (new_size >= block_size && !old_blocks.empty())
+    {
+        detail::RollingChecksum checksum(new_data, block_size);
+        while (position + block_size <= new_size)
+        {
+            const auto candidates = old_blocks.find(checksum.Get());
+            bool found = false;
+            if (candidates != old_blocks.end())
+            {
+                for (const auto offset : candidates->second)
+                {
+                    if (std::memcmp(old_data + offset, new_data + position, block_size) == 0)
+                    {
+                        writer.Literal(new_data + literal_begin, position - literal_begin);
+                        writer.Copy(offset, block_size);
+                        found = true;
+                        break;
+                    }
+                }
+            }
+
+            if (found)
+            {
+                position += block_size;
+                literal_begin = position;
+                if (position + block_size <= new_size)
+                {
+                    checksum.Reset(new_data + position);
+                }
+            }
+            else
+            {
+                if (position + block_size < new_size)
+                {
+                    checksum.Roll(new_data[position], new_data[position + block_size]);
+                }
+                ++position;
+            }
+        }
+    }
+    writer.Literal(new_data + literal_begin, new_size - literal_begin);
+    writer.End();
+
+    if (!delta_stream)
+    {
+        throw exception("Failed to write binary delta");
+    }
+}
+
+// Reconstructs the new data from old_data and a delta, the checksums of both are verified
+inline void applyBinaryDelta(const char *old_data,
+                             const std::size_t old_size,
+                             std::istream &delta_stream,
+                             std::ostream &new_stream)
+{
+    const auto read = [&delta_stream](void *value, const std::size_t size) {
+        delta_stream.read(static_cast<char *>(value), size);
+        if (!delta_stream)
+        {
+            throw exception("Binary delta is truncated");
+        }
+    };
+
+    BinaryDeltaHeader header;
+    read(&header, sizeof(BinaryDeltaHeader));
+    if (header.old_size != old_size || header.old_crc != computeCRC32(old_data, old_size))
+    {
+        throw exception("Binary delta was not created for this file");
+    }
+
+    boost::crc_32_type new_crc;
+    std::uint64_t new_size = 0;
+    std::vector<char> literal;
+    BinaryDeltaInstruction instruction;
+    for (read(&instruction, sizeof(instruction)); instruction != BinaryDeltaInstruction::End;
+         read(&instruction, sizeof(instruction)))
+    {
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+        switch (instruction)
+        {
+        case BinaryDeltaInstruction::Copy:
+            read(&offset, sizeof(offset));
+            read(&length, sizeof(length));
+            if (offset > old_size || length > old_size - offset)
+            {
+                throw exception("Binary delta copies beyond the end of the file");
+            }
+            new_stream.write(old_data + offset, length);
+            new_crc.process_bytes(old_data + offset, length);
+            break;
+        case BinaryDeltaInstruction::Literal:
+            read(&length, sizeof(length));
+            if (length > header.new_size - new_size)
+            {
+                throw exception("Binary delta is corrupt");
+            }
+            literal.resize(length);
+            read(literal.data(), length);
+            new_stream.write(literal.data(), length);
+            new_crc.process_bytes(literal.data(), length);
+            break;
+        default:
+            throw exception("Binary delta is corrupt");
+        }
+        new_size += length;
+    }
+
+    if (!new_stream)
+    {
+        throw exception("Failed to write file reconstructed from binary delta");
+    }
+    if (new_size != header.new_size || new_crc.checksum() != header.new_crc)
+    {
+        throw exception("Checksum of file reconstructed from binary delta does not match");
+    }
+}
+}
+}
+
+#endif // OSRM_UTIL_BINARY_DELTA_HPP
@@ -1,6 +1,8 @@
 #ifndef BINARY_HEAP_H
 #define BINARY_HEAP_H
 
+#include "util/heap_statistics.hpp"
+
 #include <boost/assert.hpp>
 
 #include <algorithm>
@@ -103,6 +105,7 @@ class BinaryHeap
 
     void Clear()
     {
+        statistics.CountSearch();
         heap.resize(1);
         inserted_nodes.clear();
         heap[0].weight = std::numeric_limits<Weight>::min();
@@ -113,6 +116,8 @@ class BinaryHeap
 
     bool Empty() const { return 0 == Size(); }
 
+    HeapStatistics &GetStatistics() { return statistics; }
+
     void Insert(NodeID node, Weight weight, const Data &data)
     {
         HeapElement element;
@@ -144,6 +149,12 @@ class BinaryHeap
         return inserted_nodes[index].weight;
     }
 
+    Weight const &GetKey(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].weight;
+    }
+
     bool WasRemoved(const NodeID node) const
     {
         BOOST_ASSERT(WasInserted(node));
@@ -185,6 +196,7 @@ class BinaryHeap
         }
         inserted_nodes[removedIndex].key = 0;
         CheckHeap();
+        statistics.CountSettledNode(inserted_nodes[removedIndex].node);
         return inserted_nodes[removedIndex].node;
     }
 
@@ -234,6 +246,7 @@ class BinaryHeap
     std::vector<HeapNode> inserted_nodes;
     std::vector<HeapElement> heap;
     IndexStorage node_index;
+    HeapStatistics statistics;
 
     void Downheap(Key key)
     {
@@ -0,0 +1,166 @@
+#ifndef OSRM_UTIL_CELL_TABLE_HPP
+#define OSRM_UTIL_CELL_TABLE_HPP
+
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/io.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+static const std::uint32_t INVALID_CELL_ID = std::numeric_limits<std::uint32_t>::max();
+
+// Regular grid over the dataset, in fixed point coordinates
+struct CellGrid
+{
+    std::int32_t min_lon;
+    std::int32_t min_lat;
+    std::int32_t cell_size;
+    std::uint32_t columns;
+    std::uint32_t rows;
+};
+
+// Durations between representative points of grid cells, computed offline by osrm-celltable.
+// Only cells containing road network nodes get a representative. The radius of a cell is the
+// largest duration between its representative and any sampled point of the cell in either
+// direction, so rep(a) -> rep(b) approximates every route from cell a to cell b within
+// radius(a) + radius(b), as far as the samples cover the cells.
+class CellTable
+{
+  public:
+    CellTable() = default;
+
+    CellTable(const CellGrid grid_,
+              const unsigned checksum_,
+              std::vector<std::uint32_t> cell_ids_,
+              std::vector<EdgeWeight> radiuses_,
+              std::vector<EdgeWeight> durations_)
+        : grid(grid_), checksum(checksum_), cell_ids(std::move(cell_ids_)),
+          radiuses(std::move(radiuses_)), durations(std::move(durations_))
+    {
+        BOOST_ASSERT(cell_ids.size() == static_cast<std::size_t>(grid.columns) * grid.rows);
+        BOOST_ASSERT(durations.size() == radiuses.size() * radiuses.size());
+    }
+
+    unsigned GetCheckSum() const { return checksum; }
+
+    std::uint32_t GetNumberOfCells() const { return static_cast<std::uint32_t>(radiuses.size()); }
+
+    // Index of the grid cell containing coordinate, not necessarily populated
+    std::uint32_t GetGridCell(const Coordinate coordinate) const
+    {
+        const auto lon = static_cast<std::int32_t>(coordinate.lon) - grid.min_lon;
+        const auto lat = static_cast<std::int32_t>(coordinate.lat) - grid.min_lat;
+        if (lon < 0 || lat < 0)
+        {
+            return INVALID_CELL_ID;
+        }
+        const auto column = static_cast<std::uint32_t>(lon / grid.cell_size);
+        const auto row = static_cast<std::uint32_t>(lat / grid.cell_size);
+        if (column >= grid.columns || row >= grid.rows)
+        {
+            return INVALID_CELL_ID;
+        }
+        return row * grid.columns + column;
+    }
+
+    // Dense id of a populated grid cell or INVALID_CELL_ID
+    std::uint32_t GetCell(const std::uint32_t grid_cell) const
+    {
+        if (grid_cell == INVALID_CELL_ID)
+        {
+            return INVALID_CELL_ID;
+        }
+        return cell_ids[grid_cell];
+    }
+
+    // True for the same or directly adjacent grid cells
+    bool AreNeighbours(const std::uint32_t lhs_grid_cell, const std::uint32_t rhs_grid_cell) const
+    {
+        BOOST_ASSERT(lhs_grid_cell != INVALID_CELL_ID && rhs_grid_cell != INVALID_CELL_ID);
+        const auto lhs_column = static_cast<std::int64_t>(lhs_grid_cell % grid.columns);
+        const auto rhs_column = static_cast<std::int64_t>(rhs_grid_cell % grid.columns);
+        const auto lhs_row = static_cast<std::int64_t>(lhs_grid_cell / grid.columns);
+        const auto rhs_row = static_cast<std::int64_t>(rhs_grid_cell / grid.columns);
+        const auto column_distance = std::abs(lhs_column - rhs_column);
+        const auto row_distance = std::abs(lhs_row - rhs_row);
+        return column_distance <= 1 && row_distance <= 1;
+    }
+
+    EdgeWeight GetDuration(const std::uint32_t from_cell, const std::uint32_t to_cell) const
+    {
+        BOOST_ASSERT(from_cell < GetNumberOfCells() && to_cell < GetNumberOfCells());
+        return durations[static_cast<std::size_t>(from_cell) * radiuses.size() + to_cell];
+    }
+
+    EdgeWeight GetRadius(const std::uint32_t cell) const
+    {
+        BOOST_ASSERT(cell < GetNumberOfCells());
+        return radiuses[cell];
+    }
+
+    void Write(const boost::filesystem::path &path) const
+    {
+        boost::filesystem::ofstream output_stream(path, std::ios::binary);
+        if (!output_stream)
+        {
+            throw exception("Could not open " + path.string() + " for writing.");
+        }
+        writeFingerprint(output_stream);
+        output_stream.write(reinterpret_cast<const char *>(&grid), sizeof(CellGrid));
+        output_stream.write(reinterpret_cast<const char *>(&checksum), sizeof(unsigned));
+        serializeVector(output_stream, cell_ids);
+        serializeVector(output_stream, radiuses);
+        serializeVector(output_stream, durations);
+    }
+
+    void Read(const boost::filesystem::path &path)
+    {
+        boost::filesystem::ifstream input_stream(path, std::ios::binary);
+        if (!input_stream)
+        {
+            throw exception("Could not open " + path.string() + " for reading.");
+        }
+        if (!readAndCheckFingerprint(input_stream))
+        {
+            throw exception("Fingerprint of " + path.string() + " does not match");
+        }
+        input_stream.read(reinterpret_cast<char *>(&grid), sizeof(CellGrid));
+        input_stream.read(reinterpret_cast<char *>(&checksum), sizeof(unsigned));
+        deserializeVector(input_stream, cell_ids);
+        deserializeVector(input_stream, radiuses);
+        deserializeVector(input_stream, durations);
+        if (!input_stream || grid.cell_size <= 0 ||
+            cell_ids.size() != static_cast<std::size_t>(grid.columns) * grid.rows ||
+            durations.size() != radiuses.size() * radiuses.size())
+        {
+            throw exception(path.string() + " is corrupt");
+        }
+    }
+
+  private:
+    CellGrid grid{0, 0, 1, 0, 0};
+    unsigned checksum = 0;
+    // grid cell -> dense cell id, INVALID_CELL_ID for empty cells
+    std::vector<std::uint32_t> cell_ids;
+    std::vector<EdgeWeight> radiuses;
+    // row-major matrix of dense cell ids
+    std::vector<EdgeWeight> durations;
+};
+}
+}
+
+#endif // OSRM_UTIL_CELL_TABLE_HPP
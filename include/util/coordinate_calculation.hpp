@@ -5,6 +5,7 @@
 
 #include <boost/optional.hpp>
 
+#include <cstddef>
 #include <utility>
 
 namespace osrm
@@ -78,6 +79,32 @@ double perpendicularDistance(const Coordinate segment_source,
                              Coordinate &nearest_location,
                              double &ratio);
 
+// Batch versions of the functions above, vectorized with SSE2 where available. Their results
+// agree with the single pair functions to within 1e-8 meters plus 1e-12 of the distance.
+// For the segments of a polyline pass the coordinates and the coordinates shifted by one.
+
+//! distances[i] = haversineDistance(first_coordinates[i], second_coordinates[i])
+void haversineDistances(const Coordinate *first_coordinates,
+                        const Coordinate *second_coordinates,
+                        const std::size_t number_of_pairs,
+                        double *distances);
+
+//! distances[i] = greatCircleDistance(first_coordinates[i], second_coordinates[i])
+void greatCircleDistances(const Coordinate *first_coordinates,
+                          const Coordinate *second_coordinates,
+                          const std::size_t number_of_pairs,
+                          double *distances);
+
+//! distances[i] = perpendicularDistance(segment_sources[i], segment_targets[i], query_location,
+//!                                      nearest_locations[i], ratios[i])
+void perpendicularDistances(const Coordinate *segment_sources,
+                            const Coordinate *segment_targets,
+                            const std::size_t number_of_segments,
+                            const Coordinate query_location,
+                            double *distances,
+                            Coordinate *nearest_locations,
+                            double *ratios);
+
 Coordinate centroid(const Coordinate lhs, const Coordinate rhs);
 
 double bearing(const Coordinate first_coordinate, const Coordinate second_coordinate);
@@ -0,0 +1,33 @@
+#ifndef OSRM_UTIL_CPU_FEATURES_HPP
+#define OSRM_UTIL_CPU_FEATURES_HPP
+
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Instruction sets the SIMD kernels are compiled for, each one includes the ones before it
+enum class InstructionSet
+{
+    Scalar,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+// The best instruction set supported by the CPU and the operating system. Detected once on the
+// first call. The environment variable OSRM_INSTRUCTION_SET=scalar|sse4.2|avx2|avx512 caps the
+// result, e.g. to compare the kernels in benchmarks.
+InstructionSet getInstructionSet();
+
+// All instruction sets up to and including getInstructionSet(), starting with Scalar
+std::vector<InstructionSet> getSupportedInstructionSets();
+
+std::string toString(const InstructionSet instruction_set);
+}
+}
+
+#endif // OSRM_UTIL_CPU_FEATURES_HPP
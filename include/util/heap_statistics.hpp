@@ -0,0 +1,84 @@
+#ifndef UTIL_HEAP_STATISTICS_HPP
+#define UTIL_HEAP_STATISTICS_HPP
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Number of settled nodes the heaps of a trace may still record, shared by all of them
+struct SettledNodeLimit
+{
+    std::size_t remaining;
+    // a node was settled after the limit was used up
+    bool exceeded;
+};
+
+// Searches and settled nodes of a heap while it is traced
+struct HeapCounters
+{
+    std::uint64_t number_of_searches = 0;
+    std::uint64_t number_of_settled_nodes = 0;
+    // if set, settled nodes are appended until the limit is used up
+    std::vector<NodeID> *settled_nodes = nullptr;
+    SettledNodeLimit *limit = nullptr;
+};
+
+// Every search of a heap starts with Clear and settles nodes with DeleteMin. The heaps only count
+// them while counters are attached, which the query trace does for the heaps of traced queries.
+// Untraced searches pay for a single check of the pointer.
+class HeapStatistics
+{
+  public:
+    void CountSearch()
+    {
+        if (counters != nullptr)
+        {
+            ++counters->number_of_searches;
+        }
+    }
+
+    void CountSettledNode(const NodeID node)
+    {
+        if (counters != nullptr)
+        {
+            ++counters->number_of_settled_nodes;
+            if (counters->settled_nodes != nullptr)
+            {
+                RecordSettledNode(node);
+            }
+        }
+    }
+
+    // Counts into counters_ from now on, returns the counters attached before
+    HeapCounters *Attach(HeapCounters *counters_)
+    {
+        auto previous = counters;
+        counters = counters_;
+        return previous;
+    }
+
+  private:
+    void RecordSettledNode(const NodeID node)
+    {
+        if (counters->limit->remaining == 0)
+        {
+            counters->limit->exceeded = true;
+            return;
+        }
+        --counters->limit->remaining;
+        counters->settled_nodes->push_back(node);
+    }
+
+    HeapCounters *counters = nullptr;
+};
+}
+}
+
+#endif // UTIL_HEAP_STATISTICS_HPP
@@ -0,0 +1,166 @@
+#ifndef OSRM_UTIL_HUB_LABELS_HPP
+#define OSRM_UTIL_HUB_LABELS_HPP
+
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/simd_kernels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+
+// On-disk layout of a .hl file, all arrays follow the header in this order:
+//   std::uint64_t forward_offsets[number_of_nodes + 1]
+//   std::uint64_t backward_offsets[number_of_nodes + 1]
+//   NodeID        forward_hubs[number_of_forward_entries]
+//   EdgeWeight    forward_weights[number_of_forward_entries]
+//   NodeID        backward_hubs[number_of_backward_entries]
+//   EdgeWeight    backward_weights[number_of_backward_entries]
+// Hubs are sorted ascending per label, so two labels can be intersected by a linear merge.
+struct HubLabelsHeader
+{
+    FingerPrint fingerprint;
+    std::uint32_t checksum;
+    std::uint32_t number_of_nodes;
+    std::uint64_t number_of_forward_entries;
+    std::uint64_t number_of_backward_entries;
+};
+
+struct HubLabel
+{
+    const NodeID *hubs;
+    const EdgeWeight *weights;
+    std::size_t size;
+};
+
+// Returns the minimal forward[i].weight + backward[j].weight over all common hubs, or
+// INVALID_EDGE_WEIGHT if the labels share no hub.
+inline EdgeWeight intersectHubLabels(const HubLabel &forward, const HubLabel &backward)
+{
+    return simd::getKernels().intersect_hub_labels(forward.hubs,
+                                                   forward.weights,
+                                                   forward.size,
+                                                   backward.hubs,
+                                                   backward.weights,
+                                                   backward.size);
+}
+
+// Read-only view of hub labels derived from a contraction hierarchy by osrm-hublabel.
+// The label file is memory mapped, so several processes serving the same dataset share the
+// pages through the OS page cache.
+class HubLabels
+{
+  public:
+    explicit HubLabels(const boost::filesystem::path &labels_path)
+    {
+        try
+        {
+            region.open(labels_path);
+        }
+        catch (const std::exception &exc)
+        {
+            throw exception("Could not map " + labels_path.string() + ": " + exc.what());
+        }
+
+        if (region.size() < sizeof(HubLabelsHeader))
+        {
+            throw exception(labels_path.string() + " is truncated");
+        }
+        header = reinterpret_cast<const HubLabelsHeader *>(region.data());
+
+        const auto valid = FingerPrint::GetValid();
+        if (!valid.IsMagicNumberOK(header->fingerprint) ||
+            !valid.TestContractor(header->fingerprint) || !valid.TestGraphUtil(header->fingerprint))
+        {
+            throw exception("Fingerprint of " + labels_path.string() +
+                            " does not match, rerun osrm-hublabel");
+        }
+
+        const auto number_of_offsets = static_cast<std::uint64_t>(header->number_of_nodes) + 1;
+        const std::uint64_t expected_size =
+            sizeof(HubLabelsHeader) + 2 * number_of_offsets * sizeof(std::uint64_t) +
+            header->number_of_forward_entries * (sizeof(NodeID) + sizeof(EdgeWeight)) +
+            header->number_of_backward_entries * (sizeof(NodeID) + sizeof(EdgeWeight));
+        if (region.size() != expected_size)
+        {
+            throw exception(labels_path.string() + " has an invalid size");
+        }
+
+        const char *ptr = region.data() + sizeof(HubLabelsHeader);
+        forward_offsets = reinterpret_cast<const std::uint64_t *>(ptr);
+        ptr += number_of_offsets * sizeof(std::uint64_t);
+        backward_offsets = reinterpret_cast<const std::uint64_t *>(ptr);
+        ptr += number_of_offsets * sizeof(std::uint64_t);
+        forward_hubs = reinterpret_cast<const NodeID *>(ptr);
+        ptr += header->number_of_forward_entries * sizeof(NodeID);
+        forward_weights = reinterpret_cast<const EdgeWeight *>(ptr);
+        ptr += header->number_of_forward_entries * sizeof(EdgeWeight);
+        backward_hubs = reinterpret_cast<const NodeID *>(ptr);
+        ptr += header->number_of_backward_entries * sizeof(NodeID);
+        backward_weights = reinterpret_cast<const EdgeWeight *>(ptr);
+    }
+
+    HubLabels(const HubLabels &) = delete;
+    HubLabels &operator=(const HubLabels &) = delete;
+
+    unsigned GetCheckSum() const { return header->checksum; }
+
+    unsigned GetNumberOfNodes() const { return header->number_of_nodes; }
+
+    std::uint64_t GetNumberOfEntries() const
+    {
+        return header->number_of_forward_entries + header->number_of_backward_entries;
+    }
+
+    std::size_t GetSizeInBytes() const { return region.size(); }
+
+    // Label of all hubs reachable from node in an upward forward search
+    HubLabel GetForwardLabel(const NodeID node) const
+    {
+        BOOST_ASSERT(node < header->number_of_nodes);
+        const auto begin = forward_offsets[node];
+        const auto end = forward_offsets[node + 1];
+        return HubLabel{forward_hubs + begin, forward_weights + begin, end - begin};
+    }
+
+    // Label of all hubs that reach node in an upward backward search
+    HubLabel GetBackwardLabel(const NodeID node) const
+    {
+        BOOST_ASSERT(node < header->number_of_nodes);
+        const auto begin = backward_offsets[node];
+        const auto end = backward_offsets[node + 1];
+        return HubLabel{backward_hubs + begin, backward_weights + begin, end - begin};
+    }
+
+    // Shortest path weight from source to target in the edge-based graph
+    EdgeWeight GetWeight(const NodeID source, const NodeID target) const
+    {
+        return intersectHubLabels(GetForwardLabel(source), GetBackwardLabel(target));
+    }
+
+  private:
+    boost::iostreams::mapped_file_source region;
+    const HubLabelsHeader *header;
+    const std::uint64_t *forward_offsets;
+    const std::uint64_t *backward_offsets;
+    const NodeID *forward_hubs;
+    const EdgeWeight *forward_weights;
+    const NodeID *backward_hubs;
+    const EdgeWeight *backward_weights;
+};
+}
+}
+
+#endif // OSRM_UTIL_HUB_LABELS_HPP
@@ -31,6 +31,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef JSON_CONTAINER_HPP
 #define JSON_CONTAINER_HPP
 
+#include "util/coordinate.hpp"
+
 #include <variant/variant.hpp>
 
 #include <string>
@@ -93,6 +95,29 @@ struct Number
     double value;
 };
 
+/**
+ * Typed coordinate, rendered as a [longitude, latitude] array.
+ *
+ * Unwrap the fixed point coordinate via its value member attribute.
+ */
+struct LonLat
+{
+    LonLat() = default;
+    LonLat(Coordinate value_) : value{value_} {}
+    Coordinate value;
+};
+
+/**
+ * Typed array of coordinates, rendered as an array of [longitude, latitude] arrays.
+ *
+ * Holds the coordinates in one contiguous buffer instead of an Array of two Numbers per
+ * coordinate. Unwrap the coordinates via its values member attribute.
+ */
+struct LonLatArray
+{
+    std::vector<Coordinate> values;
+};
+
 /**
  * Typed True.
  */
@@ -123,6 +148,8 @@ using Value = mapbox::util::variant<String,
                                     Number,
                                     mapbox::util::recursive_wrapper<Object>,
                                     mapbox::util::recursive_wrapper<Array>,
+                                    LonLat,
+                                    LonLatArray,
                                     True,
                                     False,
                                     Null>;
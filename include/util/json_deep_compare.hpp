@@ -123,6 +123,40 @@ struct Comparator : mapbox::util::static_visitor<bool>
         return true;
     }
 
+    bool operator()(const LonLat &lhs, const LonLat &rhs) const
+    {
+        bool is_same = lhs.value == rhs.value;
+        if (!is_same)
+        {
+            reason = lhs_path + " (= " + toString(lhs.value) + ") != " + rhs_path + " (= " +
+                     toString(rhs.value) + ")";
+        }
+        return is_same;
+    }
+
+    bool operator()(const LonLatArray &lhs, const LonLatArray &rhs) const
+    {
+        if (lhs.values.size() != rhs.values.size())
+        {
+            reason = lhs_path + ".length " + std::to_string(lhs.values.size()) + " != " + rhs_path +
+                     ".length " + std::to_string(rhs.values.size());
+            return false;
+        }
+
+        for (auto i = 0UL; i < lhs.values.size(); ++i)
+        {
+            if (lhs.values[i] != rhs.values[i])
+            {
+                reason = lhs_path + "[" + std::to_string(i) + "] (= " + toString(lhs.values[i]) +
+                         ") != " + rhs_path + "[" + std::to_string(i) + "] (= " +
+                         toString(rhs.values[i]) + ")";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     bool operator()(const True &, const True &) const { return true; }
     bool operator()(const False &, const False &) const { return true; }
     bool operator()(const Null &, const Null &) const { return true; }
@@ -148,6 +182,12 @@ struct Comparator : mapbox::util::static_visitor<bool>
     }
 
   private:
+    static std::string toString(const Coordinate coordinate)
+    {
+        return "[" + std::to_string(static_cast<double>(toFloating(coordinate.lon))) + "," +
+               std::to_string(static_cast<double>(toFloating(coordinate.lat))) + "]";
+    }
+
     std::string &reason;
     const std::string &lhs_path;
     const std::string &rhs_path;
@@ -5,10 +5,13 @@
 #define JSON_RENDERER_HPP
 
 #include "util/cast.hpp"
+#include "util/coordinate.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
 
+#include <cstdint>
+#include <cstdlib>
 #include <iterator>
 #include <ostream>
 #include <string>
@@ -21,6 +24,67 @@ namespace util
 namespace json
 {
 
+namespace detail
+{
+// Long enough for "[-2147.483648,-2147.483648]"
+const constexpr std::size_t MAX_LON_LAT_LENGTH = 27;
+
+// Writes a fixed point coordinate with the digits of COORDINATE_PRECISION and drops trailing
+// zeros, the same as cast::to_string_with_precision does for the floating point value.
+inline char *writeFixedPoint(const std::int32_t value, char *out)
+{
+    static_assert(COORDINATE_PRECISION == 1e6, "six fractional digits expected");
+    std::int64_t magnitude = value;
+    if (magnitude < 0)
+    {
+        *out++ = '-';
+        magnitude = -magnitude;
+    }
+
+    char digits[10];
+    std::size_t number_of_digits = 0;
+    auto integral = magnitude / 1000000;
+    do
+    {
+        digits[number_of_digits++] = '0' + integral % 10;
+        integral /= 10;
+    } while (integral != 0);
+    while (number_of_digits > 0)
+    {
+        *out++ = digits[--number_of_digits];
+    }
+
+    auto fraction = magnitude % 1000000;
+    if (fraction != 0)
+    {
+        *out++ = '.';
+        std::size_t number_of_fraction_digits = 6;
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            --number_of_fraction_digits;
+        }
+        for (auto position = number_of_fraction_digits; position > 0; --position)
+        {
+            out[position - 1] = '0' + fraction % 10;
+            fraction /= 10;
+        }
+        out += number_of_fraction_digits;
+    }
+    return out;
+}
+
+inline char *writeLonLat(const Coordinate coordinate, char *out)
+{
+    *out++ = '[';
+    out = writeFixedPoint(static_cast<std::int32_t>(coordinate.lon), out);
+    *out++ = ',';
+    out = writeFixedPoint(static_cast<std::int32_t>(coordinate.lat), out);
+    *out++ = ']';
+    return out;
+}
+}
+
 struct Renderer
 {
     explicit Renderer(std::ostream &_out) : out(_out) {}
@@ -67,6 +131,28 @@ struct Renderer
         out << "]";
     }
 
+    void operator()(const LonLat &lon_lat) const
+    {
+        char buffer[detail::MAX_LON_LAT_LENGTH];
+        out.write(buffer, detail::writeLonLat(lon_lat.value, buffer) - buffer);
+    }
+
+    void operator()(const LonLatArray &lon_lats) const
+    {
+        char buffer[detail::MAX_LON_LAT_LENGTH + 1];
+        out << "[";
+        for (auto it = lon_lats.values.cbegin(), end = lon_lats.values.cend(); it != end;)
+        {
+            auto buffer_end = detail::writeLonLat(*it, buffer);
+            if (++it != end)
+            {
+                *buffer_end++ = ',';
+            }
+            out.write(buffer, buffer_end - buffer);
+        }
+        out << "]";
+    }
+
     void operator()(const True &) const { out << "true"; }
 
     void operator()(const False &) const { out << "false"; }
@@ -128,6 +214,31 @@ struct ArrayRenderer
         out.push_back(']');
     }
 
+    void operator()(const LonLat &lon_lat) const
+    {
+        char buffer[detail::MAX_LON_LAT_LENGTH];
+        out.insert(out.end(), buffer, detail::writeLonLat(lon_lat.value, buffer));
+    }
+
+    // writes straight into the output buffer, which is grown once for the worst case
+    void operator()(const LonLatArray &lon_lats) const
+    {
+        const auto size = out.size();
+        out.resize(size + 2 + lon_lats.values.size() * (detail::MAX_LON_LAT_LENGTH + 1));
+        auto buffer = out.data() + size;
+        *buffer++ = '[';
+        for (auto it = lon_lats.values.cbegin(), end = lon_lats.values.cend(); it != end;)
+        {
+            buffer = detail::writeLonLat(*it, buffer);
+            if (++it != end)
+            {
+                *buffer++ = ',';
+            }
+        }
+        *buffer++ = ']';
+        out.resize(buffer - out.data());
+    }
+
     void operator()(const True &) const
     {
         const std::string temp("true");
@@ -0,0 +1,100 @@
+#ifndef UTIL_PERFORMANCE_COUNTERS_HPP
+#define UTIL_PERFORMANCE_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+
+// Hardware performance counters are compiled in with the CMake option ENABLE_PERF_COUNTERS and
+// are only available on Linux
+#if defined(ENABLE_PERF_COUNTERS) && defined(__linux__)
+const constexpr bool PERF_COUNTERS_ENABLED = true;
+#else
+const constexpr bool PERF_COUNTERS_ENABLED = false;
+#endif
+
+enum class PerformanceEvent : std::uint8_t
+{
+    Cycles,
+    Instructions,
+    L1DataMisses,
+    CacheMisses,
+    BranchMisses
+};
+const constexpr std::size_t NUMBER_OF_PERFORMANCE_EVENTS = 5;
+
+// Counts of the hardware events, events that could not be counted are unavailable
+struct PerformanceCounterValues
+{
+    PerformanceCounterValues() { values.fill(0), available.fill(false); }
+
+    std::uint64_t Get(const PerformanceEvent event) const
+    {
+        return values[static_cast<std::size_t>(event)];
+    }
+
+    bool IsAvailable(const PerformanceEvent event) const
+    {
+        return available[static_cast<std::size_t>(event)];
+    }
+
+    PerformanceCounterValues &operator+=(const PerformanceCounterValues &other)
+    {
+        for (std::size_t event = 0; event < NUMBER_OF_PERFORMANCE_EVENTS; ++event)
+        {
+            values[event] += other.values[event];
+            available[event] = available[event] || other.available[event];
+        }
+        return *this;
+    }
+
+    // e.g. "cycles 1200, instructions 3400, L1d misses n/a, ..." with all values divided by the
+    // divisor, to report them per query
+    std::string ToString(const double divisor = 1.) const;
+
+    std::array<std::uint64_t, NUMBER_OF_PERFORMANCE_EVENTS> values;
+    std::array<bool, NUMBER_OF_PERFORMANCE_EVENTS> available;
+};
+
+// Counts the hardware events of the calling thread with perf_event_open between Start and Stop.
+// A PerformanceCounters object has to be used by the thread that created it. If counters are
+// not compiled in or the kernel refuses the events, e.g. in containers without access to the
+// performance monitoring unit, all events are unavailable and nothing is counted.
+class PerformanceCounters
+{
+  public:
+    PerformanceCounters();
+    ~PerformanceCounters();
+
+    PerformanceCounters(const PerformanceCounters &) = delete;
+    PerformanceCounters &operator=(const PerformanceCounters &) = delete;
+
+    bool IsAvailable() const { return group_fd >= 0; }
+
+    void Start();
+
+    // Returns the events since Start and adds them to the totals
+    PerformanceCounterValues Stop();
+
+    const PerformanceCounterValues &GetTotals() const { return totals; }
+
+    void Reset() { totals = PerformanceCounterValues(); }
+
+  private:
+    PerformanceCounterValues Read() const;
+
+    int group_fd = -1;
+    std::array<int, NUMBER_OF_PERFORMANCE_EVENTS> fds;
+    PerformanceCounterValues start_values;
+    PerformanceCounterValues totals;
+};
+}
+}
+
+#endif // UTIL_PERFORMANCE_COUNTERS_HPP
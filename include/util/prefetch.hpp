@@ -0,0 +1,30 @@
+#ifndef UTIL_PREFETCH_HPP
+#define UTIL_PREFETCH_HPP
+
+namespace osrm
+{
+namespace util
+{
+
+// Software prefetching in the search loops is switched on at compile time with the CMake option
+// ENABLE_PREFETCHING, so its effect can be compared on different CPUs.
+#if defined(ENABLE_PREFETCHING)
+const constexpr bool PREFETCHING_ENABLED = true;
+#else
+const constexpr bool PREFETCHING_ENABLED = false;
+#endif
+
+// Hints the CPU to load the cache line of the address for reading. Never faults, so the address
+// does not have to be valid.
+inline void prefetch(const void *address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address, 0, 3);
+#else
+    (void)address;
+#endif
+}
+}
+}
+
+#endif // UTIL_PREFETCH_HPP
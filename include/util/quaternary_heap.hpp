@@ -0,0 +1,245 @@
+#ifndef QUATERNARY_HEAP_HPP
+#define QUATERNARY_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+#include "util/heap_statistics.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Drop-in replacement for BinaryHeap with four children per node. The heap is half as deep and
+// the children of a node share a cache line, which trades a few more comparisons in Downheap for
+// fewer cache misses on large heaps.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+class QuaternaryHeap
+{
+  private:
+    QuaternaryHeap(const QuaternaryHeap &right);
+    void operator=(const QuaternaryHeap &right);
+
+    static const constexpr Key REMOVED = std::numeric_limits<Key>::max();
+    static const constexpr std::size_t ARITY = 4;
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    explicit QuaternaryHeap(size_t maxID) : node_index(maxID) { Clear(); }
+
+    void Clear()
+    {
+        statistics.CountSearch();
+        heap.clear();
+        inserted_nodes.clear();
+        node_index.Clear();
+    }
+
+    std::size_t Size() const { return heap.size(); }
+
+    bool Empty() const { return 0 == Size(); }
+
+    HeapStatistics &GetStatistics() { return statistics; }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        HeapElement element;
+        element.index = static_cast<Key>(inserted_nodes.size());
+        element.weight = weight;
+        const Key key = static_cast<Key>(heap.size());
+        heap.emplace_back(element);
+        inserted_nodes.emplace_back(node, key, weight, data);
+        node_index[node] = element.index;
+        Upheap(key);
+        CheckHeap();
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    Weight const &GetKey(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].key == REMOVED;
+    }
+
+    bool WasInserted(const NodeID node) const
+    {
+        const auto index = node_index.peek_index(node);
+        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(!heap.empty());
+        return inserted_nodes[heap.front().index].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(!heap.empty());
+        return heap.front().weight;
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(!heap.empty());
+        const Key removed_index = heap.front().index;
+        heap.front() = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            Downheap(0);
+        }
+        inserted_nodes[removed_index].key = REMOVED;
+        CheckHeap();
+        statistics.CountSettledNode(inserted_nodes[removed_index].node);
+        return inserted_nodes[removed_index].node;
+    }
+
+    void DeleteAll()
+    {
+        for (const auto &element : heap)
+        {
+            inserted_nodes[element.index].key = REMOVED;
+        }
+        heap.clear();
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key index = node_index.peek_index(node);
+        const Key key = inserted_nodes[index].key;
+        BOOST_ASSERT(key != REMOVED);
+
+        inserted_nodes[index].weight = weight;
+        heap[key].weight = weight;
+        Upheap(key);
+        CheckHeap();
+    }
+
+  private:
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Key k, Weight w, Data d) : node(n), key(k), weight(w), data(std::move(d))
+        {
+        }
+
+        NodeID node;
+        Key key;
+        Weight weight;
+        Data data;
+    };
+    struct HeapElement
+    {
+        Key index;
+        Weight weight;
+    };
+
+    std::vector<HeapNode> inserted_nodes;
+    std::vector<HeapElement> heap;
+    IndexStorage node_index;
+    HeapStatistics statistics;
+
+    void Downheap(Key key)
+    {
+        const HeapElement dropping = heap[key];
+        const std::size_t heap_size = heap.size();
+        std::size_t first_child = ARITY * static_cast<std::size_t>(key) + 1;
+        while (first_child < heap_size)
+        {
+            const std::size_t last_child = std::min(first_child + ARITY, heap_size);
+            std::size_t min_child = first_child;
+            for (std::size_t child = first_child + 1; child < last_child; ++child)
+            {
+                if (heap[child].weight < heap[min_child].weight)
+                {
+                    min_child = child;
+                }
+            }
+            if (dropping.weight <= heap[min_child].weight)
+            {
+                break;
+            }
+            heap[key] = heap[min_child];
+            inserted_nodes[heap[key].index].key = key;
+            key = static_cast<Key>(min_child);
+            first_child = ARITY * min_child + 1;
+        }
+        heap[key] = dropping;
+        inserted_nodes[dropping.index].key = key;
+    }
+
+    void Upheap(Key key)
+    {
+        const HeapElement rising = heap[key];
+        while (key > 0)
+        {
+            const Key parent = (key - 1) / ARITY;
+            if (heap[parent].weight <= rising.weight)
+            {
+                break;
+            }
+            heap[key] = heap[parent];
+            inserted_nodes[heap[key].index].key = key;
+            key = parent;
+        }
+        heap[key] = rising;
+        inserted_nodes[rising.index].key = key;
+    }
+
+    void CheckHeap()
+    {
+#ifndef NDEBUG
+        for (std::size_t i = 1; i < heap.size(); ++i)
+        {
+            BOOST_ASSERT(heap[i].weight >= heap[(i - 1) / ARITY].weight);
+        }
+#endif
+    }
+};
+}
+}
+
+#endif // QUATERNARY_HEAP_HPP
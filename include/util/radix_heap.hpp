@@ -0,0 +1,304 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+#include "util/heap_statistics.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Drop-in replacement for BinaryHeap for integer weights and monotone extraction as in Dijkstra
+// searches. Elements are kept in buckets by the highest bit in which their weight differs from
+// the last extracted minimum. An element only ever moves to lower buckets, so it is touched at
+// most once per bit of the weight range and never compared against other elements.
+//
+// Weights below the current minimum, e.g. the phantom node offsets inserted before a search,
+// lower the minimum and rebuild all buckets. This is cheap while the heap is small.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+class RadixHeap
+{
+  private:
+    static_assert(std::is_integral<Weight>::value, "radix heaps need integer weights");
+
+    RadixHeap(const RadixHeap &right);
+    void operator=(const RadixHeap &right);
+
+    using UnsignedWeight = typename std::make_unsigned<Weight>::type;
+    static const constexpr std::size_t NUMBER_OF_BUCKETS = 8 * sizeof(Weight) + 1;
+    static const constexpr Key REMOVED = std::numeric_limits<Key>::max();
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    explicit RadixHeap(size_t maxID) : node_index(maxID) { Clear(); }
+
+    void Clear()
+    {
+        statistics.CountSearch();
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        inserted_nodes.clear();
+        node_index.Clear();
+        size = 0;
+        last_min = std::numeric_limits<Weight>::min();
+    }
+
+    std::size_t Size() const { return size; }
+
+    bool Empty() const { return 0 == Size(); }
+
+    HeapStatistics &GetStatistics() { return statistics; }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        const Key index = static_cast<Key>(inserted_nodes.size());
+        inserted_nodes.emplace_back(node, weight, data);
+        node_index[node] = index;
+        ++size;
+        Push(index);
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    Weight const &GetKey(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].bucket == REMOVED;
+    }
+
+    bool WasInserted(const NodeID node) const
+    {
+        const auto index = node_index.peek_index(node);
+        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(size > 0 && !buckets[0].empty());
+        return inserted_nodes[buckets[0].back()].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(size > 0 && !buckets[0].empty());
+        return last_min;
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(size > 0 && !buckets[0].empty());
+        const Key removed_index = buckets[0].back();
+        buckets[0].pop_back();
+        inserted_nodes[removed_index].bucket = REMOVED;
+        --size;
+        Refill();
+        statistics.CountSettledNode(inserted_nodes[removed_index].node);
+        return inserted_nodes[removed_index].node;
+    }
+
+    void DeleteAll()
+    {
+        for (auto &bucket : buckets)
+        {
+            for (const auto index : bucket)
+            {
+                inserted_nodes[index].bucket = REMOVED;
+            }
+            bucket.clear();
+        }
+        size = 0;
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key index = node_index.peek_index(node);
+        BOOST_ASSERT(inserted_nodes[index].bucket != REMOVED);
+        BOOST_ASSERT(weight <= inserted_nodes[index].weight);
+
+        Remove(index);
+        inserted_nodes[index].weight = weight;
+        Push(index);
+    }
+
+  private:
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Weight w, Data d)
+            : node(n), bucket(REMOVED), position(0), weight(w), data(std::move(d))
+        {
+        }
+
+        NodeID node;
+        Key bucket;
+        Key position;
+        Weight weight;
+        Data data;
+    };
+
+    std::vector<HeapNode> inserted_nodes;
+    std::array<std::vector<Key>, NUMBER_OF_BUCKETS> buckets;
+    IndexStorage node_index;
+    std::size_t size;
+    // all weights in the heap are at least last_min, bucket 0 holds the ones equal to it
+    Weight last_min;
+    HeapStatistics statistics;
+
+    // order preserving map of the weights to unsigned integers
+    static UnsignedWeight ToUnsigned(const Weight weight)
+    {
+        const UnsignedWeight sign_bit = std::is_signed<Weight>::value
+                                            ? UnsignedWeight(1) << (8 * sizeof(Weight) - 1)
+                                            : UnsignedWeight(0);
+        return static_cast<UnsignedWeight>(weight) ^ sign_bit;
+    }
+
+    // one plus the index of the highest bit in which the weight differs from last_min
+    std::size_t GetBucket(const Weight weight) const
+    {
+        const std::uint64_t difference = ToUnsigned(weight) ^ ToUnsigned(last_min);
+        if (difference == 0)
+        {
+            return 0;
+        }
+#if defined(__GNUC__)
+        return 64 - __builtin_clzll(difference);
+#else
+        std::size_t bucket = 0;
+        for (auto bits = difference; bits != 0; bits >>= 1)
+        {
+            ++bucket;
+        }
+        return bucket;
+#endif
+    }
+
+    void Push(const Key index)
+    {
+        const auto weight = inserted_nodes[index].weight;
+        if (weight < last_min)
+        {
+            Rebuild(weight);
+        }
+        Append(GetBucket(weight), index);
+        Refill();
+    }
+
+    void Append(const std::size_t bucket, const Key index)
+    {
+        inserted_nodes[index].bucket = static_cast<Key>(bucket);
+        inserted_nodes[index].position = static_cast<Key>(buckets[bucket].size());
+        buckets[bucket].push_back(index);
+    }
+
+    void Remove(const Key index)
+    {
+        auto &bucket = buckets[inserted_nodes[index].bucket];
+        const auto position = inserted_nodes[index].position;
+        bucket[position] = bucket.back();
+        inserted_nodes[bucket[position]].position = position;
+        bucket.pop_back();
+    }
+
+    // lowers last_min below the current minimum and sorts all elements into new buckets
+    void Rebuild(const Weight new_min)
+    {
+        BOOST_ASSERT(new_min < last_min);
+        std::vector<Key> indices;
+        indices.reserve(size);
+        for (auto &bucket : buckets)
+        {
+            indices.insert(indices.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        last_min = new_min;
+        for (const auto index : indices)
+        {
+            Append(GetBucket(inserted_nodes[index].weight), index);
+        }
+    }
+
+    // makes sure bucket 0 holds the minimum by moving last_min up to the smallest weight of the
+    // first non-empty bucket and redistributing that bucket
+    void Refill()
+    {
+        if (size == 0 || !buckets[0].empty())
+        {
+            return;
+        }
+
+        std::size_t first_bucket = 1;
+        while (buckets[first_bucket].empty())
+        {
+            ++first_bucket;
+            BOOST_ASSERT(first_bucket < NUMBER_OF_BUCKETS);
+        }
+
+        std::vector<Key> indices;
+        indices.swap(buckets[first_bucket]);
+        last_min = inserted_nodes[indices.front()].weight;
+        for (const auto index : indices)
+        {
+            last_min = std::min(last_min, inserted_nodes[index].weight);
+        }
+        for (const auto index : indices)
+        {
+            Append(GetBucket(inserted_nodes[index].weight), index);
+        }
+        // keep the memory of the bucket
+        indices.clear();
+        indices.swap(buckets[first_bucket]);
+    }
+};
+}
+}
+
+#endif // RADIX_HEAP_HPP
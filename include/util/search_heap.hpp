@@ -0,0 +1,31 @@
+#ifndef SEARCH_HEAP_HPP
+#define SEARCH_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+#include "util/quaternary_heap.hpp"
+#include "util/radix_heap.hpp"
+
+namespace osrm
+{
+namespace util
+{
+
+// Priority queue of the query searches and of the witness searches of the contractor. The
+// implementation is chosen at compile time with the CMake option HEAP_TYPE, heap-bench compares
+// them on the search spaces of a dataset.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+#if defined(USE_QUATERNARY_HEAP)
+using SearchHeap = QuaternaryHeap<NodeID, Key, Weight, Data, IndexStorage>;
+#elif defined(USE_RADIX_HEAP)
+using SearchHeap = RadixHeap<NodeID, Key, Weight, Data, IndexStorage>;
+#else
+using SearchHeap = BinaryHeap<NodeID, Key, Weight, Data, IndexStorage>;
+#endif
+}
+}
+
+#endif // SEARCH_HEAP_HPP
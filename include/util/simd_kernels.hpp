@@ -0,0 +1,71 @@
+#ifndef OSRM_UTIL_SIMD_KERNELS_HPP
+#define OSRM_UTIL_SIMD_KERNELS_HPP
+
+#include "util/cpu_features.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+namespace simd
+{
+
+// Hot loops compiled once per instruction set into one binary. Every variant returns exactly
+// the same results as the scalar one, they only differ in speed.
+//
+// Only integer loops over arrays are dispatched. Base64 and polyline encoding are byte serial
+// with variable-length output, fused multiply-add variants of the floating point coordinate
+// math would round differently, and the extractor spends its time in the Lua profiles, sorting
+// and hash lookups, none of which is a loop over arrays.
+struct Kernels
+{
+    // distances[i] is the squared euclidean distance of (lon, lat) to the rectangle i, 0 if the
+    // rectangle contains it. Same as RectangleInt2D::GetMinSquaredDist on fixed coordinates.
+    void (*squared_distances_to_rectangles)(const std::int32_t *min_lons,
+                                            const std::int32_t *max_lons,
+                                            const std::int32_t *min_lats,
+                                            const std::int32_t *max_lats,
+                                            const std::size_t number_of_rectangles,
+                                            const std::int32_t lon,
+                                            const std::int32_t lat,
+                                            std::uint64_t *distances);
+
+    // Minimal forward_weights[i] + backward_weights[j] over all forward_hubs[i] ==
+    // backward_hubs[j], or INVALID_EDGE_WEIGHT. Both hub arrays are sorted ascending.
+    EdgeWeight (*intersect_hub_labels)(const NodeID *forward_hubs,
+                                       const EdgeWeight *forward_weights,
+                                       const std::size_t forward_size,
+                                       const NodeID *backward_hubs,
+                                       const EdgeWeight *backward_weights,
+                                       const std::size_t backward_size);
+
+    // Relaxes the bucket of a node settled by a forward search of a many-to-many table. entries
+    // holds number_of_entries pairs of a column and the weight from the node to the target of
+    // the column, the columns are distinct. For each pair row[column] becomes the minimum of
+    // itself and weight + the weight of the pair. Pairs with a negative sum are skipped, returns
+    // true if there was one.
+    bool (*relax_bucket)(const std::int32_t *entries,
+                         const std::size_t number_of_entries,
+                         const EdgeWeight weight,
+                         EdgeWeight *row);
+};
+
+// The kernels of an instruction set, kernels without a variant for it fall back to the next
+// lower instruction set. Only call them if the CPU supports the instruction set.
+const Kernels &getKernels(const InstructionSet instruction_set);
+
+// The kernels of getInstructionSet(), resolved once
+inline const Kernels &getKernels()
+{
+    static const Kernels &kernels = getKernels(getInstructionSet());
+    return kernels;
+}
+}
+}
+}
+
+#endif // OSRM_UTIL_SIMD_KERNELS_HPP
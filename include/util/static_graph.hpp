@@ -3,6 +3,7 @@
 
 #include "util/integer_range.hpp"
 #include "util/percent.hpp"
+#include "util/prefetch.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
 #include "util/typedefs.hpp"
 
@@ -135,6 +136,19 @@ template <typename EdgeDataT, bool UseSharedMemory = false> class StaticGraph
         return EdgeIterator(node_array.at(n + 1).first_edge);
     }
 
+    // hints the CPU to load the node array entry of the node
+    void PrefetchNode(const NodeIterator n) const { prefetch(&node_array[n]); }
+
+    // hints the CPU to load the first edges of the node, reads its node array entry
+    void PrefetchEdges(const NodeIterator n) const
+    {
+        const EdgeIterator first_edge = node_array[n].first_edge;
+        if (first_edge < number_of_edges)
+        {
+            prefetch(&edge_array[first_edge]);
+        }
+    }
+
     // searches for a specific edge
     EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
     {
@@ -9,6 +9,7 @@
 #include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
+#include "util/simd_kernels.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
@@ -172,11 +173,14 @@ class StaticRTree
         const uint64_t element_count = input_data_vector.size();
         std::vector<WrappedInputElement> input_wrapper_vector(element_count);
 
-        // generate auxiliary vector of hilbert-values
+        // generate auxiliary vector of hilbert-values, the centroids of each range are projected
+        // in one batch
         tbb::parallel_for(
             tbb::blocked_range<uint64_t>(0, element_count),
             [&input_data_vector, &input_wrapper_vector, this](
                 const tbb::blocked_range<uint64_t> &range) {
+                std::vector<Coordinate> centroids(range.size());
+                std::vector<FloatLatitude> centroid_latitudes(range.size());
                 for (uint64_t element_counter = range.begin(), end = range.end();
                      element_counter != end;
                      ++element_counter)
@@ -190,13 +194,21 @@ class StaticRTree
                     BOOST_ASSERT(current_element.u < m_coordinate_list.size());
                     BOOST_ASSERT(current_element.v < m_coordinate_list.size());
 
-                    Coordinate current_centroid = coordinate_calculation::centroid(
+                    const auto index = element_counter - range.begin();
+                    centroids[index] = coordinate_calculation::centroid(
                         m_coordinate_list[current_element.u], m_coordinate_list[current_element.v]);
-                    current_centroid.lat =
-                        FixedLatitude(COORDINATE_PRECISION *
-                                      web_mercator::latToY(toFloating(current_centroid.lat)));
+                    centroid_latitudes[index] = toFloating(centroids[index].lat);
+                }
+
+                std::vector<double> centroid_ys(range.size());
+                web_mercator::latToYapprox(
+                    centroid_latitudes.data(), centroid_latitudes.size(), centroid_ys.data());
 
-                    current_wrapper.m_hilbert_value = hilbertCode(current_centroid);
+                for (const auto index : irange<std::size_t>(0, range.size()))
+                {
+                    centroids[index].lat = FixedLatitude(COORDINATE_PRECISION * centroid_ys[index]);
+                    input_wrapper_vector[range.begin() + index].m_hilbert_value =
+                        hilbertCode(centroids[index]);
                 }
             });
 
@@ -218,6 +230,7 @@ class StaticRTree
             {
                 LeafNode current_leaf;
                 Rectangle &rectangle = current_leaf.minimum_bounding_rectangle;
+                Coordinate end_points[2 * LEAF_NODE_SIZE];
                 for (std::uint32_t object_index = 0;
                      object_index < LEAF_NODE_SIZE && wrapped_element_index < element_count;
                      ++object_index, ++wrapped_element_index)
@@ -229,28 +242,26 @@ class StaticRTree
                     current_leaf.object_count += 1;
                     current_leaf.objects[object_index] = object;
 
-                    Coordinate projected_u{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
-                    Coordinate projected_v{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
-
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
-
-                    rectangle.min_lon =
-                        std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
-                    rectangle.max_lon =
-                        std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
-
-                    rectangle.min_lat =
-                        std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
-                    rectangle.max_lat =
-                        std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
+                    end_points[2 * object_index] = Coordinate{m_coordinate_list[object.u]};
+                    end_points[2 * object_index + 1] = Coordinate{m_coordinate_list[object.v]};
+                }
 
-                    BOOST_ASSERT(rectangle.IsValid());
+                // the end points of all objects of the leaf are projected in one batch
+                FloatCoordinate projected_end_points[2 * LEAF_NODE_SIZE];
+                web_mercator::fromWGS84(
+                    end_points, 2 * current_leaf.object_count, projected_end_points);
+                for (const auto index : irange<std::uint32_t>(0, 2 * current_leaf.object_count))
+                {
+                    const Coordinate projected{projected_end_points[index]};
+                    BOOST_ASSERT(std::abs(toFloating(projected.lon).operator double()) <= 180.);
+                    BOOST_ASSERT(std::abs(toFloating(projected.lat).operator double()) <= 180.);
+
+                    rectangle.min_lon = std::min(rectangle.min_lon, projected.lon);
+                    rectangle.max_lon = std::max(rectangle.max_lon, projected.lon);
+                    rectangle.min_lat = std::min(rectangle.min_lat, projected.lat);
+                    rectangle.max_lat = std::max(rectangle.max_lat, projected.lat);
                 }
+                BOOST_ASSERT(rectangle.IsValid());
 
                 // append the leaf node to the current tree node
                 current_node.child_count += 1;
@@ -575,15 +586,38 @@ class StaticRTree
                          QueueT &traversal_queue) const
     {
         const TreeNode &parent = m_search_tree[parent_id.index];
+
+        // gather the child rectangles to compute all lower bounds in one batch
+        std::int32_t min_lons[BRANCHING_FACTOR];
+        std::int32_t max_lons[BRANCHING_FACTOR];
+        std::int32_t min_lats[BRANCHING_FACTOR];
+        std::int32_t max_lats[BRANCHING_FACTOR];
         for (std::uint32_t i = 0; i < parent.child_count; ++i)
         {
             const TreeIndex child_id = parent.children[i];
             const auto &child_rectangle =
                 child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
                                  : m_search_tree[child_id.index].minimum_bounding_rectangle;
-            const auto squared_lower_bound_to_element =
-                child_rectangle.GetMinSquaredDist(fixed_projected_input_coordinate);
-            traversal_queue.push(QueryCandidate{squared_lower_bound_to_element, child_id});
+            min_lons[i] = static_cast<std::int32_t>(child_rectangle.min_lon);
+            max_lons[i] = static_cast<std::int32_t>(child_rectangle.max_lon);
+            min_lats[i] = static_cast<std::int32_t>(child_rectangle.min_lat);
+            max_lats[i] = static_cast<std::int32_t>(child_rectangle.max_lat);
+        }
+
+        std::uint64_t squared_lower_bounds[BRANCHING_FACTOR];
+        simd::getKernels().squared_distances_to_rectangles(
+            min_lons,
+            max_lons,
+            min_lats,
+            max_lats,
+            parent.child_count,
+            static_cast<std::int32_t>(fixed_projected_input_coordinate.lon),
+            static_cast<std::int32_t>(fixed_projected_input_coordinate.lat),
+            squared_lower_bounds);
+
+        for (std::uint32_t i = 0; i < parent.child_count; ++i)
+        {
+            traversal_queue.push(QueryCandidate{squared_lower_bounds[i], parent.children[i]});
         }
     }
 };
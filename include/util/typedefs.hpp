@@ -58,6 +58,8 @@ using NodeID = unsigned int;
 using EdgeID = unsigned int;
 using NameID = std::uint32_t;
 using EdgeWeight = int;
+// lengths of edges in the contracted graph are stored in decimeters
+using EdgeLength = int;
 
 using BearingClassID = std::uint32_t;
 static const BearingClassID INVALID_BEARING_CLASSID = std::numeric_limits<std::uint32_t>::max();
@@ -1,7 +1,20 @@
 #ifndef OSRM_UTIL_VECTOR_TILE_HPP
 #define OSRM_UTIL_VECTOR_TILE_HPP
 
+#include "util/coordinate.hpp"
+#include "util/web_mercator.hpp"
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/geometries.hpp>
+#include <boost/geometry/geometries/point_xy.hpp>
+#include <boost/geometry/multi/geometries/multi_linestring.hpp>
+
+#include <protozero/pbf_writer.hpp>
+#include <protozero/varint.hpp>
+
+#include <cmath>
 #include <cstdint>
+#include <vector>
 
 namespace osrm
 {
@@ -30,6 +43,125 @@ const constexpr std::uint32_t VARIANT_TYPE_DOUBLE = 3;
 // Vector tiles are 4096 virtual pixels on each side
 const constexpr double EXTENT = 4096.0;
 const constexpr double BUFFER = 128.0;
+
+// Simple container class for WGS84 coordinates
+template <typename T> struct Point final
+{
+    Point(T _x, T _y) : x(_x), y(_y) {}
+
+    const T x;
+    const T y;
+};
+
+// from mapnik-vector-tile
+namespace pbf
+{
+inline unsigned encode_length(const unsigned len) { return (len << 3u) | 2u; }
+}
+
+struct BBox final
+{
+    BBox(const double _minx, const double _miny, const double _maxx, const double _maxy)
+        : minx(_minx), miny(_miny), maxx(_maxx), maxy(_maxy)
+    {
+    }
+
+    double width() const { return maxx - minx; }
+    double height() const { return maxy - miny; }
+
+    const double minx;
+    const double miny;
+    const double maxx;
+    const double maxy;
+};
+
+using FixedLine = std::vector<Point<std::int32_t>>;
+
+typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> point_t;
+typedef boost::geometry::model::linestring<point_t> linestring_t;
+typedef boost::geometry::model::box<point_t> box_t;
+typedef boost::geometry::model::multi_linestring<linestring_t> multi_linestring_t;
+
+// from mapnik-vector-tile
+// Encodes a linestring using protobuf zigzag encoding
+inline bool encodeLinestring(const FixedLine &line,
+                             protozero::packed_field_uint32 &geometry,
+                             std::int32_t &start_x,
+                             std::int32_t &start_y)
+{
+    const std::size_t line_size = line.size();
+    if (line_size < 2)
+    {
+        return false;
+    }
+
+    const unsigned line_to_length = static_cast<const unsigned>(line_size) - 1;
+
+    auto pt = line.begin();
+    geometry.add_element(9); // move_to | (1 << 3)
+    geometry.add_element(protozero::encode_zigzag32(pt->x - start_x));
+    geometry.add_element(protozero::encode_zigzag32(pt->y - start_y));
+    start_x = pt->x;
+    start_y = pt->y;
+    geometry.add_element(pbf::encode_length(line_to_length));
+    for (++pt; pt != line.end(); ++pt)
+    {
+        const std::int32_t dx = pt->x - start_x;
+        const std::int32_t dy = pt->y - start_y;
+        geometry.add_element(protozero::encode_zigzag32(dx));
+        geometry.add_element(protozero::encode_zigzag32(dy));
+        start_x = pt->x;
+        start_y = pt->y;
+    }
+    return true;
+}
+
+// start and target are in web mercator degrees
+inline FixedLine coordinatesToTileLine(const util::FloatCoordinate &projected_start,
+                                       const util::FloatCoordinate &projected_target,
+                                       const BBox &tile_bbox)
+{
+    static const box_t clip_box(point_t(-BUFFER, -BUFFER),
+                                point_t(EXTENT + BUFFER, EXTENT + BUFFER));
+
+    linestring_t unclipped_line;
+
+    for (auto const &projected : {projected_start, projected_target})
+    {
+        double px_merc = static_cast<double>(projected.lon) * util::web_mercator::DEGREE_TO_PX;
+        double py_merc = static_cast<double>(projected.lat) * util::web_mercator::DEGREE_TO_PX;
+        // convert lon/lat to tile coordinates
+        const auto px = std::round(
+            ((px_merc - tile_bbox.minx) * util::web_mercator::TILE_SIZE / tile_bbox.width()) *
+            EXTENT / util::web_mercator::TILE_SIZE);
+        const auto py = std::round(
+            ((tile_bbox.maxy - py_merc) * util::web_mercator::TILE_SIZE / tile_bbox.height()) *
+            EXTENT / util::web_mercator::TILE_SIZE);
+
+        boost::geometry::append(unclipped_line, point_t(px, py));
+    }
+
+    multi_linestring_t clipped_line;
+
+    boost::geometry::intersection(clip_box, unclipped_line, clipped_line);
+
+    FixedLine tile_line;
+
+    // b::g::intersection might return a line with one point if the
+    // original line was very short and coords were dupes
+    if (!clipped_line.empty() && clipped_line[0].size() == 2)
+    {
+        if (clipped_line[0].size() == 2)
+        {
+            for (const auto &p : clipped_line[0])
+            {
+                tile_line.emplace_back(p.get<0>(), p.get<1>());
+            }
+        }
+    }
+
+    return tile_line;
+}
 }
 }
 }
@@ -5,6 +5,14 @@
 
 #include <boost/math/constants/constants.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
 namespace osrm
 {
 namespace util
@@ -47,48 +55,99 @@ inline double latToY(const FloatLatitude latitude)
     return clamped_y;
 }
 
-template <typename T> constexpr double horner(double, T an) { return an; }
-
-template <typename T, typename... U> constexpr double horner(double x, T an, U... a)
+namespace detail
 {
-    return horner(x, a...) * x + an;
+// Approximate the inverse Gudermannian function with the Padé approximant [11/11]: deg → deg
+// Coefficients are computed for the argument range [-70°,70°] by Remez algorithm
+// |err|_∞=3.387e-12
+const constexpr double APPROX_LATITUDE_LIMIT = 70.;
+const constexpr double LAT_TO_Y_NUMERATOR[] = {0.00000000000000000000000000e+00,
+                                               1.00000000000089108431373566e+00,
+                                               2.34439410386997223035693483e-06,
+                                               -3.21291701673364717170998957e-04,
+                                               -6.62778508496089940141103135e-10,
+                                               3.68188055470304769936079078e-08,
+                                               6.31192702320492485752941578e-14,
+                                               -1.77274453235716299127325443e-12,
+                                               -2.24563810831776747318521450e-18,
+                                               3.13524754818073129982475171e-17,
+                                               2.09014225025314211415458228e-23,
+                                               -9.82938075991732185095509716e-23};
+const constexpr double LAT_TO_Y_DENOMINATOR[] = {1.00000000000000000000000000e+00,
+                                                 2.34439410398970701719081061e-06,
+                                                 -3.72061271627251952928813333e-04,
+                                                 -7.81802389685429267252612620e-10,
+                                                 5.18418724186576447072888605e-08,
+                                                 9.37468561198098681003717477e-14,
+                                                 -3.30833288607921773936702558e-12,
+                                                 -4.78446279888774903983338274e-18,
+                                                 9.32999229169156878168234191e-17,
+                                                 9.17695141954265959600965170e-23,
+                                                 -8.72130728982012387640166055e-22,
+                                                 -3.23083224835967391884404730e-28};
+
+template <std::size_t N> inline double horner(const double x, const double (&coefficients)[N])
+{
+    double result = coefficients[N - 1];
+    for (std::size_t index = N - 1; index > 0; --index)
+    {
+        result = result * x + coefficients[index - 1];
+    }
+    return result;
+}
+
+#if defined(__SSE2__)
+template <std::size_t N> inline __m128d horner(const __m128d x, const double (&coefficients)[N])
+{
+    __m128d result = _mm_set1_pd(coefficients[N - 1]);
+    for (std::size_t index = N - 1; index > 0; --index)
+    {
+        result = _mm_add_pd(_mm_mul_pd(result, x), _mm_set1_pd(coefficients[index - 1]));
+    }
+    return result;
+}
+#endif
 }
 
 inline double latToYapprox(const FloatLatitude latitude)
 {
-    if (latitude < FloatLatitude(-70.) || latitude > FloatLatitude(70.))
+    if (latitude < FloatLatitude(-detail::APPROX_LATITUDE_LIMIT) ||
+        latitude > FloatLatitude(detail::APPROX_LATITUDE_LIMIT))
         return latToY(latitude);
 
-    // Approximate the inverse Gudermannian function with the Padé approximant [11/11]: deg → deg
-    // Coefficients are computed for the argument range [-70°,70°] by Remez algorithm
-    // |err|_∞=3.387e-12
     const auto x = static_cast<double>(latitude);
-    return horner(x,
-                  0.00000000000000000000000000e+00,
-                  1.00000000000089108431373566e+00,
-                  2.34439410386997223035693483e-06,
-                  -3.21291701673364717170998957e-04,
-                  -6.62778508496089940141103135e-10,
-                  3.68188055470304769936079078e-08,
-                  6.31192702320492485752941578e-14,
-                  -1.77274453235716299127325443e-12,
-                  -2.24563810831776747318521450e-18,
-                  3.13524754818073129982475171e-17,
-                  2.09014225025314211415458228e-23,
-                  -9.82938075991732185095509716e-23) /
-           horner(x,
-                  1.00000000000000000000000000e+00,
-                  2.34439410398970701719081061e-06,
-                  -3.72061271627251952928813333e-04,
-                  -7.81802389685429267252612620e-10,
-                  5.18418724186576447072888605e-08,
-                  9.37468561198098681003717477e-14,
-                  -3.30833288607921773936702558e-12,
-                  -4.78446279888774903983338274e-18,
-                  9.32999229169156878168234191e-17,
-                  9.17695141954265959600965170e-23,
-                  -8.72130728982012387640166055e-22,
-                  -3.23083224835967391884404730e-28);
+    return detail::horner(x, detail::LAT_TO_Y_NUMERATOR) /
+           detail::horner(x, detail::LAT_TO_Y_DENOMINATOR);
+}
+
+// Projects a batch of latitudes, ys[i] = latToYapprox(latitudes[i]). Vectorized with SSE2
+// where available, pairs with a latitude beyond the range of the approximation fall back to
+// latToY.
+inline void latToYapprox(const FloatLatitude *latitudes, const std::size_t size, double *ys)
+{
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128d limit = _mm_set1_pd(detail::APPROX_LATITUDE_LIMIT);
+    const __m128d sign_mask = _mm_set1_pd(-0.);
+    for (; index + 2 <= size; index += 2)
+    {
+        const __m128d x = _mm_set_pd(static_cast<double>(latitudes[index + 1]),
+                                     static_cast<double>(latitudes[index]));
+        if (_mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(sign_mask, x), limit)) != 0)
+        {
+            ys[index] = latToYapprox(latitudes[index]);
+            ys[index + 1] = latToYapprox(latitudes[index + 1]);
+            continue;
+        }
+        _mm_storeu_pd(ys + index,
+                      _mm_div_pd(detail::horner(x, detail::LAT_TO_Y_NUMERATOR),
+                                 detail::horner(x, detail::LAT_TO_Y_DENOMINATOR)));
+    }
+#endif
+    for (; index < size; ++index)
+    {
+        ys[index] = latToYapprox(latitudes[index]);
+    }
 }
 
 inline FloatLatitude clamp(const FloatLatitude lat)
@@ -134,6 +193,29 @@ inline FloatCoordinate fromWGS84(const FloatCoordinate &wgs84_coordinate)
     return {wgs84_coordinate.lon, FloatLatitude{latToYapprox(wgs84_coordinate.lat)}};
 }
 
+// Projects a batch of coordinates, projected[i] = fromWGS84(coordinates[i])
+inline void
+fromWGS84(const Coordinate *coordinates, const std::size_t size, FloatCoordinate *projected)
+{
+    const constexpr std::size_t BATCH_SIZE = 64;
+    FloatLatitude latitudes[BATCH_SIZE];
+    double ys[BATCH_SIZE];
+    for (std::size_t begin = 0; begin < size; begin += BATCH_SIZE)
+    {
+        const auto batch_size = std::min(BATCH_SIZE, size - begin);
+        for (std::size_t index = 0; index < batch_size; ++index)
+        {
+            latitudes[index] = toFloating(coordinates[begin + index].lat);
+        }
+        latToYapprox(latitudes, batch_size, ys);
+        for (std::size_t index = 0; index < batch_size; ++index)
+        {
+            projected[begin + index] = {toFloating(coordinates[begin + index].lon),
+                                        FloatLatitude{ys[index]}};
+        }
+    }
+}
+
 inline FloatCoordinate toWGS84(const FloatCoordinate &mercator_coordinate)
 {
     return {mercator_coordinate.lon, yToLat(static_cast<double>(mercator_coordinate.lat))};
@@ -0,0 +1,96 @@
+#include "util/performance_counters.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include <cstdlib>
+
+// Compares the latency of route requests with and without alternatives. Run it once on a fully
+// contracted dataset and once on a dataset with an uncontracted core (osrm-contract --core) to
+// see the overhead of alternative routes on the core.
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    OSRM osrm{config};
+
+    // Route across monaco
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::False;
+    params.steps = false;
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    params.coordinates.push_back(
+        FloatCoordinate{FloatLongitude{7.419758}, FloatLatitude{43.731142}});
+    params.coordinates.push_back(
+        FloatCoordinate{FloatLongitude{7.439159}, FloatLatitude{43.749736}});
+
+    const auto NUM = 1000;
+    util::PerformanceCounters counters;
+    const auto benchmark = [&](const bool alternatives, std::size_t &number_of_routes) {
+        params.alternatives = alternatives;
+
+        counters.Reset();
+        TIMER_START(routes);
+        counters.Start();
+        for (int i = 0; i < NUM; ++i)
+        {
+            json::Object result;
+            const auto rc = osrm.Route(params, result);
+            if (rc != Status::Ok)
+            {
+                throw std::runtime_error("Route request failed");
+            }
+            number_of_routes = result.values.at("routes").get<json::Array>().values.size();
+        }
+        counters.Stop();
+        TIMER_STOP(routes);
+        return TIMER_MSEC(routes) / NUM;
+    };
+
+    std::size_t number_of_routes = 0;
+    const auto shortest_path_msec = benchmark(false, number_of_routes);
+    std::cout << shortest_path_msec << "ms/req for the shortest route" << std::endl;
+    std::cout << "per request: " << counters.GetTotals().ToString(NUM) << std::endl;
+
+    const auto alternatives_msec = benchmark(true, number_of_routes);
+    std::cout << alternatives_msec << "ms/req with alternatives, " << number_of_routes
+              << " routes found" << std::endl;
+    std::cout << "per request: " << counters.GetTotals().ToString(NUM) << std::endl;
+    std::cout << (alternatives_msec / shortest_path_msec) << "x latency for alternatives"
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,153 @@
+#include "engine/closure_overlay.hpp"
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/incoming_edge_index.hpp"
+#include "engine/internal_route_result.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/routing_algorithms/closure_aware_path.hpp"
+#include "engine/search_engine_data.hpp"
+#include "storage/storage_config.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned DEFAULT_NUMBER_OF_QUERIES = 1000;
+
+using ClosureAwarePathRouting =
+    engine::routing_algorithms::ClosureAwarePathRouting<engine::datafacade::BaseDataFacade>;
+
+// Snaps to the via node of an original edge leaving a random node
+engine::PhantomNode randomPhantom(const engine::datafacade::BaseDataFacade &facade,
+                                  std::mt19937 &mt_rand)
+{
+    std::uniform_int_distribution<NodeID> node_udist(0, facade.GetNumberOfNodes() - 1);
+    while (true)
+    {
+        const auto node = node_udist(mt_rand);
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (!data.shortcut)
+            {
+                const auto via_node = facade.GetOriginalEdgeData(data.id).via_node;
+                return facade
+                    .NearestPhantomNodeWithAlternativeFromBigComponent(
+                        facade.GetCoordinateOfNode(via_node))
+                    .first;
+            }
+        }
+    }
+}
+
+engine::ClosedNodes randomClosures(const engine::datafacade::BaseDataFacade &facade,
+                                   const std::size_t number_of_closures,
+                                   std::mt19937 &mt_rand)
+{
+    std::uniform_int_distribution<NodeID> node_udist(0, facade.GetNumberOfNodes() - 1);
+    engine::ClosedNodes closed_nodes(number_of_closures);
+    std::generate(
+        closed_nodes.begin(), closed_nodes.end(), [&] { return node_udist(mt_rand); });
+    std::sort(closed_nodes.begin(), closed_nodes.end());
+    closed_nodes.erase(std::unique(closed_nodes.begin(), closed_nodes.end()), closed_nodes.end());
+    return closed_nodes;
+}
+
+void benchmark(engine::datafacade::BaseDataFacade &facade, const unsigned number_of_queries)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+
+    TIMER_START(index);
+    const engine::IncomingEdgeIndex incoming_edges(facade);
+    TIMER_STOP(index);
+    std::cout << "indexed the incoming edges in " << TIMER_MSEC(index) << "ms\n";
+
+    std::vector<engine::PhantomNodes> queries(number_of_queries);
+    for (auto &query : queries)
+    {
+        query.source_phantom = randomPhantom(facade, mt_rand);
+        query.target_phantom = randomPhantom(facade, mt_rand);
+    }
+
+    engine::SearchEngineData engine_working_data;
+    ClosureAwarePathRouting routing(&facade, engine_working_data);
+
+    const auto run = [&](const engine::ClosedNodes &closed_nodes, std::size_t &number_of_routes) {
+        number_of_routes = 0;
+        TIMER_START(queries);
+        for (const auto &query : queries)
+        {
+            engine::InternalRouteResult result;
+            result.segment_end_coordinates = {query};
+            routing(result.segment_end_coordinates, closed_nodes, incoming_edges, result);
+            number_of_routes += result.is_valid();
+        }
+        TIMER_STOP(queries);
+        return TIMER_USEC(queries) / number_of_queries;
+    };
+
+    // warm up the heaps and the page cache
+    std::size_t number_of_routes = 0;
+    run({}, number_of_routes);
+
+    for (const std::size_t number_of_closures : {0, 10, 100, 1000, 10000, 100000})
+    {
+        if (number_of_closures > facade.GetNumberOfNodes())
+        {
+            break;
+        }
+        const auto closed_nodes = randomClosures(facade, number_of_closures, mt_rand);
+        const auto usec = run(closed_nodes, number_of_routes);
+        std::cout << closed_nodes.size() << " closures: " << usec << "us/query, "
+                  << number_of_routes << "/" << number_of_queries << " routes found\n";
+    }
+}
+}
+}
+
+// Routes random queries around an increasing number of random closures, to see how the latency
+// of /route grows with the closures published by osrm-closures.
+int main(int argc, const char *argv[]) try
+{
+    osrm::util::LogPolicy::GetInstance().Unmute();
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of queries]\n";
+        return EXIT_FAILURE;
+    }
+
+    const osrm::storage::StorageConfig config(argv[1]);
+    if (!config.IsValid())
+    {
+        std::cerr << "Invalid dataset " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const unsigned number_of_queries =
+        argc > 2 ? std::stoul(argv[2]) : osrm::benchmarks::DEFAULT_NUMBER_OF_QUERIES;
+
+    osrm::engine::datafacade::InternalDataFacade facade(config);
+    osrm::benchmarks::benchmark(facade, number_of_queries);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
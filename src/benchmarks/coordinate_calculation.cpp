@@ -0,0 +1,135 @@
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned NUMBER_OF_COORDINATES = 1000000;
+constexpr unsigned NUMBER_OF_RUNS = 20;
+
+// random walk with road geometry like segment lengths of a few meters
+std::vector<util::Coordinate> makePolyline()
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<> step_udist(-200, 200);
+    std::vector<util::Coordinate> polyline;
+    util::Coordinate current{util::FloatLongitude{13.4}, util::FloatLatitude{52.5}};
+    for (unsigned i = 0; i < NUMBER_OF_COORDINATES; i++)
+    {
+        polyline.push_back(current);
+        current.lon = current.lon + util::FixedLongitude{step_udist(mt_rand)};
+        current.lat = current.lat + util::FixedLatitude{step_udist(mt_rand)};
+    }
+    return polyline;
+}
+
+template <typename ScalarT, typename BatchT>
+void benchmarkKernel(const std::string &name, ScalarT scalar, BatchT batch)
+{
+    std::vector<double> scalar_distances(NUMBER_OF_COORDINATES);
+    std::vector<double> batch_distances(NUMBER_OF_COORDINATES);
+
+    TIMER_START(scalar);
+    for (unsigned run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+        scalar(scalar_distances);
+    }
+    TIMER_STOP(scalar);
+
+    TIMER_START(batch);
+    for (unsigned run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+        batch(batch_distances);
+    }
+    TIMER_STOP(batch);
+
+    double max_error = 0;
+    for (unsigned i = 0; i < NUMBER_OF_COORDINATES; ++i)
+    {
+        max_error = std::max(max_error, std::abs(scalar_distances[i] - batch_distances[i]));
+    }
+
+    const double scalar_nsec = TIMER_NSEC(scalar);
+    const double batch_nsec = TIMER_NSEC(batch);
+    const double total = NUMBER_OF_RUNS * NUMBER_OF_COORDINATES;
+    std::cout << name << ": scalar " << scalar_nsec / total << " ns, batch " << batch_nsec / total
+              << " ns per coordinate, speedup " << scalar_nsec / batch_nsec << ", max error "
+              << max_error << " m" << std::endl;
+}
+
+void benchmark()
+{
+    using namespace util::coordinate_calculation;
+
+    const auto polyline = makePolyline();
+    const auto segments = polyline.size() - 1;
+    const auto query = polyline[polyline.size() / 2];
+
+    benchmarkKernel("haversineDistances",
+                    [&](std::vector<double> &distances) {
+                        for (std::size_t i = 0; i < segments; ++i)
+                        {
+                            distances[i] = haversineDistance(polyline[i], polyline[i + 1]);
+                        }
+                    },
+                    [&](std::vector<double> &distances) {
+                        haversineDistances(
+                            polyline.data(), polyline.data() + 1, segments, distances.data());
+                    });
+
+    benchmarkKernel("greatCircleDistances",
+                    [&](std::vector<double> &distances) {
+                        for (std::size_t i = 0; i < segments; ++i)
+                        {
+                            distances[i] = greatCircleDistance(polyline[i], polyline[i + 1]);
+                        }
+                    },
+                    [&](std::vector<double> &distances) {
+                        greatCircleDistances(
+                            polyline.data(), polyline.data() + 1, segments, distances.data());
+                    });
+
+    std::vector<util::Coordinate> nearest_locations(segments);
+    std::vector<double> ratios(segments);
+    benchmarkKernel("perpendicularDistances",
+                    [&](std::vector<double> &distances) {
+                        for (std::size_t i = 0; i < segments; ++i)
+                        {
+                            distances[i] = perpendicularDistance(polyline[i],
+                                                                 polyline[i + 1],
+                                                                 query,
+                                                                 nearest_locations[i],
+                                                                 ratios[i]);
+                        }
+                    },
+                    [&](std::vector<double> &distances) {
+                        perpendicularDistances(polyline.data(),
+                                               polyline.data() + 1,
+                                               segments,
+                                               query,
+                                               distances.data(),
+                                               nearest_locations.data(),
+                                               ratios.data());
+                    });
+}
+}
+}
+
+int main()
+{
+    osrm::benchmarks::benchmark();
+
+    return 0;
+}
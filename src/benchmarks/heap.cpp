@@ -0,0 +1,173 @@
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/search_engine_data.hpp"
+#include "storage/storage_config.hpp"
+#include "util/performance_counters.hpp"
+#include "util/binary_heap.hpp"
+#include "util/quaternary_heap.hpp"
+#include "util/radix_heap.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned DEFAULT_NUMBER_OF_SEARCHES = 1000;
+
+template <template <typename, typename, typename, typename, typename> class HeapT>
+using BenchmarkHeap = HeapT<NodeID,
+                            NodeID,
+                            int,
+                            engine::HeapData,
+                            util::UnorderedMapStorage<NodeID, int>>;
+
+// Settles the upward search spaces of the contracted graph from the sources, the forward and the
+// backward search of a query without stalling. Returns the sum of all settled weights, which
+// has to be the same for all heaps.
+template <typename HeapT>
+std::uint64_t searchSpaces(const engine::datafacade::BaseDataFacade &facade,
+                           const std::vector<NodeID> &sources,
+                           std::uint64_t &number_of_settled_nodes)
+{
+    HeapT heap(facade.GetNumberOfNodes());
+    std::uint64_t checksum = 0;
+    number_of_settled_nodes = 0;
+    for (const auto forward : {true, false})
+    {
+        for (const auto source : sources)
+        {
+            heap.Clear();
+            heap.Insert(source, 0, source);
+            while (!heap.Empty())
+            {
+                const auto weight = heap.MinKey();
+                const auto node = heap.DeleteMin();
+                checksum += weight;
+                ++number_of_settled_nodes;
+
+                for (const auto edge : facade.GetAdjacentEdgeRange(node))
+                {
+                    const auto &data = facade.GetEdgeData(edge);
+                    if (!(forward ? data.forward : data.backward))
+                    {
+                        continue;
+                    }
+                    const auto to = facade.GetTarget(edge);
+                    const auto to_weight = weight + data.distance;
+                    if (!heap.WasInserted(to))
+                    {
+                        heap.Insert(to, to_weight, node);
+                    }
+                    else if (!heap.WasRemoved(to) && to_weight < heap.GetKey(to))
+                    {
+                        heap.GetData(to).parent = node;
+                        heap.DecreaseKey(to, to_weight);
+                    }
+                }
+            }
+        }
+    }
+    return checksum;
+}
+
+template <typename HeapT>
+bool benchmarkHeap(const std::string &name,
+                   const engine::datafacade::BaseDataFacade &facade,
+                   const std::vector<NodeID> &sources,
+                   std::uint64_t &expected_checksum)
+{
+    std::uint64_t number_of_settled_nodes = 0;
+    util::PerformanceCounters counters;
+    TIMER_START(searches);
+    counters.Start();
+    const auto checksum = searchSpaces<HeapT>(facade, sources, number_of_settled_nodes);
+    const auto events = counters.Stop();
+    TIMER_STOP(searches);
+
+    std::cout << name << ": " << TIMER_MSEC(searches) / (2 * sources.size()) << " ms/search, "
+              << TIMER_NSEC(searches) / number_of_settled_nodes << " ns/settled node"
+              << std::endl;
+    std::cout << "  per settled node: " << events.ToString(number_of_settled_nodes) << std::endl;
+
+    if (expected_checksum == 0)
+    {
+        expected_checksum = checksum;
+    }
+    return expected_checksum == checksum;
+}
+
+bool benchmark(const engine::datafacade::BaseDataFacade &facade, const unsigned number_of_searches)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_udist(0, facade.GetNumberOfNodes() - 1);
+    std::vector<NodeID> sources(number_of_searches);
+    for (auto &source : sources)
+    {
+        source = node_udist(mt_rand);
+    }
+
+    // warm up the page cache
+    std::uint64_t number_of_settled_nodes = 0;
+    searchSpaces<BenchmarkHeap<util::BinaryHeap>>(facade, sources, number_of_settled_nodes);
+
+    std::uint64_t checksum = 0;
+    bool same_results = benchmarkHeap<BenchmarkHeap<util::BinaryHeap>>(
+        "binary heap", facade, sources, checksum);
+    same_results &= benchmarkHeap<BenchmarkHeap<util::QuaternaryHeap>>(
+        "quaternary heap", facade, sources, checksum);
+    same_results &= benchmarkHeap<BenchmarkHeap<util::RadixHeap>>(
+        "radix heap", facade, sources, checksum);
+    return same_results;
+}
+}
+}
+
+// Compares the heaps that can be selected with HEAP_TYPE on the search spaces of the contracted
+// graph of a dataset
+int main(int argc, const char *argv[]) try
+{
+    osrm::util::LogPolicy::GetInstance().Unmute();
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of searches]\n";
+        return EXIT_FAILURE;
+    }
+
+    const osrm::storage::StorageConfig config(argv[1]);
+    if (!config.IsValid())
+    {
+        std::cerr << "Invalid dataset " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const unsigned number_of_searches =
+        argc > 2 ? std::stoul(argv[2]) : osrm::benchmarks::DEFAULT_NUMBER_OF_SEARCHES;
+
+    const osrm::engine::datafacade::InternalDataFacade facade(config);
+    if (!osrm::benchmarks::benchmark(facade, number_of_searches))
+    {
+        std::cerr << "The heaps settled different weights" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -1,3 +1,5 @@
+#include "util/coordinate_calculation.hpp"
+#include "util/performance_counters.hpp"
 #include "util/timing_util.hpp"
 
 #include "osrm/match_parameters.hpp"
@@ -11,6 +13,7 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <string>
@@ -210,22 +213,83 @@ int main(int argc, const char *argv[]) try
     params.coordinates.push_back(
         FloatCoordinate{FloatLongitude{7.415342330932617}, FloatLatitude{43.733251335381205}});
 
-    TIMER_START(routes);
-    auto NUM = 100;
-    for (int i = 0; i < NUM; ++i)
+    const auto NUM = 100;
+    util::PerformanceCounters counters;
+    const auto benchmark = [&](const MatchParameters &parameters, json::Object &result) {
+        TIMER_START(routes);
+        counters.Start();
+        for (int i = 0; i < NUM; ++i)
+        {
+            result = json::Object();
+            const auto rc = osrm.Match(parameters, result);
+            if (rc != Status::Ok ||
+                result.values.at("matchings").get<json::Array>().values.size() != 1)
+            {
+                return -1.;
+            }
+        }
+        counters.Stop();
+        TIMER_STOP(routes);
+        return TIMER_MSEC(routes) / NUM;
+    };
+
+    json::Object full_result;
+    const auto full_msec = benchmark(params, full_result);
+    if (full_msec < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << full_msec << "ms/req at " << params.coordinates.size() << " coordinate"
+              << std::endl;
+    std::cout << (full_msec / params.coordinates.size()) << "ms/coordinate" << std::endl;
+    std::cout << "per request: " << counters.GetTotals().ToString(NUM) << std::endl;
+    counters.Reset();
+
+    // thinning the trace and pruning candidates with tidy, compared against the full matching
+    auto tidy_params = params;
+    tidy_params.tidy = true;
+    json::Object tidy_result;
+    const auto tidy_msec = benchmark(tidy_params, tidy_result);
+    if (tidy_msec < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << tidy_msec << "ms/req with tidy, " << (100. * (1. - tidy_msec / full_msec))
+              << "% CPU saved" << std::endl;
+    std::cout << "per request with tidy: " << counters.GetTotals().ToString(NUM) << std::endl;
+
+    const auto getLocation = [](const json::Value &tracepoint) {
+        return tracepoint.get<json::Object>().values.at("location").get<json::LonLat>().value;
+    };
+    const auto getDistance = [](const json::Object &result) {
+        const auto &matching =
+            result.values.at("matchings").get<json::Array>().values.front().get<json::Object>();
+        return matching.values.at("distance").get<json::Number>().value;
+    };
+
+    const auto &full_tracepoints = full_result.values.at("tracepoints").get<json::Array>().values;
+    const auto &tidy_tracepoints = tidy_result.values.at("tracepoints").get<json::Array>().values;
+    BOOST_ASSERT(full_tracepoints.size() == tidy_tracepoints.size());
+    double sum_offset = 0;
+    double max_offset = 0;
+    std::size_t compared = 0;
+    for (std::size_t i = 0; i < full_tracepoints.size(); ++i)
     {
-        json::Object result;
-        const auto rc = osrm.Match(params, result);
-        if (rc != Status::Ok || result.values.at("matchings").get<json::Array>().values.size() != 1)
+        if (full_tracepoints[i].is<json::Null>() || tidy_tracepoints[i].is<json::Null>())
         {
-            return EXIT_FAILURE;
+            continue;
         }
+        const auto offset = util::coordinate_calculation::haversineDistance(
+            getLocation(full_tracepoints[i]), getLocation(tidy_tracepoints[i]));
+        sum_offset += offset;
+        max_offset = std::max(max_offset, offset);
+        ++compared;
     }
-    TIMER_STOP(routes);
-    std::cout << (TIMER_MSEC(routes) / NUM) << "ms/req at " << params.coordinates.size()
-              << " coordinate" << std::endl;
-    std::cout << (TIMER_MSEC(routes) / NUM / params.coordinates.size()) << "ms/coordinate"
+    std::cout << "tracepoint offset with tidy: mean " << (compared ? sum_offset / compared : 0.)
+              << " m, max " << max_offset << " m over " << compared << " tracepoints"
               << std::endl;
+    std::cout << "matched distance: " << getDistance(full_result) << " m, with tidy "
+              << getDistance(tidy_result) << " m" << std::endl;
 
     return EXIT_SUCCESS;
 }
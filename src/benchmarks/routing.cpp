@@ -0,0 +1,139 @@
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/routing_algorithms/routing_base.hpp"
+#include "engine/search_engine_data.hpp"
+#include "storage/storage_config.hpp"
+#include "util/performance_counters.hpp"
+#include "util/prefetch.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned DEFAULT_NUMBER_OF_QUERIES = 10000;
+
+// Exposes the plain bidirectional search of the routing base
+class NodeToNodeSearch final
+    : public engine::routing_algorithms::
+          BasicRoutingInterface<engine::datafacade::BaseDataFacade, NodeToNodeSearch>
+{
+    using super = engine::routing_algorithms::
+        BasicRoutingInterface<engine::datafacade::BaseDataFacade, NodeToNodeSearch>;
+
+  public:
+    NodeToNodeSearch(engine::datafacade::BaseDataFacade *facade,
+                     engine::SearchEngineData &engine_working_data)
+        : super(facade), engine_working_data(engine_working_data)
+    {
+    }
+
+    EdgeWeight operator()(const NodeID source, const NodeID target) const
+    {
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        auto &forward_heap = *(engine_working_data.forward_heap_1);
+        auto &reverse_heap = *(engine_working_data.reverse_heap_1);
+
+        forward_heap.Insert(source, 0, source);
+        reverse_heap.Insert(target, 0, target);
+
+        std::int32_t weight = INVALID_EDGE_WEIGHT;
+        std::vector<NodeID> packed_path;
+        super::Search(forward_heap, reverse_heap, weight, packed_path, false, false);
+        return weight;
+    }
+
+  private:
+    engine::SearchEngineData &engine_working_data;
+};
+
+void benchmark(engine::datafacade::BaseDataFacade &facade, const unsigned number_of_queries)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_udist(0, facade.GetNumberOfNodes() - 1);
+    std::vector<std::pair<NodeID, NodeID>> queries(number_of_queries);
+    for (auto &query : queries)
+    {
+        query = std::make_pair(node_udist(mt_rand), node_udist(mt_rand));
+    }
+
+    engine::SearchEngineData engine_working_data;
+    NodeToNodeSearch search(&facade, engine_working_data);
+
+    // warm up the heaps and the page cache
+    for (const auto &query : queries)
+    {
+        search(query.first, query.second);
+    }
+
+    util::PerformanceCounters counters;
+    std::size_t number_of_routes = 0;
+    TIMER_START(queries);
+    counters.Start();
+    for (const auto &query : queries)
+    {
+        number_of_routes += search(query.first, query.second) != INVALID_EDGE_WEIGHT;
+    }
+    const auto events = counters.Stop();
+    TIMER_STOP(queries);
+
+    std::cout << "prefetching " << (util::PREFETCHING_ENABLED ? "enabled" : "disabled") << ", "
+              << number_of_routes << "/" << number_of_queries << " routes found\n";
+    std::cout << (TIMER_USEC(queries) / number_of_queries) << "us/query\n";
+    std::cout << "per query: " << events.ToString(number_of_queries) << "\n";
+}
+}
+}
+
+// Runs random node to node queries on the contracted graph, compare builds with and without
+// -DENABLE_PREFETCHING=ON to evaluate prefetching in the search loop on a CPU.
+int main(int argc, const char *argv[]) try
+{
+    osrm::util::LogPolicy::GetInstance().Unmute();
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of queries]\n";
+        return EXIT_FAILURE;
+    }
+
+    const osrm::storage::StorageConfig config(argv[1]);
+    if (!config.IsValid())
+    {
+        std::cerr << "Invalid dataset " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const unsigned number_of_queries =
+        argc > 2 ? std::stoul(argv[2]) : osrm::benchmarks::DEFAULT_NUMBER_OF_QUERIES;
+
+    osrm::engine::datafacade::InternalDataFacade facade(config);
+    if (facade.GetCoreSize() > 0)
+    {
+        std::cerr << "The dataset has an uncontracted core, the searches settle all of it\n";
+    }
+
+    osrm::benchmarks::benchmark(facade, number_of_queries);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -4,6 +4,7 @@
 #include "mocks/mock_datafacade.hpp"
 #include "engine/geospatial_query.hpp"
 #include "util/coordinate.hpp"
+#include "util/performance_counters.hpp"
 #include "util/timing_util.hpp"
 
 #include <iostream>
@@ -52,12 +53,15 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
 {
     std::cout << "Running " << name << " with " << queries.size() << " coordinates: " << std::flush;
 
+    util::PerformanceCounters counters;
     TIMER_START(query);
+    counters.Start();
     for (const auto &q : queries)
     {
         auto result = query(q);
         (void)result;
     }
+    const auto events = counters.Stop();
     TIMER_STOP(query);
 
     std::cout << "Took " << TIMER_SEC(query) << " seconds "
@@ -65,6 +69,7 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")  ->  " << TIMER_MSEC(query) / queries.size() << " ms/query "
               << "(" << TIMER_MSEC(query) << "ms"
               << ")" << std::endl;
+    std::cout << "  per query: " << events.ToString(queries.size()) << std::endl;
 }
 
 void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
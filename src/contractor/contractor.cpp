@@ -5,6 +5,7 @@
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/node_based_edge.hpp"
 
+#include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
@@ -34,6 +35,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cmath>
 #include <cstdint>
 #include <fstream>
 #include <iterator>
@@ -127,11 +129,20 @@ int Contractor::Run()
         throw util::exception("Failed reading node weights.");
     }
 
-    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    // without lengths all edges of the contracted graph have length 0
+    std::vector<EdgeLength> node_lengths;
+    if (config.use_edge_lengths)
+    {
+        util::SimpleLogger().Write() << "Computing node lengths.";
+        ReadNodeLengths(max_edge_id, node_lengths);
+    }
+
+    util::DeallocatingVector<ContractedEdge> contracted_edge_list;
     ContractGraph(max_edge_id,
                   edge_based_edge_list,
                   contracted_edge_list,
                   std::move(node_weights),
+                  node_lengths,
                   is_core_node,
                   node_levels);
     TIMER_STOP(contraction);
@@ -139,6 +150,7 @@ int Contractor::Run()
     util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
     std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
+    WriteEdgeLengths(contracted_edge_list);
     WriteCoreNodeMarker(std::move(is_core_node));
     if (!config.use_cached_priority)
     {
@@ -820,6 +832,68 @@ void Contractor::ReadNodeLevels(std::vector<float> &node_levels) const
     order_input_stream.read((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
+// The length of an edge-based node is the sum of the lengths of the segments it covers. The
+// segments are taken from the leaves of the static rtree, since each of them knows the edge-based
+// nodes of both of its directions.
+void Contractor::ReadNodeLengths(const unsigned max_edge_id,
+                                 std::vector<EdgeLength> &node_lengths) const
+{
+    boost::filesystem::ifstream nodes_input_stream(config.node_based_graph_path,
+                                                   std::ios::binary);
+    if (!nodes_input_stream)
+    {
+        throw util::exception("Failed to open " + config.node_based_graph_path);
+    }
+
+    unsigned number_of_nodes = 0;
+    nodes_input_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+    std::vector<extractor::QueryNode> coordinates(number_of_nodes);
+    nodes_input_stream.read(reinterpret_cast<char *>(coordinates.data()),
+                            number_of_nodes * sizeof(extractor::QueryNode));
+
+    using LeafNode = util::StaticRTree<extractor::EdgeBasedNode>::LeafNode;
+
+    using boost::interprocess::file_mapping;
+    using boost::interprocess::mapped_region;
+    using boost::interprocess::read_only;
+
+    const file_mapping mapping{config.rtree_leaf_path.c_str(), read_only};
+    mapped_region region{mapping, read_only};
+    region.advise(mapped_region::advice_sequential);
+
+    const auto first = static_cast<const LeafNode *>(region.get_address());
+    const auto last = first + (region.get_size() / sizeof(LeafNode));
+
+    std::vector<double> lengths(max_edge_id + 1, 0.);
+    std::for_each(first, last, [&](const LeafNode &current_node) {
+        for (const auto i : util::irange<std::uint32_t>(0, current_node.object_count))
+        {
+            const auto &leaf_object = current_node.objects[i];
+            BOOST_ASSERT(leaf_object.u < coordinates.size());
+            BOOST_ASSERT(leaf_object.v < coordinates.size());
+            const double segment_length = util::coordinate_calculation::haversineDistance(
+                util::Coordinate{coordinates[leaf_object.u].lon, coordinates[leaf_object.u].lat},
+                util::Coordinate{coordinates[leaf_object.v].lon, coordinates[leaf_object.v].lat});
+
+            if (leaf_object.forward_segment_id.enabled)
+            {
+                BOOST_ASSERT(leaf_object.forward_segment_id.id <= max_edge_id);
+                lengths[leaf_object.forward_segment_id.id] += segment_length;
+            }
+            if (leaf_object.reverse_segment_id.enabled)
+            {
+                BOOST_ASSERT(leaf_object.reverse_segment_id.id <= max_edge_id);
+                lengths[leaf_object.reverse_segment_id.id] += segment_length;
+            }
+        }
+    });
+
+    node_lengths.resize(lengths.size());
+    std::transform(lengths.begin(), lengths.end(), node_lengths.begin(), [](const double length) {
+        return static_cast<EdgeLength>(std::round(length * 10.));
+    });
+}
+
 void Contractor::WriteNodeLevels(std::vector<float> &&in_node_levels) const
 {
     std::vector<float> node_levels(std::move(in_node_levels));
@@ -848,9 +922,30 @@ void Contractor::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
                                     sizeof(char) * unpacked_bool_flags.size());
 }
 
+// The lengths are in the order of the edges in the .hsgr, the file holds no lengths if they were
+// not requested
+void Contractor::WriteEdgeLengths(
+    const util::DeallocatingVector<ContractedEdge> &contracted_edge_list) const
+{
+    boost::filesystem::ofstream edge_lengths_output_stream(config.edge_lengths_output_path,
+                                                           std::ios::binary);
+    std::vector<EdgeLength> edge_lengths;
+    if (config.use_edge_lengths)
+    {
+        edge_lengths.reserve(contracted_edge_list.size());
+        for (const ContractedEdge &edge : contracted_edge_list)
+        {
+            edge_lengths.push_back(edge.length);
+        }
+    }
+    const unsigned size = edge_lengths.size();
+    edge_lengths_output_stream.write((char *)&size, sizeof(unsigned));
+    edge_lengths_output_stream.write((char *)edge_lengths.data(), sizeof(EdgeLength) * size);
+}
+
 std::size_t
 Contractor::WriteContractedGraph(unsigned max_node_id,
-                                 const util::DeallocatingVector<QueryEdge> &contracted_edge_list)
+                                 const util::DeallocatingVector<ContractedEdge> &contracted_edge_list)
 {
     // Sorting contracted edges in a way that the static query graph can read some in in-place.
     tbb::parallel_sort(contracted_edge_list.begin(), contracted_edge_list.end());
@@ -863,7 +958,7 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
     hsgr_output_stream.write((char *)&fingerprint, sizeof(util::FingerPrint));
     const unsigned max_used_node_id = [&contracted_edge_list] {
         unsigned tmp_max = 0;
-        for (const QueryEdge &edge : contracted_edge_list)
+        for (const ContractedEdge &edge : contracted_edge_list)
         {
             BOOST_ASSERT(SPECIAL_NODEID != edge.source);
             BOOST_ASSERT(SPECIAL_NODEID != edge.target);
@@ -972,16 +1067,20 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
 void Contractor::ContractGraph(
     const unsigned max_edge_id,
     util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
-    util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+    util::DeallocatingVector<ContractedEdge> &contracted_edge_list,
     std::vector<EdgeWeight> &&node_weights,
+    const std::vector<EdgeLength> &node_lengths,
     std::vector<bool> &is_core_node,
     std::vector<float> &inout_node_levels) const
 {
     std::vector<float> node_levels;
     node_levels.swap(inout_node_levels);
 
-    GraphContractor graph_contractor(
-        max_edge_id + 1, edge_based_edge_list, std::move(node_levels), std::move(node_weights));
+    GraphContractor graph_contractor(max_edge_id + 1,
+                                     edge_based_edge_list,
+                                     std::move(node_levels),
+                                     std::move(node_weights),
+                                     node_lengths);
     graph_contractor.Run(config.core_factor);
     graph_contractor.GetEdges(contracted_edge_list);
     graph_contractor.GetCoreMarker(is_core_node);
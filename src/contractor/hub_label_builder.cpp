@@ -0,0 +1,294 @@
+#include "contractor/hub_label_builder.hpp"
+
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/graph_loader.hpp"
+#include "util/hub_labels.hpp"
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+
+util::HubLabel makeView(const HubLabelBuilder::Label &label)
+{
+    return util::HubLabel{label.hubs.data(), label.weights.data(), label.hubs.size()};
+}
+
+// Merges the labels of all upward neighbours of node and prunes entries that are dominated by
+// a shorter path through another hub. opposite_labels must be final for all hubs above node.
+template <bool forward_direction>
+void buildLabel(const HubLabelBuilder::QueryGraph &graph,
+                const NodeID node,
+                std::vector<HubLabelBuilder::Label> &labels,
+                const std::vector<HubLabelBuilder::Label> &opposite_labels)
+{
+    std::vector<std::pair<NodeID, EdgeWeight>> candidates;
+    candidates.emplace_back(node, 0);
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        const auto &data = graph.GetEdgeData(edge);
+        const auto target = graph.GetTarget(edge);
+        if (target == node || !(forward_direction ? data.forward : data.backward))
+        {
+            continue;
+        }
+
+        const auto &upper_label = labels[target];
+        for (const auto index : util::irange<std::size_t>(0UL, upper_label.hubs.size()))
+        {
+            candidates.emplace_back(upper_label.hubs[index],
+                                    upper_label.weights[index] + data.distance);
+        }
+    }
+
+    // keep the smallest weight per hub
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(),
+                                 candidates.end(),
+                                 [](const std::pair<NodeID, EdgeWeight> &lhs,
+                                    const std::pair<NodeID, EdgeWeight> &rhs) {
+                                     return lhs.first == rhs.first;
+                                 }),
+                     candidates.end());
+
+    HubLabelBuilder::Label merged;
+    merged.hubs.reserve(candidates.size());
+    merged.weights.reserve(candidates.size());
+    for (const auto &candidate : candidates)
+    {
+        merged.hubs.push_back(candidate.first);
+        merged.weights.push_back(candidate.second);
+    }
+
+    auto &label = labels[node];
+    label.hubs.clear();
+    label.weights.clear();
+    for (const auto index : util::irange<std::size_t>(0UL, merged.hubs.size()))
+    {
+        const auto hub = merged.hubs[index];
+        const auto weight = merged.weights[index];
+        if (hub != node)
+        {
+            const auto shortest = util::intersectHubLabels(makeView(merged),
+                                                           makeView(opposite_labels[hub]));
+            if (shortest < weight)
+            {
+                continue;
+            }
+        }
+        label.hubs.push_back(hub);
+        label.weights.push_back(weight);
+    }
+    label.hubs.shrink_to_fit();
+    label.weights.shrink_to_fit();
+}
+}
+
+int HubLabelBuilder::Run()
+{
+    TIMER_START(preparing);
+
+    if (HasCore())
+    {
+        throw util::exception("Hub labels need a fully contracted hierarchy. Rerun osrm-contract "
+                              "with --core 1.0");
+    }
+
+    util::SimpleLogger().Write() << "Loading contracted graph from " << config.graph_path;
+    std::vector<QueryGraph::NodeArrayEntry> node_list;
+    std::vector<QueryGraph::EdgeArrayEntry> edge_list;
+    unsigned checksum = 0;
+    util::readHSGRFromStream(config.graph_path, node_list, edge_list, &checksum);
+    const QueryGraph graph(node_list, edge_list);
+
+    TIMER_START(labeling);
+    std::vector<Label> forward_labels;
+    std::vector<Label> backward_labels;
+    BuildLabels(graph, forward_labels, backward_labels);
+    TIMER_STOP(labeling);
+    util::SimpleLogger().Write() << "Labeling took " << TIMER_SEC(labeling) << " sec";
+
+    WriteLabels(checksum, forward_labels, backward_labels);
+
+    TIMER_STOP(preparing);
+    util::SimpleLogger().Write() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
+    util::SimpleLogger().Write() << "finished preprocessing";
+
+    return 0;
+}
+
+void HubLabelBuilder::BuildLabels(const QueryGraph &graph,
+                                  std::vector<Label> &forward_labels,
+                                  std::vector<Label> &backward_labels)
+{
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+    forward_labels.clear();
+    backward_labels.clear();
+    forward_labels.resize(number_of_nodes);
+    backward_labels.resize(number_of_nodes);
+
+    // A node can be labeled as soon as all of its upward neighbours are.
+    std::vector<std::uint32_t> pending_upward(number_of_nodes, 0);
+    std::vector<std::vector<NodeID>> downward_neighbours(number_of_nodes);
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto target = graph.GetTarget(edge);
+            if (target != node)
+            {
+                ++pending_upward[node];
+                downward_neighbours[target].push_back(node);
+            }
+        }
+    }
+
+    std::vector<NodeID> frontier;
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        if (pending_upward[node] == 0)
+        {
+            frontier.push_back(node);
+        }
+    }
+
+    std::size_t number_of_labeled_nodes = 0;
+    std::vector<NodeID> next_frontier;
+    while (!frontier.empty())
+    {
+        // all nodes of a frontier only depend on labels of earlier frontiers
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  const auto node = frontier[index];
+                                  buildLabel<true>(graph, node, forward_labels, backward_labels);
+                                  buildLabel<false>(graph, node, backward_labels, forward_labels);
+                              }
+                          });
+        number_of_labeled_nodes += frontier.size();
+
+        next_frontier.clear();
+        for (const auto node : frontier)
+        {
+            for (const auto lower : downward_neighbours[node])
+            {
+                BOOST_ASSERT(pending_upward[lower] > 0);
+                if (--pending_upward[lower] == 0)
+                {
+                    next_frontier.push_back(lower);
+                }
+            }
+        }
+        std::swap(frontier, next_frontier);
+    }
+
+    if (number_of_labeled_nodes != number_of_nodes)
+    {
+        throw util::exception("Query graph is not a hierarchy, can not derive hub labels");
+    }
+}
+
+bool HubLabelBuilder::HasCore() const
+{
+    boost::filesystem::ifstream core_stream(config.core_path, std::ios::binary);
+    if (!core_stream)
+    {
+        throw util::exception("Could not open " + config.core_path + " for reading.");
+    }
+
+    unsigned number_of_markers = 0;
+    core_stream.read(reinterpret_cast<char *>(&number_of_markers), sizeof(unsigned));
+    std::vector<char> core_markers(number_of_markers);
+    if (number_of_markers > 0)
+    {
+        core_stream.read(core_markers.data(), number_of_markers);
+    }
+    return std::any_of(
+        core_markers.begin(), core_markers.end(), [](const char marker) { return marker == 1; });
+}
+
+void HubLabelBuilder::WriteLabels(const unsigned checksum,
+                                  const std::vector<Label> &forward_labels,
+                                  const std::vector<Label> &backward_labels) const
+{
+    BOOST_ASSERT(forward_labels.size() == backward_labels.size());
+
+    const auto make_offsets = [](const std::vector<Label> &labels) {
+        std::vector<std::uint64_t> offsets;
+        offsets.reserve(labels.size() + 1);
+        offsets.push_back(0);
+        for (const auto &label : labels)
+        {
+            offsets.push_back(offsets.back() + label.hubs.size());
+        }
+        return offsets;
+    };
+    const auto forward_offsets = make_offsets(forward_labels);
+    const auto backward_offsets = make_offsets(backward_labels);
+
+    util::HubLabelsHeader header;
+    header.fingerprint = util::FingerPrint::GetValid();
+    header.checksum = checksum;
+    header.number_of_nodes = static_cast<std::uint32_t>(forward_labels.size());
+    header.number_of_forward_entries = forward_offsets.back();
+    header.number_of_backward_entries = backward_offsets.back();
+
+    util::SimpleLogger().Write() << "Serializing " << header.number_of_forward_entries
+                                 << " forward and " << header.number_of_backward_entries
+                                 << " backward label entries";
+
+    boost::filesystem::ofstream output_stream(config.hub_labels_output_path, std::ios::binary);
+    if (!output_stream)
+    {
+        throw util::exception("Could not open " + config.hub_labels_output_path +
+                              " for writing.");
+    }
+
+    output_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output_stream.write(reinterpret_cast<const char *>(forward_offsets.data()),
+                        forward_offsets.size() * sizeof(std::uint64_t));
+    output_stream.write(reinterpret_cast<const char *>(backward_offsets.data()),
+                        backward_offsets.size() * sizeof(std::uint64_t));
+
+    const auto write_labels = [&output_stream](const std::vector<Label> &labels) {
+        for (const auto &label : labels)
+        {
+            output_stream.write(reinterpret_cast<const char *>(label.hubs.data()),
+                                label.hubs.size() * sizeof(NodeID));
+        }
+        for (const auto &label : labels)
+        {
+            output_stream.write(reinterpret_cast<const char *>(label.weights.data()),
+                                label.weights.size() * sizeof(EdgeWeight));
+        }
+    };
+    write_labels(forward_labels);
+    write_labels(backward_labels);
+
+    if (!output_stream)
+    {
+        throw util::exception("Writing " + config.hub_labels_output_path + " failed.");
+    }
+}
+}
+}
@@ -77,12 +77,9 @@ std::string waypointTypeToString(const guidance::WaypointType waypoint_type)
     return waypoint_type_names[static_cast<std::size_t>(waypoint_type)];
 }
 
-util::json::Array coordinateToLonLat(const util::Coordinate coordinate)
+util::json::LonLat coordinateToLonLat(const util::Coordinate coordinate)
 {
-    util::json::Array array;
-    array.values.push_back(static_cast<double>(toFloating(coordinate.lon)));
-    array.values.push_back(static_cast<double>(toFloating(coordinate.lat)));
-    return array;
+    return util::json::LonLat{coordinate};
 }
 
 // FIXME this actually needs to be configurable from the profiles
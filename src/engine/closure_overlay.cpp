@@ -0,0 +1,112 @@
+#include "engine/closure_overlay.hpp"
+
+#include "storage/shared_memory.hpp"
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace osrm
+{
+namespace engine
+{
+
+ClosureOverlay::ClosureOverlay(const datafacade::BaseDataFacade &facade,
+                               const std::chrono::milliseconds refresh_interval)
+    : facade(facade), refresh_interval(refresh_interval), last_refresh(0),
+      current_region(storage::DATA_NONE), current_timestamp(0),
+      incoming_edges(std::make_shared<const IncomingEdgeIndex>(facade))
+{
+    std::lock_guard<std::mutex> lock(refresh_mutex);
+    Refresh();
+}
+
+std::shared_ptr<const ClosureOverlay::Closures>
+ClosureOverlay::GetClosures(const unsigned dataset_checksum)
+{
+    using Duration = std::chrono::steady_clock::duration;
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    const auto interval = std::chrono::duration_cast<Duration>(refresh_interval).count();
+    auto last = last_refresh.load(std::memory_order_relaxed);
+    if (now - last >= interval &&
+        last_refresh.compare_exchange_strong(last, now, std::memory_order_relaxed))
+    {
+        // only the query that won the exchange polls, nobody waits for a running poll
+        std::unique_lock<std::mutex> lock(refresh_mutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            Refresh();
+        }
+    }
+
+    const auto current = std::atomic_load(&snapshot);
+    if (current == nullptr || current->checksum != dataset_checksum)
+    {
+        return nullptr;
+    }
+    return current;
+}
+
+void ClosureOverlay::Refresh()
+{
+    last_refresh.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                       std::memory_order_relaxed);
+
+    try
+    {
+        if (!storage::SharedMemory::RegionExists(storage::CURRENT_CLOSURES))
+        {
+            std::atomic_store(&snapshot, std::shared_ptr<const Closures>());
+            return;
+        }
+
+        const std::unique_ptr<storage::SharedMemory> timestamp_memory(
+            storage::makeSharedMemory(storage::CURRENT_CLOSURES));
+        const auto timestamp =
+            *static_cast<const storage::SharedClosuresTimestamp *>(timestamp_memory->Ptr());
+        if (timestamp.region == current_region && timestamp.timestamp == current_timestamp)
+        {
+            return;
+        }
+
+        const std::unique_ptr<storage::SharedMemory> closures_memory(
+            storage::makeSharedMemory(timestamp.region));
+        const auto header =
+            static_cast<const storage::SharedClosuresHeader *>(closures_memory->Ptr());
+        const auto begin = reinterpret_cast<const NodeID *>(header + 1);
+
+        if (incoming_edges->GetCheckSum() != header->checksum)
+        {
+            if (facade.GetCheckSum() != header->checksum)
+            {
+                // published for a dataset the queries do not use yet, read again on the next poll
+                return;
+            }
+            incoming_edges = std::make_shared<const IncomingEdgeIndex>(facade);
+        }
+
+        auto new_snapshot = std::make_shared<Closures>();
+        new_snapshot->checksum = header->checksum;
+        new_snapshot->closed_nodes.assign(begin, begin + header->number_of_closed_nodes);
+        BOOST_ASSERT(std::is_sorted(new_snapshot->closed_nodes.begin(),
+                                    new_snapshot->closed_nodes.end()));
+        new_snapshot->incoming_edges = incoming_edges;
+        const auto number_of_closures = new_snapshot->closed_nodes.size();
+
+        current_region = timestamp.region;
+        current_timestamp = timestamp.timestamp;
+        std::atomic_store(&snapshot, std::shared_ptr<const Closures>(std::move(new_snapshot)));
+
+        util::SimpleLogger().Write() << "Loaded " << number_of_closures << " road closures";
+    }
+    catch (const std::exception &exc)
+    {
+        // keep serving the last known closures
+        util::SimpleLogger().Write(logWARNING) << "Could not read road closures: " << exc.what();
+    }
+}
+}
+}
@@ -45,9 +45,7 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
     }
 
     std::vector<util::FloatCoordinate> projected_coordinates(size);
-    std::transform(begin, end, projected_coordinates.begin(), [](const util::Coordinate coord) {
-        return util::web_mercator::fromWGS84(coord);
-    });
+    util::web_mercator::fromWGS84(&*begin, size, projected_coordinates.data());
 
     std::vector<bool> is_necessary(size, false);
     BOOST_ASSERT(is_necessary.size() >= 2);
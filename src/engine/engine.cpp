@@ -1,8 +1,10 @@
 #include "engine/engine.hpp"
 #include "engine/api/route_parameters.hpp"
+#include "engine/closure_overlay.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/status.hpp"
 
+#include "engine/plugins/facilities.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
@@ -15,6 +17,9 @@
 #include "engine/datafacade/shared_datafacade.hpp"
 
 #include "storage/shared_barriers.hpp"
+#include "util/exception.hpp"
+#include "util/hub_labels.hpp"
+#include "util/cell_table.hpp"
 #include "util/make_unique.hpp"
 #include "util/simple_logger.hpp"
 
@@ -82,33 +87,98 @@ void Engine::EngineLock::IncreaseQueryCount()
 
 namespace
 {
+// Counts a query as running and holds the data lock while it uses the shared memory. Streamed
+// replies let go of both while a piece of the reply is written to the client, so a slow client
+// does not hold back osrm-datastore and the queries waiting for its update.
+class RunningQuery
+{
+  public:
+    RunningQuery(osrm::engine::Engine::EngineLock &lock,
+                 osrm::engine::datafacade::SharedDataFacade &facade)
+        : lock(lock), facade(facade), counted(false)
+    {
+        try
+        {
+            Acquire();
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+        generation = facade.GetGeneration();
+    }
+
+    ~RunningQuery() { Release(); }
+
+    RunningQuery(const RunningQuery &) = delete;
+    RunningQuery &operator=(const RunningQuery &) = delete;
+
+    // The results computed so far refer to the data the query started with, the query is
+    // aborted if it was updated in the meantime
+    osrm::engine::ResponseWriter Unlocked(const osrm::engine::ResponseWriter &writer)
+    {
+        return [this, &writer](const char *data, const std::size_t size) {
+            Release();
+            writer(data, size);
+            Acquire();
+            if (facade.GetGeneration() != generation || facade.HasUpdates())
+            {
+                throw osrm::util::exception("Data was updated while the reply was sent");
+            }
+        };
+    }
+
+  private:
+    void Acquire()
+    {
+        lock.IncreaseQueryCount();
+        counted = true;
+        facade.CheckAndReloadFacade();
+        // Get a shared data lock so that other threads won't update
+        // things while the query is running
+        data_lock = boost::shared_lock<boost::shared_mutex>{facade.data_mutex};
+    }
+
+    void Release()
+    {
+        if (data_lock.owns_lock())
+        {
+            data_lock.unlock();
+        }
+        if (counted)
+        {
+            counted = false;
+            lock.DecreaseQueryCount();
+        }
+    }
+
+    osrm::engine::Engine::EngineLock &lock;
+    osrm::engine::datafacade::SharedDataFacade &facade;
+    boost::shared_lock<boost::shared_mutex> data_lock;
+    bool counted;
+    unsigned generation;
+};
+
 // Abstracted away the query locking into a template function
 // Works the same for every plugin.
-template <typename ParameterT, typename PluginT, typename ResultT>
+template <typename ParameterT, typename PluginT, typename ResultT, typename... WriterT>
 osrm::engine::Status RunQuery(const std::unique_ptr<osrm::engine::Engine::EngineLock> &lock,
                               osrm::engine::datafacade::BaseDataFacade &facade,
                               const ParameterT &parameters,
                               PluginT &plugin,
-                              ResultT &result)
+                              ResultT &result,
+                              const WriterT &... writer)
 {
     if (!lock)
     {
-        return plugin.HandleRequest(parameters, result);
+        return plugin.HandleRequest(parameters, result, writer...);
     }
 
     BOOST_ASSERT(lock);
-    lock->IncreaseQueryCount();
-
-    auto &shared_facade = static_cast<osrm::engine::datafacade::SharedDataFacade &>(facade);
-    shared_facade.CheckAndReloadFacade();
-    // Get a shared data lock so that other threads won't update
-    // things while the query is running
-    boost::shared_lock<boost::shared_mutex> data_lock{shared_facade.data_mutex};
-
-    osrm::engine::Status status = plugin.HandleRequest(parameters, result);
-
-    lock->DecreaseQueryCount();
-    return status;
+    RunningQuery query(*lock,
+                       static_cast<osrm::engine::datafacade::SharedDataFacade &>(facade));
+    return plugin.HandleRequest(parameters, result, query.Unlocked(writer)...);
 }
 
 template <typename Plugin, typename Facade, typename... Args>
@@ -131,6 +201,10 @@ Engine::Engine(EngineConfig &config)
         lock = util::make_unique<EngineLock>();
         query_data_facade = util::make_unique<datafacade::SharedDataFacade>();
     }
+    else if (!config.image_path.empty())
+    {
+        query_data_facade = util::make_unique<datafacade::SharedDataFacade>(config.image_path);
+    }
     else
     {
         if (!config.storage_config.IsValid())
@@ -141,15 +215,52 @@ Engine::Engine(EngineConfig &config)
             util::make_unique<datafacade::InternalDataFacade>(config.storage_config);
     }
 
+    if (!config.hub_labels_path.empty())
+    {
+        hub_labels = util::make_unique<util::HubLabels>(config.hub_labels_path);
+        if (hub_labels->GetCheckSum() != query_data_facade->GetCheckSum())
+        {
+            throw util::exception("Hub labels in " + config.hub_labels_path.string() +
+                                  " were not created for this dataset");
+        }
+        util::SimpleLogger().Write() << "Loaded " << hub_labels->GetNumberOfEntries()
+                                     << " hub label entries ("
+                                     << (hub_labels->GetSizeInBytes() >> 20) << " MiB)";
+    }
+
+    if (!config.cell_table_path.empty())
+    {
+        cell_table = util::make_unique<util::CellTable>();
+        cell_table->Read(config.cell_table_path);
+        if (cell_table->GetCheckSum() != query_data_facade->GetCheckSum())
+        {
+            throw util::exception("Cell table in " + config.cell_table_path.string() +
+                                  " was not created for this dataset");
+        }
+        util::SimpleLogger().Write() << "Loaded cell table with "
+                                     << cell_table->GetNumberOfCells() << " cells";
+    }
+
+    if (config.use_closures)
+    {
+        closures = util::make_unique<ClosureOverlay>(*query_data_facade);
+    }
+
     // Register plugins
     using namespace plugins;
 
-    route_plugin = create<ViaRoutePlugin>(*query_data_facade, config.max_locations_viaroute);
-    table_plugin = create<TablePlugin>(*query_data_facade, config.max_locations_distance_table);
+    route_plugin = create<ViaRoutePlugin>(
+        *query_data_facade, config.max_locations_viaroute, closures.get());
+    table_plugin = create<TablePlugin>(*query_data_facade,
+                                       config.max_locations_distance_table,
+                                       hub_labels.get(),
+                                       cell_table.get());
     nearest_plugin = create<NearestPlugin>(*query_data_facade);
     trip_plugin = create<TripPlugin>(*query_data_facade, config.max_locations_trip);
     match_plugin = create<MatchPlugin>(*query_data_facade, config.max_locations_map_matching);
     tile_plugin = create<TilePlugin>(*query_data_facade);
+    facilities_plugin = create<FacilitiesPlugin>(
+        *query_data_facade, config.max_locations_distance_table, config.facility_set_paths);
 }
 
 // make sure we deallocate the unique ptr at a position where we know the size of the plugins
@@ -167,6 +278,13 @@ Status Engine::Table(const api::TableParameters &params, util::json::Object &res
     return RunQuery(lock, *query_data_facade, params, *table_plugin, result);
 }
 
+Status Engine::Table(const api::TableParameters &params,
+                     util::json::Object &result,
+                     const ResponseWriter &writer)
+{
+    return RunQuery(lock, *query_data_facade, params, *table_plugin, result, writer);
+}
+
 Status Engine::Nearest(const api::NearestParameters &params, util::json::Object &result)
 {
     return RunQuery(lock, *query_data_facade, params, *nearest_plugin, result);
@@ -187,5 +305,10 @@ Status Engine::Tile(const api::TileParameters &params, std::string &result)
     return RunQuery(lock, *query_data_facade, params, *tile_plugin, result);
 }
 
+Status Engine::Facilities(const api::FacilitiesParameters &params, util::json::Object &result)
+{
+    return RunQuery(lock, *query_data_facade, params, *facilities_plugin, result);
+}
+
 } // engine ns
 } // osrm ns
@@ -9,7 +9,8 @@ bool EngineConfig::IsValid() const
 {
     const bool all_path_are_empty =
         storage_config.ram_index_path.empty() && storage_config.file_index_path.empty() &&
-        storage_config.hsgr_data_path.empty() && storage_config.nodes_data_path.empty() &&
+        storage_config.hsgr_data_path.empty() && storage_config.edge_lengths_path.empty() &&
+        storage_config.nodes_data_path.empty() &&
         storage_config.edges_data_path.empty() && storage_config.core_data_path.empty() &&
         storage_config.geometries_path.empty() && storage_config.timestamp_path.empty() &&
         storage_config.datasource_names_path.empty() &&
@@ -21,7 +22,10 @@ bool EngineConfig::IsValid() const
         (max_locations_trip == -1 || max_locations_trip > 2) &&
         (max_locations_viaroute == -1 || max_locations_viaroute > 2);
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    const bool use_image = !use_shared_memory && !image_path.empty();
+
+    return (((use_shared_memory || use_image) && all_path_are_empty) || storage_config.IsValid()) &&
+           limits_valid;
 }
 }
 }
@@ -0,0 +1,198 @@
+#include "engine/plugins/facilities.hpp"
+
+#include "engine/api/facilities_api.hpp"
+#include "engine/api/facilities_parameters.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+namespace
+{
+std::vector<util::Coordinate> readFacilities(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream facilities_file(path);
+    if (!facilities_file)
+    {
+        throw util::exception("Unable to open facility set " + path.string());
+    }
+
+    std::vector<util::Coordinate> coordinates;
+    double lon{};
+    double lat{};
+    for (std::string line; std::getline(facilities_file, line);)
+    {
+        using namespace boost::spirit::qi;
+
+        auto it = begin(line);
+        const auto last = end(line);
+
+        const auto ok = parse(it, last, (double_ >> ',' >> double_), lon, lat);
+        if (!ok || it != last)
+        {
+            throw util::exception("Facility set " + path.string() + " malformed");
+        }
+
+        util::Coordinate coordinate{util::FloatLongitude(lon), util::FloatLatitude(lat)};
+        if (!coordinate.IsValid())
+        {
+            throw util::exception("Facility set " + path.string() + " has invalid coordinates");
+        }
+        coordinates.push_back(coordinate);
+    }
+    return coordinates;
+}
+}
+
+FacilitiesPlugin::FacilitiesPlugin(
+    datafacade::BaseDataFacade &facade,
+    const int max_locations_facilities,
+    const std::map<std::string, boost::filesystem::path> &facility_set_paths)
+    : BasePlugin{facade}, nearest_facilities(&facade, heaps),
+      max_locations_facilities(max_locations_facilities)
+{
+    for (const auto &name_and_path : facility_set_paths)
+    {
+        auto &facility_set = facility_sets[name_and_path.first];
+        facility_set.coordinates = readFacilities(name_and_path.second);
+        util::SimpleLogger().Write() << "Registered facility set " << name_and_path.first
+                                     << " with " << facility_set.coordinates.size()
+                                     << " facilities";
+    }
+}
+
+std::shared_ptr<const FacilitiesPlugin::SnappedFacilities>
+FacilitiesPlugin::GetFacilitySet(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(facility_sets_mutex);
+
+    const auto iter = facility_sets.find(name);
+    if (iter == facility_sets.end())
+    {
+        return nullptr;
+    }
+
+    auto &facility_set = iter->second;
+    if (facility_set.snapped == nullptr || facility_set.checksum != facade.GetCheckSum())
+    {
+        api::BaseParameters parameters;
+        parameters.coordinates = facility_set.coordinates;
+
+        auto snapped = std::make_shared<SnappedFacilities>();
+        snapped->phantoms = SnapPhantomNodes(GetPhantomNodes(parameters));
+
+        std::vector<std::size_t> all_facilities(snapped->phantoms.size());
+        std::iota(all_facilities.begin(), all_facilities.end(), 0);
+        snapped->buckets = nearest_facilities.BuildBuckets(snapped->phantoms, all_facilities);
+
+        facility_set.checksum = facade.GetCheckSum();
+        facility_set.snapped = std::move(snapped);
+    }
+    return facility_set.snapped;
+}
+
+Status FacilitiesPlugin::HandleRequest(const api::FacilitiesParameters &params,
+                                       util::json::Object &result)
+{
+    BOOST_ASSERT(params.IsValid());
+
+    if (!CheckAllCoordinates(params.coordinates))
+    {
+        return Error("InvalidOptions", "Coordinates are invalid", result);
+    }
+
+    if (params.bearings.size() > 0 && params.coordinates.size() != params.bearings.size())
+    {
+        return Error(
+            "InvalidOptions", "Number of bearings does not match number of coordinates", result);
+    }
+
+    std::vector<std::size_t> source_indices = params.sources;
+    if (source_indices.empty())
+    {
+        for (const auto index : util::irange<std::size_t>(0UL, params.coordinates.size()))
+        {
+            if (std::find(params.destinations.begin(), params.destinations.end(), index) ==
+                params.destinations.end())
+            {
+                source_indices.push_back(index);
+            }
+        }
+    }
+
+    std::shared_ptr<const SnappedFacilities> facilities;
+    std::size_t number_of_facilities = params.destinations.size();
+    if (!params.facility_set.empty())
+    {
+        facilities = GetFacilitySet(params.facility_set);
+        if (facilities == nullptr)
+        {
+            return Error(
+                "InvalidOptions", "Unknown facility set " + params.facility_set, result);
+        }
+        number_of_facilities = facilities->phantoms.size();
+    }
+
+    if (max_locations_facilities > 0 &&
+        (source_indices.size() * number_of_facilities >
+         static_cast<std::size_t>(max_locations_facilities * max_locations_facilities)))
+    {
+        return Error("TooBig", "Too many facilities coordinates", result);
+    }
+
+    const auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(params));
+
+    if (facilities == nullptr)
+    {
+        auto snapped = std::make_shared<SnappedFacilities>();
+        for (const auto index : params.destinations)
+        {
+            snapped->phantoms.push_back(snapped_phantoms[index]);
+        }
+        snapped->buckets = nearest_facilities.BuildBuckets(snapped_phantoms, params.destinations);
+        facilities = std::move(snapped);
+    }
+
+    // no source can have more results than there are facilities
+    const auto number_of_results = static_cast<unsigned>(
+        std::min<std::size_t>(params.number_of_results, facilities->phantoms.size()));
+
+    std::vector<PhantomNode> source_phantoms;
+    std::vector<std::vector<routing_algorithms::FacilityResult>> facility_results;
+    for (const auto index : source_indices)
+    {
+        source_phantoms.push_back(snapped_phantoms[index]);
+        if (number_of_results == 0)
+        {
+            facility_results.emplace_back();
+            continue;
+        }
+        facility_results.push_back(
+            nearest_facilities(snapped_phantoms[index], facilities->buckets, number_of_results));
+    }
+
+    api::FacilitiesAPI facilities_api{facade, params};
+    facilities_api.MakeResponse(facility_results, source_phantoms, facilities->phantoms, result);
+
+    return Status::Ok;
+}
+}
+}
+}
@@ -4,6 +4,8 @@
 #include "engine/api/match_api.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/map_matching/bayes_classifier.hpp"
+#include "engine/map_matching/trace_thinning.hpp"
+#include "engine/query_trace.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_logger.hpp"
@@ -24,6 +26,39 @@ namespace engine
 namespace plugins
 {
 
+namespace
+{
+// Empty per point parameters stay empty
+template <typename T>
+std::vector<T> selectElements(const std::vector<T> &values, const std::vector<std::size_t> &indices)
+{
+    if (values.empty())
+    {
+        return values;
+    }
+    std::vector<T> selected;
+    selected.reserve(indices.size());
+    for (const auto index : indices)
+    {
+        selected.push_back(values[index]);
+    }
+    return selected;
+}
+
+// Restricts all per point parameters to the points with the given indices
+api::MatchParameters selectPoints(const api::MatchParameters &parameters,
+                                  const std::vector<std::size_t> &indices)
+{
+    auto selected = parameters;
+    selected.coordinates = selectElements(parameters.coordinates, indices);
+    selected.hints = selectElements(parameters.hints, indices);
+    selected.radiuses = selectElements(parameters.radiuses, indices);
+    selected.bearings = selectElements(parameters.bearings, indices);
+    selected.timestamps = selectElements(parameters.timestamps, indices);
+    return selected;
+}
+}
+
 // Filters PhantomNodes to obtain a set of viable candiates
 void filterCandidates(const std::vector<util::Coordinate> &coordinates,
                       MatchPlugin::CandidateLists &candidates_lists)
@@ -123,20 +158,31 @@ Status MatchPlugin::HandleRequest(const api::MatchParameters &parameters,
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
     }
 
+    // With tidy only the points left after thinning the trace are matched, the others are
+    // interpolated between their matched neighbours in the response
+    std::vector<std::size_t> kept_indices;
+    if (parameters.tidy)
+    {
+        kept_indices = map_matching::thinTrace(parameters.coordinates, parameters.timestamps);
+    }
+    const auto tidied_parameters =
+        parameters.tidy ? selectPoints(parameters, kept_indices) : api::MatchParameters{};
+    const auto &matched_parameters = parameters.tidy ? tidied_parameters : parameters;
+
     // assuming radius is the standard deviation of a normal distribution
     // that models GPS noise (in this model), x3 should give us the correct
     // search radius with > 99% confidence
     std::vector<double> search_radiuses;
-    if (parameters.radiuses.empty())
+    if (matched_parameters.radiuses.empty())
     {
-        search_radiuses.resize(parameters.coordinates.size(),
+        search_radiuses.resize(matched_parameters.coordinates.size(),
                                DEFAULT_GPS_PRECISION * RADIUS_MULTIPLIER);
     }
     else
     {
-        search_radiuses.resize(parameters.coordinates.size());
-        std::transform(parameters.radiuses.begin(),
-                       parameters.radiuses.end(),
+        search_radiuses.resize(matched_parameters.coordinates.size());
+        std::transform(matched_parameters.radiuses.begin(),
+                       matched_parameters.radiuses.end(),
                        search_radiuses.begin(),
                        [](const boost::optional<double> &maybe_radius) {
                            if (maybe_radius)
@@ -151,9 +197,14 @@ Status MatchPlugin::HandleRequest(const api::MatchParameters &parameters,
                        });
     }
 
-    auto candidates_lists = GetPhantomNodesInRange(parameters, search_radiuses);
+    auto candidates_lists = GetPhantomNodesInRange(matched_parameters, search_radiuses);
 
-    filterCandidates(parameters.coordinates, candidates_lists);
+    filterCandidates(matched_parameters.coordinates, candidates_lists);
+    if (parameters.tidy)
+    {
+        std::for_each(
+            candidates_lists.begin(), candidates_lists.end(), map_matching::pruneCandidates);
+    }
     if (std::all_of(candidates_lists.begin(),
                     candidates_lists.end(),
                     [](const std::vector<PhantomNodeWithDistance> &candidates) {
@@ -166,14 +217,27 @@ Status MatchPlugin::HandleRequest(const api::MatchParameters &parameters,
     }
 
     // call the actual map matching
-    SubMatchingList sub_matchings = map_matching(
-        candidates_lists, parameters.coordinates, parameters.timestamps, parameters.radiuses);
+    SubMatchingList sub_matchings = map_matching(candidates_lists,
+                                                 matched_parameters.coordinates,
+                                                 matched_parameters.timestamps,
+                                                 matched_parameters.radiuses);
 
     if (sub_matchings.size() == 0)
     {
         return Error("NoMatch", "Could not match the trace.", json_result);
     }
 
+    if (parameters.tidy)
+    {
+        for (auto &sub_matching : sub_matchings)
+        {
+            for (auto &index : sub_matching.indices)
+            {
+                index = kept_indices[index];
+            }
+        }
+    }
+
     std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
     for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
     {
@@ -197,6 +261,7 @@ Status MatchPlugin::HandleRequest(const api::MatchParameters &parameters,
         BOOST_ASSERT(sub_routes[index].shortest_path_length != INVALID_EDGE_WEIGHT);
     }
 
+    ScopedTraceStage stage("response");
     api::MatchAPI match_api{BasePlugin::facade, parameters};
     match_api.MakeResponse(sub_matchings, sub_routes, json_result);
 
@@ -2,15 +2,24 @@
 
 #include "engine/api/table_api.hpp"
 #include "engine/api/table_parameters.hpp"
+#include "engine/query_trace.hpp"
+#include "engine/routing_algorithms/approximate_table.hpp"
+#include "engine/routing_algorithms/hub_label_table.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
 #include "util/string_util.hpp"
 
+#include <cmath>
 #include <cstdlib>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -23,13 +32,66 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(datafacade::BaseDataFacade &facade, const int max_locations_distance_table)
+namespace
+{
+// Empty indices select all phantom nodes
+std::vector<std::size_t> expandIndices(const std::vector<std::size_t> &indices,
+                                       const std::size_t number_of_phantoms)
+{
+    if (!indices.empty())
+    {
+        return indices;
+    }
+    std::vector<std::size_t> all(number_of_phantoms);
+    std::iota(all.begin(), all.end(), 0);
+    return all;
+}
+
+// The great circle distance is a lower bound of the route distance, so pairs farther apart than
+// max_distance can never be in range
+std::vector<bool> findPairsInRange(const std::vector<PhantomNode> &phantom_nodes,
+                                   const std::vector<std::size_t> &sources,
+                                   const std::vector<std::size_t> &targets,
+                                   const double max_distance)
+{
+    std::vector<bool> in_range(sources.size() * targets.size(), false);
+    for (const auto row : util::irange<std::size_t>(0UL, sources.size()))
+    {
+        for (const auto column : util::irange<std::size_t>(0UL, targets.size()))
+        {
+            const auto distance = util::coordinate_calculation::haversineDistance(
+                phantom_nodes[sources[row]].location, phantom_nodes[targets[column]].location);
+            in_range[row * targets.size() + column] = distance <= max_distance;
+        }
+    }
+    return in_range;
+}
+
+// durations are given in seconds, weights are in deciseconds
+EdgeWeight getMaxWeight(const api::TableParameters &params)
+{
+    return params.max_duration
+               ? static_cast<EdgeWeight>(std::min<double>(std::round(*params.max_duration * 10.),
+                                                          INVALID_EDGE_WEIGHT - 1))
+               : INVALID_EDGE_WEIGHT;
+}
+
+// Number of entries of the table computed at once for streamed responses
+const constexpr std::size_t STREAMED_BLOCK_ENTRIES = 1 << 16;
+}
+
+TablePlugin::TablePlugin(datafacade::BaseDataFacade &facade,
+                         const int max_locations_distance_table,
+                         const util::HubLabels *hub_labels,
+                         const util::CellTable *cell_table)
     : BasePlugin{facade}, distance_table(&facade, heaps),
-      max_locations_distance_table(max_locations_distance_table)
+      max_locations_distance_table(max_locations_distance_table), hub_labels(hub_labels),
+      cell_table(cell_table)
 {
 }
 
-Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json::Object &result)
+Status TablePlugin::ValidateRequest(const api::TableParameters &params,
+                                    util::json::Object &result)
 {
     BOOST_ASSERT(params.IsValid());
 
@@ -44,6 +106,25 @@ Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json
             "InvalidOptions", "Number of bearings does not match number of coordinates", result);
     }
 
+    // a shared memory dataset might have been swapped for one the cells do not belong to
+    if (params.approximate &&
+        (cell_table == nullptr || cell_table->GetCheckSum() != facade.GetCheckSum()))
+    {
+        return Error("InvalidOptions", "Approximate tables are not available", result);
+    }
+
+    if (params.approximate && params.HasDistances())
+    {
+        return Error("InvalidOptions", "Approximate tables do not support distances", result);
+    }
+
+    if (params.HasDistances() && !facade.HasEdgeLengths())
+    {
+        return Error("InvalidOptions",
+                     "Distances need a dataset contracted with osrm-contract --edge-lengths",
+                     result);
+    }
+
     // Empty sources or destinations means the user wants all of them included, respectively
     // The ManyToMany routing algorithm we dispatch to below already handles this perfectly.
     const auto num_sources =
@@ -58,19 +139,344 @@ Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json
         return Error("TooBig", "Too many table coordinates", result);
     }
 
+    return Status::Ok;
+}
+
+Status TablePlugin::HandleRequest(const api::TableParameters &params, util::json::Object &result)
+{
+    const auto validation = ValidateRequest(params, result);
+    if (validation != Status::Ok)
+    {
+        return validation;
+    }
+
     auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(params));
-    auto result_table = distance_table(snapped_phantoms, params.sources, params.destinations);
+    const EdgeWeight max_weight = getMaxWeight(params);
+
+    std::vector<EdgeWeight> result_table;
+    std::vector<EdgeWeight> estimated_duration_errors;
+    std::vector<EdgeLength> length_table;
+    auto *const requested_lengths = params.HasDistances() ? &length_table : nullptr;
+    if (params.approximate)
+    {
+        if (!ComputeApproximateTable(snapped_phantoms, params, max_weight, result_table,
+                                     estimated_duration_errors))
+        {
+            return Error("NoTable", "No table found", result);
+        }
+    }
+    else if (params.max_distance)
+    {
+        const auto sources = expandIndices(params.sources, snapped_phantoms.size());
+        const auto targets = expandIndices(params.destinations, snapped_phantoms.size());
+        const auto in_range =
+            findPairsInRange(snapped_phantoms, sources, targets, *params.max_distance);
+        result_table.resize(sources.size() * targets.size(), INVALID_EDGE_WEIGHT);
+        length_table.resize(result_table.size(), INVALID_EDGE_WEIGHT);
+        if (!ComputePartialTable(snapped_phantoms,
+                                 sources,
+                                 targets,
+                                 in_range,
+                                 max_weight,
+                                 result_table,
+                                 requested_lengths))
+        {
+            result_table.clear();
+        }
+        else if (params.HasDistances())
+        {
+            // The straight line only pruned the pairs that are certainly too far apart, the
+            // lengths of the computed paths decide for all others. Lengths are in decimeters.
+            for (const auto index : util::irange<std::size_t>(0UL, result_table.size()))
+            {
+                if (length_table[index] != INVALID_EDGE_WEIGHT &&
+                    length_table[index] > *params.max_distance * 10.)
+                {
+                    result_table[index] = INVALID_EDGE_WEIGHT;
+                }
+            }
+        }
+    }
+    else
+    {
+        result_table = ComputeTable(snapped_phantoms,
+                                    params.sources,
+                                    params.destinations,
+                                    max_weight,
+                                    requested_lengths);
+    }
 
     if (result_table.empty())
     {
         return Error("NoTable", "No table found", result);
     }
 
+    ScopedTraceStage stage("response");
     api::TableAPI table_api{facade, params};
     table_api.MakeResponse(result_table, snapped_phantoms, result);
+    if (params.approximate)
+    {
+        table_api.AddEstimatedDurationErrors(estimated_duration_errors, result);
+    }
+    if (params.HasDistances())
+    {
+        BOOST_ASSERT(length_table.size() == result_table.size());
+        for (const auto index : util::irange<std::size_t>(0UL, result_table.size()))
+        {
+            if (result_table[index] == INVALID_EDGE_WEIGHT)
+            {
+                length_table[index] = INVALID_EDGE_WEIGHT;
+            }
+        }
+        table_api.AddDistances(length_table, result);
+    }
+
+    return Status::Ok;
+}
+
+// Plain duration tables are computed and rendered in blocks of rows, so the memory of a request
+// is bounded by the block size instead of the size of the table. All other tables are rendered
+// at once and handed to the writer in one piece.
+Status TablePlugin::HandleRequest(const api::TableParameters &params,
+                                  util::json::Object &result,
+                                  const ResponseWriter &writer)
+{
+    if (params.approximate || params.max_distance || params.HasDistances() ||
+        !params.HasDurations())
+    {
+        const auto status = HandleRequest(params, result);
+        if (status == Status::Ok)
+        {
+            std::vector<char> output;
+            util::json::render(output, result);
+            writer(output.data(), output.size());
+        }
+        return status;
+    }
 
+    const auto validation = ValidateRequest(params, result);
+    if (validation != Status::Ok)
+    {
+        return validation;
+    }
+
+    const auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(params));
+    const EdgeWeight max_weight = getMaxWeight(params);
+    const auto sources = expandIndices(params.sources, snapped_phantoms.size());
+    const auto targets = expandIndices(params.destinations, snapped_phantoms.size());
+    const auto rows_per_block = std::max<std::size_t>(1, STREAMED_BLOCK_ENTRIES / targets.size());
+
+    api::TableAPI table_api{facade, params};
+    std::vector<char> output;
+    std::vector<char> closing;
+    table_api.BeginStreamedResponse(snapped_phantoms, output, closing);
+    writer(output.data(), output.size());
+
+    const auto write_rows = [&](const std::size_t first_row, const std::vector<EdgeWeight> &rows) {
+        output.clear();
+        table_api.AppendStreamedRows(rows, first_row, targets.size(), output);
+        writer(output.data(), output.size());
+    };
+
+    // the labels answer a block of sources at once, blocks they can not answer are searched
+    if (hub_labels != nullptr && hub_labels->GetCheckSum() == facade.GetCheckSum())
+    {
+        for (std::size_t first_row = 0; first_row < sources.size(); first_row += rows_per_block)
+        {
+            const std::vector<std::size_t> block_sources(
+                sources.begin() + first_row,
+                sources.begin() + std::min(first_row + rows_per_block, sources.size()));
+            write_rows(first_row,
+                       ComputeTable(snapped_phantoms, block_sources, targets, max_weight));
+        }
+    }
+    else
+    {
+        distance_table.ForEachRowBlock(
+            snapped_phantoms,
+            sources,
+            targets,
+            max_weight,
+            rows_per_block,
+            [&](const std::size_t first_row, const std::vector<EdgeWeight> &rows) {
+                write_rows(first_row, rows);
+            });
+    }
+
+    writer(closing.data(), closing.size());
     return Status::Ok;
 }
+
+std::vector<EdgeWeight> TablePlugin::ComputeTable(const std::vector<PhantomNode> &phantom_nodes,
+                                                  const std::vector<std::size_t> &source_indices,
+                                                  const std::vector<std::size_t> &target_indices,
+                                                  const EdgeWeight max_weight,
+                                                  std::vector<EdgeLength> *length_table)
+{
+    std::vector<EdgeWeight> result_table;
+    // a shared memory dataset might have been swapped for one the labels do not belong to,
+    // the labels only know durations
+    if (length_table == nullptr && hub_labels != nullptr &&
+        hub_labels->GetCheckSum() == facade.GetCheckSum())
+    {
+        result_table = routing_algorithms::HubLabelTable{*hub_labels}(
+            phantom_nodes, source_indices, target_indices);
+        std::replace_if(result_table.begin(),
+                        result_table.end(),
+                        [max_weight](const EdgeWeight weight) { return weight > max_weight; },
+                        INVALID_EDGE_WEIGHT);
+    }
+    if (result_table.empty())
+    {
+        result_table = distance_table(
+            phantom_nodes, source_indices, target_indices, max_weight, length_table);
+    }
+    return result_table;
+}
+
+// Only sources and targets with at least one wanted entry take part in the searches.
+bool TablePlugin::ComputePartialTable(const std::vector<PhantomNode> &phantom_nodes,
+                                      const std::vector<std::size_t> &sources,
+                                      const std::vector<std::size_t> &targets,
+                                      const std::vector<bool> &wanted,
+                                      const EdgeWeight max_weight,
+                                      std::vector<EdgeWeight> &result_table,
+                                      std::vector<EdgeLength> *length_table)
+{
+    BOOST_ASSERT(wanted.size() == sources.size() * targets.size());
+    BOOST_ASSERT(result_table.size() == wanted.size());
+    BOOST_ASSERT(length_table == nullptr || length_table->size() == wanted.size());
+
+    std::vector<std::size_t> used_sources;
+    std::vector<bool> target_is_used(targets.size(), false);
+    for (const auto row : util::irange<std::size_t>(0UL, sources.size()))
+    {
+        bool source_is_used = false;
+        for (const auto column : util::irange<std::size_t>(0UL, targets.size()))
+        {
+            if (wanted[row * targets.size() + column])
+            {
+                target_is_used[column] = true;
+                source_is_used = true;
+            }
+        }
+        if (source_is_used)
+        {
+            used_sources.push_back(row);
+        }
+    }
+    std::vector<std::size_t> used_targets;
+    for (const auto column : util::irange<std::size_t>(0UL, targets.size()))
+    {
+        if (target_is_used[column])
+        {
+            used_targets.push_back(column);
+        }
+    }
+
+    if (used_sources.empty())
+    {
+        return true;
+    }
+
+    const auto to_phantom_indices = [](const std::vector<std::size_t> &used,
+                                       const std::vector<std::size_t> &indices) {
+        std::vector<std::size_t> phantom_indices(used.size());
+        std::transform(used.begin(),
+                       used.end(),
+                       phantom_indices.begin(),
+                       [&indices](const std::size_t idx) { return indices[idx]; });
+        return phantom_indices;
+    };
+    std::vector<EdgeLength> partial_lengths;
+    const auto partial_table = ComputeTable(phantom_nodes,
+                                            to_phantom_indices(used_sources, sources),
+                                            to_phantom_indices(used_targets, targets),
+                                            max_weight,
+                                            length_table ? &partial_lengths : nullptr);
+    if (partial_table.empty())
+    {
+        return false;
+    }
+
+    for (const auto row : util::irange<std::size_t>(0UL, used_sources.size()))
+    {
+        for (const auto column : util::irange<std::size_t>(0UL, used_targets.size()))
+        {
+            const auto index = used_sources[row] * targets.size() + used_targets[column];
+            if (wanted[index])
+            {
+                const auto partial_index = row * used_targets.size() + column;
+                result_table[index] = partial_table[partial_index];
+                if (length_table != nullptr)
+                {
+                    (*length_table)[index] = partial_lengths[partial_index];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Entries between distant cells come from the cell table, only the remaining ones are searched.
+bool TablePlugin::ComputeApproximateTable(const std::vector<PhantomNode> &phantom_nodes,
+                                          const api::TableParameters &params,
+                                          const EdgeWeight max_weight,
+                                          std::vector<EdgeWeight> &result_table,
+                                          std::vector<EdgeWeight> &estimated_duration_errors)
+{
+    BOOST_ASSERT(cell_table != nullptr);
+
+    const auto sources = expandIndices(params.sources, phantom_nodes.size());
+    const auto targets = expandIndices(params.destinations, phantom_nodes.size());
+
+    auto approximation =
+        routing_algorithms::ApproximateTable{*cell_table}(phantom_nodes, sources, targets);
+
+    if (params.max_distance)
+    {
+        const auto in_range =
+            findPairsInRange(phantom_nodes, sources, targets, *params.max_distance);
+        for (const auto index : util::irange<std::size_t>(0UL, in_range.size()))
+        {
+            if (!in_range[index])
+            {
+                approximation.durations[index] = INVALID_EDGE_WEIGHT;
+                approximation.needs_exact[index] = false;
+            }
+        }
+    }
+
+    if (!ComputePartialTable(phantom_nodes,
+                             sources,
+                             targets,
+                             approximation.needs_exact,
+                             max_weight,
+                             approximation.durations))
+    {
+        return false;
+    }
+
+    for (const auto index : util::irange<std::size_t>(0UL, approximation.durations.size()))
+    {
+        if (approximation.durations[index] > max_weight)
+        {
+            approximation.durations[index] = INVALID_EDGE_WEIGHT;
+        }
+        if (approximation.durations[index] == INVALID_EDGE_WEIGHT)
+        {
+            approximation.errors[index] = INVALID_EDGE_WEIGHT;
+        }
+        else if (approximation.needs_exact[index])
+        {
+            approximation.errors[index] = 0;
+        }
+    }
+
+    result_table = std::move(approximation.durations);
+    estimated_duration_errors = std::move(approximation.errors);
+    return true;
+}
 }
 }
 }
@@ -2,16 +2,11 @@
 #include "engine/plugins/plugin_base.hpp"
 
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/vector_tile.hpp"
 #include "util/web_mercator.hpp"
 
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/geometries.hpp>
-#include <boost/geometry/geometries/point_xy.hpp>
-#include <boost/geometry/multi/geometries/multi_linestring.hpp>
-
 #include <protozero/pbf_writer.hpp>
-#include <protozero/varint.hpp>
 
 #include <string>
 #include <utility>
@@ -26,144 +21,6 @@ namespace engine
 {
 namespace plugins
 {
-namespace detail
-{
-// Simple container class for WGS84 coordinates
-template <typename T> struct Point final
-{
-    Point(T _x, T _y) : x(_x), y(_y) {}
-
-    const T x;
-    const T y;
-};
-
-// from mapnik-vector-tile
-namespace pbf
-{
-inline unsigned encode_length(const unsigned len) { return (len << 3u) | 2u; }
-}
-
-struct BBox final
-{
-    BBox(const double _minx, const double _miny, const double _maxx, const double _maxy)
-        : minx(_minx), miny(_miny), maxx(_maxx), maxy(_maxy)
-    {
-    }
-
-    double width() const { return maxx - minx; }
-    double height() const { return maxy - miny; }
-
-    const double minx;
-    const double miny;
-    const double maxx;
-    const double maxy;
-};
-
-// Simple container for integer coordinates (i.e. pixel coords)
-struct point_type_i final
-{
-    point_type_i(std::int64_t _x, std::int64_t _y) : x(_x), y(_y) {}
-
-    const std::int64_t x;
-    const std::int64_t y;
-};
-
-using FixedLine = std::vector<detail::Point<std::int32_t>>;
-using FloatLine = std::vector<detail::Point<double>>;
-
-typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> point_t;
-typedef boost::geometry::model::linestring<point_t> linestring_t;
-typedef boost::geometry::model::box<point_t> box_t;
-typedef boost::geometry::model::multi_linestring<linestring_t> multi_linestring_t;
-const static box_t clip_box(point_t(-util::vector_tile::BUFFER, -util::vector_tile::BUFFER),
-                            point_t(util::vector_tile::EXTENT + util::vector_tile::BUFFER,
-                                    util::vector_tile::EXTENT + util::vector_tile::BUFFER));
-
-// from mapnik-vector-tile
-// Encodes a linestring using protobuf zigzag encoding
-inline bool encodeLinestring(const FixedLine &line,
-                             protozero::packed_field_uint32 &geometry,
-                             std::int32_t &start_x,
-                             std::int32_t &start_y)
-{
-    const std::size_t line_size = line.size();
-    if (line_size < 2)
-    {
-        return false;
-    }
-
-    const unsigned line_to_length = static_cast<const unsigned>(line_size) - 1;
-
-    auto pt = line.begin();
-    geometry.add_element(9); // move_to | (1 << 3)
-    geometry.add_element(protozero::encode_zigzag32(pt->x - start_x));
-    geometry.add_element(protozero::encode_zigzag32(pt->y - start_y));
-    start_x = pt->x;
-    start_y = pt->y;
-    geometry.add_element(detail::pbf::encode_length(line_to_length));
-    for (++pt; pt != line.end(); ++pt)
-    {
-        const std::int32_t dx = pt->x - start_x;
-        const std::int32_t dy = pt->y - start_y;
-        geometry.add_element(protozero::encode_zigzag32(dx));
-        geometry.add_element(protozero::encode_zigzag32(dy));
-        start_x = pt->x;
-        start_y = pt->y;
-    }
-    return true;
-}
-
-FixedLine coordinatesToTileLine(const util::Coordinate start,
-                                const util::Coordinate target,
-                                const detail::BBox &tile_bbox)
-{
-    FloatLine geo_line;
-    geo_line.emplace_back(static_cast<double>(util::toFloating(start.lon)),
-                          static_cast<double>(util::toFloating(start.lat)));
-    geo_line.emplace_back(static_cast<double>(util::toFloating(target.lon)),
-                          static_cast<double>(util::toFloating(target.lat)));
-
-    linestring_t unclipped_line;
-
-    for (auto const &pt : geo_line)
-    {
-        double px_merc = pt.x * util::web_mercator::DEGREE_TO_PX;
-        double py_merc = util::web_mercator::latToY(util::FloatLatitude(pt.y)) *
-                         util::web_mercator::DEGREE_TO_PX;
-        // convert lon/lat to tile coordinates
-        const auto px = std::round(
-            ((px_merc - tile_bbox.minx) * util::web_mercator::TILE_SIZE / tile_bbox.width()) *
-            util::vector_tile::EXTENT / util::web_mercator::TILE_SIZE);
-        const auto py = std::round(
-            ((tile_bbox.maxy - py_merc) * util::web_mercator::TILE_SIZE / tile_bbox.height()) *
-            util::vector_tile::EXTENT / util::web_mercator::TILE_SIZE);
-
-        boost::geometry::append(unclipped_line, point_t(px, py));
-    }
-
-    multi_linestring_t clipped_line;
-
-    boost::geometry::intersection(clip_box, unclipped_line, clipped_line);
-
-    FixedLine tile_line;
-
-    // b::g::intersection might return a line with one point if the
-    // original line was very short and coords were dupes
-    if (!clipped_line.empty() && clipped_line[0].size() == 2)
-    {
-        if (clipped_line[0].size() == 2)
-        {
-            for (const auto &p : clipped_line[0])
-            {
-                tile_line.emplace_back(p.get<0>(), p.get<1>());
-            }
-        }
-    }
-
-    return tile_line;
-}
-}
-
 Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::string &pbf_buffer)
 {
     BOOST_ASSERT(parameters.IsValid());
@@ -181,6 +38,22 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
     // This hits the OSRM StaticRTree
     const auto edges = facade.GetEdgesInBox(southwest, northeast);
 
+    // Project the segment end points and compute the segment lengths in batches
+    std::vector<util::Coordinate> sources(edges.size());
+    std::vector<util::Coordinate> targets(edges.size());
+    for (const auto edge_index : util::irange<std::size_t>(0UL, edges.size()))
+    {
+        sources[edge_index] = facade.GetCoordinateOfNode(edges[edge_index].u);
+        targets[edge_index] = facade.GetCoordinateOfNode(edges[edge_index].v);
+    }
+    std::vector<util::FloatCoordinate> projected_sources(edges.size());
+    std::vector<util::FloatCoordinate> projected_targets(edges.size());
+    util::web_mercator::fromWGS84(sources.data(), sources.size(), projected_sources.data());
+    util::web_mercator::fromWGS84(targets.data(), targets.size(), projected_targets.data());
+    std::vector<double> lengths(edges.size());
+    util::coordinate_calculation::haversineDistances(
+        sources.data(), targets.data(), edges.size(), lengths.data());
+
     std::vector<int> used_weights;
     std::unordered_map<int, std::size_t> weight_offsets;
     uint8_t max_datasource_id = 0;
@@ -244,7 +117,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
     // Convert tile coordinates into mercator coordinates
     util::web_mercator::xyzToMercator(
         parameters.x, parameters.y, parameters.z, min_lon, min_lat, max_lon, max_lat);
-    const detail::BBox tile_bbox{min_lon, min_lat, max_lon, max_lat};
+    const util::vector_tile::BBox tile_bbox{min_lon, min_lat, max_lon, max_lat};
 
     // Protobuf serialized blocks when objects go out of scope, hence
     // the extra scoping below.
@@ -265,13 +138,14 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
         {
             // Each feature gets a unique id, starting at 1
             unsigned id = 1;
-            for (const auto &edge : edges)
+            for (const auto edge_index : util::irange<std::size_t>(0UL, edges.size()))
             {
-                // Get coordinates for start/end nodes of segmet (NodeIDs u and v)
-                const auto a = facade.GetCoordinateOfNode(edge.u);
-                const auto b = facade.GetCoordinateOfNode(edge.v);
-                // Calculate the length in meters
-                const double length = osrm::util::coordinate_calculation::haversineDistance(a, b);
+                const auto &edge = edges[edge_index];
+                // Projected start/end nodes of segment (NodeIDs u and v)
+                const auto &a = projected_sources[edge_index];
+                const auto &b = projected_targets[edge_index];
+                // Length in meters
+                const double length = lengths[edge_index];
 
                 int forward_weight = 0;
                 int reverse_weight = 0;
@@ -317,7 +191,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
                 max_datasource_id = std::max(max_datasource_id, reverse_datasource);
 
                 const auto encode_tile_line = [&layer_writer, &edge, &id, &max_datasource_id](
-                    const detail::FixedLine &tile_line,
+                    const util::vector_tile::FixedLine &tile_line,
                     const std::uint32_t speed_kmh,
                     const std::size_t duration,
                     const std::uint8_t datasource,
@@ -362,7 +236,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
                         // Encode the geometry for the feature
                         protozero::packed_field_uint32 geometry(
                             feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
-                        encodeLinestring(tile_line, geometry, start_x, start_y);
+                        util::vector_tile::encodeLinestring(tile_line, geometry, start_x, start_y);
                     }
                 };
 
@@ -376,7 +250,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
                     std::uint32_t speed_kmh =
                         static_cast<std::uint32_t>(round(length / forward_weight * 10 * 3.6));
 
-                    auto tile_line = coordinatesToTileLine(a, b, tile_bbox);
+                    auto tile_line = util::vector_tile::coordinatesToTileLine(a, b, tile_bbox);
                     if (!tile_line.empty())
                     {
                         encode_tile_line(tile_line,
@@ -399,7 +273,7 @@ Status TilePlugin::HandleRequest(const api::TileParameters &parameters, std::str
                     std::uint32_t speed_kmh =
                         static_cast<std::uint32_t>(round(length / reverse_weight * 10 * 3.6));
 
-                    auto tile_line = coordinatesToTileLine(b, a, tile_bbox);
+                    auto tile_line = util::vector_tile::coordinatesToTileLine(b, a, tile_bbox);
                     if (!tile_line.empty())
                     {
                         encode_tile_line(tile_line,
@@ -4,6 +4,7 @@
 
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/query_trace.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
@@ -234,6 +235,7 @@ Status TripPlugin::HandleRequest(const api::TripParameters &parameters,
         routes.push_back(ComputeRoute(snapped_phantoms, trip));
     }
 
+    ScopedTraceStage stage("response");
     api::TripAPI trip_api{BasePlugin::facade, parameters};
     trip_api.MakeResponse(trips, routes, snapped_phantoms, json_result);
 
@@ -1,6 +1,7 @@
 #include "engine/plugins/viaroute.hpp"
 #include "engine/api/route_api.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
+#include "engine/query_trace.hpp"
 #include "engine/status.hpp"
 
 #include "util/for_each_pair.hpp"
@@ -21,9 +22,12 @@ namespace engine
 namespace plugins
 {
 
-ViaRoutePlugin::ViaRoutePlugin(datafacade::BaseDataFacade &facade_, int max_locations_viaroute)
+ViaRoutePlugin::ViaRoutePlugin(datafacade::BaseDataFacade &facade_,
+                               int max_locations_viaroute,
+                               ClosureOverlay *closures)
     : BasePlugin(facade_), shortest_path(&facade_, heaps), alternative_path(&facade_, heaps),
-      direct_shortest_path(&facade_, heaps), max_locations_viaroute(max_locations_viaroute)
+      direct_shortest_path(&facade_, heaps), closure_aware_path(&facade_, heaps),
+      max_locations_viaroute(max_locations_viaroute), closures(closures)
 {
 }
 
@@ -47,6 +51,23 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
     }
 
+    const auto active_closures =
+        closures != nullptr ? closures->GetClosures(facade.GetCheckSum()) : nullptr;
+    const bool avoid_closures =
+        active_closures != nullptr && !active_closures->closed_nodes.empty();
+
+    // legs around closures are computed one by one and without alternatives
+    if (avoid_closures && route_parameters.alternatives)
+    {
+        return Error("InvalidOptions", "Alternatives are not available with closures", json_result);
+    }
+    if (avoid_closures && route_parameters.continue_straight &&
+        *route_parameters.continue_straight)
+    {
+        return Error(
+            "InvalidOptions", "continue_straight is not available with closures", json_result);
+    }
+
     auto phantom_node_pairs = GetPhantomNodes(route_parameters);
     if (phantom_node_pairs.size() != route_parameters.coordinates.size())
     {
@@ -83,9 +104,16 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
     };
     util::for_each_pair(snapped_phantoms, build_phantom_pairs);
 
-    if (1 == raw_route.segment_end_coordinates.size())
+    if (avoid_closures)
+    {
+        closure_aware_path(raw_route.segment_end_coordinates,
+                           active_closures->closed_nodes,
+                           *active_closures->incoming_edges,
+                           raw_route);
+    }
+    else if (1 == raw_route.segment_end_coordinates.size())
     {
-        if (route_parameters.alternatives && facade.GetCoreSize() == 0)
+        if (route_parameters.alternatives)
         {
             alternative_path(raw_route.segment_end_coordinates.front(), raw_route);
         }
@@ -104,6 +132,7 @@ Status ViaRoutePlugin::HandleRequest(const api::RouteParameters &route_parameter
     // allow for connection in one direction.
     if (raw_route.is_valid())
     {
+        ScopedTraceStage stage("response");
         api::RouteAPI route_api{BasePlugin::facade, route_parameters};
         route_api.MakeResponse(raw_route, json_result);
     }
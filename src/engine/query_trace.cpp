@@ -0,0 +1,56 @@
+#include "engine/query_trace.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+thread_local ScopedQueryTrace *current_trace = nullptr;
+}
+
+ScopedQueryTrace::ScopedQueryTrace(QueryTrace &trace, const std::size_t max_settled_nodes)
+    : trace(trace), record_settled_nodes(max_settled_nodes > 0),
+      settled_node_limit{max_settled_nodes, false}, outer_trace(current_trace)
+{
+    current_trace = this;
+}
+
+ScopedQueryTrace::~ScopedQueryTrace()
+{
+    for (auto &traced_heap : traced_heaps)
+    {
+        const auto &counters = traced_heap->counters;
+        traced_heap->heap_statistics->Attach(traced_heap->outer_counters);
+        if (traced_heap->outer_counters != nullptr)
+        {
+            traced_heap->outer_counters->number_of_searches += counters.number_of_searches;
+            traced_heap->outer_counters->number_of_settled_nodes +=
+                counters.number_of_settled_nodes;
+        }
+        traced_heap->statistics.number_of_searches = counters.number_of_searches;
+        traced_heap->statistics.number_of_settled_nodes = counters.number_of_settled_nodes;
+        trace.heaps.push_back(std::move(traced_heap->statistics));
+    }
+    trace.settled_nodes_truncated = settled_node_limit.exceeded;
+    current_trace = outer_trace;
+}
+
+ScopedQueryTrace *ScopedQueryTrace::Current() { return current_trace; }
+
+void ScopedQueryTrace::AddStage(const char *name, const double milliseconds)
+{
+    for (auto &stage : trace.stages)
+    {
+        if (stage.name == name)
+        {
+            stage.count += 1;
+            stage.milliseconds += milliseconds;
+            return;
+        }
+    }
+    trace.stages.push_back(QueryTrace::Stage{name, 1, milliseconds});
+}
+}
+}
@@ -1,6 +1,7 @@
 #include "engine/search_engine_data.hpp"
+#include "engine/query_trace.hpp"
 
-#include "util/binary_heap.hpp"
+#include "util/search_heap.hpp"
 
 namespace osrm
 {
@@ -13,67 +14,58 @@ SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
+SearchEngineData::ManyToManyHeapPtr SearchEngineData::many_to_many_heap;
+SearchEngineData::HiddenMarkovModelPtr SearchEngineData::hidden_markov_model;
 
-void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+namespace
+{
+// Clears the heap of the calling thread for a new search. Heaps are added to the trace of the
+// query before they are cleared, so the trace counts this search as well.
+template <typename HeapT>
+void initializeOrClear(boost::thread_specific_ptr<HeapT> &heap,
+                       const char *name,
+                       const unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
+    if (!heap.get())
     {
-        forward_heap_1->Clear();
+        heap.reset(new HeapT(number_of_nodes));
     }
-    else
+    if (auto *trace = ScopedQueryTrace::Current())
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        trace->AddHeap(name, *heap);
     }
+    heap->Clear();
+}
+}
 
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+{
+    initializeOrClear(forward_heap_1, "forward 1", number_of_nodes);
+    initializeOrClear(reverse_heap_1, "reverse 1", number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClear(forward_heap_2, "forward 2", number_of_nodes);
+    initializeOrClear(reverse_heap_2, "reverse 2", number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClear(forward_heap_3, "forward 3", number_of_nodes);
+    initializeOrClear(reverse_heap_3, "reverse 3", number_of_nodes);
+}
 
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
+void SearchEngineData::InitializeOrClearManyToManyThreadLocalStorage(const unsigned number_of_nodes)
+{
+    initializeOrClear(many_to_many_heap, "many to many", number_of_nodes);
+}
+
+void SearchEngineData::InitializeHiddenMarkovModelThreadLocalStorage()
+{
+    if (!hidden_markov_model.get())
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        hidden_markov_model.reset(new map_matching::HiddenMarkovModel());
     }
 }
 }
@@ -0,0 +1,349 @@
+#include "engine/slow_query_log.hpp"
+
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/simple_logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+
+struct SlowQueryLogHeader
+{
+    util::FingerPrint fingerprint;
+    std::uint32_t number_of_slots;
+    std::uint64_t slot_size;
+};
+
+// A sequence number of 0 marks an empty slot
+struct SlotHeader
+{
+    std::uint64_t sequence_number;
+    std::uint64_t size;
+};
+
+bool isValidHeader(const SlowQueryLogHeader &header)
+{
+    const auto valid = util::FingerPrint::GetValid();
+    return valid.IsMagicNumberOK(header.fingerprint) &&
+           valid.TestQueryObjects(header.fingerprint) && header.number_of_slots > 0 &&
+           header.slot_size > sizeof(SlotHeader);
+}
+
+std::uint64_t getSlotOffset(const std::uint32_t number_of_slots,
+                            const std::uint64_t slot_size,
+                            const std::uint64_t sequence_number)
+{
+    return sizeof(SlowQueryLogHeader) + (sequence_number % number_of_slots) * slot_size;
+}
+
+template <typename T> void append(std::string &buffer, const T &value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void appendString(std::string &buffer, const std::string &value)
+{
+    append(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+std::string serializeRecord(const SlowQueryRecord &record)
+{
+    std::string buffer;
+    append(buffer, record.timestamp);
+    appendString(buffer, record.dataset);
+    appendString(buffer, record.service);
+    appendString(buffer, record.query);
+    append(buffer, record.milliseconds);
+    append(buffer, static_cast<std::uint8_t>(record.sampled));
+    append(buffer, static_cast<std::uint8_t>(record.truncated));
+
+    append(buffer, static_cast<std::uint32_t>(record.trace.stages.size()));
+    for (const auto &stage : record.trace.stages)
+    {
+        appendString(buffer, stage.name);
+        append(buffer, stage.count);
+        append(buffer, stage.milliseconds);
+    }
+
+    append(buffer, static_cast<std::uint32_t>(record.trace.heaps.size()));
+    for (const auto &heap : record.trace.heaps)
+    {
+        appendString(buffer, heap.name);
+        append(buffer, heap.number_of_searches);
+        append(buffer, heap.number_of_settled_nodes);
+        append(buffer, static_cast<std::uint64_t>(heap.settled_nodes.size()));
+        buffer.append(reinterpret_cast<const char *>(heap.settled_nodes.data()),
+                      heap.settled_nodes.size() * sizeof(NodeID));
+    }
+    return buffer;
+}
+
+// Reads the values of a serialized record, throws if the record ends early
+class RecordReader
+{
+  public:
+    RecordReader(const char *begin, const char *end) : position(begin), end(end) {}
+
+    template <typename T> T Read()
+    {
+        T value;
+        Copy(&value, sizeof(T));
+        return value;
+    }
+
+    std::string ReadString()
+    {
+        std::string value(ReadCount(1), '\0');
+        Copy(&value[0], value.size());
+        return value;
+    }
+
+    // Number of the elements that follow, each of them takes at least minimum_size bytes
+    std::size_t ReadCount(const std::size_t minimum_size)
+    {
+        const auto count = Read<std::uint32_t>();
+        if (count > static_cast<std::size_t>(end - position) / minimum_size)
+        {
+            throw util::exception("Slow query record is corrupt");
+        }
+        return count;
+    }
+
+    template <typename T> void ReadVector(std::vector<T> &values)
+    {
+        const auto size = Read<std::uint64_t>();
+        if (size > static_cast<std::uint64_t>(end - position) / sizeof(T))
+        {
+            throw util::exception("Slow query record is corrupt");
+        }
+        values.resize(size);
+        Copy(values.data(), size * sizeof(T));
+    }
+
+  private:
+    void Copy(void *destination, const std::size_t size)
+    {
+        if (size > static_cast<std::size_t>(end - position))
+        {
+            throw util::exception("Slow query record is corrupt");
+        }
+        std::memcpy(destination, position, size);
+        position += size;
+    }
+
+    const char *position;
+    const char *const end;
+};
+
+SlowQueryRecord deserializeRecord(const std::uint64_t sequence_number, const std::string &buffer)
+{
+    RecordReader reader(buffer.data(), buffer.data() + buffer.size());
+    SlowQueryRecord record;
+    record.sequence_number = sequence_number;
+    record.timestamp = reader.Read<std::uint64_t>();
+    record.dataset = reader.ReadString();
+    record.service = reader.ReadString();
+    record.query = reader.ReadString();
+    record.milliseconds = reader.Read<double>();
+    record.sampled = reader.Read<std::uint8_t>() != 0;
+    record.truncated = reader.Read<std::uint8_t>() != 0;
+
+    // name, count and milliseconds of a stage
+    record.trace.stages.resize(reader.ReadCount(2 * sizeof(std::uint32_t) + sizeof(double)));
+    for (auto &stage : record.trace.stages)
+    {
+        stage.name = reader.ReadString();
+        stage.count = reader.Read<std::uint32_t>();
+        stage.milliseconds = reader.Read<double>();
+    }
+
+    // name and three counts of a heap
+    record.trace.heaps.resize(reader.ReadCount(sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t)));
+    for (auto &heap : record.trace.heaps)
+    {
+        heap.name = reader.ReadString();
+        heap.number_of_searches = reader.Read<std::uint64_t>();
+        heap.number_of_settled_nodes = reader.Read<std::uint64_t>();
+        reader.ReadVector(heap.settled_nodes);
+    }
+    return record;
+}
+}
+
+SlowQueryLog::SlowQueryLog(const boost::filesystem::path &path,
+                           const std::uint32_t number_of_slots,
+                           const std::uint64_t slot_size)
+    : number_of_slots(number_of_slots), slot_size(slot_size), next_sequence_number(1)
+{
+    SlowQueryLogHeader header;
+    header.fingerprint = util::FingerPrint::GetValid();
+    header.number_of_slots = number_of_slots;
+    header.slot_size = slot_size;
+    if (!isValidHeader(header))
+    {
+        throw util::exception("Slow query logs need at least one slot of more than " +
+                              std::to_string(sizeof(SlotHeader)) + " bytes");
+    }
+
+    bool reuse_log = false;
+    {
+        boost::filesystem::ifstream existing_stream(path, std::ios::binary);
+        SlowQueryLogHeader existing_header;
+        if (existing_stream &&
+            existing_stream.read(reinterpret_cast<char *>(&existing_header),
+                                 sizeof(SlowQueryLogHeader)))
+        {
+            reuse_log = isValidHeader(existing_header) &&
+                        existing_header.number_of_slots == number_of_slots &&
+                        existing_header.slot_size == slot_size;
+            if (!reuse_log)
+            {
+                util::SimpleLogger().Write(logWARNING)
+                    << "Replacing slow query log " << path.string() << " with a new layout";
+            }
+        }
+    }
+
+    if (!reuse_log)
+    {
+        boost::filesystem::ofstream new_stream(path, std::ios::binary | std::ios::trunc);
+        new_stream.write(reinterpret_cast<const char *>(&header), sizeof(SlowQueryLogHeader));
+        if (!new_stream)
+        {
+            throw util::exception("Could not create slow query log " + path.string());
+        }
+    }
+
+    log_stream.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!log_stream)
+    {
+        throw util::exception("Could not open slow query log " + path.string());
+    }
+
+    // continue after the newest record, slots behind the end of the file are still empty
+    if (reuse_log)
+    {
+        for (std::uint64_t slot = 0; slot < number_of_slots; ++slot)
+        {
+            SlotHeader slot_header;
+            log_stream.seekg(getSlotOffset(number_of_slots, slot_size, slot));
+            if (log_stream.read(reinterpret_cast<char *>(&slot_header), sizeof(SlotHeader)))
+            {
+                next_sequence_number =
+                    std::max(next_sequence_number, slot_header.sequence_number + 1);
+            }
+            log_stream.clear();
+        }
+    }
+}
+
+void SlowQueryLog::Write(SlowQueryRecord record)
+{
+    std::lock_guard<std::mutex> lock(write_mutex);
+    record.sequence_number = next_sequence_number++;
+
+    const auto capacity = slot_size - sizeof(SlotHeader);
+    auto payload = serializeRecord(record);
+    if (payload.size() > capacity)
+    {
+        record.truncated = true;
+        for (auto &heap : record.trace.heaps)
+        {
+            heap.settled_nodes.clear();
+        }
+        payload = serializeRecord(record);
+    }
+    if (payload.size() > capacity)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Slow query " << record.sequence_number
+                                               << " does not fit into a slot of the log";
+        return;
+    }
+
+    const auto offset = getSlotOffset(number_of_slots, slot_size, record.sequence_number);
+
+    // the slot header is written last, a torn record is skipped as corrupt when reading
+    const SlotHeader slot_header{record.sequence_number, payload.size()};
+    log_stream.seekp(offset + sizeof(SlotHeader));
+    log_stream.write(payload.data(), payload.size());
+    log_stream.seekp(offset);
+    log_stream.write(reinterpret_cast<const char *>(&slot_header), sizeof(SlotHeader));
+    log_stream.flush();
+    if (!log_stream)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Could not write slow query "
+                                               << record.sequence_number;
+        log_stream.clear();
+    }
+}
+
+std::uint64_t SlowQueryLog::GetMaxSettledNodes() const
+{
+    return (slot_size - sizeof(SlotHeader)) / sizeof(NodeID);
+}
+
+std::vector<SlowQueryRecord> SlowQueryLog::Read(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream log_stream(path, std::ios::binary);
+    SlowQueryLogHeader header;
+    if (!log_stream ||
+        !log_stream.read(reinterpret_cast<char *>(&header), sizeof(SlowQueryLogHeader)) ||
+        !isValidHeader(header))
+    {
+        throw util::exception(path.string() + " is not a slow query log of this build");
+    }
+
+    std::vector<SlowQueryRecord> records;
+    std::string payload;
+    for (std::uint64_t slot = 0; slot < header.number_of_slots; ++slot)
+    {
+        SlotHeader slot_header;
+        log_stream.seekg(getSlotOffset(header.number_of_slots, header.slot_size, slot));
+        if (!log_stream.read(reinterpret_cast<char *>(&slot_header), sizeof(SlotHeader)))
+        {
+            break;
+        }
+        if (slot_header.sequence_number == 0)
+        {
+            continue;
+        }
+
+        try
+        {
+            if (slot_header.size > header.slot_size - sizeof(SlotHeader))
+            {
+                throw util::exception("Slow query record is corrupt");
+            }
+            payload.resize(slot_header.size);
+            if (!log_stream.read(&payload[0], payload.size()))
+            {
+                throw util::exception("Slow query record is corrupt");
+            }
+            records.push_back(deserializeRecord(slot_header.sequence_number, payload));
+        }
+        catch (const util::exception &)
+        {
+            util::SimpleLogger().Write(logWARNING) << "Skipping corrupt slow query "
+                                                   << slot_header.sequence_number;
+            log_stream.clear();
+        }
+    }
+
+    std::sort(records.begin(), records.end(), [](const SlowQueryRecord &lhs,
+                                                 const SlowQueryRecord &rhs) {
+        return lhs.sequence_number < rhs.sequence_number;
+    });
+    return records;
+}
+}
+}
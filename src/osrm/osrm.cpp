@@ -1,4 +1,5 @@
 #include "osrm/osrm.hpp"
+#include "engine/api/facilities_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -31,6 +32,13 @@ engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Obj
     return engine_->Table(params, result);
 }
 
+engine::Status OSRM::Table(const engine::api::TableParameters &params,
+                           json::Object &result,
+                           const engine::ResponseWriter &writer)
+{
+    return engine_->Table(params, result, writer);
+}
+
 engine::Status OSRM::Nearest(const engine::api::NearestParameters &params, json::Object &result)
 {
     return engine_->Nearest(params, result);
@@ -51,4 +59,10 @@ engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string
     return engine_->Tile(params, result);
 }
 
+engine::Status OSRM::Facilities(const engine::api::FacilitiesParameters &params,
+                                json::Object &result)
+{
+    return engine_->Facilities(params, result);
+}
+
 } // ns osrm
@@ -1,5 +1,6 @@
 #include "server/api/parameters_parser.hpp"
 
+#include "server/api/facilities_parameter_grammar.hpp"
 #include "server/api/match_parameter_grammar.hpp"
 #include "server/api/nearest_parameter_grammar.hpp"
 #include "server/api/route_parameters_grammar.hpp"
@@ -26,7 +27,8 @@ using is_grammar_t =
                                std::is_same<NearestParametersGrammar<>, T>::value ||
                                std::is_same<TripParametersGrammar<>, T>::value ||
                                std::is_same<MatchParametersGrammar<>, T>::value ||
-                               std::is_same<TileParametersGrammar<>, T>::value>;
+                               std::is_same<TileParametersGrammar<>, T>::value ||
+                               std::is_same<FacilitiesParametersGrammar<>, T>::value>;
 
 template <typename ParameterT,
           typename GrammarT,
@@ -106,6 +108,14 @@ boost::optional<engine::api::TileParameters> parseParameters(std::string::iterat
     return detail::parseParameters<engine::api::TileParameters, TileParametersGrammar<>>(iter, end);
 }
 
+template <>
+boost::optional<engine::api::FacilitiesParameters>
+parseParameters(std::string::iterator &iter, const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::FacilitiesParameters,
+                                   FacilitiesParametersGrammar<>>(iter, end);
+}
+
 } // ns api
 } // ns server
 } // ns osrm
@@ -1,4 +1,5 @@
 #include "server/connection.hpp"
+#include "server/reply_stream.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
 
@@ -53,7 +54,19 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     if (result == RequestParser::RequestStatus::valid)
     {
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        const bool supports_chunked_encoding =
+            current_request.http_major_version > 1 ||
+            (current_request.http_major_version == 1 && current_request.http_minor_version >= 1);
+        ReplyStream reply_stream(TCP_socket, compression_type, supports_chunked_encoding);
+        request_handler.HandleRequest(current_request, current_reply, reply_stream);
+
+        // streamed replies have been sent while the request was handled
+        if (reply_stream.IsStarted())
+        {
+            boost::system::error_code ignore_error;
+            TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+            return;
+        }
 
         // compress the result w/ gzip/deflate if requested
         switch (compression_type)
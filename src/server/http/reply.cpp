@@ -16,6 +16,7 @@ const char internal_server_error_html[] =
 const char seperators[] = {':', ' '};
 const char crlf[] = {'\r', '\n'};
 const std::string http_ok_string = "HTTP/1.0 200 OK\r\n";
+const std::string http_1_1_ok_string = "HTTP/1.1 200 OK\r\n";
 const std::string http_bad_request_string = "HTTP/1.0 400 Bad Request\r\n";
 const std::string http_internal_server_error_string = "HTTP/1.0 500 Internal Server Error\r\n";
 
@@ -94,7 +95,7 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
 {
     if (reply::ok == status)
     {
-        return boost::asio::buffer(http_ok_string);
+        return boost::asio::buffer(chunked ? http_1_1_ok_string : http_ok_string);
     }
     if (reply::internal_server_error == status)
     {
@@ -103,7 +104,7 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
     return boost::asio::buffer(http_bad_request_string);
 }
 
-reply::reply() : status(ok)
+reply::reply() : status(ok), chunked(false)
 {
     // We do not currently support keep alive. Always set 'Connection: close'.
     headers.emplace_back("Connection", "close");
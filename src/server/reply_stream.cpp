@@ -0,0 +1,198 @@
+#include "server/reply_stream.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+// a client has this long to take each piece of the reply before the stream is aborted
+const constexpr std::chrono::seconds SEND_TIMEOUT{30};
+
+// returns once the socket accepts more data, an error occurred or the timeout expired
+void waitUntilWritable(boost::asio::ip::tcp::socket &socket,
+                       const std::chrono::milliseconds timeout)
+{
+#ifdef _WIN32
+    WSAPOLLFD descriptor{};
+    descriptor.fd = socket.native_handle();
+    descriptor.events = POLLOUT;
+    WSAPoll(&descriptor, 1, static_cast<INT>(timeout.count()));
+#else
+    pollfd descriptor{};
+    descriptor.fd = socket.native_handle();
+    descriptor.events = POLLOUT;
+    ::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+#endif
+}
+}
+
+// Hands the output of the compressor to the socket
+struct ReplyStream::CompressedSink
+{
+    using char_type = char;
+    using category = boost::iostreams::sink_tag;
+
+    std::streamsize write(const char *data, const std::streamsize size)
+    {
+        stream->WriteChunk(data, static_cast<std::size_t>(size));
+        return size;
+    }
+
+    ReplyStream *stream;
+};
+
+ReplyStream::ReplyStream(boost::asio::ip::tcp::socket &socket,
+                         const http::compression_type compression,
+                         const bool chunked)
+    : socket(socket), compression(compression), chunked(chunked), started(false)
+{
+}
+
+void ReplyStream::Start(http::reply &reply)
+{
+    BOOST_ASSERT(!started);
+    started = true;
+
+    reply.chunked = chunked;
+    if (chunked)
+    {
+        reply.headers.emplace_back("Transfer-Encoding", "chunked");
+    }
+    if (compression != http::no_compression)
+    {
+        reply.headers.emplace_back("Content-Encoding",
+                                   compression == http::gzip_rfc1952 ? "gzip" : "deflate");
+
+        // there's a trade-off between speed and size. speed wins
+        boost::iostreams::gzip_params compression_parameters;
+        compression_parameters.level = boost::iostreams::zlib::best_speed;
+        compression_parameters.noheader = compression == http::deflate_rfc1951;
+        compressor = std::unique_ptr<boost::iostreams::filtering_ostream>(
+            new boost::iostreams::filtering_ostream);
+        compressor->push(boost::iostreams::gzip_compressor(compression_parameters));
+        compressor->push(CompressedSink{this});
+    }
+
+    // the socket is only waited for with a timeout, see Send
+    socket.non_blocking(true, error);
+    ThrowOnError();
+
+    Send(reply.headers_to_buffers());
+    ThrowOnError();
+}
+
+void ReplyStream::Write(const char *data, const std::size_t size)
+{
+    BOOST_ASSERT(started);
+    if (compressor)
+    {
+        compressor->write(data, size);
+    }
+    else
+    {
+        WriteChunk(data, size);
+    }
+    ThrowOnError();
+}
+
+void ReplyStream::Finish()
+{
+    BOOST_ASSERT(started);
+    if (compressor)
+    {
+        boost::iostreams::close(*compressor);
+        compressor.reset();
+    }
+    if (chunked && !error)
+    {
+        const char last_chunk[] = {'0', '\r', '\n', '\r', '\n'};
+        Send({boost::asio::buffer(last_chunk)});
+    }
+    ThrowOnError();
+}
+
+void ReplyStream::WriteChunk(const char *data, const std::size_t size)
+{
+    // an empty chunk would end the content
+    if (size == 0 || error)
+    {
+        return;
+    }
+
+    if (!chunked)
+    {
+        Send({boost::asio::buffer(data, size)});
+        return;
+    }
+
+    std::array<char, 2 * sizeof(std::size_t) + 3> chunk_size;
+    const auto length = std::snprintf(chunk_size.data(), chunk_size.size(), "%zx\r\n", size);
+    const char crlf[] = {'\r', '\n'};
+    Send({boost::asio::buffer(chunk_size.data(), length),
+          boost::asio::buffer(data, size),
+          boost::asio::buffer(crlf)});
+}
+
+void ReplyStream::Send(std::vector<boost::asio::const_buffer> buffers)
+{
+    const auto deadline = std::chrono::steady_clock::now() + SEND_TIMEOUT;
+    while (!error && !buffers.empty())
+    {
+        auto written = socket.write_some(buffers, error);
+        if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
+        {
+            error.clear();
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                error = boost::asio::error::timed_out;
+                return;
+            }
+            waitUntilWritable(socket,
+                              std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) +
+                                  std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // drop what has been sent
+        auto first = buffers.begin();
+        while (first != buffers.end() && boost::asio::buffer_size(*first) <= written)
+        {
+            written -= boost::asio::buffer_size(*first);
+            ++first;
+        }
+        if (first != buffers.end())
+        {
+            *first = *first + written;
+        }
+        buffers.erase(buffers.begin(), first);
+    }
+}
+
+void ReplyStream::ThrowOnError() const
+{
+    if (error)
+    {
+        throw boost::system::system_error(error);
+    }
+}
+}
+}
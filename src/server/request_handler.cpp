@@ -1,5 +1,6 @@
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
+#include "server/reply_stream.hpp"
 
 #include "server/api/url_parser.hpp"
 #include "server/http/reply.hpp"
@@ -30,14 +31,67 @@ namespace osrm
 namespace server
 {
 
-void RequestHandler::RegisterServiceHandler(std::unique_ptr<ServiceHandler> service_handler_)
+void RequestHandler::RegisterServiceHandler(const std::string &profile,
+                                            std::unique_ptr<ServiceHandler> service_handler_)
 {
-    service_handler = std::move(service_handler_);
+    service_handlers[profile] = std::move(service_handler_);
 }
 
-void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
+ServiceHandler *RequestHandler::GetServiceHandler(const std::string &profile) const
 {
-    if (!service_handler)
+    auto iter = service_handlers.find(profile);
+    // the handler registered for the empty profile serves all profiles, but only if it is the
+    // only one, otherwise a request for an unknown profile is an error
+    if (iter == service_handlers.end() && service_handlers.size() == 1)
+    {
+        iter = service_handlers.find("");
+    }
+    return iter == service_handlers.end() ? nullptr : iter->second.get();
+}
+
+void RequestHandler::WriteMetrics() const
+{
+    for (const auto &profile_and_handler : service_handlers)
+    {
+        const auto metrics = profile_and_handler.second->GetMetrics();
+        const auto mean_microseconds =
+            metrics.number_of_requests == 0
+                ? 0
+                : metrics.total_microseconds / metrics.number_of_requests;
+        util::SimpleLogger().Write()
+            << "profile "
+            << (profile_and_handler.first.empty() ? "<default>" : profile_and_handler.first)
+            << ": " << metrics.number_of_requests << " requests, " << metrics.number_of_errors
+            << " errors, " << mean_microseconds << "us mean query time";
+
+        for (const auto &service_and_performance : metrics.performance_per_service)
+        {
+            const auto &performance = service_and_performance.second;
+            util::SimpleLogger().Write() << "  " << service_and_performance.first << ": "
+                                         << performance.number_of_queries << " queries, per query "
+                                         << performance.events.ToString(
+                                                performance.number_of_queries);
+        }
+    }
+}
+
+namespace
+{
+void addJSONHeaders(http::reply &reply)
+{
+    reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
+    reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
+    reply.headers.emplace_back("Access-Control-Allow-Headers", "X-Requested-With, Content-Type");
+    reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+    reply.headers.emplace_back("Content-Disposition", "inline; filename=\"response.json\"");
+}
+}
+
+void RequestHandler::HandleRequest(const http::request &current_request,
+                                   http::reply &current_reply,
+                                   ReplyStream &reply_stream)
+{
+    if (service_handlers.empty())
     {
         current_reply = http::reply::stock_reply(http::reply::internal_server_error);
         util::SimpleLogger().Write(logWARNING) << "No service handler registered." << std::endl;
@@ -84,11 +138,32 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         ServiceHandler::ResultT result;
 
         // check if the was an error with the request
+        ServiceHandler *service_handler = nullptr;
         if (maybe_parsed_url && api_iterator == request_string.end())
         {
+            service_handler = GetServiceHandler(maybe_parsed_url->profile);
+        }
 
+        if (service_handler != nullptr)
+        {
+            // the reply is started with the first piece of a streamed response
+            const engine::ResponseWriter writer = [&](const char *data, const std::size_t size) {
+                if (!reply_stream.IsStarted())
+                {
+                    addJSONHeaders(current_reply);
+                    reply_stream.Start(current_reply);
+                }
+                reply_stream.Write(data, size);
+            };
             const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
+                service_handler->RunQuery(*std::move(maybe_parsed_url), result, writer);
+            if (reply_stream.IsStarted())
+            {
+                BOOST_ASSERT(status == engine::Status::Ok);
+                reply_stream.Finish();
+                return;
+            }
+
             if (status != engine::Status::Ok)
             {
                 // 4xx bad request return code
@@ -99,6 +174,14 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                 BOOST_ASSERT(status == engine::Status::Ok);
             }
         }
+        else if (maybe_parsed_url && api_iterator == request_string.end())
+        {
+            current_reply.status = http::reply::bad_request;
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "InvalidProfile";
+            json_result.values["message"] = "Profile " + maybe_parsed_url->profile + " not found!";
+        }
         else
         {
             const auto position = std::distance(request_string.begin(), api_iterator);
@@ -119,20 +202,17 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                                             std::to_string(position) + ": \"" + context + "\"";
         }
 
-        current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
-        current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
-        current_reply.headers.emplace_back("Access-Control-Allow-Headers",
-                                           "X-Requested-With, Content-Type");
         if (result.is<util::json::Object>())
         {
-            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
-            current_reply.headers.emplace_back("Content-Disposition",
-                                               "inline; filename=\"response.json\"");
-
+            addJSONHeaders(current_reply);
             util::json::render(current_reply.content, result.get<util::json::Object>());
         }
         else
         {
+            current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
+            current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
+            current_reply.headers.emplace_back("Access-Control-Allow-Headers",
+                                               "X-Requested-With, Content-Type");
             BOOST_ASSERT(result.is<std::string>());
             std::copy(result.get<std::string>().cbegin(),
                       result.get<std::string>().cend(),
@@ -147,7 +227,11 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
     }
     catch (const std::exception &e)
     {
-        current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+        // a streamed reply can not be replaced anymore, the connection is closed unfinished
+        if (!reply_stream.IsStarted())
+        {
+            current_reply = http::reply::stock_reply(http::reply::internal_server_error);
+        }
         util::SimpleLogger().Write(logWARNING) << "[server error] code: " << e.what()
                                                << ", uri: " << current_request.uri;
     }
@@ -116,6 +116,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            current_request.http_major_version = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -128,12 +129,15 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_major_version =
+                10 * current_request.http_major_version + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            current_request.http_minor_version = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -146,6 +150,8 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            current_request.http_minor_version =
+                10 * current_request.http_minor_version + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -60,6 +60,14 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 
 engine::Status
 TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+{
+    return RunStreamingQuery(prefix_length, query, result, engine::ResponseWriter{});
+}
+
+engine::Status TableService::RunStreamingQuery(std::size_t prefix_length,
+                                               std::string &query,
+                                               ResultT &result,
+                                               const engine::ResponseWriter &writer)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
@@ -85,6 +93,10 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
+    if (writer)
+    {
+        return BaseService::routing_machine.Table(*parameters, json_result, writer);
+    }
     return BaseService::routing_machine.Table(*parameters, json_result);
 }
 }
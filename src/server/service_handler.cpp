@@ -1,5 +1,6 @@
 #include "server/service_handler.hpp"
 
+#include "server/service/facilities_service.hpp"
 #include "server/service/match_service.hpp"
 #include "server/service/nearest_service.hpp"
 #include "server/service/route_service.hpp"
@@ -7,26 +8,44 @@
 #include "server/service/tile_service.hpp"
 #include "server/service/trip_service.hpp"
 
+#include "engine/engine_config.hpp"
+#include "engine/query_trace.hpp"
 #include "server/api/parsed_url.hpp"
 #include "util/json_util.hpp"
 #include "util/make_unique.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <ctime>
+#include <random>
 
 namespace osrm
 {
 namespace server
 {
-ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(config)
+ServiceHandler::ServiceHandler(osrm::EngineConfig &config)
+    : routing_machine(config), slow_query_capture{nullptr, 0, 0, false}
 {
+    if (!config.use_shared_memory && config.image_path.empty())
+    {
+        dataset = boost::filesystem::path(config.storage_config.hsgr_data_path)
+                      .replace_extension()
+                      .string();
+    }
+
     service_map["route"] = util::make_unique<service::RouteService>(routing_machine);
     service_map["table"] = util::make_unique<service::TableService>(routing_machine);
     service_map["nearest"] = util::make_unique<service::NearestService>(routing_machine);
     service_map["trip"] = util::make_unique<service::TripService>(routing_machine);
     service_map["match"] = util::make_unique<service::MatchService>(routing_machine);
     service_map["tile"] = util::make_unique<service::TileService>(routing_machine);
+    service_map["facilities"] = util::make_unique<service::FacilitiesService>(routing_machine);
 }
 
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
-                                        service::BaseService::ResultT &result)
+                                        service::BaseService::ResultT &result,
+                                        const engine::ResponseWriter &writer)
 {
     const auto &service_iter = service_map.find(parsed_url.service);
     if (service_iter == service_map.end())
@@ -48,7 +67,93 @@ engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
         return engine::Status::Error;
     }
 
-    return service->RunQuery(parsed_url.prefix_length, parsed_url.query, result);
+    // the counters measure the thread they were opened on, each server thread needs its own
+    static thread_local std::unique_ptr<util::PerformanceCounters> counters;
+    if (util::PERF_COUNTERS_ENABLED && !counters)
+    {
+        counters = util::make_unique<util::PerformanceCounters>();
+    }
+
+    engine::QueryTrace trace;
+    std::unique_ptr<engine::ScopedQueryTrace> scoped_trace;
+    if (slow_query_capture.log)
+    {
+        const auto max_settled_nodes = slow_query_capture.record_settled_nodes
+                                           ? slow_query_capture.log->GetMaxSettledNodes()
+                                           : 0;
+        scoped_trace = util::make_unique<engine::ScopedQueryTrace>(trace, max_settled_nodes);
+    }
+
+    TIMER_START(query);
+    if (util::PERF_COUNTERS_ENABLED)
+    {
+        counters->Start();
+    }
+    const auto status =
+        service->RunStreamingQuery(parsed_url.prefix_length, parsed_url.query, result, writer);
+    if (util::PERF_COUNTERS_ENABLED)
+    {
+        const auto events = counters->Stop();
+        std::lock_guard<std::mutex> lock(performance_mutex);
+        auto &performance = performance_per_service[parsed_url.service];
+        performance.number_of_queries += 1;
+        performance.events += events;
+    }
+    TIMER_STOP(query);
+
+    if (scoped_trace)
+    {
+        // ends the trace
+        scoped_trace.reset();
+        CaptureSlowQuery(parsed_url, TIMER_MSEC(query), std::move(trace));
+    }
+
+    number_of_requests += 1;
+    if (status != engine::Status::Ok)
+    {
+        number_of_errors += 1;
+    }
+    total_microseconds += TIMER_USEC(query);
+
+    return status;
+}
+
+void ServiceHandler::EnableSlowQueryCapture(SlowQueryCapture capture)
+{
+    slow_query_capture = std::move(capture);
+}
+
+void ServiceHandler::CaptureSlowQuery(const api::ParsedURL &parsed_url,
+                                      const double milliseconds,
+                                      engine::QueryTrace trace) const
+{
+    static thread_local std::mt19937 generator{std::random_device{}()};
+    const bool is_slow = milliseconds >= slow_query_capture.threshold_milliseconds;
+    const bool is_sampled =
+        !is_slow && slow_query_capture.sample_rate > 0 &&
+        std::uniform_real_distribution<double>(0, 1)(generator) < slow_query_capture.sample_rate;
+    if (!is_slow && !is_sampled)
+    {
+        return;
+    }
+
+    engine::SlowQueryRecord record;
+    record.timestamp = static_cast<std::uint64_t>(std::time(nullptr));
+    record.dataset = dataset;
+    record.service = parsed_url.service;
+    record.query = parsed_url.query;
+    record.milliseconds = milliseconds;
+    record.sampled = is_sampled;
+    record.truncated = trace.settled_nodes_truncated;
+    record.trace = std::move(trace);
+    slow_query_capture.log->Write(std::move(record));
+}
+
+ServiceMetrics ServiceHandler::GetMetrics() const
+{
+    std::lock_guard<std::mutex> lock(performance_mutex);
+    return ServiceMetrics{
+        number_of_requests, number_of_errors, total_microseconds, performance_per_service};
 }
 }
 }
@@ -6,6 +6,7 @@
 #include "extractor/profile_properties.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/travel_mode.hpp"
+#include "storage/dataset_image.hpp"
 #include "storage/shared_barriers.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
@@ -19,6 +20,7 @@
 #include "util/simple_logger.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
 #ifdef __linux__
@@ -28,13 +30,16 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/iostreams/seek.hpp>
 
+#include <algorithm>
 #include <cstdint>
 
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -66,6 +71,12 @@ void deleteRegion(const SharedDataType region)
                 return "DATA_2";
             case LAYOUT_NONE:
                 return "LAYOUT_NONE";
+            case CURRENT_CLOSURES:
+                return "CURRENT_CLOSURES";
+            case CLOSURES_1:
+                return "CLOSURES_1";
+            case CLOSURES_2:
+                return "CLOSURES_2";
             default: // DATA_NONE:
                 return "DATA_NONE";
             }
@@ -81,6 +92,73 @@ int Storage::Run()
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
+    return Publish([this](SharedDataLayout &layout, const SharedDataType data_region) {
+        const auto file_index_path = boost::filesystem::absolute(config.file_index_path);
+        PopulateData(layout, file_index_path, 0, [data_region](const std::uint64_t size) {
+            util::SimpleLogger().Write() << "allocating shared memory of " << size << " bytes";
+            return static_cast<char *>(makeSharedMemory(data_region, size)->Ptr());
+        });
+    });
+}
+
+int Storage::RunFromImage(const boost::filesystem::path &image_path)
+{
+    return Publish([&image_path](SharedDataLayout &layout, const SharedDataType data_region) {
+        util::SimpleLogger().Write() << "load image from: " << image_path;
+        char *data = nullptr;
+        readDatasetImage(image_path, layout, [&data, data_region](const std::uint64_t size) {
+            util::SimpleLogger().Write() << "allocating shared memory of " << size << " bytes";
+            data = static_cast<char *>(makeSharedMemory(data_region, size)->Ptr());
+            return data;
+        });
+
+        // the facades expect the absolute path of the leaf file in shared memory
+        const auto file_index_path = resolveImageFileIndexPath(image_path, layout, data).string();
+        if (file_index_path.length() >= layout.GetBlockSize(SharedDataLayout::FILE_INDEX_PATH))
+        {
+            throw util::exception("Path of the leaf file " + file_index_path + " is too long");
+        }
+        char *file_index_path_ptr =
+            layout.GetBlockPtr<char>(data, SharedDataLayout::FILE_INDEX_PATH);
+        std::fill(file_index_path_ptr,
+                  file_index_path_ptr + layout.GetBlockSize(SharedDataLayout::FILE_INDEX_PATH),
+                  0);
+        std::copy(file_index_path.begin(), file_index_path.end(), file_index_path_ptr);
+    });
+}
+
+void Storage::WriteImage(const boost::filesystem::path &image_path, const bool compress)
+{
+    BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
+
+    // the image refers to the leaf file by name, it has to ship in the same directory
+    const auto file_index_name = config.file_index_path.filename();
+    const auto image_file_index_path =
+        boost::filesystem::absolute(image_path).parent_path() / file_index_name;
+    if (!boost::filesystem::exists(image_file_index_path) ||
+        !boost::filesystem::equivalent(config.file_index_path, image_file_index_path))
+    {
+        util::SimpleLogger().Write() << "copy " << config.file_index_path << " to "
+                                     << image_file_index_path;
+        boost::filesystem::remove(image_file_index_path);
+        boost::filesystem::copy_file(config.file_index_path, image_file_index_path);
+    }
+
+    SharedDataLayout layout;
+    std::vector<char> data;
+    PopulateData(layout,
+                 file_index_name,
+                 IMAGE_FILE_INDEX_PATH_SIZE,
+                 [&data](const std::uint64_t size) {
+                     data.resize(size);
+                     return data.data();
+                 });
+    writeDatasetImage(image_path, layout, data.data(), compress ? IMAGE_BLOCK_SIZE : 0);
+    util::SimpleLogger().Write() << "wrote " << data.size() << " bytes to " << image_path;
+}
+
+int Storage::Publish(const std::function<void(SharedDataLayout &, SharedDataType)> &load)
+{
     util::LogPolicy::GetInstance().Unmute();
     SharedBarriers barrier;
 
@@ -120,10 +198,50 @@ int Storage::Run()
     // Allocate a memory layout in shared memory, deallocate previous
     auto *layout_memory = makeSharedMemory(layout_region, sizeof(SharedDataLayout));
     auto shared_layout_ptr = new (layout_memory->Ptr()) SharedDataLayout();
-    auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
 
-    shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
-                                          absolute_file_index_path.string().length() + 1);
+    TIMER_START(load);
+    load(*shared_layout_ptr, data_region);
+    TIMER_STOP(load);
+    util::SimpleLogger().Write() << "loaded data in " << TIMER_SEC(load) << "s";
+
+    // acquire lock
+    SharedMemory *data_type_memory =
+        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false);
+    SharedDataTimestamp *data_timestamp_ptr =
+        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
+
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
+        barrier.query_mutex);
+
+    // notify all processes that were waiting for this condition
+    if (0 < barrier.number_of_queries)
+    {
+        barrier.no_running_queries_condition.wait(query_lock);
+    }
+
+    data_timestamp_ptr->layout = layout_region;
+    data_timestamp_ptr->data = data_region;
+    data_timestamp_ptr->timestamp += 1;
+    deleteRegion(previous_data_region);
+    deleteRegion(previous_layout_region);
+    util::SimpleLogger().Write() << "all data loaded";
+
+    return EXIT_SUCCESS;
+}
+
+// Reads all dataset files into the layout of the shared memory data block, the block itself is
+// allocated by allocate_data once its size is known.
+void Storage::PopulateData(SharedDataLayout &layout,
+                           const boost::filesystem::path &file_index_path,
+                           const std::uint64_t file_index_path_size,
+                           const std::function<char *(std::uint64_t)> &allocate_data)
+{
+    auto shared_layout_ptr = &layout;
+    const auto file_index_path_string = file_index_path.string();
+
+    shared_layout_ptr->SetBlockSize<char>(
+        SharedDataLayout::FILE_INDEX_PATH,
+        std::max<std::uint64_t>(file_index_path_string.length() + 1, file_index_path_size));
 
     // collect number of elements to store in shared memory object
     util::SimpleLogger().Write() << "load names from: " << config.names_data_path;
@@ -156,17 +274,10 @@ int Storage::Run()
     unsigned number_of_original_edges = 0;
     edges_input_stream.read((char *)&number_of_original_edges, sizeof(unsigned));
 
-    // note: settings this all to the same size is correct, we extract them from the same struct
-    shared_layout_ptr->SetBlockSize<NodeID>(SharedDataLayout::VIA_NODE_LIST,
-                                            number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::NAME_ID_LIST,
-                                              number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<extractor::TravelMode>(SharedDataLayout::TRAVEL_MODE,
-                                                           number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<extractor::guidance::TurnInstruction>(
-        SharedDataLayout::TURN_INSTRUCTION, number_of_original_edges);
-    shared_layout_ptr->SetBlockSize<EntryClassID>(SharedDataLayout::ENTRY_CLASSID,
-                                                  number_of_original_edges);
+    // all per-edge annotations are stored interleaved, so unpacking an edge touches a single
+    // record instead of one entry per annotation array
+    shared_layout_ptr->SetBlockSize<extractor::OriginalEdgeData>(
+        SharedDataLayout::ORIGINAL_EDGE_DATA, number_of_original_edges);
 
     boost::filesystem::ifstream hsgr_input_stream(config.hsgr_data_path, std::ios::binary);
     if (!hsgr_input_stream)
@@ -206,6 +317,22 @@ int Storage::Run()
     shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
                                                                 number_of_graph_edges);
 
+    // load edge lengths size, 0 if osrm-contract did not store them
+    boost::filesystem::ifstream edge_lengths_stream(config.edge_lengths_path, std::ios::binary);
+    if (!edge_lengths_stream)
+    {
+        throw util::exception("Could not open " + config.edge_lengths_path.string() +
+                              " for reading.");
+    }
+    unsigned number_of_edge_lengths = 0;
+    edge_lengths_stream.read((char *)&number_of_edge_lengths, sizeof(unsigned));
+    if (number_of_edge_lengths != 0 && number_of_edge_lengths != number_of_graph_edges)
+    {
+        throw util::exception(config.edge_lengths_path.string() + " does not match the .hsgr");
+    }
+    shared_layout_ptr->SetBlockSize<EdgeLength>(SharedDataLayout::GRAPH_EDGE_LENGTHS,
+                                                number_of_edge_lengths);
+
     // load rsearch tree size
     boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
 
@@ -375,10 +502,7 @@ int Storage::Run()
                                                                 entry_class_table.size());
 
     // allocate shared memory block
-    util::SimpleLogger().Write() << "allocating shared memory of "
-                                 << shared_layout_ptr->GetSizeOfLayout() << " bytes";
-    auto *shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout());
-    char *shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+    char *shared_memory_ptr = allocate_data(shared_layout_ptr->GetSizeOfLayout());
 
     // read actual data into shared memory object //
 
@@ -395,9 +519,7 @@ int Storage::Run()
               file_index_path_ptr +
                   shared_layout_ptr->GetBlockSize(SharedDataLayout::FILE_INDEX_PATH),
               0);
-    std::copy(absolute_file_index_path.string().begin(),
-              absolute_file_index_path.string().end(),
-              file_index_path_ptr);
+    std::copy(file_index_path_string.begin(), file_index_path_string.end(), file_index_path_ptr);
 
     // Loading street names
     unsigned *name_offsets_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
@@ -434,32 +556,15 @@ int Storage::Run()
     name_stream.close();
 
     // load original edge information
-    NodeID *via_node_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
-        shared_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
-
-    unsigned *name_id_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_ID_LIST);
-
-    extractor::TravelMode *travel_mode_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::TravelMode, true>(shared_memory_ptr,
-                                                                    SharedDataLayout::TRAVEL_MODE);
-
-    extractor::guidance::TurnInstruction *turn_instructions_ptr =
-        shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
-
-    EntryClassID *entry_class_id_ptr = shared_layout_ptr->GetBlockPtr<EntryClassID, true>(
-        shared_memory_ptr, SharedDataLayout::ENTRY_CLASSID);
-
-    extractor::OriginalEdgeData current_edge_data;
-    for (unsigned i = 0; i < number_of_original_edges; ++i)
+    extractor::OriginalEdgeData *original_edge_data_ptr =
+        shared_layout_ptr->GetBlockPtr<extractor::OriginalEdgeData, true>(
+            shared_memory_ptr, SharedDataLayout::ORIGINAL_EDGE_DATA);
+    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::ORIGINAL_EDGE_DATA) > 0)
     {
-        edges_input_stream.read((char *)&(current_edge_data), sizeof(extractor::OriginalEdgeData));
-        via_node_ptr[i] = current_edge_data.via_node;
-        name_id_ptr[i] = current_edge_data.name_id;
-        travel_mode_ptr[i] = current_edge_data.travel_mode;
-        turn_instructions_ptr[i] = current_edge_data.turn_instruction;
-        entry_class_id_ptr[i] = current_edge_data.entry_classid;
+        // the .edges file has the same record layout, no conversion needed
+        edges_input_stream.read(
+            reinterpret_cast<char *>(original_edge_data_ptr),
+            shared_layout_ptr->GetBlockSize(SharedDataLayout::ORIGINAL_EDGE_DATA));
     }
     edges_input_stream.close();
 
@@ -609,6 +714,17 @@ int Storage::Run()
     }
     hsgr_input_stream.close();
 
+    // load the edge lengths of the search graph
+    EdgeLength *graph_edge_lengths_ptr = shared_layout_ptr->GetBlockPtr<EdgeLength, true>(
+        shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LENGTHS);
+    if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LENGTHS) > 0)
+    {
+        edge_lengths_stream.read(
+            (char *)graph_edge_lengths_ptr,
+            shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LENGTHS));
+    }
+    edge_lengths_stream.close();
+
     // load profile properties
     auto profile_properties_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::ProfileProperties, true>(
@@ -657,30 +773,6 @@ int Storage::Run()
             shared_memory_ptr, SharedDataLayout::ENTRY_CLASS);
         std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
     }
-
-    // acquire lock
-    SharedMemory *data_type_memory =
-        makeSharedMemory(CURRENT_REGIONS, sizeof(SharedDataTimestamp), true, false);
-    SharedDataTimestamp *data_timestamp_ptr =
-        static_cast<SharedDataTimestamp *>(data_type_memory->Ptr());
-
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> query_lock(
-        barrier.query_mutex);
-
-    // notify all processes that were waiting for this condition
-    if (0 < barrier.number_of_queries)
-    {
-        barrier.no_running_queries_condition.wait(query_lock);
-    }
-
-    data_timestamp_ptr->layout = layout_region;
-    data_timestamp_ptr->data = data_region;
-    data_timestamp_ptr->timestamp += 1;
-    deleteRegion(previous_data_region);
-    deleteRegion(previous_layout_region);
-    util::SimpleLogger().Write() << "all data loaded";
-
-    return EXIT_SUCCESS;
 }
 }
 }
@@ -10,7 +10,8 @@ namespace storage
 
 StorageConfig::StorageConfig(const boost::filesystem::path &base)
     : ram_index_path{base.string() + ".ramIndex"}, file_index_path{base.string() + ".fileIndex"},
-      hsgr_data_path{base.string() + ".hsgr"}, nodes_data_path{base.string() + ".nodes"},
+      hsgr_data_path{base.string() + ".hsgr"},
+      edge_lengths_path{base.string() + ".edge_lengths"}, nodes_data_path{base.string() + ".nodes"},
       edges_data_path{base.string() + ".edges"}, core_data_path{base.string() + ".core"},
       geometries_path{base.string() + ".geometry"}, timestamp_path{base.string() + ".timestamp"},
       datasource_names_path{base.string() + ".datasource_names"},
@@ -22,10 +23,11 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
 
 bool StorageConfig::IsValid() const
 {
-    const constexpr auto num_files = 13;
+    const constexpr auto num_files = 14;
     const boost::filesystem::path paths[num_files] = {ram_index_path,
                                                       file_index_path,
                                                       hsgr_data_path,
+                                                      edge_lengths_path,
                                                       nodes_data_path,
                                                       edges_data_path,
                                                       core_data_path,
@@ -0,0 +1,386 @@
+#include "extractor/query_node.hpp"
+#include "util/cell_table.hpp"
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
+#include "util/simple_logger.hpp"
+#include "util/typedefs.hpp"
+#include "util/version.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+// number of representatives used as sources of a single table query
+const constexpr std::size_t SOURCES_PER_QUERY = 64;
+
+// generate boost::program_options object for the cell table tool
+bool generateCellTableOptions(const int argc,
+                              const char *argv[],
+                              boost::filesystem::path &base_path,
+                              boost::filesystem::path &cell_table_path,
+                              double &cell_size,
+                              unsigned &samples_per_cell)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    // as well as in a config file
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "output,o",
+        boost::program_options::value<boost::filesystem::path>(&cell_table_path),
+        "Output file, defaults to <base.osrm>.cells")(
+        "cell-size",
+        boost::program_options::value<double>(&cell_size)->default_value(0.05),
+        "Edge length of the grid cells in degrees")(
+        "samples",
+        boost::program_options::value<unsigned>(&samples_per_cell)->default_value(8),
+        "Number of points per cell used to estimate the error of the cell durations");
+
+    // hidden options, will be allowed on command line but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()("base,b",
+                                 boost::program_options::value<boost::filesystem::path>(&base_path),
+                                 "base path to .osrm file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("base", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <base.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("base"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    if (cell_size <= 0 || cell_size > 10)
+    {
+        throw util::exception("Cell size has to be in (0, 10] degrees");
+    }
+
+    if (cell_table_path.empty())
+    {
+        cell_table_path = base_path.string() + ".cells";
+    }
+
+    return true;
+}
+
+std::vector<extractor::QueryNode> readNodes(const boost::filesystem::path &base_path)
+{
+    const auto nodes_path = base_path.string() + ".nodes";
+    boost::filesystem::ifstream nodes_input_stream(nodes_path, std::ios::binary);
+    if (!nodes_input_stream)
+    {
+        throw util::exception("Could not open " + nodes_path + " for reading.");
+    }
+    unsigned number_of_nodes = 0;
+    nodes_input_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+    std::vector<extractor::QueryNode> nodes(number_of_nodes);
+    nodes_input_stream.read((char *)nodes.data(), number_of_nodes * sizeof(extractor::QueryNode));
+    if (!nodes_input_stream)
+    {
+        throw util::exception(nodes_path + " is corrupt");
+    }
+    return nodes;
+}
+
+unsigned readChecksum(const boost::filesystem::path &base_path)
+{
+    const auto hsgr_path = base_path.string() + ".hsgr";
+    boost::filesystem::ifstream hsgr_input_stream(hsgr_path, std::ios::binary);
+    if (!hsgr_input_stream)
+    {
+        throw util::exception("Could not open " + hsgr_path + " for reading.");
+    }
+
+    util::FingerPrint fingerprint_loaded;
+    hsgr_input_stream.read((char *)&fingerprint_loaded, sizeof(util::FingerPrint));
+    if (!fingerprint_loaded.TestGraphUtil(util::FingerPrint::GetValid()))
+    {
+        util::SimpleLogger().Write(logWARNING) << ".hsgr was prepared with different build.";
+    }
+
+    unsigned checksum = 0;
+    hsgr_input_stream.read((char *)&checksum, sizeof(unsigned));
+    return checksum;
+}
+
+struct Cell
+{
+    std::uint32_t grid_cell;
+    util::Coordinate representative;
+    std::vector<util::Coordinate> samples;
+};
+
+util::CellGrid makeGrid(const std::vector<extractor::QueryNode> &nodes, const double cell_size)
+{
+    std::int32_t min_lon = std::numeric_limits<std::int32_t>::max();
+    std::int32_t min_lat = std::numeric_limits<std::int32_t>::max();
+    std::int32_t max_lon = std::numeric_limits<std::int32_t>::min();
+    std::int32_t max_lat = std::numeric_limits<std::int32_t>::min();
+    for (const auto &node : nodes)
+    {
+        min_lon = std::min(min_lon, static_cast<std::int32_t>(node.lon));
+        min_lat = std::min(min_lat, static_cast<std::int32_t>(node.lat));
+        max_lon = std::max(max_lon, static_cast<std::int32_t>(node.lon));
+        max_lat = std::max(max_lat, static_cast<std::int32_t>(node.lat));
+    }
+    if (nodes.empty())
+    {
+        throw util::exception("Dataset has no nodes");
+    }
+
+    util::CellGrid grid;
+    grid.min_lon = min_lon;
+    grid.min_lat = min_lat;
+    grid.cell_size = static_cast<std::int32_t>(std::round(cell_size * COORDINATE_PRECISION));
+    grid.columns = static_cast<std::uint32_t>((max_lon - min_lon) / grid.cell_size) + 1;
+    grid.rows = static_cast<std::uint32_t>((max_lat - min_lat) / grid.cell_size) + 1;
+    return grid;
+}
+
+// The representative of a cell is the node closest to its center, the samples are spread
+// evenly over the nodes of the cell.
+std::vector<Cell> makeCells(const std::vector<extractor::QueryNode> &nodes,
+                            const util::CellGrid &grid,
+                            const unsigned samples_per_cell)
+{
+    const util::CellTable lookup{
+        grid,
+        0,
+        std::vector<std::uint32_t>(static_cast<std::size_t>(grid.columns) * grid.rows),
+        {},
+        {}};
+
+    // ordered by grid cell, so dense ids follow the grid
+    std::map<std::uint32_t, std::vector<util::Coordinate>> nodes_per_cell;
+    for (const auto &node : nodes)
+    {
+        const util::Coordinate coordinate{node.lon, node.lat};
+        nodes_per_cell[lookup.GetGridCell(coordinate)].push_back(coordinate);
+    }
+
+    std::vector<Cell> cells;
+    cells.reserve(nodes_per_cell.size());
+    for (const auto &grid_cell_and_nodes : nodes_per_cell)
+    {
+        const auto grid_cell = grid_cell_and_nodes.first;
+        const auto &cell_nodes = grid_cell_and_nodes.second;
+
+        const std::int64_t center_lon = grid.min_lon +
+                                        (grid_cell % grid.columns) * std::int64_t{grid.cell_size} +
+                                        grid.cell_size / 2;
+        const std::int64_t center_lat = grid.min_lat +
+                                        (grid_cell / grid.columns) * std::int64_t{grid.cell_size} +
+                                        grid.cell_size / 2;
+        const auto squared_distance_to_center = [&](const util::Coordinate coordinate) {
+            const auto lon = static_cast<std::int32_t>(coordinate.lon) - center_lon;
+            const auto lat = static_cast<std::int32_t>(coordinate.lat) - center_lat;
+            return lon * lon + lat * lat;
+        };
+
+        Cell cell;
+        cell.grid_cell = grid_cell;
+        cell.representative = *std::min_element(
+            cell_nodes.begin(),
+            cell_nodes.end(),
+            [&](const util::Coordinate lhs, const util::Coordinate rhs) {
+                return squared_distance_to_center(lhs) < squared_distance_to_center(rhs);
+            });
+
+        const auto stride = std::max<std::size_t>(1, cell_nodes.size() / samples_per_cell);
+        for (std::size_t index = 0;
+             index < cell_nodes.size() && cell.samples.size() < samples_per_cell;
+             index += stride)
+        {
+            cell.samples.push_back(cell_nodes[index]);
+        }
+        cells.push_back(std::move(cell));
+    }
+    return cells;
+}
+
+std::vector<EdgeWeight> computeTable(OSRM &osrm, const TableParameters &params)
+{
+    json::Object result;
+    if (osrm.Table(params, result) != Status::Ok)
+    {
+        throw util::exception("Table query failed: " +
+                              result.values["message"].get<json::String>().value);
+    }
+
+    std::vector<EdgeWeight> weights;
+    for (const auto &row : result.values["durations"].get<json::Array>().values)
+    {
+        for (const auto &value : row.get<json::Array>().values)
+        {
+            if (value.is<json::Null>())
+            {
+                weights.push_back(INVALID_EDGE_WEIGHT);
+            }
+            else
+            {
+                // durations are given in seconds, weights are in deciseconds
+                weights.push_back(static_cast<EdgeWeight>(
+                    std::round(value.get<json::Number>().value * 10.)));
+            }
+        }
+    }
+    return weights;
+}
+
+// Largest duration between the representative and a sample in either direction
+EdgeWeight computeRadius(OSRM &osrm, const Cell &cell)
+{
+    TableParameters params;
+    params.coordinates.push_back(cell.representative);
+    params.coordinates.insert(params.coordinates.end(), cell.samples.begin(), cell.samples.end());
+
+    const auto size = params.coordinates.size();
+    const auto table = computeTable(osrm, params);
+
+    EdgeWeight radius = 0;
+    for (const auto index : util::irange<std::size_t>(1UL, size))
+    {
+        const auto to_sample = table[index];
+        const auto from_sample = table[index * size];
+        if (to_sample == INVALID_EDGE_WEIGHT || from_sample == INVALID_EDGE_WEIGHT)
+        {
+            return INVALID_EDGE_WEIGHT;
+        }
+        radius = std::max(radius, std::max(to_sample, from_sample));
+    }
+    return radius;
+}
+}
+
+int main(const int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    boost::filesystem::path base_path;
+    boost::filesystem::path cell_table_path;
+    double cell_size = 0;
+    unsigned samples_per_cell = 0;
+    if (!generateCellTableOptions(
+            argc, argv, base_path, cell_table_path, cell_size, samples_per_cell))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    const auto nodes = readNodes(base_path);
+    const auto grid = makeGrid(nodes, cell_size);
+    const auto cells = makeCells(nodes, grid, samples_per_cell);
+    util::SimpleLogger().Write() << "Grid of " << grid.columns << "x" << grid.rows << " with "
+                                 << cells.size() << " populated cells";
+
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    OSRM osrm{config};
+
+    std::vector<std::uint32_t> cell_ids(static_cast<std::size_t>(grid.columns) * grid.rows,
+                                        util::INVALID_CELL_ID);
+    std::vector<EdgeWeight> radiuses;
+    radiuses.reserve(cells.size());
+    for (const auto cell_id : util::irange<std::size_t>(0UL, cells.size()))
+    {
+        cell_ids[cells[cell_id].grid_cell] = static_cast<std::uint32_t>(cell_id);
+        radiuses.push_back(computeRadius(osrm, cells[cell_id]));
+    }
+
+    TableParameters params;
+    for (const auto &cell : cells)
+    {
+        params.coordinates.push_back(cell.representative);
+    }
+    params.destinations.resize(cells.size());
+    std::iota(params.destinations.begin(), params.destinations.end(), 0);
+
+    std::vector<EdgeWeight> durations;
+    durations.reserve(cells.size() * cells.size());
+    for (std::size_t first_source = 0; first_source < cells.size();
+         first_source += SOURCES_PER_QUERY)
+    {
+        const auto last_source = std::min(first_source + SOURCES_PER_QUERY, cells.size());
+        params.sources.resize(last_source - first_source);
+        std::iota(params.sources.begin(), params.sources.end(), first_source);
+
+        const auto rows = computeTable(osrm, params);
+        durations.insert(durations.end(), rows.begin(), rows.end());
+        util::SimpleLogger().Write() << "Computed " << last_source << "/" << cells.size()
+                                     << " rows";
+    }
+
+    const util::CellTable cell_table{grid,
+                                     readChecksum(base_path),
+                                     std::move(cell_ids),
+                                     std::move(radiuses),
+                                     std::move(durations)};
+    cell_table.Write(cell_table_path);
+    util::SimpleLogger().Write() << "Wrote cell table to " << cell_table_path.string();
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,273 @@
+#include "extractor/edge_based_node.hpp"
+#include "extractor/query_node.hpp"
+#include "storage/shared_datatype.hpp"
+#include "storage/shared_memory.hpp"
+#include "util/exception.hpp"
+#include "util/fingerprint.hpp"
+#include "util/simple_logger.hpp"
+#include "util/static_rtree.hpp"
+#include "util/typedefs.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/program_options.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+// generate boost::program_options object for the closures tool
+bool generateClosureOptions(const int argc,
+                            const char *argv[],
+                            boost::filesystem::path &base_path,
+                            boost::filesystem::path &closures_path,
+                            bool &clear)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    // as well as in a config file
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "closures,c",
+        boost::program_options::value<boost::filesystem::path>(&closures_path),
+        "CSV file with one closed segment per line: from_osm_id,to_osm_id")(
+        "clear",
+        boost::program_options::value<bool>(&clear)->implicit_value(true)->default_value(false),
+        "Remove all closures");
+
+    // hidden options, will be allowed on command line but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()("base,b",
+                                 boost::program_options::value<boost::filesystem::path>(&base_path),
+                                 "base path to .osrm file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("base", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <base.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("base") || (!option_variables.count("closures") && !clear))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    return true;
+}
+
+using OSMSegment = std::pair<OSMNodeID, OSMNodeID>;
+
+std::vector<OSMSegment> parseClosures(const boost::filesystem::path &closures_path)
+{
+    boost::filesystem::ifstream closures_file(closures_path, std::ios::binary);
+    if (!closures_file)
+    {
+        throw util::exception("Unable to open closures file " + closures_path.string());
+    }
+
+    std::vector<OSMSegment> segments;
+    std::uint64_t from_node_id{};
+    std::uint64_t to_node_id{};
+
+    for (std::string line; std::getline(closures_file, line);)
+    {
+        using namespace boost::spirit::qi;
+
+        auto it = begin(line);
+        const auto last = end(line);
+
+        const auto ok =
+            parse(it, last, (ulong_long >> ',' >> ulong_long), from_node_id, to_node_id);
+        if (!ok || it != last)
+        {
+            throw util::exception("Closures file " + closures_path.string() + " malformed");
+        }
+
+        segments.emplace_back(static_cast<OSMNodeID>(from_node_id),
+                              static_cast<OSMNodeID>(to_node_id));
+    }
+
+    std::sort(segments.begin(), segments.end());
+    segments.erase(std::unique(segments.begin(), segments.end()), segments.end());
+    return segments;
+}
+
+// Maps the closed OSM segments to the edge-based nodes that contain them. A closed segment is
+// only closed in the given direction.
+std::vector<NodeID> findClosedNodes(const boost::filesystem::path &base_path,
+                                    const std::vector<OSMSegment> &segments)
+{
+    const auto nodes_path = base_path.string() + ".nodes";
+    boost::filesystem::ifstream nodes_input_stream(nodes_path, std::ios::binary);
+    if (!nodes_input_stream)
+    {
+        throw util::exception("Could not open " + nodes_path + " for reading.");
+    }
+    unsigned number_of_nodes = 0;
+    nodes_input_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+    std::vector<extractor::QueryNode> internal_to_external_node_map(number_of_nodes);
+    nodes_input_stream.read((char *)internal_to_external_node_map.data(),
+                            number_of_nodes * sizeof(extractor::QueryNode));
+
+    using LeafNode = util::StaticRTree<extractor::EdgeBasedNode>::LeafNode;
+
+    using boost::interprocess::file_mapping;
+    using boost::interprocess::mapped_region;
+    using boost::interprocess::read_only;
+
+    const auto leaf_path = base_path.string() + ".fileIndex";
+    const file_mapping mapping{leaf_path.c_str(), read_only};
+    mapped_region region{mapping, read_only};
+    region.advise(mapped_region::advice_sequential);
+
+    const auto first = static_cast<const LeafNode *>(region.get_address());
+    const auto last = first + (region.get_size() / sizeof(LeafNode));
+
+    const auto is_closed = [&](const NodeID from, const NodeID to) {
+        const OSMSegment segment{internal_to_external_node_map[from].node_id,
+                                 internal_to_external_node_map[to].node_id};
+        return std::binary_search(segments.begin(), segments.end(), segment);
+    };
+
+    std::vector<NodeID> closed_nodes;
+    std::for_each(first, last, [&](const LeafNode &leaf) {
+        for (std::size_t i = 0; i < leaf.object_count; ++i)
+        {
+            const auto &object = leaf.objects[i];
+            if (object.forward_segment_id.enabled && is_closed(object.u, object.v))
+            {
+                closed_nodes.push_back(object.forward_segment_id.id);
+            }
+            if (object.reverse_segment_id.enabled && is_closed(object.v, object.u))
+            {
+                closed_nodes.push_back(object.reverse_segment_id.id);
+            }
+        }
+    });
+
+    std::sort(closed_nodes.begin(), closed_nodes.end());
+    closed_nodes.erase(std::unique(closed_nodes.begin(), closed_nodes.end()), closed_nodes.end());
+    return closed_nodes;
+}
+
+unsigned readChecksum(const boost::filesystem::path &base_path)
+{
+    const auto hsgr_path = base_path.string() + ".hsgr";
+    boost::filesystem::ifstream hsgr_input_stream(hsgr_path, std::ios::binary);
+    if (!hsgr_input_stream)
+    {
+        throw util::exception("Could not open " + hsgr_path + " for reading.");
+    }
+
+    util::FingerPrint fingerprint_loaded;
+    hsgr_input_stream.read((char *)&fingerprint_loaded, sizeof(util::FingerPrint));
+    if (!fingerprint_loaded.TestGraphUtil(util::FingerPrint::GetValid()))
+    {
+        util::SimpleLogger().Write(logWARNING) << ".hsgr was prepared with different build.";
+    }
+
+    unsigned checksum = 0;
+    hsgr_input_stream.read((char *)&checksum, sizeof(unsigned));
+    return checksum;
+}
+
+void publishClosures(const unsigned checksum, const std::vector<NodeID> &closed_nodes)
+{
+    using namespace storage;
+
+    auto *current_closures_memory = makeSharedMemory(
+        CURRENT_CLOSURES, sizeof(SharedClosuresTimestamp), true, false);
+    auto *current = static_cast<SharedClosuresTimestamp *>(current_closures_memory->Ptr());
+
+    // never touch the region osrm-routed could be reading right now
+    const auto next_region = current->region == CLOSURES_1 ? CLOSURES_2 : CLOSURES_1;
+
+    const auto size = sizeof(SharedClosuresHeader) + closed_nodes.size() * sizeof(NodeID);
+    // the region has to outlive this process, so the memory object is never deleted
+    auto *closures_memory = makeSharedMemory(next_region, size, true, true);
+    auto *header = static_cast<SharedClosuresHeader *>(closures_memory->Ptr());
+    header->checksum = checksum;
+    header->number_of_closed_nodes = static_cast<std::uint32_t>(closed_nodes.size());
+    std::copy(closed_nodes.begin(), closed_nodes.end(), reinterpret_cast<NodeID *>(header + 1));
+
+    current->region = next_region;
+    current->timestamp += 1;
+
+    util::SimpleLogger().Write() << "Published " << closed_nodes.size()
+                                 << " closed nodes, timestamp " << current->timestamp;
+}
+}
+
+int main(const int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    boost::filesystem::path base_path;
+    boost::filesystem::path closures_path;
+    bool clear = false;
+    if (!generateClosureOptions(argc, argv, base_path, closures_path, clear))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<NodeID> closed_nodes;
+    if (!clear)
+    {
+        const auto segments = parseClosures(closures_path);
+        util::SimpleLogger().Write() << "Loaded " << segments.size() << " closed segments";
+        closed_nodes = findClosedNodes(base_path, segments);
+    }
+
+    publishClosures(readChecksum(base_path), closed_nodes);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
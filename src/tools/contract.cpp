@@ -52,7 +52,12 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         "level-cache,o",
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
-        "Use .level file to retain the contaction level for each node from the last run.");
+        "Use .level file to retain the contaction level for each node from the last run.")(
+        "edge-lengths",
+        boost::program_options::value<bool>(&contractor_config.use_edge_lengths)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store the length of every edge for the distances of the table service, 4 bytes per edge");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -0,0 +1,287 @@
+#include "util/binary_delta.hpp"
+#include "util/exception.hpp"
+#include "util/io.hpp"
+#include "util/simple_logger.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+// generate boost::program_options object for the delta tool
+bool generateDeltaOptions(const int argc,
+                          const char *argv[],
+                          std::string &command,
+                          boost::filesystem::path &old_base_path,
+                          boost::filesystem::path &second_path,
+                          boost::filesystem::path &output_path,
+                          std::size_t &block_size)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    // as well as in a config file
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "output,o",
+        boost::program_options::value<boost::filesystem::path>(&output_path),
+        "Delta file for create, base path of the updated dataset for apply")(
+        "block-size",
+        boost::program_options::value<std::size_t>(&block_size)
+            ->default_value(util::DEFAULT_DELTA_BLOCK_SIZE),
+        "Size of the blocks that are matched between both datasets");
+
+    // hidden options, will be allowed on command line but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "command", boost::program_options::value<std::string>(&command), "create or apply")(
+        "old", boost::program_options::value<boost::filesystem::path>(&old_base_path), "")(
+        "second", boost::program_options::value<boost::filesystem::path>(&second_path), "");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("command", 1).add("old", 1).add("second", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto executable = boost::filesystem::path(argv[0]).filename().string();
+    boost::program_options::options_description visible_options(
+        executable + " create <old.osrm> <new.osrm> -o <update.delta> [options]\n" + executable +
+        " apply <old.osrm> <update.delta> -o <new.osrm>");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if ((command != "create" && command != "apply") || !option_variables.count("old") ||
+        !option_variables.count("second") || !option_variables.count("output"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    if (block_size < 64)
+    {
+        throw util::exception("Block size has to be at least 64 bytes");
+    }
+
+    return true;
+}
+
+// Read only mapping of a whole file, files that do not exist are empty
+class MappedFile
+{
+  public:
+    explicit MappedFile(const boost::filesystem::path &path)
+    {
+        if (!boost::filesystem::exists(path) || boost::filesystem::file_size(path) == 0)
+        {
+            return;
+        }
+        mapping = boost::interprocess::file_mapping(path.string().c_str(),
+                                                    boost::interprocess::read_only);
+        region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+    }
+
+    const char *GetData() const { return static_cast<const char *>(region.get_address()); }
+    std::size_t GetSize() const { return region.get_size(); }
+
+  private:
+    boost::interprocess::file_mapping mapping;
+    boost::interprocess::mapped_region region;
+};
+
+// The files of a dataset are all files next to the base path whose name starts with it,
+// returns the suffixes that are appended to the base path
+std::vector<std::string> getDatasetSuffixes(const boost::filesystem::path &base_path)
+{
+    auto directory = base_path.parent_path();
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+    const auto base_name = base_path.filename().string();
+
+    std::vector<std::string> suffixes;
+    for (boost::filesystem::directory_iterator iter(directory), end; iter != end; ++iter)
+    {
+        const auto name = iter->path().filename().string();
+        if (boost::filesystem::is_regular_file(iter->path()) &&
+            name.compare(0, base_name.size(), base_name) == 0)
+        {
+            suffixes.push_back(name.substr(base_name.size()));
+        }
+    }
+    std::sort(suffixes.begin(), suffixes.end());
+    return suffixes;
+}
+
+// A delta file is a gzip compressed stream of
+//
+//   fingerprint | number of files | (suffix length | suffix | binary delta)*
+void createDelta(const boost::filesystem::path &old_base_path,
+                 const boost::filesystem::path &new_base_path,
+                 const boost::filesystem::path &delta_path,
+                 const std::size_t block_size)
+{
+    auto suffixes = getDatasetSuffixes(new_base_path);
+    suffixes.erase(std::remove_if(suffixes.begin(),
+                                  suffixes.end(),
+                                  [&](const std::string &suffix) {
+                                      return boost::filesystem::path(new_base_path.string() +
+                                                                     suffix) == delta_path;
+                                  }),
+                   suffixes.end());
+    if (suffixes.empty())
+    {
+        throw util::exception("No dataset found at " + new_base_path.string());
+    }
+
+    boost::iostreams::filtering_ostream delta_stream;
+    delta_stream.push(boost::iostreams::gzip_compressor());
+    delta_stream.push(boost::iostreams::file_sink(delta_path.string(), std::ios::binary));
+
+    util::writeFingerprint(delta_stream);
+    const std::uint64_t number_of_files = suffixes.size();
+    delta_stream.write(reinterpret_cast<const char *>(&number_of_files), sizeof(number_of_files));
+
+    for (const auto &suffix : suffixes)
+    {
+        const MappedFile old_file(old_base_path.string() + suffix);
+        const MappedFile new_file(new_base_path.string() + suffix);
+
+        const std::uint64_t suffix_length = suffix.size();
+        delta_stream.write(reinterpret_cast<const char *>(&suffix_length), sizeof(suffix_length));
+        delta_stream.write(suffix.data(), suffix_length);
+        util::writeBinaryDelta(old_file.GetData(),
+                               old_file.GetSize(),
+                               new_file.GetData(),
+                               new_file.GetSize(),
+                               delta_stream,
+                               block_size);
+        util::SimpleLogger().Write() << "Processed " << new_base_path.string() + suffix;
+    }
+
+    delta_stream.reset();
+    util::SimpleLogger().Write() << "Wrote delta of " << boost::filesystem::file_size(delta_path)
+                                 << " bytes to " << delta_path.string();
+}
+
+void applyDelta(const boost::filesystem::path &old_base_path,
+                const boost::filesystem::path &delta_path,
+                const boost::filesystem::path &new_base_path)
+{
+    if (boost::filesystem::absolute(old_base_path) == boost::filesystem::absolute(new_base_path))
+    {
+        throw util::exception("The updated dataset can not replace the old dataset in place");
+    }
+    if (!boost::filesystem::exists(delta_path))
+    {
+        throw util::exception(delta_path.string() + " not found");
+    }
+
+    boost::iostreams::filtering_istream delta_stream;
+    delta_stream.push(boost::iostreams::gzip_decompressor());
+    delta_stream.push(boost::iostreams::file_source(delta_path.string(), std::ios::binary));
+
+    if (!util::readAndCheckFingerprint(delta_stream))
+    {
+        throw util::exception("Fingerprint of " + delta_path.string() + " does not match");
+    }
+
+    std::uint64_t number_of_files = 0;
+    delta_stream.read(reinterpret_cast<char *>(&number_of_files), sizeof(number_of_files));
+    for (std::uint64_t file = 0; file < number_of_files; ++file)
+    {
+        std::uint64_t suffix_length = 0;
+        delta_stream.read(reinterpret_cast<char *>(&suffix_length), sizeof(suffix_length));
+        if (!delta_stream || suffix_length > 1024)
+        {
+            throw util::exception(delta_path.string() + " is corrupt");
+        }
+        std::string suffix(suffix_length, '\0');
+        delta_stream.read(&suffix[0], suffix_length);
+
+        const MappedFile old_file(old_base_path.string() + suffix);
+        const auto new_path = new_base_path.string() + suffix;
+        boost::filesystem::ofstream new_stream(new_path, std::ios::binary);
+        if (!new_stream)
+        {
+            throw util::exception("Could not open " + new_path + " for writing.");
+        }
+        util::applyBinaryDelta(old_file.GetData(), old_file.GetSize(), delta_stream, new_stream);
+        util::SimpleLogger().Write() << "Wrote " << new_path;
+    }
+}
+}
+
+int main(const int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    std::string command;
+    boost::filesystem::path old_base_path;
+    boost::filesystem::path second_path;
+    boost::filesystem::path output_path;
+    std::size_t block_size = 0;
+    if (!generateDeltaOptions(
+            argc, argv, command, old_base_path, second_path, output_path, block_size))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    if (command == "create")
+    {
+        createDelta(old_base_path, second_path, output_path, block_size);
+    }
+    else
+    {
+        applyDelta(old_base_path, second_path, output_path);
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
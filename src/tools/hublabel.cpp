@@ -0,0 +1,143 @@
+#include "contractor/hub_label_builder.hpp"
+#include "contractor/hub_label_config.hpp"
+#include "util/simple_logger.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <boost/program_options/errors.hpp>
+
+#include <tbb/task_scheduler_init.h>
+
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <ostream>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+return_code parseArguments(int argc, char *argv[], contractor::HubLabelConfig &hub_label_config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "threads,t",
+        boost::program_options::value<unsigned int>(&hub_label_config.requested_num_threads)
+            ->default_value(tbb::task_scheduler_init::default_num_threads()),
+        "Number of threads to use");
+
+    // hidden options, will be allowed on command line, but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&hub_label_config.osrm_input_path),
+        "Input file in .osrm format, contracted with osrm-contract");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        "Usage: " + boost::filesystem::path(executable).filename().string() +
+        " <input.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return return_code::exit;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("input"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    contractor::HubLabelConfig hub_label_config;
+
+    const return_code result = parseArguments(argc, argv, hub_label_config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    hub_label_config.UseDefaultOutputNames();
+
+    if (1 > hub_label_config.requested_num_threads)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Number of threads must be 1 or larger";
+        return EXIT_FAILURE;
+    }
+
+    if (!boost::filesystem::is_regular_file(hub_label_config.graph_path))
+    {
+        util::SimpleLogger().Write(logWARNING) << "Contracted graph " << hub_label_config.graph_path
+                                               << " not found! Did you run osrm-contract?";
+        return EXIT_FAILURE;
+    }
+
+    util::SimpleLogger().Write() << "Input file: "
+                                 << hub_label_config.osrm_input_path.filename().string();
+    util::SimpleLogger().Write() << "Threads: " << hub_label_config.requested_num_threads;
+
+    tbb::task_scheduler_init init(hub_label_config.requested_num_threads);
+
+    return contractor::HubLabelBuilder(hub_label_config).Run();
+}
+catch (const std::bad_alloc &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    util::SimpleLogger().Write(logWARNING)
+        << "Please provide more memory or consider using a larger swapfile";
+    return EXIT_FAILURE;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
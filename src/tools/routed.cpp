@@ -15,6 +15,7 @@
 #include <sys/mman.h>
 #endif
 
+#include <cstdint>
 #include <cstdlib>
 
 #include <signal.h>
@@ -22,9 +23,12 @@
 #include <chrono>
 #include <future>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <new>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -47,23 +51,43 @@ BOOL WINAPI console_ctrl_handler(DWORD ctrl_type)
 
 using namespace osrm;
 
+// Options of the slow query capture, disabled without a log path
+struct SlowQueryOptions
+{
+    boost::filesystem::path log_path;
+    double threshold_milliseconds;
+    double sample_rate;
+    unsigned number_of_slots;
+    unsigned slot_size_kib;
+    bool record_settled_nodes;
+};
+
 const static unsigned INIT_OK_START_ENGINE = 0;
 const static unsigned INIT_OK_DO_NOT_START_ENGINE = 1;
 const static unsigned INIT_FAILED = -1;
 
 // generate boost::program_options object for the routing part
-inline unsigned generateServerProgramOptions(const int argc,
-                                             const char *argv[],
-                                             boost::filesystem::path &base_path,
-                                             std::string &ip_address,
-                                             int &ip_port,
-                                             int &requested_num_threads,
-                                             bool &use_shared_memory,
-                                             bool &trial,
-                                             int &max_locations_trip,
-                                             int &max_locations_viaroute,
-                                             int &max_locations_distance_table,
-                                             int &max_locations_map_matching)
+inline unsigned
+generateServerProgramOptions(const int argc,
+                             const char *argv[],
+                             boost::filesystem::path &base_path,
+                             std::string &ip_address,
+                             int &ip_port,
+                             int &requested_num_threads,
+                             bool &use_shared_memory,
+                             boost::filesystem::path &image_path,
+                             bool &trial,
+                             int &max_locations_trip,
+                             int &max_locations_viaroute,
+                             int &max_locations_distance_table,
+                             int &max_locations_map_matching,
+                             boost::filesystem::path &hub_labels_path,
+                             boost::filesystem::path &cell_table_path,
+                             bool &use_closures,
+                             std::map<std::string, boost::filesystem::path> &facility_set_paths,
+                             std::map<std::string, boost::filesystem::path> &dataset_paths,
+                             std::string &main_profile,
+                             SlowQueryOptions &slow_query_options)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -89,6 +113,9 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("image",
+         value<boost::filesystem::path>(&image_path),
+         "Map a dataset image written by osrm-datastore --write-image") //
         ("max-viaroute-size",
          value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -100,7 +127,45 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in distance table query") //
         ("max-matching-size",
          value<int>(&max_locations_map_matching)->default_value(100),
-         "Max. locations supported in map matching query");
+         "Max. locations supported in map matching query") //
+        ("hub-labels",
+         value<boost::filesystem::path>(&hub_labels_path),
+         "Answer table queries with hub labels created by osrm-hublabel (.hl file)") //
+        ("cell-table",
+         value<boost::filesystem::path>(&cell_table_path),
+         "Answer approximate table queries with cells created by osrm-celltable (.cells file)") //
+        ("closures",
+         value<bool>(&use_closures)->implicit_value(true)->default_value(false),
+         "Route around road closures published by osrm-closures") //
+        ("facility-set",
+         value<std::vector<std::string>>()->composing(),
+         "Register a facility set for the facilities service: <name>=<file with lon,lat lines>") //
+        ("dataset",
+         value<std::vector<std::string>>()->composing(),
+         "Serve another dataset for requests with the given profile: <profile>=<base.osrm>") //
+        ("profile",
+         value<std::string>(&main_profile)->default_value("driving"),
+         "Profile of the main dataset if --dataset is given, otherwise it serves all profiles") //
+        ("slow-query-log",
+         value<boost::filesystem::path>(&slow_query_options.log_path),
+         "Capture slow and sampled queries with their search statistics into this file") //
+        ("slow-query-threshold",
+         value<double>(&slow_query_options.threshold_milliseconds)->default_value(1000),
+         "Capture queries that take at least this many milliseconds") //
+        ("slow-query-sample-rate",
+         value<double>(&slow_query_options.sample_rate)->default_value(0),
+         "Fraction of all other queries that are captured as samples") //
+        ("slow-query-slots",
+         value<unsigned>(&slow_query_options.number_of_slots)->default_value(1000),
+         "Number of queries kept in the slow query log, older ones are overwritten") //
+        ("slow-query-slot-size",
+         value<unsigned>(&slow_query_options.slot_size_kib)->default_value(1024),
+         "Size of a query in the slow query log in KiB, larger ones lose their settled nodes") //
+        ("slow-query-settled-nodes",
+         value<bool>(&slow_query_options.record_settled_nodes)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Record the settled nodes of the captured queries for osrm-slowqueries");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -142,6 +207,61 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (slow_query_options.sample_rate < 0 || slow_query_options.sample_rate > 1)
+    {
+        util::SimpleLogger().Write(logWARNING) << "Slow query sample rate has to be in [0, 1]";
+        return INIT_FAILED;
+    }
+
+    if (option_variables.count("facility-set"))
+    {
+        for (const auto &facility_set :
+             option_variables["facility-set"].as<std::vector<std::string>>())
+        {
+            const auto separator = facility_set.find('=');
+            if (separator == std::string::npos || separator == 0)
+            {
+                util::SimpleLogger().Write(logWARNING) << "Invalid facility set " << facility_set
+                                                       << ", expected <name>=<file>";
+                return INIT_FAILED;
+            }
+            facility_set_paths[facility_set.substr(0, separator)] =
+                facility_set.substr(separator + 1);
+        }
+    }
+
+    if (option_variables.count("dataset"))
+    {
+        for (const auto &dataset : option_variables["dataset"].as<std::vector<std::string>>())
+        {
+            const auto separator = dataset.find('=');
+            if (separator == std::string::npos || separator == 0)
+            {
+                util::SimpleLogger().Write(logWARNING) << "Invalid dataset " << dataset
+                                                       << ", expected <profile>=<base.osrm>";
+                return INIT_FAILED;
+            }
+            dataset_paths[dataset.substr(0, separator)] = dataset.substr(separator + 1);
+        }
+        if (dataset_paths.count(main_profile))
+        {
+            util::SimpleLogger().Write(logWARNING) << "Profile " << main_profile
+                                                   << " is served by the main dataset";
+            return INIT_FAILED;
+        }
+    }
+
+    if (option_variables.count("image"))
+    {
+        if (use_shared_memory || option_variables.count("base"))
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "Image settings conflict with shared memory or path settings.";
+            return INIT_FAILED;
+        }
+        return INIT_OK_START_ENGINE;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -170,6 +290,9 @@ int main(int argc, const char *argv[]) try
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    std::map<std::string, boost::filesystem::path> dataset_paths;
+    std::string main_profile;
+    SlowQueryOptions slow_query_options;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
                                                               base_path,
@@ -177,11 +300,19 @@ int main(int argc, const char *argv[]) try
                                                               ip_port,
                                                               requested_thread_num,
                                                               config.use_shared_memory,
+                                                              config.image_path,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
-                                                              config.max_locations_map_matching);
+                                                              config.max_locations_map_matching,
+                                                              config.hub_labels_path,
+                                                              config.cell_table_path,
+                                                              config.use_closures,
+                                                              config.facility_set_paths,
+                                                              dataset_paths,
+                                                              main_profile,
+                                                              slow_query_options);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -217,6 +348,11 @@ int main(int argc, const char *argv[]) try
                 util::SimpleLogger().Write(logWARNING) << config.storage_config.hsgr_data_path
                                                        << " is not found";
             }
+            if (!boost::filesystem::is_regular_file(config.storage_config.edge_lengths_path))
+            {
+                util::SimpleLogger().Write(logWARNING) << config.storage_config.edge_lengths_path
+                                                       << " is not found";
+            }
             if (!boost::filesystem::is_regular_file(config.storage_config.nodes_data_path))
             {
                 util::SimpleLogger().Write(logWARNING) << config.storage_config.nodes_data_path
@@ -307,7 +443,62 @@ int main(int argc, const char *argv[]) try
     auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
     auto service_handler = util::make_unique<server::ServiceHandler>(config);
 
-    routing_server->RegisterServiceHandler(std::move(service_handler));
+    // all datasets share the slow query log, the records name their dataset
+    server::SlowQueryCapture slow_query_capture{nullptr,
+                                                slow_query_options.threshold_milliseconds,
+                                                slow_query_options.sample_rate,
+                                                slow_query_options.record_settled_nodes};
+    if (!slow_query_options.log_path.empty())
+    {
+        slow_query_capture.log = std::make_shared<engine::SlowQueryLog>(
+            slow_query_options.log_path,
+            slow_query_options.number_of_slots,
+            static_cast<std::uint64_t>(slow_query_options.slot_size_kib) * 1024);
+        service_handler->EnableSlowQueryCapture(slow_query_capture);
+        util::SimpleLogger().Write() << "Capturing queries slower than "
+                                     << slow_query_options.threshold_milliseconds << " ms into "
+                                     << slow_query_options.log_path.string();
+    }
+
+    // A single dataset serves all profiles. With several datasets each one only serves its own
+    // profile and requests for any other profile are answered with InvalidProfile.
+    if (dataset_paths.empty())
+    {
+        routing_server->RegisterServiceHandler("", std::move(service_handler));
+    }
+    else
+    {
+        util::SimpleLogger().Write() << "Profile " << main_profile << ": main dataset";
+        routing_server->RegisterServiceHandler(main_profile, std::move(service_handler));
+    }
+
+    // Shared memory only holds one dataset, the others are always loaded into process memory.
+    // Hub labels, cell tables, facility sets and closures are only used by the main dataset.
+    for (const auto &profile_and_path : dataset_paths)
+    {
+        EngineConfig dataset_config;
+        dataset_config.storage_config = storage::StorageConfig(profile_and_path.second);
+        dataset_config.use_shared_memory = false;
+        dataset_config.max_locations_trip = config.max_locations_trip;
+        dataset_config.max_locations_viaroute = config.max_locations_viaroute;
+        dataset_config.max_locations_distance_table = config.max_locations_distance_table;
+        dataset_config.max_locations_map_matching = config.max_locations_map_matching;
+        if (!dataset_config.IsValid())
+        {
+            util::SimpleLogger().Write(logWARNING) << "Invalid dataset "
+                                                   << profile_and_path.second.string();
+            return EXIT_FAILURE;
+        }
+
+        util::SimpleLogger().Write() << "Profile " << profile_and_path.first << ": "
+                                     << profile_and_path.second.string();
+        auto dataset_handler = util::make_unique<server::ServiceHandler>(dataset_config);
+        if (slow_query_capture.log)
+        {
+            dataset_handler->EnableSlowQueryCapture(slow_query_capture);
+        }
+        routing_server->RegisterServiceHandler(profile_and_path.first, std::move(dataset_handler));
+    }
 
     if (trial_run)
     {
@@ -358,6 +549,8 @@ int main(int argc, const char *argv[]) try
             util::SimpleLogger().Write(logWARNING) << "Didn't exit within 2 seconds. Hard abort!";
             server_task.reset(); // just kill it
         }
+
+        routing_server->WriteMetrics();
     }
 
     util::SimpleLogger().Write() << "freeing objects";
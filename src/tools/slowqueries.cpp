@@ -0,0 +1,432 @@
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/slow_query_log.hpp"
+#include "storage/storage_config.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
+#include "util/simple_logger.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_tile.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/json_container.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+
+#include <protozero/pbf_writer.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+struct SlowQueryToolOptions
+{
+    boost::filesystem::path log_path;
+    std::uint64_t sequence_number = 0;
+    boost::filesystem::path dataset_path;
+    std::string bbox;
+    boost::filesystem::path geojson_path;
+    std::string tile;
+    boost::filesystem::path tile_path;
+};
+
+// A road segment in the direction in which a heap settled its edge based node
+struct SettledSegment
+{
+    util::Coordinate source;
+    util::Coordinate target;
+    std::size_t heap;
+};
+
+// generate boost::program_options object for the slow query tool
+bool generateSlowQueryOptions(const int argc, const char *argv[], SlowQueryToolOptions &options)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    // as well as in a config file
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "record,r",
+        boost::program_options::value<std::uint64_t>(&options.sequence_number),
+        "Sequence number of the record whose search space is exported")(
+        "dataset,d",
+        boost::program_options::value<boost::filesystem::path>(&options.dataset_path),
+        "Base path of the .osrm files, defaults to the dataset of the record")(
+        "bbox",
+        boost::program_options::value<std::string>(&options.bbox)
+            ->default_value("-180,-85,180,85"),
+        "Bounding box of the GeoJSON export: min_lon,min_lat,max_lon,max_lat")(
+        "geojson",
+        boost::program_options::value<boost::filesystem::path>(&options.geojson_path),
+        "Write the settled segments of the record as GeoJSON into this file")(
+        "tile",
+        boost::program_options::value<std::string>(&options.tile),
+        "Tile of the vector tile export: z,x,y")(
+        "mvt",
+        boost::program_options::value<boost::filesystem::path>(&options.tile_path),
+        "Write the settled segments of the record in the tile as a vector tile into this file");
+
+    // hidden options, will be allowed on command line but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "log", boost::program_options::value<boost::filesystem::path>(&options.log_path),
+        "slow query log written by osrm-routed");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("log", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <slow query log> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                      .options(cmdline_options)
+                                      .positional(positional_options)
+                                      .run(),
+                                  option_variables);
+
+    if (option_variables.count("version"))
+    {
+        util::SimpleLogger().Write() << OSRM_VERSION;
+        return false;
+    }
+
+    if (option_variables.count("help"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("log"))
+    {
+        util::SimpleLogger().Write() << visible_options;
+        return false;
+    }
+
+    const bool exports = !options.geojson_path.empty() || !options.tile_path.empty();
+    if (exports && !option_variables.count("record"))
+    {
+        throw util::exception("Exporting a search space needs the --record to export");
+    }
+    if (options.tile.empty() != options.tile_path.empty())
+    {
+        throw util::exception("Vector tile exports need both --tile and --mvt");
+    }
+
+    return true;
+}
+
+// Parses a comma separated list of exactly size numbers
+template <typename T> std::vector<T> parseList(const std::string &list, const std::size_t size)
+{
+    std::vector<T> values;
+    std::istringstream stream(list);
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        try
+        {
+            values.push_back(static_cast<T>(std::stod(value)));
+        }
+        catch (const std::exception &)
+        {
+            break;
+        }
+    }
+    if (values.size() != size)
+    {
+        throw util::exception("Expected " + std::to_string(size) + " comma separated numbers: " +
+                              list);
+    }
+    return values;
+}
+
+std::string formatTimestamp(const std::uint64_t timestamp)
+{
+    const auto time = static_cast<std::time_t>(timestamp);
+    std::tm utc_time;
+    gmtime_r(&time, &utc_time);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc_time);
+    return buffer;
+}
+
+void listRecords(const std::vector<engine::SlowQueryRecord> &records)
+{
+    for (const auto &record : records)
+    {
+        util::SimpleLogger().Write()
+            << "#" << record.sequence_number << " " << formatTimestamp(record.timestamp) << " "
+            << record.milliseconds << " ms" << (record.sampled ? " sampled" : "")
+            << (record.truncated ? " truncated" : "") << " " << record.dataset << " "
+            << record.service << "/" << record.query;
+        for (const auto &stage : record.trace.stages)
+        {
+            util::SimpleLogger().Write() << "  stage " << stage.name << ": " << stage.milliseconds
+                                         << " ms in " << stage.count << " calls";
+        }
+        for (const auto &heap : record.trace.heaps)
+        {
+            util::SimpleLogger().Write() << "  heap " << heap.name << ": "
+                                         << heap.number_of_settled_nodes << " settled nodes in "
+                                         << heap.number_of_searches << " searches";
+        }
+    }
+}
+
+// The segments in the box whose edge based nodes were settled by one of the heaps
+std::vector<SettledSegment>
+getSettledSegments(const engine::datafacade::InternalDataFacade &facade,
+                   const engine::QueryTrace &trace,
+                   const util::Coordinate south_west,
+                   const util::Coordinate north_east)
+{
+    std::vector<std::unordered_set<NodeID>> settled_nodes;
+    for (const auto &heap : trace.heaps)
+    {
+        settled_nodes.emplace_back(heap.settled_nodes.begin(), heap.settled_nodes.end());
+    }
+
+    std::vector<SettledSegment> segments;
+    for (const auto &edge : facade.GetEdgesInBox(south_west, north_east))
+    {
+        const auto source = facade.GetCoordinateOfNode(edge.u);
+        const auto target = facade.GetCoordinateOfNode(edge.v);
+        for (const auto heap : util::irange<std::size_t>(0UL, settled_nodes.size()))
+        {
+            if (edge.forward_segment_id.enabled &&
+                settled_nodes[heap].count(edge.forward_segment_id.id) > 0)
+            {
+                segments.push_back(SettledSegment{source, target, heap});
+            }
+            if (edge.reverse_segment_id.enabled &&
+                settled_nodes[heap].count(edge.reverse_segment_id.id) > 0)
+            {
+                segments.push_back(SettledSegment{target, source, heap});
+            }
+        }
+    }
+    return segments;
+}
+
+void writeGeoJSON(const boost::filesystem::path &path,
+                  const engine::QueryTrace &trace,
+                  const std::vector<SettledSegment> &segments)
+{
+    util::json::Array features;
+    features.values.reserve(segments.size());
+    for (const auto &segment : segments)
+    {
+        util::json::Object geometry;
+        geometry.values["type"] = "LineString";
+        util::json::LonLatArray coordinates;
+        coordinates.values = {segment.source, segment.target};
+        geometry.values["coordinates"] = std::move(coordinates);
+
+        util::json::Object properties;
+        properties.values["heap"] = trace.heaps[segment.heap].name;
+
+        util::json::Object feature;
+        feature.values["type"] = "Feature";
+        feature.values["geometry"] = std::move(geometry);
+        feature.values["properties"] = std::move(properties);
+        features.values.push_back(std::move(feature));
+    }
+
+    util::json::Object collection;
+    collection.values["type"] = "FeatureCollection";
+    collection.values["features"] = std::move(features);
+
+    boost::filesystem::ofstream output(path);
+    util::json::render(output, collection);
+    if (!output)
+    {
+        throw util::exception("Could not write " + path.string());
+    }
+}
+
+// Same layout as the tiles of the tile plugin with a single search_space layer
+void writeVectorTile(const boost::filesystem::path &path,
+                     const engine::QueryTrace &trace,
+                     const std::vector<SettledSegment> &segments,
+                     const util::vector_tile::BBox &tile_bbox)
+{
+    std::string pbf_buffer;
+    {
+        protozero::pbf_writer tile_writer{pbf_buffer};
+        protozero::pbf_writer layer_writer(tile_writer, util::vector_tile::LAYER_TAG);
+        layer_writer.add_uint32(util::vector_tile::VERSION_TAG, 2);
+        layer_writer.add_string(util::vector_tile::NAME_TAG, "search_space");
+        layer_writer.add_uint32(util::vector_tile::EXTEND_TAG, util::vector_tile::EXTENT);
+
+        std::uint64_t id = 0;
+        for (const auto &segment : segments)
+        {
+            const auto tile_line = util::vector_tile::coordinatesToTileLine(
+                util::web_mercator::fromWGS84(util::FloatCoordinate{segment.source}),
+                util::web_mercator::fromWGS84(util::FloatCoordinate{segment.target}),
+                tile_bbox);
+            if (tile_line.empty())
+            {
+                continue;
+            }
+
+            protozero::pbf_writer feature_writer(layer_writer, util::vector_tile::FEATURE_TAG);
+            feature_writer.add_enum(util::vector_tile::GEOMETRY_TAG,
+                                    util::vector_tile::GEOMETRY_TYPE_LINE);
+            feature_writer.add_uint64(util::vector_tile::ID_TAG, id++);
+            {
+                // the heap key and the index of its name in the values
+                protozero::packed_field_uint32 field(feature_writer,
+                                                     util::vector_tile::FEATURE_ATTRIBUTES_TAG);
+                field.add_element(0);
+                field.add_element(static_cast<std::uint32_t>(segment.heap));
+            }
+            {
+                std::int32_t start_x = 0;
+                std::int32_t start_y = 0;
+                protozero::packed_field_uint32 geometry(
+                    feature_writer, util::vector_tile::FEATURE_GEOMETRIES_TAG);
+                util::vector_tile::encodeLinestring(tile_line, geometry, start_x, start_y);
+            }
+        }
+
+        layer_writer.add_string(util::vector_tile::KEY_TAG, "heap");
+        for (const auto &heap : trace.heaps)
+        {
+            protozero::pbf_writer values_writer(layer_writer, util::vector_tile::VARIANT_TAG);
+            values_writer.add_string(util::vector_tile::VARIANT_TYPE_STRING, heap.name);
+        }
+    }
+
+    boost::filesystem::ofstream output(path, std::ios::binary);
+    output.write(pbf_buffer.data(), pbf_buffer.size());
+    if (!output)
+    {
+        throw util::exception("Could not write " + path.string());
+    }
+}
+
+void exportSearchSpace(const SlowQueryToolOptions &options,
+                       const engine::SlowQueryRecord &record)
+{
+    if (record.truncated)
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "Record " << record.sequence_number
+            << " lost its settled nodes, increase --slow-query-slot-size of osrm-routed";
+    }
+
+    const auto dataset_path = options.dataset_path.empty()
+                                  ? boost::filesystem::path(record.dataset)
+                                  : options.dataset_path;
+    if (dataset_path.empty())
+    {
+        throw util::exception("Record " + std::to_string(record.sequence_number) +
+                              " was captured from shared memory, pass its --dataset");
+    }
+    const storage::StorageConfig config(dataset_path);
+    if (!config.IsValid())
+    {
+        throw util::exception("Invalid dataset " + dataset_path.string());
+    }
+    const engine::datafacade::InternalDataFacade facade(config);
+
+    if (!options.geojson_path.empty())
+    {
+        const auto bbox = parseList<double>(options.bbox, 4);
+        const auto segments = getSettledSegments(
+            facade,
+            record.trace,
+            util::Coordinate{util::FloatLongitude(bbox[0]), util::FloatLatitude(bbox[1])},
+            util::Coordinate{util::FloatLongitude(bbox[2]), util::FloatLatitude(bbox[3])});
+        writeGeoJSON(options.geojson_path, record.trace, segments);
+        util::SimpleLogger().Write() << "Wrote " << segments.size() << " settled segments to "
+                                     << options.geojson_path.string();
+    }
+
+    if (!options.tile_path.empty())
+    {
+        const auto zxy = parseList<unsigned>(options.tile, 3);
+        double min_lon, min_lat, max_lon, max_lat;
+        util::web_mercator::xyzToWGS84(zxy[1], zxy[2], zxy[0], min_lon, min_lat, max_lon, max_lat);
+        const auto segments = getSettledSegments(
+            facade,
+            record.trace,
+            util::Coordinate{util::FloatLongitude(min_lon), util::FloatLatitude(min_lat)},
+            util::Coordinate{util::FloatLongitude(max_lon), util::FloatLatitude(max_lat)});
+
+        util::web_mercator::xyzToMercator(
+            zxy[1], zxy[2], zxy[0], min_lon, min_lat, max_lon, max_lat);
+        writeVectorTile(options.tile_path,
+                        record.trace,
+                        segments,
+                        util::vector_tile::BBox{min_lon, min_lat, max_lon, max_lat});
+        util::SimpleLogger().Write() << "Wrote " << segments.size() << " settled segments to "
+                                     << options.tile_path.string();
+    }
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    SlowQueryToolOptions options;
+    if (!generateSlowQueryOptions(argc, argv, options))
+    {
+        return EXIT_SUCCESS;
+    }
+
+    const auto records = engine::SlowQueryLog::Read(options.log_path);
+    if (options.geojson_path.empty() && options.tile_path.empty())
+    {
+        listRecords(records);
+        return EXIT_SUCCESS;
+    }
+
+    const auto record = std::find_if(
+        records.begin(), records.end(), [&options](const engine::SlowQueryRecord &record) {
+            return record.sequence_number == options.sequence_number;
+        });
+    if (record == records.end())
+    {
+        throw util::exception("No record " + std::to_string(options.sequence_number) + " in " +
+                              options.log_path.string());
+    }
+    exportSearchSpace(options, *record);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
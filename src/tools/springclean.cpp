@@ -31,6 +31,12 @@ void deleteRegion(const SharedDataType region)
                 return "DATA_2";
             case LAYOUT_NONE:
                 return "LAYOUT_NONE";
+            case CURRENT_CLOSURES:
+                return "CURRENT_CLOSURES";
+            case CLOSURES_1:
+                return "CLOSURES_1";
+            case CLOSURES_2:
+                return "CLOSURES_2";
             default: // DATA_NONE:
                 return "DATA_NONE";
             }
@@ -49,6 +55,9 @@ void springclean()
     deleteRegion(DATA_2);
     deleteRegion(LAYOUT_2);
     deleteRegion(CURRENT_REGIONS);
+    deleteRegion(CLOSURES_1);
+    deleteRegion(CLOSURES_2);
+    deleteRegion(CURRENT_CLOSURES);
 }
 }
 }
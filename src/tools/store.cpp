@@ -12,7 +12,10 @@ using namespace osrm;
 // generate boost::program_options object for the routing part
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
-                              boost::filesystem::path &base_path)
+                              boost::filesystem::path &base_path,
+                              boost::filesystem::path &image_path,
+                              boost::filesystem::path &write_image_path,
+                              bool &compress_image)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -22,6 +25,19 @@ bool generateDataStoreOptions(const int argc,
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
     boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()(
+        "image",
+        boost::program_options::value<boost::filesystem::path>(&image_path),
+        "Load a dataset image instead of the dataset files")(
+        "write-image",
+        boost::program_options::value<boost::filesystem::path>(&write_image_path),
+        "Write a dataset image of <base.osrm> instead of loading it into shared memory. The "
+        ".fileIndex is copied next to the image and has to be shipped with it")(
+        "compress-image",
+        boost::program_options::value<bool>(&compress_image)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Compress the written image in independent blocks, inflated in parallel on load");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -79,10 +95,21 @@ int main(const int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     boost::filesystem::path base_path;
-    if (!generateDataStoreOptions(argc, argv, base_path))
+    boost::filesystem::path image_path;
+    boost::filesystem::path write_image_path;
+    bool compress_image = false;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, image_path, write_image_path, compress_image))
     {
         return EXIT_SUCCESS;
     }
+
+    if (!image_path.empty())
+    {
+        storage::Storage storage{storage::StorageConfig{}};
+        return storage.RunFromImage(image_path);
+    }
+
     storage::StorageConfig config(base_path);
     if (!config.IsValid())
     {
@@ -90,6 +117,11 @@ int main(const int argc, const char *argv[]) try
         return EXIT_FAILURE;
     }
     storage::Storage storage(std::move(config));
+    if (!write_image_path.empty())
+    {
+        storage.WriteImage(write_image_path, compress_image);
+        return EXIT_SUCCESS;
+    }
     return storage.Run();
 }
 catch (const std::bad_alloc &e)
@@ -5,10 +5,16 @@
 
 #include <boost/assert.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
 #include <cmath>
 
 #include <limits>
 #include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -110,6 +116,230 @@ double perpendicularDistance(const Coordinate source_coordinate,
         source_coordinate, target_coordinate, query_location, nearest_location, ratio);
 }
 
+namespace
+{
+#if defined(__SSE2__)
+// Taylor coefficients of cos(x) and sin(x) / x in x^2, enough terms to be exact in double
+// precision for |x| <= pi/2
+const constexpr double COSINE_COEFFICIENTS[] = {1.,
+                                                -1. / 2,
+                                                1. / 24,
+                                                -1. / 720,
+                                                1. / 40320,
+                                                -1. / 3628800,
+                                                1. / 479001600,
+                                                -1. / 87178291200.,
+                                                1. / 20922789888000.,
+                                                -1. / 6402373705728000.,
+                                                1. / 2432902008176640000.,
+                                                -1. / 1124000727777607680000.};
+const constexpr double SINE_COEFFICIENTS[] = {1.,
+                                              -1. / 6,
+                                              1. / 120,
+                                              -1. / 5040,
+                                              1. / 362880,
+                                              -1. / 39916800,
+                                              1. / 6227020800.,
+                                              -1. / 1307674368000.,
+                                              1. / 355687428096000.,
+                                              -1. / 121645100408832000.,
+                                              1. / 51090942171709440000.,
+                                              -1. / 25852016738884976640000.};
+
+// Taylor coefficients of asin(x) / x in x^2, exact in double precision for |x| <= 0.2
+const constexpr double ARCSINE_COEFFICIENTS[] = {1.,
+                                                 1. / 6,
+                                                 3. / 40,
+                                                 5. / 112,
+                                                 35. / 1152,
+                                                 63. / 2816,
+                                                 231. / 13312,
+                                                 143. / 10240,
+                                                 6435. / 557056,
+                                                 12155. / 1245184};
+const constexpr double ARCSINE_SERIES_LIMIT = 0.2;
+
+template <std::size_t N> inline __m128d evaluatePolynomial(const double (&coefficients)[N],
+                                                           const __m128d x)
+{
+    __m128d result = _mm_set1_pd(coefficients[N - 1]);
+    for (std::size_t index = N - 1; index > 0; --index)
+    {
+        result = _mm_add_pd(_mm_mul_pd(result, x), _mm_set1_pd(coefficients[index - 1]));
+    }
+    return result;
+}
+
+// only valid for |x| <= pi/2
+inline __m128d cosine(const __m128d x)
+{
+    return evaluatePolynomial(COSINE_COEFFICIENTS, _mm_mul_pd(x, x));
+}
+
+// only valid for |x| <= pi/2
+inline __m128d sine(const __m128d x)
+{
+    return _mm_mul_pd(x, evaluatePolynomial(SINE_COEFFICIENTS, _mm_mul_pd(x, x)));
+}
+
+// only valid for |x| <= ARCSINE_SERIES_LIMIT
+inline __m128d arcsine(const __m128d x)
+{
+    return _mm_mul_pd(x, evaluatePolynomial(ARCSINE_COEFFICIENTS, _mm_mul_pd(x, x)));
+}
+
+// latitudes and longitudes of two coordinates in radians
+inline __m128d toRadians(const FixedLatitude first, const FixedLatitude second)
+{
+    return _mm_mul_pd(_mm_set_pd(static_cast<int>(second), static_cast<int>(first)),
+                      _mm_set1_pd(detail::DEGREE_TO_RAD / COORDINATE_PRECISION));
+}
+
+inline __m128d toRadians(const FixedLongitude first, const FixedLongitude second)
+{
+    return _mm_mul_pd(_mm_set_pd(static_cast<int>(second), static_cast<int>(first)),
+                      _mm_set1_pd(detail::DEGREE_TO_RAD / COORDINATE_PRECISION));
+}
+#endif
+}
+
+void haversineDistances(const Coordinate *first_coordinates,
+                        const Coordinate *second_coordinates,
+                        const std::size_t number_of_pairs,
+                        double *distances)
+{
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d pi = _mm_set1_pd(detail::DEGREE_TO_RAD * 180.);
+    const __m128d sign_mask = _mm_set1_pd(-0.);
+    const __m128d series_limit = _mm_set1_pd(ARCSINE_SERIES_LIMIT);
+    const __m128d twice_earth_radius = _mm_set1_pd(2. * detail::EARTH_RADIUS);
+    for (; index + 2 <= number_of_pairs; index += 2)
+    {
+        const auto &first_0 = first_coordinates[index];
+        const auto &first_1 = first_coordinates[index + 1];
+        const auto &second_0 = second_coordinates[index];
+        const auto &second_1 = second_coordinates[index + 1];
+
+        const __m128d lat_1 = toRadians(first_0.lat, first_1.lat);
+        const __m128d lat_2 = toRadians(second_0.lat, second_1.lat);
+        const __m128d lon_1 = toRadians(first_0.lon, first_1.lon);
+        const __m128d lon_2 = toRadians(second_0.lon, second_1.lon);
+
+        // half of the latitude difference is in [-pi/2, pi/2], half of the longitude difference
+        // in [-pi, pi]: sin^2 is symmetric around pi/2, so it is mirrored into [0, pi/2]
+        const __m128d half_dlat = _mm_mul_pd(_mm_sub_pd(lat_1, lat_2), half);
+        const __m128d abs_half_dlon =
+            _mm_andnot_pd(sign_mask, _mm_mul_pd(_mm_sub_pd(lon_1, lon_2), half));
+        const __m128d half_dlon = _mm_min_pd(abs_half_dlon, _mm_sub_pd(pi, abs_half_dlon));
+
+        const __m128d sin_dlat = sine(half_dlat);
+        const __m128d sin_dlon = sine(half_dlon);
+        const __m128d aharv = _mm_add_pd(
+            _mm_mul_pd(sin_dlat, sin_dlat),
+            _mm_mul_pd(_mm_mul_pd(cosine(lat_1), cosine(lat_2)), _mm_mul_pd(sin_dlon, sin_dlon)));
+
+        // 2 * atan2(sqrt(a), sqrt(1 - a)) equals 2 * asin(sqrt(a)), which has a fast converging
+        // series for the short distances that are the common case
+        const __m128d root = _mm_sqrt_pd(aharv);
+        if (_mm_movemask_pd(_mm_cmplt_pd(root, series_limit)) == 3)
+        {
+            _mm_storeu_pd(distances + index, _mm_mul_pd(arcsine(root), twice_earth_radius));
+            continue;
+        }
+
+        double values[2];
+        _mm_storeu_pd(values, aharv);
+        for (const auto lane : {0, 1})
+        {
+            const double value = std::min(1., values[lane]);
+            const double charv = 2. * std::atan2(std::sqrt(value), std::sqrt(1.0 - value));
+            distances[index + lane] = detail::EARTH_RADIUS * charv;
+        }
+    }
+#endif
+    for (; index < number_of_pairs; ++index)
+    {
+        distances[index] = haversineDistance(first_coordinates[index], second_coordinates[index]);
+    }
+}
+
+void greatCircleDistances(const Coordinate *first_coordinates,
+                          const Coordinate *second_coordinates,
+                          const std::size_t number_of_pairs,
+                          double *distances)
+{
+    std::size_t index = 0;
+#if defined(__SSE2__)
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d earth_radius = _mm_set1_pd(detail::EARTH_RADIUS);
+    for (; index + 2 <= number_of_pairs; index += 2)
+    {
+        const auto &first_0 = first_coordinates[index];
+        const auto &first_1 = first_coordinates[index + 1];
+        const auto &second_0 = second_coordinates[index];
+        const auto &second_1 = second_coordinates[index + 1];
+
+        const __m128d lat_1 = toRadians(first_0.lat, first_1.lat);
+        const __m128d lat_2 = toRadians(second_0.lat, second_1.lat);
+        const __m128d lon_1 = toRadians(first_0.lon, first_1.lon);
+        const __m128d lon_2 = toRadians(second_0.lon, second_1.lon);
+
+        const __m128d x_value = _mm_mul_pd(_mm_sub_pd(lon_2, lon_1),
+                                           cosine(_mm_mul_pd(_mm_add_pd(lat_1, lat_2), half)));
+        const __m128d y_value = _mm_sub_pd(lat_2, lat_1);
+        const __m128d distance = _mm_mul_pd(
+            _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x_value, x_value), _mm_mul_pd(y_value, y_value))),
+            earth_radius);
+        _mm_storeu_pd(distances + index, distance);
+    }
+#endif
+    for (; index < number_of_pairs; ++index)
+    {
+        distances[index] =
+            greatCircleDistance(first_coordinates[index], second_coordinates[index]);
+    }
+}
+
+void perpendicularDistances(const Coordinate *segment_sources,
+                            const Coordinate *segment_targets,
+                            const std::size_t number_of_segments,
+                            const Coordinate query_location,
+                            double *distances,
+                            Coordinate *nearest_locations,
+                            double *ratios)
+{
+    BOOST_ASSERT(query_location.IsValid());
+
+    // the query location is projected only once for all segments
+    const auto projected_query_location = web_mercator::fromWGS84(query_location);
+    std::vector<FloatCoordinate> projected_sources(number_of_segments);
+    std::vector<FloatCoordinate> projected_targets(number_of_segments);
+    web_mercator::fromWGS84(segment_sources, number_of_segments, projected_sources.data());
+    web_mercator::fromWGS84(segment_targets, number_of_segments, projected_targets.data());
+    for (std::size_t index = 0; index < number_of_segments; ++index)
+    {
+        FloatCoordinate projected_nearest;
+        std::tie(ratios[index], projected_nearest) = projectPointOnSegment(
+            projected_sources[index], projected_targets[index], projected_query_location);
+        nearest_locations[index] = web_mercator::toWGS84(projected_nearest);
+    }
+
+    // greatCircleDistances expects two arrays, the query location is passed through a
+    // small buffer instead of materializing N copies at once
+    const constexpr std::size_t BUFFER_SIZE = 32;
+    Coordinate query_locations[BUFFER_SIZE];
+    std::fill(query_locations, query_locations + BUFFER_SIZE, query_location);
+    for (std::size_t index = 0; index < number_of_segments; index += BUFFER_SIZE)
+    {
+        greatCircleDistances(query_locations,
+                             nearest_locations + index,
+                             std::min(BUFFER_SIZE, number_of_segments - index),
+                             distances + index);
+    }
+}
+
 Coordinate centroid(const Coordinate lhs, const Coordinate rhs)
 {
     Coordinate centroid;
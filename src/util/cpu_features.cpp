@@ -0,0 +1,90 @@
+#include "util/cpu_features.hpp"
+#include "util/simple_logger.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+
+const constexpr InstructionSet ALL_INSTRUCTION_SETS[] = {
+    InstructionSet::Scalar, InstructionSet::SSE42, InstructionSet::AVX2, InstructionSet::AVX512};
+
+InstructionSet detectInstructionSet()
+{
+    InstructionSet detected = InstructionSet::Scalar;
+#if defined(__x86_64__) && defined(__GNUC__)
+    // also checks that the operating system saves the wide registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        detected = InstructionSet::SSE42;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        detected = InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        detected = InstructionSet::AVX512;
+    }
+#endif
+
+    const char *requested = std::getenv("OSRM_INSTRUCTION_SET");
+    if (requested == nullptr)
+    {
+        return detected;
+    }
+    for (const auto instruction_set : ALL_INSTRUCTION_SETS)
+    {
+        if (toString(instruction_set) == requested)
+        {
+            return std::min(instruction_set, detected);
+        }
+    }
+    SimpleLogger().Write(logWARNING) << "Ignoring unknown OSRM_INSTRUCTION_SET " << requested;
+    return detected;
+}
+}
+
+InstructionSet getInstructionSet()
+{
+    static const InstructionSet instruction_set = detectInstructionSet();
+    return instruction_set;
+}
+
+std::vector<InstructionSet> getSupportedInstructionSets()
+{
+    std::vector<InstructionSet> instruction_sets;
+    for (const auto instruction_set : ALL_INSTRUCTION_SETS)
+    {
+        if (instruction_set <= getInstructionSet())
+        {
+            instruction_sets.push_back(instruction_set);
+        }
+    }
+    return instruction_sets;
+}
+
+std::string toString(const InstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+    case InstructionSet::SSE42:
+        return "sse4.2";
+    case InstructionSet::AVX2:
+        return "avx2";
+    case InstructionSet::AVX512:
+        return "avx512";
+    case InstructionSet::Scalar:
+    default:
+        return "scalar";
+    }
+}
+}
+}
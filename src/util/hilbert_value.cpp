@@ -1,5 +1,9 @@
 #include "util/hilbert_value.hpp"
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 namespace osrm
 {
 namespace util
@@ -8,64 +12,55 @@ namespace util
 namespace
 {
 
+// Interleaves the bits of both values, the longitude bits end up at the even positions
 std::uint64_t bitInterleaving(const std::uint32_t longitude, const std::uint32_t latitude)
 {
-    std::uint64_t result = 0;
-    for (std::int8_t index = 31; index >= 0; --index)
-    {
-        result |= (latitude >> index) & 1;
-        result <<= 1;
-        result |= (longitude >> index) & 1;
-        if (0 != index)
-        {
-            result <<= 1;
-        }
-    }
-    return result;
+#if defined(__BMI2__)
+    return _pdep_u64(longitude, 0x5555555555555555ULL) |
+           _pdep_u64(latitude, 0xAAAAAAAAAAAAAAAAULL);
+#else
+    // spreads the 32 bits of value to the even bits of the result
+    const auto spread = [](const std::uint64_t value) {
+        std::uint64_t result = value;
+        result = (result | (result << 16)) & 0x0000FFFF0000FFFFULL;
+        result = (result | (result << 8)) & 0x00FF00FF00FF00FFULL;
+        result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        result = (result | (result << 2)) & 0x3333333333333333ULL;
+        result = (result | (result << 1)) & 0x5555555555555555ULL;
+        return result;
+    };
+    return spread(longitude) | (spread(latitude) << 1);
+#endif
 }
 
+// The conditional inversions and exchanges are computed with masks, their outcome depends on
+// the coordinate bits and would be mispredicted half of the time as branches
 void transposeCoordinate(std::uint32_t *x)
 {
-    std::uint32_t M = 1u << (32 - 1), P, Q, t;
-    int i;
+    const std::uint32_t M = 1u << (32 - 1);
     // Inverse undo
-    for (Q = M; Q > 1; Q >>= 1)
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
     {
-        P = Q - 1;
-        for (i = 0; i < 2; ++i)
+        const std::uint32_t P = Q - 1;
+        for (int i = 0; i < 2; ++i)
         {
-
-            const bool condition = (x[i] & Q);
-            if (condition)
-            {
-                x[0] ^= P; // invert
-            }
-            else
-            {
-                t = (x[0] ^ x[i]) & P;
-                x[0] ^= t;
-                x[i] ^= t;
-            }
-        } // exchange
+            // all bits set if bit Q of x[i] is set
+            const std::uint32_t is_set = 0u - static_cast<std::uint32_t>((x[i] & Q) != 0);
+            // invert if set, exchange otherwise
+            const std::uint32_t t = (x[0] ^ x[i]) & P & ~is_set;
+            x[0] ^= (P & is_set) ^ t;
+            x[i] ^= t;
+        }
     }
     // Gray encode
-    for (i = 1; i < 2; ++i)
-    {
-        x[i] ^= x[i - 1];
-    }
-    t = 0;
-    for (Q = M; Q > 1; Q >>= 1)
-    {
-        const bool condition = (x[2 - 1] & Q);
-        if (condition)
-        {
-            t ^= Q - 1;
-        }
-    } // check if this for loop is wrong
-    for (i = 0; i < 2; ++i)
+    x[1] ^= x[0];
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
     {
-        x[i] ^= t;
+        t ^= (Q - 1) & (0u - static_cast<std::uint32_t>((x[1] & Q) != 0));
     }
+    x[0] ^= t;
+    x[1] ^= t;
 }
 } // anonymous ns
 
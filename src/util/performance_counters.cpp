@@ -0,0 +1,154 @@
+#include "util/performance_counters.hpp"
+
+#if defined(ENABLE_PERF_COUNTERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <sstream>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+const constexpr char *EVENT_NAMES[NUMBER_OF_PERFORMANCE_EVENTS] = {
+    "cycles", "instructions", "L1d misses", "cache misses", "branch misses"};
+}
+
+std::string PerformanceCounterValues::ToString(const double divisor) const
+{
+    std::ostringstream out;
+    for (std::size_t event = 0; event < NUMBER_OF_PERFORMANCE_EVENTS; ++event)
+    {
+        out << (event > 0 ? ", " : "") << EVENT_NAMES[event] << " ";
+        if (available[event])
+        {
+            out << values[event] / divisor;
+        }
+        else
+        {
+            out << "n/a";
+        }
+    }
+    return out.str();
+}
+
+#if defined(ENABLE_PERF_COUNTERS) && defined(__linux__)
+
+namespace
+{
+struct EventConfig
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventConfig EVENT_CONFIGS[NUMBER_OF_PERFORMANCE_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+}
+
+// All events that can be opened form one group, so they are scheduled together and are read
+// with a single system call
+PerformanceCounters::PerformanceCounters()
+{
+    fds.fill(-1);
+    for (std::size_t event = 0; event < NUMBER_OF_PERFORMANCE_EVENTS; ++event)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = EVENT_CONFIGS[event].type;
+        attributes.config = EVENT_CONFIGS[event].config;
+        attributes.disabled = group_fd < 0 ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+        fds[event] = syscall(__NR_perf_event_open, &attributes, 0, -1, group_fd, 0);
+        if (group_fd < 0)
+        {
+            group_fd = fds[event];
+        }
+    }
+
+    if (group_fd >= 0)
+    {
+        ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+    for (const auto fd : fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+}
+
+PerformanceCounterValues PerformanceCounters::Read() const
+{
+    PerformanceCounterValues result;
+    if (group_fd < 0)
+    {
+        return result;
+    }
+
+    // number of events followed by their values in the order they joined the group
+    std::uint64_t buffer[1 + NUMBER_OF_PERFORMANCE_EVENTS];
+    const auto bytes = read(group_fd, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(sizeof(std::uint64_t)))
+    {
+        return result;
+    }
+
+    std::size_t position = 1;
+    for (std::size_t event = 0; event < NUMBER_OF_PERFORMANCE_EVENTS; ++event)
+    {
+        if (fds[event] >= 0 && position <= buffer[0])
+        {
+            result.values[event] = buffer[position++];
+            result.available[event] = true;
+        }
+    }
+    return result;
+}
+
+#else
+
+PerformanceCounters::PerformanceCounters() { fds.fill(-1); }
+
+PerformanceCounters::~PerformanceCounters() {}
+
+PerformanceCounterValues PerformanceCounters::Read() const { return PerformanceCounterValues(); }
+
+#endif
+
+void PerformanceCounters::Start() { start_values = Read(); }
+
+PerformanceCounterValues PerformanceCounters::Stop()
+{
+    auto result = Read();
+    for (std::size_t event = 0; event < NUMBER_OF_PERFORMANCE_EVENTS; ++event)
+    {
+        result.values[event] -= start_values.values[event];
+    }
+    totals += result;
+    return result;
+}
+}
+}
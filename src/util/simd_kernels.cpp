@@ -0,0 +1,538 @@
+#include "util/simd_kernels.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+// The variants are compiled with function level target attributes, so the rest of the binary
+// keeps running on CPUs without the instruction sets
+#if defined(__x86_64__) && defined(__GNUC__)
+#define OSRM_SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace simd
+{
+
+namespace
+{
+
+inline void updateMinimum(EdgeWeight &best, const EdgeWeight lhs, const EdgeWeight rhs)
+{
+    // weights are non-negative, the sum can not underflow
+    const std::int64_t sum = static_cast<std::int64_t>(lhs) + rhs;
+    if (sum < best)
+    {
+        best = static_cast<EdgeWeight>(sum);
+    }
+}
+
+inline std::uint64_t squaredDistanceToRectangle(const std::int32_t min_lon,
+                                                const std::int32_t max_lon,
+                                                const std::int32_t min_lat,
+                                                const std::int32_t max_lat,
+                                                const std::int32_t lon,
+                                                const std::int32_t lat)
+{
+    const std::uint64_t dx = std::max(std::max(min_lon - lon, lon - max_lon), 0);
+    const std::uint64_t dy = std::max(std::max(min_lat - lat, lat - max_lat), 0);
+    return dx * dx + dy * dy;
+}
+
+void squaredDistancesToRectanglesScalar(const std::int32_t *min_lons,
+                                        const std::int32_t *max_lons,
+                                        const std::int32_t *min_lats,
+                                        const std::int32_t *max_lats,
+                                        const std::size_t number_of_rectangles,
+                                        const std::int32_t lon,
+                                        const std::int32_t lat,
+                                        std::uint64_t *distances)
+{
+    for (std::size_t index = 0; index < number_of_rectangles; ++index)
+    {
+        distances[index] = squaredDistanceToRectangle(
+            min_lons[index], max_lons[index], min_lats[index], max_lats[index], lon, lat);
+    }
+}
+
+// Linear merge of the labels starting at forward_index and backward_index
+EdgeWeight mergeHubLabels(const NodeID *forward_hubs,
+                          const EdgeWeight *forward_weights,
+                          const std::size_t forward_size,
+                          const NodeID *backward_hubs,
+                          const EdgeWeight *backward_weights,
+                          const std::size_t backward_size,
+                          std::size_t forward_index,
+                          std::size_t backward_index,
+                          EdgeWeight best)
+{
+    while (forward_index < forward_size && backward_index < backward_size)
+    {
+        if (forward_hubs[forward_index] < backward_hubs[backward_index])
+        {
+            ++forward_index;
+        }
+        else if (backward_hubs[backward_index] < forward_hubs[forward_index])
+        {
+            ++backward_index;
+        }
+        else
+        {
+            updateMinimum(best, forward_weights[forward_index], backward_weights[backward_index]);
+            ++forward_index;
+            ++backward_index;
+        }
+    }
+    return best;
+}
+
+// Checks all pairs of a block with at least one matching hub
+inline void updateMinimumOfBlock(const NodeID *forward_hubs,
+                                 const EdgeWeight *forward_weights,
+                                 const NodeID *backward_hubs,
+                                 const EdgeWeight *backward_weights,
+                                 const std::size_t block_size,
+                                 EdgeWeight &best)
+{
+    for (std::size_t k = 0; k < block_size; ++k)
+    {
+        for (std::size_t l = 0; l < block_size; ++l)
+        {
+            if (forward_hubs[k] == backward_hubs[l])
+            {
+                updateMinimum(best, forward_weights[k], backward_weights[l]);
+            }
+        }
+    }
+}
+
+EdgeWeight intersectHubLabelsScalar(const NodeID *forward_hubs,
+                                    const EdgeWeight *forward_weights,
+                                    const std::size_t forward_size,
+                                    const NodeID *backward_hubs,
+                                    const EdgeWeight *backward_weights,
+                                    const std::size_t backward_size)
+{
+    return mergeHubLabels(forward_hubs,
+                          forward_weights,
+                          forward_size,
+                          backward_hubs,
+                          backward_weights,
+                          backward_size,
+                          0,
+                          0,
+                          INVALID_EDGE_WEIGHT);
+}
+
+bool relaxBucketScalar(const std::int32_t *entries,
+                       const std::size_t number_of_entries,
+                       const EdgeWeight weight,
+                       EdgeWeight *row)
+{
+    bool has_negative_sums = false;
+    for (std::size_t index = 0; index < number_of_entries; ++index)
+    {
+        const EdgeWeight sum = weight + entries[2 * index + 1];
+        if (sum < 0)
+        {
+            has_negative_sums = true;
+            continue;
+        }
+        auto &current = row[entries[2 * index]];
+        current = std::min(current, sum);
+    }
+    return has_negative_sums;
+}
+
+#if defined(OSRM_SIMD_KERNELS_X86)
+
+// The distance kernels compute the per axis distances in 32 bit lanes and widen them to 64 bit
+// lanes for the squares. The per axis distances are non-negative, so they are zero extended.
+
+__attribute__((target("sse4.2"))) void
+squaredDistancesToRectanglesSSE42(const std::int32_t *min_lons,
+                                  const std::int32_t *max_lons,
+                                  const std::int32_t *min_lats,
+                                  const std::int32_t *max_lats,
+                                  const std::size_t number_of_rectangles,
+                                  const std::int32_t lon,
+                                  const std::int32_t lat,
+                                  std::uint64_t *distances)
+{
+    const __m128i lons = _mm_set1_epi32(lon);
+    const __m128i lats = _mm_set1_epi32(lat);
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t index = 0;
+    for (; index + 4 <= number_of_rectangles; index += 4)
+    {
+        const __m128i min_lon =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(min_lons + index));
+        const __m128i max_lon =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(max_lons + index));
+        const __m128i min_lat =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(min_lats + index));
+        const __m128i max_lat =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(max_lats + index));
+        const __m128i dx = _mm_max_epi32(
+            _mm_max_epi32(_mm_sub_epi32(min_lon, lons), _mm_sub_epi32(lons, max_lon)), zero);
+        const __m128i dy = _mm_max_epi32(
+            _mm_max_epi32(_mm_sub_epi32(min_lat, lats), _mm_sub_epi32(lats, max_lat)), zero);
+
+        const __m128i dx_low = _mm_cvtepu32_epi64(dx);
+        const __m128i dy_low = _mm_cvtepu32_epi64(dy);
+        const __m128i dx_high = _mm_cvtepu32_epi64(_mm_srli_si128(dx, 8));
+        const __m128i dy_high = _mm_cvtepu32_epi64(_mm_srli_si128(dy, 8));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(distances + index),
+            _mm_add_epi64(_mm_mul_epu32(dx_low, dx_low), _mm_mul_epu32(dy_low, dy_low)));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(distances + index + 2),
+            _mm_add_epi64(_mm_mul_epu32(dx_high, dx_high), _mm_mul_epu32(dy_high, dy_high)));
+    }
+    squaredDistancesToRectanglesScalar(min_lons + index,
+                                       max_lons + index,
+                                       min_lats + index,
+                                       max_lats + index,
+                                       number_of_rectangles - index,
+                                       lon,
+                                       lat,
+                                       distances + index);
+}
+
+__attribute__((target("avx2"))) void
+squaredDistancesToRectanglesAVX2(const std::int32_t *min_lons,
+                                 const std::int32_t *max_lons,
+                                 const std::int32_t *min_lats,
+                                 const std::int32_t *max_lats,
+                                 const std::size_t number_of_rectangles,
+                                 const std::int32_t lon,
+                                 const std::int32_t lat,
+                                 std::uint64_t *distances)
+{
+    const __m256i lons = _mm256_set1_epi32(lon);
+    const __m256i lats = _mm256_set1_epi32(lat);
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t index = 0;
+    for (; index + 8 <= number_of_rectangles; index += 8)
+    {
+        const __m256i min_lon =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(min_lons + index));
+        const __m256i max_lon =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_lons + index));
+        const __m256i min_lat =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(min_lats + index));
+        const __m256i max_lat =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_lats + index));
+        const __m256i dx = _mm256_max_epi32(
+            _mm256_max_epi32(_mm256_sub_epi32(min_lon, lons), _mm256_sub_epi32(lons, max_lon)),
+            zero);
+        const __m256i dy = _mm256_max_epi32(
+            _mm256_max_epi32(_mm256_sub_epi32(min_lat, lats), _mm256_sub_epi32(lats, max_lat)),
+            zero);
+
+        const __m256i dx_low = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(dx));
+        const __m256i dy_low = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(dy));
+        const __m256i dx_high = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(dx, 1));
+        const __m256i dy_high = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(dy, 1));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(distances + index),
+            _mm256_add_epi64(_mm256_mul_epu32(dx_low, dx_low), _mm256_mul_epu32(dy_low, dy_low)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(distances + index + 4),
+                            _mm256_add_epi64(_mm256_mul_epu32(dx_high, dx_high),
+                                             _mm256_mul_epu32(dy_high, dy_high)));
+    }
+    squaredDistancesToRectanglesScalar(min_lons + index,
+                                       max_lons + index,
+                                       min_lats + index,
+                                       max_lats + index,
+                                       number_of_rectangles - index,
+                                       lon,
+                                       lat,
+                                       distances + index);
+}
+
+// GCC 12 warns about the intentionally undefined pass-through operand of _mm512_max_epi32
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) void
+squaredDistancesToRectanglesAVX512(const std::int32_t *min_lons,
+                                   const std::int32_t *max_lons,
+                                   const std::int32_t *min_lats,
+                                   const std::int32_t *max_lats,
+                                   const std::size_t number_of_rectangles,
+                                   const std::int32_t lon,
+                                   const std::int32_t lat,
+                                   std::uint64_t *distances)
+{
+    const __m512i lons = _mm512_set1_epi32(lon);
+    const __m512i lats = _mm512_set1_epi32(lat);
+    const __m512i zero = _mm512_setzero_si512();
+    std::size_t index = 0;
+    for (; index + 16 <= number_of_rectangles; index += 16)
+    {
+        const __m512i min_lon = _mm512_loadu_si512(min_lons + index);
+        const __m512i max_lon = _mm512_loadu_si512(max_lons + index);
+        const __m512i min_lat = _mm512_loadu_si512(min_lats + index);
+        const __m512i max_lat = _mm512_loadu_si512(max_lats + index);
+        const __m512i dx = _mm512_max_epi32(
+            _mm512_max_epi32(_mm512_sub_epi32(min_lon, lons), _mm512_sub_epi32(lons, max_lon)),
+            zero);
+        const __m512i dy = _mm512_max_epi32(
+            _mm512_max_epi32(_mm512_sub_epi32(min_lat, lats), _mm512_sub_epi32(lats, max_lat)),
+            zero);
+
+        const __m512i dx_low = _mm512_cvtepu32_epi64(_mm512_castsi512_si256(dx));
+        const __m512i dy_low = _mm512_cvtepu32_epi64(_mm512_castsi512_si256(dy));
+        const __m512i dx_high = _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(dx, 1));
+        const __m512i dy_high = _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(dy, 1));
+        _mm512_storeu_si512(
+            distances + index,
+            _mm512_add_epi64(_mm512_mul_epu32(dx_low, dx_low), _mm512_mul_epu32(dy_low, dy_low)));
+        _mm512_storeu_si512(distances + index + 8,
+                            _mm512_add_epi64(_mm512_mul_epu32(dx_high, dx_high),
+                                             _mm512_mul_epu32(dy_high, dy_high)));
+    }
+    squaredDistancesToRectanglesAVX2(min_lons + index,
+                                     max_lons + index,
+                                     min_lats + index,
+                                     max_lats + index,
+                                     number_of_rectangles - index,
+                                     lon,
+                                     lat,
+                                     distances + index);
+}
+#pragma GCC diagnostic pop
+
+// The intersection kernels compare blocks of hubs against all rotations of each other. Road
+// network labels are sparse relative to each other, so most blocks contain no match and are
+// skipped with a handful of instructions. The block with the smaller last hub is done, all its
+// hubs are smaller than the ones following in the other label.
+
+__attribute__((target("sse4.2"))) EdgeWeight
+intersectHubLabelsSSE42(const NodeID *forward_hubs,
+                        const EdgeWeight *forward_weights,
+                        const std::size_t forward_size,
+                        const NodeID *backward_hubs,
+                        const EdgeWeight *backward_weights,
+                        const std::size_t backward_size)
+{
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    std::size_t i = 0, j = 0;
+    while (i + 4 <= forward_size && j + 4 <= backward_size)
+    {
+        const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(forward_hubs + i));
+        const __m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(backward_hubs + j));
+        const __m128i rotated_1 = _mm_shuffle_epi32(rhs, _MM_SHUFFLE(0, 3, 2, 1));
+        const __m128i rotated_2 = _mm_shuffle_epi32(rhs, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m128i rotated_3 = _mm_shuffle_epi32(rhs, _MM_SHUFFLE(2, 1, 0, 3));
+        const __m128i matches =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(lhs, rhs), _mm_cmpeq_epi32(lhs, rotated_1)),
+                         _mm_or_si128(_mm_cmpeq_epi32(lhs, rotated_2),
+                                      _mm_cmpeq_epi32(lhs, rotated_3)));
+
+        if (!_mm_testz_si128(matches, matches))
+        {
+            updateMinimumOfBlock(forward_hubs + i,
+                                 forward_weights + i,
+                                 backward_hubs + j,
+                                 backward_weights + j,
+                                 4,
+                                 best);
+        }
+
+        const NodeID last_forward = forward_hubs[i + 3];
+        const NodeID last_backward = backward_hubs[j + 3];
+        i += (last_forward <= last_backward) ? 4 : 0;
+        j += (last_backward <= last_forward) ? 4 : 0;
+    }
+    return mergeHubLabels(forward_hubs,
+                          forward_weights,
+                          forward_size,
+                          backward_hubs,
+                          backward_weights,
+                          backward_size,
+                          i,
+                          j,
+                          best);
+}
+
+__attribute__((target("avx2"))) EdgeWeight
+intersectHubLabelsAVX2(const NodeID *forward_hubs,
+                       const EdgeWeight *forward_weights,
+                       const std::size_t forward_size,
+                       const NodeID *backward_hubs,
+                       const EdgeWeight *backward_weights,
+                       const std::size_t backward_size)
+{
+    const __m256i rotate_1 = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    std::size_t i = 0, j = 0;
+    while (i + 8 <= forward_size && j + 8 <= backward_size)
+    {
+        const __m256i lhs =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(forward_hubs + i));
+        __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(backward_hubs + j));
+        __m256i matches = _mm256_cmpeq_epi32(lhs, rhs);
+        for (int rotation = 1; rotation < 8; ++rotation)
+        {
+            rhs = _mm256_permutevar8x32_epi32(rhs, rotate_1);
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(lhs, rhs));
+        }
+
+        if (!_mm256_testz_si256(matches, matches))
+        {
+            updateMinimumOfBlock(forward_hubs + i,
+                                 forward_weights + i,
+                                 backward_hubs + j,
+                                 backward_weights + j,
+                                 8,
+                                 best);
+        }
+
+        const NodeID last_forward = forward_hubs[i + 7];
+        const NodeID last_backward = backward_hubs[j + 7];
+        i += (last_forward <= last_backward) ? 8 : 0;
+        j += (last_backward <= last_forward) ? 8 : 0;
+    }
+    return mergeHubLabels(forward_hubs,
+                          forward_weights,
+                          forward_size,
+                          backward_hubs,
+                          backward_weights,
+                          backward_size,
+                          i,
+                          j,
+                          best);
+}
+
+// The bucket kernels gather the current entries of the row. Most of them are already smaller
+// than the new sums once the first searches of a block are done, so the few improved lanes are
+// written one by one without AVX-512 scatters.
+
+__attribute__((target("avx2"))) bool relaxBucketAVX2(const std::int32_t *entries,
+                                                     const std::size_t number_of_entries,
+                                                     const EdgeWeight weight,
+                                                     EdgeWeight *row)
+{
+    // moves the columns of four pairs into the low half and their weights into the high half
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i weights = _mm256_set1_epi32(weight);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i negative = zero;
+    std::size_t index = 0;
+    for (; index + 8 <= number_of_entries; index += 8)
+    {
+        const __m256i first = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(entries + 2 * index)),
+            deinterleave);
+        const __m256i second = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(entries + 2 * index + 8)),
+            deinterleave);
+        const __m256i columns = _mm256_permute2x128_si256(first, second, 0x20);
+        const __m256i sums =
+            _mm256_add_epi32(_mm256_permute2x128_si256(first, second, 0x31), weights);
+        const __m256i is_negative = _mm256_cmpgt_epi32(zero, sums);
+        negative = _mm256_or_si256(negative, is_negative);
+
+        const __m256i current = _mm256_i32gather_epi32(row, columns, 4);
+        const __m256i is_better =
+            _mm256_andnot_si256(is_negative, _mm256_cmpgt_epi32(current, sums));
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(is_better));
+        if (mask != 0)
+        {
+            alignas(32) std::int32_t lane_columns[8];
+            alignas(32) EdgeWeight lane_sums[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lane_columns), columns);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lane_sums), sums);
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const auto lane = __builtin_ctz(mask);
+                row[lane_columns[lane]] = lane_sums[lane];
+            }
+        }
+    }
+    const bool has_negative_sums =
+        relaxBucketScalar(entries + 2 * index, number_of_entries - index, weight, row);
+    return has_negative_sums || !_mm256_testz_si256(negative, negative);
+}
+
+// The columns of a bucket are distinct, the scatter never writes a column twice. GCC 12 warns
+// about the intentionally undefined pass-through operand of _mm512_i32gather_epi32.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) bool relaxBucketAVX512(const std::int32_t *entries,
+                                                         const std::size_t number_of_entries,
+                                                         const EdgeWeight weight,
+                                                         EdgeWeight *row)
+{
+    const __m512i column_lanes =
+        _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i weight_lanes =
+        _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    const __m512i weights = _mm512_set1_epi32(weight);
+    const __m512i zero = _mm512_setzero_si512();
+    __mmask16 negative = 0;
+    std::size_t index = 0;
+    for (; index + 16 <= number_of_entries; index += 16)
+    {
+        const __m512i first = _mm512_loadu_si512(entries + 2 * index);
+        const __m512i second = _mm512_loadu_si512(entries + 2 * index + 16);
+        const __m512i columns = _mm512_permutex2var_epi32(first, column_lanes, second);
+        const __m512i sums =
+            _mm512_add_epi32(_mm512_permutex2var_epi32(first, weight_lanes, second), weights);
+        const __mmask16 is_negative = _mm512_cmplt_epi32_mask(sums, zero);
+        negative |= is_negative;
+
+        const __m512i current = _mm512_i32gather_epi32(columns, row, 4);
+        const __mmask16 is_better = _mm512_mask_cmplt_epi32_mask(
+            static_cast<__mmask16>(~is_negative), sums, current);
+        _mm512_mask_i32scatter_epi32(row, is_better, columns, sums, 4);
+    }
+    const bool has_negative_sums =
+        relaxBucketAVX2(entries + 2 * index, number_of_entries - index, weight, row);
+    return has_negative_sums || negative != 0;
+}
+#pragma GCC diagnostic pop
+
+#endif
+}
+
+const Kernels &getKernels(const InstructionSet instruction_set)
+{
+    static const Kernels scalar_kernels{
+        squaredDistancesToRectanglesScalar, intersectHubLabelsScalar, relaxBucketScalar};
+#if defined(OSRM_SIMD_KERNELS_X86)
+    // without gathers the row is read lane by lane, which is no faster than the scalar loop
+    static const Kernels sse42_kernels{
+        squaredDistancesToRectanglesSSE42, intersectHubLabelsSSE42, relaxBucketScalar};
+    static const Kernels avx2_kernels{
+        squaredDistancesToRectanglesAVX2, intersectHubLabelsAVX2, relaxBucketAVX2};
+    // 16 hub blocks take 15 rotations, more than they save over the 8 hub blocks
+    static const Kernels avx512_kernels{
+        squaredDistancesToRectanglesAVX512, intersectHubLabelsAVX2, relaxBucketAVX512};
+
+    switch (instruction_set)
+    {
+    case InstructionSet::SSE42:
+        return sse42_kernels;
+    case InstructionSet::AVX2:
+        return avx2_kernels;
+    case InstructionSet::AVX512:
+        return avx512_kernels;
+    case InstructionSet::Scalar:
+    default:
+        return scalar_kernels;
+    }
+#else
+    BOOST_ASSERT(instruction_set == InstructionSet::Scalar);
+    (void)instruction_set;
+    return scalar_kernels;
+#endif
+}
+}
+}
+}
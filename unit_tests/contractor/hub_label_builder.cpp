@@ -0,0 +1,160 @@
+#include "contractor/graph_contractor.hpp"
+#include "contractor/hub_label_builder.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/hub_labels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hub_label_builder_test)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+
+struct InputEdge
+{
+    NodeID source;
+    NodeID target;
+    EdgeWeight weight;
+    bool forward;
+    bool backward;
+};
+
+// A grid with one-way and two-way streets of random weight plus a few long random edges
+std::vector<InputEdge> makeGraph(const unsigned grid_size, std::mt19937 &generator)
+{
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 100);
+    std::uniform_int_distribution<int> direction_distribution(0, 2);
+    std::uniform_int_distribution<NodeID> node_distribution(0, grid_size * grid_size - 1);
+
+    std::vector<InputEdge> edges;
+    const auto add_edge = [&](const NodeID source, const NodeID target) {
+        const auto direction = direction_distribution(generator);
+        edges.push_back(InputEdge{
+            source, target, weight_distribution(generator), direction != 1, direction != 2});
+    };
+
+    for (unsigned row = 0; row < grid_size; ++row)
+    {
+        for (unsigned column = 0; column < grid_size; ++column)
+        {
+            const NodeID node = row * grid_size + column;
+            if (column + 1 < grid_size)
+                add_edge(node, node + 1);
+            if (row + 1 < grid_size)
+                add_edge(node, node + grid_size);
+        }
+    }
+    for (unsigned i = 0; i < grid_size; ++i)
+    {
+        add_edge(node_distribution(generator), node_distribution(generator));
+    }
+    return edges;
+}
+
+std::vector<EdgeWeight>
+dijkstra(const unsigned number_of_nodes, const std::vector<InputEdge> &edges, const NodeID source)
+{
+    std::vector<std::vector<std::pair<NodeID, EdgeWeight>>> adjacency(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (edge.forward)
+            adjacency[edge.source].emplace_back(edge.target, edge.weight);
+        if (edge.backward)
+            adjacency[edge.target].emplace_back(edge.source, edge.weight);
+    }
+
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<EdgeWeight> weights(number_of_nodes, INVALID_EDGE_WEIGHT);
+    weights[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto entry = queue.top();
+        queue.pop();
+        if (entry.first > weights[entry.second])
+            continue;
+        for (const auto &neighbour : adjacency[entry.second])
+        {
+            const auto weight = entry.first + neighbour.second;
+            if (weight < weights[neighbour.first])
+            {
+                weights[neighbour.first] = weight;
+                queue.emplace(weight, neighbour.first);
+            }
+        }
+    }
+    return weights;
+}
+
+util::HubLabel makeView(const HubLabelBuilder::Label &label)
+{
+    return util::HubLabel{label.hubs.data(), label.weights.data(), label.hubs.size()};
+}
+}
+
+// Contracts small random graphs and checks the label distance of every pair of nodes against a
+// plain Dijkstra on the uncontracted edges
+BOOST_AUTO_TEST_CASE(labels_match_dijkstra_on_contracted_graph)
+{
+    const unsigned grid_size = 6;
+    const unsigned number_of_nodes = grid_size * grid_size;
+
+    std::mt19937 generator(1337);
+    for (int round = 0; round < 10; ++round)
+    {
+        const auto input_edges = makeGraph(grid_size, generator);
+
+        util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edges;
+        for (NodeID id = 0; id < input_edges.size(); ++id)
+        {
+            const auto &edge = input_edges[id];
+            edge_based_edges.push_back(extractor::EdgeBasedEdge(
+                edge.source, edge.target, id, edge.weight, edge.forward, edge.backward));
+        }
+
+        GraphContractor graph_contractor(number_of_nodes,
+                                         edge_based_edges,
+                                         {},
+                                         std::vector<EdgeWeight>(number_of_nodes, 0));
+        graph_contractor.Run();
+        util::DeallocatingVector<QueryEdge> contracted_edges;
+        graph_contractor.GetEdges(contracted_edges);
+
+        std::vector<QueryEdge> query_edges(contracted_edges.begin(), contracted_edges.end());
+        std::sort(query_edges.begin(), query_edges.end());
+        const HubLabelBuilder::QueryGraph graph(number_of_nodes, query_edges);
+
+        std::vector<HubLabelBuilder::Label> forward_labels;
+        std::vector<HubLabelBuilder::Label> backward_labels;
+        HubLabelBuilder::BuildLabels(graph, forward_labels, backward_labels);
+        BOOST_REQUIRE_EQUAL(forward_labels.size(), number_of_nodes);
+        BOOST_REQUIRE_EQUAL(backward_labels.size(), number_of_nodes);
+
+        for (NodeID source = 0; source < number_of_nodes; ++source)
+        {
+            const auto expected = dijkstra(number_of_nodes, input_edges, source);
+            for (NodeID target = 0; target < number_of_nodes; ++target)
+            {
+                BOOST_CHECK_EQUAL(util::intersectHubLabels(makeView(forward_labels[source]),
+                                                           makeView(backward_labels[target])),
+                                  expected[target]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
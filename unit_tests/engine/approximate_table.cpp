@@ -0,0 +1,65 @@
+#include "engine/routing_algorithms/approximate_table.hpp"
+#include "engine/phantom_node.hpp"
+#include "util/cell_table.hpp"
+#include "util/coordinate.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(approximate_table)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// 5x1 grid of 1 degree cells starting at (0, 0). Cell 4 has a large radius, the representative
+// of cell 2 can not reach the one of cell 0.
+util::CellTable makeCellTable()
+{
+    const util::CellGrid grid{0, 0, static_cast<std::int32_t>(COORDINATE_PRECISION), 5, 1};
+    std::vector<std::uint32_t> cell_ids = {0, 1, 2, 3, 4};
+    std::vector<EdgeWeight> radiuses = {10, 10, 10, 10, 500};
+    std::vector<EdgeWeight> durations(radiuses.size() * radiuses.size(), 1000);
+    durations[2 * radiuses.size() + 0] = INVALID_EDGE_WEIGHT;
+    return util::CellTable{
+        grid, 0, std::move(cell_ids), std::move(radiuses), std::move(durations)};
+}
+
+PhantomNode makePhantom(const double lon)
+{
+    PhantomNode phantom;
+    phantom.location = util::Coordinate{util::FloatLongitude(lon), util::FloatLatitude(0.5)};
+    return phantom;
+}
+}
+
+BOOST_AUTO_TEST_CASE(approximates_only_within_the_relative_error)
+{
+    const auto cell_table = makeCellTable();
+    const std::vector<PhantomNode> phantoms = {
+        makePhantom(0.5), makePhantom(1.5), makePhantom(2.5), makePhantom(4.5)};
+
+    const auto result =
+        routing_algorithms::ApproximateTable{cell_table}(phantoms, {0, 2}, {0, 1, 2, 3});
+    BOOST_REQUIRE_EQUAL(result.durations.size(), 8);
+
+    // same and adjacent cells
+    BOOST_CHECK(result.needs_exact[0]);
+    BOOST_CHECK(result.needs_exact[1]);
+    // 20 s error on 1000 s
+    BOOST_CHECK(!result.needs_exact[2]);
+    BOOST_CHECK_EQUAL(result.durations[2], 1000);
+    BOOST_CHECK_EQUAL(result.errors[2], 20);
+    // 510 s error on 1000 s
+    BOOST_CHECK(result.needs_exact[3]);
+    BOOST_CHECK_EQUAL(result.durations[3], INVALID_EDGE_WEIGHT);
+    // no duration between the representatives
+    BOOST_CHECK(result.needs_exact[4]);
+    BOOST_CHECK_EQUAL(result.durations[4], INVALID_EDGE_WEIGHT);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
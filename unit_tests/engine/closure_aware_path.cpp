@@ -0,0 +1,182 @@
+#include "engine/routing_algorithms/closure_aware_path.hpp"
+#include "contractor/query_edge.hpp"
+#include "engine/incoming_edge_index.hpp"
+#include "engine/internal_route_result.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+#include "extractor/guidance/turn_instruction.hpp"
+#include "extractor/original_edge_data.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(closure_aware_path)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+
+const constexpr NodeID S = 0;
+const constexpr NodeID T = 1;
+const constexpr NodeID A = 2;
+const constexpr NodeID B = 3;
+// geometry of an original edge is the single node VIA_OFFSET + edge id
+const constexpr NodeID VIA_OFFSET = 100;
+
+// Hierarchy of s -1- a -1- t and s -w- b -w- t with a contracted first, then b. The shortcut
+// s -> t over a is a witness for the detour over b, so b has no shortcut and the detour is only
+// reachable through original edges that lead down from s and t.
+class TestFacade
+{
+  public:
+    using EdgeData = contractor::QueryEdge::EdgeData;
+    using Graph = util::StaticGraph<EdgeData>;
+
+    explicit TestFacade(const EdgeWeight detour_weight)
+        : graph(4,
+                std::vector<contractor::QueryEdge>{makeEdge(S, T, A, 2, true),
+                                                   makeEdge(A, S, 0, 1, false),
+                                                   makeEdge(A, T, 1, 1, false),
+                                                   makeEdge(B, S, 2, detour_weight, false),
+                                                   makeEdge(B, T, 3, detour_weight, false)})
+    {
+    }
+
+    unsigned GetNumberOfNodes() const { return graph.GetNumberOfNodes(); }
+    unsigned GetCheckSum() const { return 0; }
+    std::size_t GetCoreSize() const { return 0; }
+    bool IsCoreNode(const NodeID) const { return false; }
+    void PrefetchNode(const NodeID) const {}
+    void PrefetchAdjacentEdges(const NodeID) const {}
+
+    util::range<EdgeID> GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return graph.GetAdjacentEdgeRange(node);
+    }
+    NodeID GetTarget(const EdgeID edge) const { return graph.GetTarget(edge); }
+    const EdgeData &GetEdgeData(const EdgeID edge) const { return graph.GetEdgeData(edge); }
+
+    extractor::OriginalEdgeData GetOriginalEdgeData(const unsigned id) const
+    {
+        return extractor::OriginalEdgeData{VIA_OFFSET + id,
+                                           0,
+                                           extractor::guidance::TurnInstruction::NO_TURN(),
+                                           0,
+                                           TRAVEL_MODE_DRIVING};
+    }
+    void GetUncompressedGeometry(const EdgeID id, std::vector<NodeID> &result_nodes) const
+    {
+        result_nodes = {id};
+    }
+    void GetUncompressedWeights(const EdgeID /* id */, std::vector<EdgeWeight> &result) const
+    {
+        result = {0};
+    }
+
+  private:
+    static contractor::QueryEdge makeEdge(const NodeID source,
+                                          const NodeID target,
+                                          const NodeID id,
+                                          const EdgeWeight weight,
+                                          const bool shortcut)
+    {
+        contractor::QueryEdge::EdgeData data;
+        data.id = id;
+        data.shortcut = shortcut;
+        data.distance = weight;
+        data.forward = true;
+        data.backward = true;
+        return contractor::QueryEdge(source, target, data);
+    }
+
+    Graph graph;
+};
+
+PhantomNode makePhantom(const NodeID node)
+{
+    const util::Coordinate location{util::FloatLongitude{7.42}, util::FloatLatitude{43.73}};
+    return PhantomNode{SegmentID{node, true},
+                       SegmentID{SPECIAL_SEGMENTID, false},
+                       0,
+                       0,
+                       0,
+                       0,
+                       0,
+                       VIA_OFFSET + 10 + node,
+                       VIA_OFFSET + 10 + node,
+                       false,
+                       0,
+                       location,
+                       location,
+                       0,
+                       TRAVEL_MODE_DRIVING,
+                       TRAVEL_MODE_DRIVING};
+}
+
+InternalRouteResult route(const ClosedNodes &closed_nodes, const EdgeWeight detour_weight = 2)
+{
+    TestFacade facade(detour_weight);
+    const IncomingEdgeIndex incoming_edges(facade);
+    SearchEngineData heaps;
+    routing_algorithms::ClosureAwarePathRouting<TestFacade> routing(&facade, heaps);
+
+    InternalRouteResult result;
+    result.segment_end_coordinates = {PhantomNodes{makePhantom(S), makePhantom(T)}};
+    routing(result.segment_end_coordinates, closed_nodes, incoming_edges, result);
+    return result;
+}
+
+std::vector<NodeID> viaNodes(const InternalRouteResult &result)
+{
+    std::vector<NodeID> nodes;
+    for (const auto &path_data : result.unpacked_path_segments.front())
+    {
+        nodes.push_back(path_data.turn_via_node);
+    }
+    return nodes;
+}
+}
+
+BOOST_AUTO_TEST_CASE(uses_shortcut_without_closures)
+{
+    const auto result = route({});
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_CHECK_EQUAL(result.shortest_path_length, 2);
+    const std::vector<NodeID> expected = {VIA_OFFSET + 0, VIA_OFFSET + 1};
+    const auto nodes = viaNodes(result);
+    BOOST_CHECK_EQUAL_COLLECTIONS(nodes.begin(), nodes.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(falls_back_to_original_edges_below_closed_shortcut)
+{
+    const auto result = route({A});
+    BOOST_REQUIRE(result.is_valid());
+    BOOST_CHECK_EQUAL(result.shortest_path_length, 4);
+    const std::vector<NodeID> expected = {VIA_OFFSET + 2, VIA_OFFSET + 3};
+    const auto nodes = viaNodes(result);
+    BOOST_CHECK_EQUAL_COLLECTIONS(nodes.begin(), nodes.end(), expected.begin(), expected.end());
+}
+
+// detours have to be lighter than twice the weight of the leg without closures plus 6000
+BOOST_AUTO_TEST_CASE(fallback_only_searches_bounded_detours)
+{
+    const auto within_bound = route({A}, 3001);
+    BOOST_REQUIRE(within_bound.is_valid());
+    BOOST_CHECK_EQUAL(within_bound.shortest_path_length, 2 * 3001);
+
+    const auto beyond_bound = route({A}, 3002);
+    BOOST_CHECK(!beyond_bound.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(no_route_if_all_detours_are_closed)
+{
+    const auto result = route({A, B});
+    BOOST_CHECK(!result.is_valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+#include "engine/map_matching/hidden_markov_model.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hidden_markov_model)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+std::vector<std::vector<PhantomNodeWithDistance>>
+makeCandidates(const std::vector<std::vector<double>> &distances)
+{
+    std::vector<std::vector<PhantomNodeWithDistance>> candidates_list(distances.size());
+    for (std::size_t t = 0; t < distances.size(); ++t)
+    {
+        for (const auto distance : distances[t])
+        {
+            candidates_list[t].push_back(PhantomNodeWithDistance{PhantomNode{}, distance});
+        }
+    }
+    return candidates_list;
+}
+}
+
+BOOST_AUTO_TEST_CASE(batch_emission_matches_scalar)
+{
+    const map_matching::EmissionLogProbability emission(5.);
+    const std::vector<double> distances = {0., 0.5, 3., 7.25, 12., 40., 99.9};
+
+    std::vector<double> log_probabilities(distances.size());
+    emission(distances.data(), distances.size(), log_probabilities.data());
+    for (std::size_t i = 0; i < distances.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(log_probabilities[i], emission(distances[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(max_element_index_matches_std)
+{
+    const std::vector<std::vector<double>> values_list = {
+        {1.},
+        {map_matching::IMPOSSIBLE_LOG_PROB, -3.},
+        {-5., -1., -2., -1., -7.},
+        {map_matching::IMPOSSIBLE_LOG_PROB, map_matching::IMPOSSIBLE_LOG_PROB},
+        {-4., -3., -2., -1., -2., -3., -4., -1.}};
+
+    for (const auto &values : values_list)
+    {
+        const auto expected =
+            std::distance(values.begin(), std::max_element(values.begin(), values.end()));
+        BOOST_CHECK_EQUAL(map_matching::maxElementIndex(values.data(), values.size()), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(flat_layers)
+{
+    map_matching::HiddenMarkovModel model;
+
+    model.Reset(makeCandidates({{1., 2.}, {}, {3., 4., 5.}}));
+    BOOST_CHECK_EQUAL(model.GetNumberOfTimestamps(), 3);
+    BOOST_CHECK_EQUAL(model.GetNumberOfStates(0), 2);
+    BOOST_CHECK_EQUAL(model.GetNumberOfStates(1), 0);
+    BOOST_CHECK_EQUAL(model.GetNumberOfStates(2), 3);
+    BOOST_CHECK_EQUAL(model.GetState(2, 1), 3);
+    BOOST_CHECK_EQUAL(model.distances[model.GetState(2, 2)], 5.);
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 5);
+
+    // a smaller trace reuses the buffers of the previous one
+    const auto capacity = model.viterbi.capacity();
+    model.Reset(makeCandidates({{6.}, {7.}}));
+    BOOST_CHECK_EQUAL(model.viterbi.size(), 2);
+    BOOST_CHECK_EQUAL(model.viterbi.capacity(), capacity);
+    BOOST_CHECK_EQUAL(model.distances[model.GetState(1, 0)], 7.);
+    BOOST_CHECK(std::all_of(model.breakage.begin(), model.breakage.end(), [](std::uint8_t b) {
+        return b != 0;
+    }));
+}
+
+BOOST_AUTO_TEST_CASE(initialize_skips_broken_points)
+{
+    map_matching::HiddenMarkovModel model;
+    model.Reset(makeCandidates({{1.}, {2., 3.}, {4.}}));
+
+    // the first point has no possible candidate
+    model.emission_log_probabilities = {map_matching::IMPOSSIBLE_LOG_PROB, -2., -1., -3.};
+    BOOST_CHECK_EQUAL(model.initialize(0), 1);
+    BOOST_CHECK(model.breakage[0]);
+    BOOST_CHECK(!model.breakage[1]);
+    BOOST_CHECK_EQUAL(model.GetMaxCandidate(1), 1);
+    BOOST_CHECK(model.parents[model.GetState(1, 1)] == std::make_pair(1u, 1u));
+
+    // clearing keeps everything before the split
+    model.Clear(2);
+    BOOST_CHECK_EQUAL(model.viterbi[model.GetState(1, 0)], -2.);
+    BOOST_CHECK_EQUAL(model.viterbi[model.GetState(2, 0)], map_matching::IMPOSSIBLE_LOG_PROB);
+    BOOST_CHECK(model.breakage[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+#include "engine/query_trace.hpp"
+#include "engine/slow_query_log.hpp"
+#include "util/binary_heap.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(slow_query_log)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+using TestHeap = util::BinaryHeap<NodeID, NodeID, int, int>;
+
+BOOST_AUTO_TEST_CASE(trace_counts_searches_of_its_scope)
+{
+    TestHeap heap(10);
+    QueryTrace trace;
+    {
+        ScopedQueryTrace scoped_trace(trace, 10);
+        BOOST_CHECK_EQUAL(ScopedQueryTrace::Current(), &scoped_trace);
+        scoped_trace.AddHeap("forward", heap);
+        scoped_trace.AddHeap("forward", heap);
+
+        heap.Clear();
+        heap.Insert(3, 5, 0);
+        heap.Insert(7, 2, 0);
+        heap.DeleteMin();
+        heap.DeleteMin();
+
+        {
+            ScopedTraceStage stage("snapping");
+        }
+        {
+            ScopedTraceStage stage("snapping");
+        }
+    }
+    BOOST_CHECK(ScopedQueryTrace::Current() == nullptr);
+
+    // not part of the trace anymore
+    heap.Clear();
+    heap.Insert(1, 1, 0);
+    heap.DeleteMin();
+
+    BOOST_REQUIRE_EQUAL(trace.heaps.size(), 1);
+    BOOST_CHECK_EQUAL(trace.heaps[0].name, "forward");
+    BOOST_CHECK(!trace.settled_nodes_truncated);
+    BOOST_CHECK_EQUAL(trace.heaps[0].number_of_searches, 1);
+    BOOST_CHECK_EQUAL(trace.heaps[0].number_of_settled_nodes, 2);
+    const std::vector<NodeID> settled_nodes{7, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(trace.heaps[0].settled_nodes.begin(),
+                                  trace.heaps[0].settled_nodes.end(),
+                                  settled_nodes.begin(),
+                                  settled_nodes.end());
+
+    BOOST_REQUIRE_EQUAL(trace.stages.size(), 1);
+    BOOST_CHECK_EQUAL(trace.stages[0].name, "snapping");
+    BOOST_CHECK_EQUAL(trace.stages[0].count, 2);
+}
+
+// The limit is shared by the heaps, nodes settled after it is used up are only counted
+BOOST_AUTO_TEST_CASE(trace_stops_recording_at_the_limit)
+{
+    TestHeap forward_heap(10);
+    TestHeap reverse_heap(10);
+    QueryTrace trace;
+    {
+        ScopedQueryTrace scoped_trace(trace, 3);
+        scoped_trace.AddHeap("forward", forward_heap);
+        scoped_trace.AddHeap("reverse", reverse_heap);
+
+        for (auto *heap : {&forward_heap, &reverse_heap})
+        {
+            heap->Clear();
+            heap->Insert(1, 1, 0);
+            heap->Insert(2, 2, 0);
+            heap->DeleteMin();
+            heap->DeleteMin();
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(trace.heaps.size(), 2);
+    BOOST_CHECK(trace.settled_nodes_truncated);
+    BOOST_CHECK_EQUAL(trace.heaps[0].settled_nodes.size(), 2);
+    BOOST_CHECK_EQUAL(trace.heaps[1].settled_nodes.size(), 1);
+    BOOST_CHECK_EQUAL(trace.heaps[1].number_of_settled_nodes, 2);
+}
+
+// The searches of an inner trace are counted by the outer trace of the same heap as well
+BOOST_AUTO_TEST_CASE(nested_traces_count_into_the_outer_trace)
+{
+    TestHeap heap(10);
+    QueryTrace outer_trace;
+    QueryTrace inner_trace;
+    {
+        ScopedQueryTrace outer_scoped_trace(outer_trace, 0);
+        outer_scoped_trace.AddHeap("forward", heap);
+        heap.Clear();
+        {
+            ScopedQueryTrace inner_scoped_trace(inner_trace, 0);
+            inner_scoped_trace.AddHeap("forward", heap);
+            heap.Clear();
+            heap.Insert(1, 1, 0);
+            heap.DeleteMin();
+        }
+        heap.Clear();
+    }
+
+    BOOST_REQUIRE_EQUAL(inner_trace.heaps.size(), 1);
+    BOOST_CHECK_EQUAL(inner_trace.heaps[0].number_of_searches, 1);
+    BOOST_CHECK_EQUAL(inner_trace.heaps[0].number_of_settled_nodes, 1);
+    BOOST_CHECK(inner_trace.heaps[0].settled_nodes.empty());
+    BOOST_REQUIRE_EQUAL(outer_trace.heaps.size(), 1);
+    BOOST_CHECK_EQUAL(outer_trace.heaps[0].number_of_searches, 3);
+    BOOST_CHECK_EQUAL(outer_trace.heaps[0].number_of_settled_nodes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(log_keeps_the_newest_records)
+{
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("slow-queries-%%%%-%%%%.log");
+
+    QueryTrace trace;
+    trace.heaps.push_back(QueryTrace::Heap{"forward", 1, 2, {7, 3}});
+    {
+        SlowQueryLog log(path, 3, 256);
+        for (const auto query : {"a", "b", "c", "d"})
+        {
+            SlowQueryRecord record;
+            record.service = "route";
+            record.query = query;
+            record.trace = trace;
+            log.Write(record);
+        }
+
+        SlowQueryRecord large_record;
+        large_record.query = "e";
+        large_record.trace = trace;
+        large_record.trace.heaps[0].settled_nodes.resize(1000);
+        log.Write(large_record);
+    }
+    {
+        // continues after the newest record
+        SlowQueryLog log(path, 3, 256);
+        SlowQueryRecord record;
+        record.query = "f";
+        log.Write(record);
+    }
+
+    const auto records = SlowQueryLog::Read(path);
+    boost::filesystem::remove(path);
+
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_CHECK_EQUAL(records[0].sequence_number, 4);
+    BOOST_CHECK_EQUAL(records[0].service, "route");
+    BOOST_CHECK_EQUAL(records[0].query, "d");
+    BOOST_CHECK(!records[0].truncated);
+    BOOST_REQUIRE_EQUAL(records[0].trace.heaps.size(), 1);
+    BOOST_CHECK_EQUAL(records[0].trace.heaps[0].number_of_settled_nodes, 2);
+    BOOST_CHECK_EQUAL(records[0].trace.heaps[0].settled_nodes.size(), 2);
+
+    BOOST_CHECK_EQUAL(records[1].query, "e");
+    BOOST_CHECK(records[1].truncated);
+    BOOST_CHECK(records[1].trace.heaps[0].settled_nodes.empty());
+
+    BOOST_CHECK_EQUAL(records[2].sequence_number, 6);
+    BOOST_CHECK_EQUAL(records[2].query, "f");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#include "engine/map_matching/trace_thinning.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <osrm/coordinate.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trace_thinning)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// roughly 11 meters per step in latitude direction
+util::Coordinate makeCoordinate(const double lon_steps, const double lat_steps)
+{
+    return util::Coordinate{util::FloatLongitude{7.42 + lon_steps * 0.0001},
+                            util::FloatLatitude{43.73 + lat_steps * 0.0001}};
+}
+
+PhantomNodeWithDistance makeCandidate(const double distance)
+{
+    return PhantomNodeWithDistance{PhantomNode{}, distance};
+}
+}
+
+BOOST_AUTO_TEST_CASE(keeps_first_and_last_point)
+{
+    BOOST_CHECK(map_matching::thinTrace({}, {}).empty());
+
+    const std::vector<util::Coordinate> single = {makeCoordinate(0, 0)};
+    BOOST_CHECK_EQUAL(map_matching::thinTrace(single, {}).size(), 1);
+
+    const std::vector<util::Coordinate> pair = {makeCoordinate(0, 0), makeCoordinate(0, 0)};
+    const auto kept = map_matching::thinTrace(pair, {});
+    BOOST_REQUIRE_EQUAL(kept.size(), 2);
+    BOOST_CHECK_EQUAL(kept[0], 0);
+    BOOST_CHECK_EQUAL(kept[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(drops_stationary_and_collinear_points)
+{
+    /*
+      0 1 2 3-4-5-6
+                  |
+                  7
+    */
+    const std::vector<util::Coordinate> trace = {makeCoordinate(0, 0),
+                                                 makeCoordinate(0.01, 0),
+                                                 makeCoordinate(0, 0.01),
+                                                 makeCoordinate(0, 1),
+                                                 makeCoordinate(0, 2),
+                                                 makeCoordinate(0, 3),
+                                                 makeCoordinate(0, 4),
+                                                 makeCoordinate(1, 4)};
+
+    const auto kept = map_matching::thinTrace(trace, {});
+    const std::vector<std::size_t> expected = {0, 6, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(kept.begin(), kept.end(), expected.begin(), expected.end());
+
+    // a long pause keeps the points on both sides of it, so no trace split is introduced
+    const std::vector<unsigned> timestamps = {0, 1, 2, 3, 4, 100, 101, 102};
+    const auto kept_with_pause = map_matching::thinTrace(trace, timestamps);
+    const std::vector<std::size_t> expected_with_pause = {0, 4, 5, 6, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(kept_with_pause.begin(),
+                                  kept_with_pause.end(),
+                                  expected_with_pause.begin(),
+                                  expected_with_pause.end());
+}
+
+BOOST_AUTO_TEST_CASE(prunes_distant_candidates)
+{
+    std::vector<PhantomNodeWithDistance> candidates = {
+        makeCandidate(2), makeCandidate(8), makeCandidate(12), makeCandidate(13)};
+    map_matching::pruneCandidates(candidates);
+    BOOST_CHECK_EQUAL(candidates.size(), 3);
+
+    candidates = {makeCandidate(10), makeCandidate(25), makeCandidate(30), makeCandidate(31)};
+    map_matching::pruneCandidates(candidates);
+    BOOST_CHECK_EQUAL(candidates.size(), 3);
+
+    candidates.clear();
+    map_matching::pruneCandidates(candidates);
+    BOOST_CHECK(candidates.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
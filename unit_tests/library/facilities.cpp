@@ -0,0 +1,120 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "args.hpp"
+#include "coordinates.hpp"
+#include "fixture.hpp"
+#include "waypoint_check.hpp"
+
+#include "osrm/facilities_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(facilities)
+
+namespace
+{
+
+// A source followed by five facilities spread over Monaco
+Locations getFacilityLocations()
+{
+    return {{Longitude{7.415800}, Latitude{43.734132}},
+            {Longitude{7.417710}, Latitude{43.736721}},
+            {Longitude{7.421315}, Latitude{43.738814}},
+            {Longitude{7.437069}, Latitude{43.749249}},
+            {Longitude{7.425000}, Latitude{43.737000}},
+            {Longitude{7.419000}, Latitude{43.731000}}};
+}
+
+// Checks the nearest facilities of the source against its /table row sorted by duration
+void checkAgainstTable(const unsigned number_of_results)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    const std::vector<std::size_t> destinations = {1, 2, 3, 4, 5};
+
+    TableParameters table_params;
+    table_params.coordinates = getFacilityLocations();
+    table_params.sources = {0};
+    table_params.destinations = destinations;
+
+    json::Object table_result;
+    BOOST_REQUIRE(osrm.Table(table_params, table_result) == Status::Ok);
+    const auto &row = table_result.values.at("durations")
+                          .get<json::Array>()
+                          .values.at(0)
+                          .get<json::Array>()
+                          .values;
+    BOOST_REQUIRE_EQUAL(row.size(), destinations.size());
+
+    std::vector<std::pair<double, std::size_t>> sorted_row;
+    for (std::size_t index = 0; index < row.size(); ++index)
+    {
+        if (row[index].is<json::Number>())
+            sorted_row.emplace_back(row[index].get<json::Number>().value, index);
+    }
+    std::sort(sorted_row.begin(), sorted_row.end());
+
+    FacilitiesParameters params;
+    params.coordinates = getFacilityLocations();
+    params.sources = {0};
+    params.destinations = destinations;
+    params.number_of_results = number_of_results;
+
+    json::Object result;
+    BOOST_REQUIRE(osrm.Facilities(params, result) == Status::Ok);
+    BOOST_CHECK_EQUAL(result.values.at("code").get<json::String>().value, "Ok");
+
+    const auto &sources = result.values.at("sources").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(sources.size(), 1);
+    BOOST_CHECK(waypoint_check(sources.front()));
+
+    const auto &nearest = result.values.at("facilities")
+                              .get<json::Array>()
+                              .values.at(0)
+                              .get<json::Array>()
+                              .values;
+    BOOST_REQUIRE_EQUAL(nearest.size(),
+                        std::min<std::size_t>(number_of_results, sorted_row.size()));
+
+    for (std::size_t rank = 0; rank < nearest.size(); ++rank)
+    {
+        const auto &facility = nearest[rank].get<json::Object>();
+        BOOST_CHECK(waypoint_check(nearest[rank]));
+        const auto index =
+            static_cast<std::size_t>(facility.values.at("index").get<json::Number>().value);
+        const auto duration = facility.values.at("duration").get<json::Number>().value;
+
+        // facilities with the same duration may be returned in any order
+        BOOST_CHECK_EQUAL(duration, sorted_row[rank].first);
+        BOOST_REQUIRE(index < row.size());
+        BOOST_CHECK_EQUAL(duration, row[index].get<json::Number>().value);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_facilities_match_sorted_table_row)
+{
+    checkAgainstTable(3);
+}
+
+BOOST_AUTO_TEST_CASE(test_facilities_number_of_results_capped_by_facilities)
+{
+    checkAgainstTable(10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
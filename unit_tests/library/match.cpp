@@ -68,4 +68,67 @@ BOOST_AUTO_TEST_CASE(test_match)
     }
 }
 
+
+// With tidy the near-duplicate points are dropped before matching and reported on the matched
+// route between their neighbouring waypoints
+BOOST_AUTO_TEST_CASE(test_match_tidy_interpolates_dropped_points)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    const auto locations = get_locations_in_big_component();
+
+    MatchParameters params;
+    params.tidy = true;
+    params.coordinates.push_back(locations.at(0));
+    params.coordinates.push_back({Longitude{7.415800}, Latitude{43.734142}});
+    params.coordinates.push_back(locations.at(1));
+    params.coordinates.push_back({Longitude{7.417710}, Latitude{43.736731}});
+    params.coordinates.push_back(locations.at(2));
+
+    json::Object result;
+    BOOST_REQUIRE(osrm.Match(params, result) == Status::Ok);
+
+    const auto &tracepoints = result.values.at("tracepoints").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(tracepoints.size(), params.coordinates.size());
+    const auto &matchings = result.values.at("matchings").get<json::Array>().values;
+
+    std::size_t number_of_interpolated = 0;
+    for (const auto &tracepoint : tracepoints)
+    {
+        if (tracepoint.is<json::Null>())
+            continue;
+
+        BOOST_CHECK(waypoint_check(tracepoint));
+        const auto &tracepoint_object = tracepoint.get<json::Object>();
+        const auto matchings_index = static_cast<std::size_t>(
+            tracepoint_object.values.at("matchings_index").get<json::Number>().value);
+        BOOST_REQUIRE_LT(matchings_index, matchings.size());
+        const auto &legs = matchings[matchings_index]
+                               .get<json::Object>()
+                               .values.at("legs")
+                               .get<json::Array>()
+                               .values;
+
+        if (tracepoint_object.values.count("interpolated") == 0)
+        {
+            BOOST_CHECK(tracepoint_object.values.count("hint") == 1);
+            BOOST_CHECK_LT(tracepoint_object.values.at("waypoint_index").get<json::Number>().value,
+                           legs.size() + 1);
+            continue;
+        }
+
+        ++number_of_interpolated;
+        BOOST_CHECK(tracepoint_object.values.count("hint") == 0);
+        BOOST_CHECK(tracepoint_object.values.count("waypoint_index") == 0);
+        BOOST_CHECK_LT(tracepoint_object.values.at("leg_index").get<json::Number>().value,
+                       legs.size());
+    }
+    BOOST_CHECK_GT(number_of_interpolated, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
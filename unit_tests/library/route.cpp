@@ -36,7 +36,8 @@ BOOST_AUTO_TEST_CASE(test_route_same_coordinates_fixture)
     for (auto &itr : result.values["waypoints"].get<json::Array>().values)
         itr.get<json::Object>().values["hint"] = "";
 
-    const auto location = json::Array{{{7.437070}, {43.749247}}};
+    const auto location = json::LonLat{
+        util::Coordinate{util::FixedLongitude{7437070}, util::FixedLatitude{43749247}}};
 
     json::Object reference{
         {{"code", "Ok"},
@@ -129,9 +130,9 @@ BOOST_AUTO_TEST_CASE(test_route_same_coordinates)
         const auto name = waypoint_object.values.at("name").get<json::String>().value;
         BOOST_CHECK(((void)name, true));
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
 
@@ -212,9 +213,9 @@ BOOST_AUTO_TEST_CASE(test_route_same_coordinates)
                 {
                     const auto &intersection_object = intersection.get<json::Object>().values;
                     const auto location =
-                        intersection_object.at("location").get<json::Array>().values;
-                    const auto longitude = location[0].get<json::Number>().value;
-                    const auto latitude = location[1].get<json::Number>().value;
+                        intersection_object.at("location").get<json::LonLat>().value;
+                    const auto longitude = static_cast<double>(util::toFloating(location.lon));
+                    const auto latitude = static_cast<double>(util::toFloating(location.lat));
                     BOOST_CHECK(longitude >= -180. && longitude <= 180.);
                     BOOST_CHECK(latitude >= -90. && latitude <= 90.);
 
@@ -279,9 +280,9 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_in_small_component)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
     }
@@ -315,9 +316,9 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_in_big_component)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
     }
@@ -353,12 +354,78 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_across_components)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
     }
 }
 
+// Routes with four or more legs that allow u-turns search their legs in parallel, a single leg is
+// searched by the sequential DP. Every leg of the parallel route has to match the single leg route
+// between its waypoints.
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_match_sequential_legs)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    const Locations locations = {{Longitude{7.415800}, Latitude{43.734132}},
+                                 {Longitude{7.417710}, Latitude{43.736721}},
+                                 {Longitude{7.421315}, Latitude{43.738814}},
+                                 {Longitude{7.425000}, Latitude{43.737000}},
+                                 {Longitude{7.419000}, Latitude{43.731000}}};
+
+    const auto make_params = [](const Locations &coordinates) {
+        RouteParameters params;
+        params.coordinates = coordinates;
+        params.continue_straight = false;
+        params.steps = true;
+        params.annotations = true;
+        params.geometries = RouteParameters::GeometriesType::GeoJSON;
+        return params;
+    };
+
+    json::Object result;
+    BOOST_REQUIRE(osrm.Route(make_params(locations), result) == Status::Ok);
+    const auto &route =
+        result.values.at("routes").get<json::Array>().values.at(0).get<json::Object>();
+    const auto &legs = route.values.at("legs").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(legs.size(), locations.size() - 1);
+
+    double total_distance = 0.;
+    for (std::size_t index = 0; index < legs.size(); ++index)
+    {
+        json::Object leg_result;
+        BOOST_REQUIRE(osrm.Route(make_params({locations[index], locations[index + 1]}),
+                                 leg_result) == Status::Ok);
+        const auto &leg_route =
+            leg_result.values.at("routes").get<json::Array>().values.at(0).get<json::Object>();
+        const auto &expected_leg =
+            leg_route.values.at("legs").get<json::Array>().values.at(0).get<json::Object>();
+        const auto &leg = legs[index].get<json::Object>();
+
+        BOOST_CHECK_EQUAL(leg.values.at("distance").get<json::Number>().value,
+                          expected_leg.values.at("distance").get<json::Number>().value);
+        BOOST_CHECK_EQUAL(leg.values.at("duration").get<json::Number>().value,
+                          expected_leg.values.at("duration").get<json::Number>().value);
+        CHECK_EQUAL_JSON(leg.values.at("annotation"), expected_leg.values.at("annotation"));
+
+        const auto &steps = leg.values.at("steps").get<json::Array>().values;
+        const auto &expected_steps = expected_leg.values.at("steps").get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(steps.size(), expected_steps.size());
+        for (std::size_t step = 0; step < steps.size(); ++step)
+        {
+            CHECK_EQUAL_JSON(steps[step].get<json::Object>().values.at("geometry"),
+                             expected_steps[step].get<json::Object>().values.at("geometry"));
+        }
+
+        total_distance += expected_leg.values.at("distance").get<json::Number>().value;
+    }
+    // leg distances are rounded on their own
+    BOOST_CHECK_CLOSE(route.values.at("distance").get<json::Number>().value, total_distance, 0.01);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
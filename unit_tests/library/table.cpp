@@ -6,6 +6,7 @@
 #include "fixture.hpp"
 #include "waypoint_check.hpp"
 
+#include "osrm/route_parameters.hpp"
 #include "osrm/table_parameters.hpp"
 
 #include "osrm/coordinate.hpp"
@@ -14,8 +15,96 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/coordinate_calculation.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(table)
 
+namespace
+{
+
+// Distinct locations in the big component of Monaco, the last one about 2km from the others
+osrm::util::Coordinate getBoundsLocation(const std::size_t index)
+{
+    using namespace osrm::util;
+    const Coordinate locations[] = {{FloatLongitude{7.415800}, FloatLatitude{43.734132}},
+                                    {FloatLongitude{7.417710}, FloatLatitude{43.736721}},
+                                    {FloatLongitude{7.421315}, FloatLatitude{43.738814}},
+                                    {FloatLongitude{7.437069}, FloatLatitude{43.749249}}};
+    return locations[index];
+}
+
+// The matrix of an annotation row by row, null entries are empty
+std::vector<boost::optional<double>> getMatrix(const osrm::json::Object &result,
+                                               const std::string &annotation)
+{
+    using namespace osrm;
+    std::vector<boost::optional<double>> matrix;
+    for (const auto &row : result.values.at(annotation).get<json::Array>().values)
+    {
+        for (const auto &entry : row.get<json::Array>().values)
+        {
+            if (entry.is<json::Null>())
+                matrix.push_back(boost::none);
+            else
+                matrix.push_back(entry.get<json::Number>().value);
+        }
+    }
+    return matrix;
+}
+
+// Renders a table once through the writer and once as a regular response, the bytes must match
+void checkStreamedTable(const osrm::TableParameters &params)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    json::Object result;
+    BOOST_REQUIRE(osrm.Table(params, result) == Status::Ok);
+    std::vector<char> rendered;
+    util::json::render(rendered, result);
+
+    json::Object streamed_result;
+    std::vector<char> streamed;
+    std::size_t number_of_pieces = 0;
+    const ResponseWriter writer = [&](const char *data, const std::size_t size) {
+        streamed.insert(streamed.end(), data, data + size);
+        ++number_of_pieces;
+    };
+    BOOST_REQUIRE(osrm.Table(params, streamed_result, writer) == Status::Ok);
+
+    BOOST_CHECK_EQUAL(std::string(streamed.begin(), streamed.end()),
+                      std::string(rendered.begin(), rendered.end()));
+    BOOST_CHECK(number_of_pieces > 2);
+}
+
+// A grid over Monaco, some of the locations snap to small components
+std::vector<osrm::util::Coordinate> getGridLocations(const std::size_t size)
+{
+    using namespace osrm::util;
+    std::vector<Coordinate> locations;
+    for (std::size_t row = 0; row < size; ++row)
+    {
+        for (std::size_t column = 0; column < size; ++column)
+        {
+            locations.push_back({FloatLongitude{7.410 + 0.030 * column / size},
+                                 FloatLatitude{43.728 + 0.022 * row / size}});
+        }
+    }
+    return locations;
+}
+}
+
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
 {
     const auto args = get_args();
@@ -161,4 +250,261 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_table_three_coordinates_distance_matrix)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    params.coordinates.push_back(getBoundsLocation(0));
+    params.coordinates.push_back(getBoundsLocation(1));
+    params.coordinates.push_back(getBoundsLocation(2));
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object result;
+
+    const auto rc = osrm.Table(params, result);
+
+    BOOST_REQUIRE(rc == Status::Ok);
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto durations = getMatrix(result, "durations");
+    const auto distances = getMatrix(result, "distances");
+    const auto size = params.coordinates.size();
+    BOOST_REQUIRE_EQUAL(durations.size(), size * size);
+    BOOST_REQUIRE_EQUAL(distances.size(), size * size);
+
+    // /route sums up its leg distances from the leg geometry, the table from the edge lengths
+    for (std::size_t source = 0; source < size; ++source)
+    {
+        for (std::size_t target = 0; target < size; ++target)
+        {
+            const auto &distance = distances[source * size + target];
+            BOOST_REQUIRE(distance);
+            BOOST_REQUIRE(durations[source * size + target]);
+            if (source == target)
+            {
+                BOOST_CHECK_EQUAL(*distance, 0);
+                continue;
+            }
+
+            RouteParameters route_params;
+            route_params.coordinates.push_back(params.coordinates[source]);
+            route_params.coordinates.push_back(params.coordinates[target]);
+
+            json::Object route_result;
+            BOOST_REQUIRE(osrm.Route(route_params, route_result) == Status::Ok);
+            const auto &route = route_result.values.at("routes")
+                                    .get<json::Array>()
+                                    .values.at(0)
+                                    .get<json::Object>();
+            const auto &leg =
+                route.values.at("legs").get<json::Array>().values.at(0).get<json::Object>();
+
+            // the edge lengths and phantom offsets of the table are rounded to decimeters
+            const auto leg_distance = leg.values.at("distance").get<json::Number>().value;
+            BOOST_CHECK_SMALL(*distance - leg_distance, std::max(1., 0.01 * leg_distance));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_table_max_duration)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    for (std::size_t index = 0; index < 4; ++index)
+        params.coordinates.push_back(getBoundsLocation(index));
+
+    json::Object unbounded_result;
+    BOOST_REQUIRE(osrm.Table(params, unbounded_result) == Status::Ok);
+    const auto unbounded = getMatrix(unbounded_result, "durations");
+    BOOST_REQUIRE_EQUAL(unbounded.size(), 16);
+
+    // use one of the durations as bound to test both sides of it
+    std::vector<double> durations;
+    for (const auto &duration : unbounded)
+    {
+        BOOST_REQUIRE(duration);
+        durations.push_back(*duration);
+    }
+    std::sort(durations.begin(), durations.end());
+    params.max_duration = durations[durations.size() / 2];
+
+    json::Object result;
+    BOOST_REQUIRE(osrm.Table(params, result) == Status::Ok);
+    const auto bounded = getMatrix(result, "durations");
+    BOOST_REQUIRE_EQUAL(bounded.size(), unbounded.size());
+
+    std::size_t number_in_range = 0;
+    for (std::size_t index = 0; index < bounded.size(); ++index)
+    {
+        if (*unbounded[index] <= *params.max_duration)
+        {
+            ++number_in_range;
+            BOOST_REQUIRE(bounded[index]);
+            BOOST_CHECK_EQUAL(*bounded[index], *unbounded[index]);
+        }
+        else
+        {
+            BOOST_CHECK(!bounded[index]);
+        }
+    }
+    BOOST_CHECK(number_in_range > 0);
+    BOOST_CHECK(number_in_range < bounded.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_max_distance)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    for (std::size_t index = 0; index < 4; ++index)
+        params.coordinates.push_back(getBoundsLocation(index));
+    params.sources = {0, 3};
+    params.destinations = {0, 1, 2, 3};
+    params.annotations = TableParameters::AnnotationsType::All;
+
+    json::Object unbounded_result;
+    BOOST_REQUIRE(osrm.Table(params, unbounded_result) == Status::Ok);
+
+    params.max_distance = 500.;
+    json::Object result;
+    BOOST_REQUIRE(osrm.Table(params, result) == Status::Ok);
+
+    // with distances requested the bound applies to them instead of the straight line
+    const auto unbounded_distances = getMatrix(unbounded_result, "distances");
+    std::size_t number_in_range = 0;
+    for (const auto annotation : {"durations", "distances"})
+    {
+        const auto unbounded = getMatrix(unbounded_result, annotation);
+        const auto bounded = getMatrix(result, annotation);
+        BOOST_REQUIRE_EQUAL(bounded.size(), params.sources.size() * params.destinations.size());
+        BOOST_REQUIRE_EQUAL(unbounded.size(), bounded.size());
+
+        for (std::size_t index = 0; index < bounded.size(); ++index)
+        {
+            BOOST_REQUIRE(unbounded_distances[index]);
+            if (*unbounded_distances[index] <= *params.max_distance)
+            {
+                ++number_in_range;
+                BOOST_REQUIRE(bounded[index]);
+                BOOST_REQUIRE(unbounded[index]);
+                BOOST_CHECK_EQUAL(*bounded[index], *unbounded[index]);
+            }
+            else
+            {
+                BOOST_CHECK(!bounded[index]);
+            }
+        }
+    }
+    BOOST_CHECK(number_in_range > 0);
+    BOOST_CHECK(number_in_range < 2 * params.sources.size() * params.destinations.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_max_distance_straight_line)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    for (std::size_t index = 0; index < 4; ++index)
+        params.coordinates.push_back(getBoundsLocation(index));
+    params.sources = {0, 3};
+    params.destinations = {0, 1, 2, 3};
+
+    json::Object unbounded_result;
+    BOOST_REQUIRE(osrm.Table(params, unbounded_result) == Status::Ok);
+
+    params.max_distance = 500.;
+    json::Object result;
+    BOOST_REQUIRE(osrm.Table(params, result) == Status::Ok);
+
+    // the bound applies to the great circle distance between the snapped locations
+    const auto &sources = result.values.at("sources").get<json::Array>().values;
+    const auto &destinations = result.values.at("destinations").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(sources.size(), params.sources.size());
+    BOOST_REQUIRE_EQUAL(destinations.size(), params.destinations.size());
+
+    const auto unbounded = getMatrix(unbounded_result, "durations");
+    const auto bounded = getMatrix(result, "durations");
+    BOOST_REQUIRE_EQUAL(bounded.size(), sources.size() * destinations.size());
+    BOOST_REQUIRE_EQUAL(unbounded.size(), bounded.size());
+
+    std::size_t number_in_range = 0;
+    for (std::size_t row = 0; row < sources.size(); ++row)
+    {
+        for (std::size_t column = 0; column < destinations.size(); ++column)
+        {
+            const auto location = [](const json::Value &waypoint) {
+                return waypoint.get<json::Object>().values.at("location").get<json::LonLat>().value;
+            };
+            const auto distance = util::coordinate_calculation::haversineDistance(
+                location(sources[row]), location(destinations[column]));
+
+            const auto index = row * destinations.size() + column;
+            if (distance <= *params.max_distance)
+            {
+                ++number_in_range;
+                BOOST_REQUIRE(bounded[index]);
+                BOOST_REQUIRE(unbounded[index]);
+                BOOST_CHECK_EQUAL(*bounded[index], *unbounded[index]);
+            }
+            else
+            {
+                BOOST_CHECK(!bounded[index]);
+            }
+        }
+    }
+    BOOST_CHECK(number_in_range > 0);
+    BOOST_CHECK(number_in_range < bounded.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_streamed_matches_response)
+{
+    osrm::TableParameters params;
+    for (std::size_t index = 0; index < 4; ++index)
+        params.coordinates.push_back(getBoundsLocation(index));
+    params.sources = {3, 0};
+    params.destinations = {1, 2, 3};
+
+    checkStreamedTable(params);
+}
+
+// 289 sources and 256 destinations do not fit into a single block of rows, the bound leaves
+// some of the entries empty
+BOOST_AUTO_TEST_CASE(test_table_streamed_blocks_match_response)
+{
+    osrm::TableParameters params;
+    params.coordinates = getGridLocations(17);
+    for (std::size_t index = 0; index < params.coordinates.size(); ++index)
+    {
+        params.sources.push_back(index);
+        if (index % 9 != 0)
+            params.destinations.push_back(index);
+    }
+    params.max_duration = 120.;
+
+    checkStreamedTable(params);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -46,9 +46,9 @@ BOOST_AUTO_TEST_CASE(test_trip_response_for_locations_in_small_component)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
 
@@ -90,9 +90,9 @@ BOOST_AUTO_TEST_CASE(test_trip_response_for_locations_in_big_component)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
 
@@ -138,9 +138,9 @@ BOOST_AUTO_TEST_CASE(test_trip_response_for_locations_across_components)
     {
         const auto &waypoint_object = waypoint.get<json::Object>();
 
-        const auto location = waypoint_object.values.at("location").get<json::Array>().values;
-        const auto longitude = location[0].get<json::Number>().value;
-        const auto latitude = location[1].get<json::Number>().value;
+        const auto location = waypoint_object.values.at("location").get<json::LonLat>().value;
+        const auto longitude = static_cast<double>(util::toFloating(location.lon));
+        const auto latitude = static_cast<double>(util::toFloating(location.lat));
         BOOST_CHECK(longitude >= -180. && longitude <= 180.);
         BOOST_CHECK(latitude >= -90. && latitude <= 90.);
 
@@ -26,12 +26,16 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     unsigned GetOutDegree(const NodeID /* n */) const override { return 0; }
     NodeID GetTarget(const EdgeID /* e */) const override { return SPECIAL_NODEID; }
     const EdgeData &GetEdgeData(const EdgeID /* e */) const override { return foo; }
+    bool HasEdgeLengths() const override { return false; }
+    EdgeLength GetEdgeLength(const EdgeID /* e */) const override { return 0; }
     EdgeID BeginEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     EdgeID EndEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     osrm::engine::datafacade::EdgeRange GetAdjacentEdgeRange(const NodeID /* node */) const override
     {
         return util::irange(static_cast<EdgeID>(0), static_cast<EdgeID>(0));
     }
+    void PrefetchNode(const NodeID /* n */) const override {}
+    void PrefetchAdjacentEdges(const NodeID /* n */) const override {}
     EdgeID FindEdge(const NodeID /* from */, const NodeID /* to */) const override
     {
         return SPECIAL_EDGEID;
@@ -80,6 +84,14 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     {
         return TRAVEL_MODE_INACCESSIBLE;
     }
+    extractor::OriginalEdgeData GetOriginalEdgeData(const unsigned /* id */) const override
+    {
+        return extractor::OriginalEdgeData{SPECIAL_NODEID,
+                                           0,
+                                           extractor::guidance::TurnInstruction::NO_TURN(),
+                                           0,
+                                           TRAVEL_MODE_INACCESSIBLE};
+    }
     std::vector<RTreeLeaf> GetEdgesInBox(const util::Coordinate /* south_west */,
                                          const util::Coordinate /*north_east */) const override
     {
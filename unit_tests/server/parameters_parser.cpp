@@ -3,6 +3,7 @@
 #include "parameters_io.hpp"
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/facilities_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -72,6 +73,10 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?max_duration=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?max_distance=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?approximate=foo"), 20UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?annotations=foo"), 20UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_urls)
@@ -325,6 +330,46 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.bearings, result_3->bearings);
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    TableParameters reference_4{};
+    reference_4.coordinates = coords_1;
+    reference_4.max_duration = 900.;
+    reference_4.max_distance = 10000.5;
+    auto result_4 =
+        parseParameters<TableParameters>("1,2;3,4?max_duration=900&max_distance=10000.5");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK_EQUAL(reference_4.max_duration, result_4->max_duration);
+    BOOST_CHECK_EQUAL(reference_4.max_distance, result_4->max_distance);
+    CHECK_EQUAL_RANGE(reference_4.sources, result_4->sources);
+    CHECK_EQUAL_RANGE(reference_4.destinations, result_4->destinations);
+    CHECK_EQUAL_RANGE(reference_4.coordinates, result_4->coordinates);
+
+    TableParameters reference_5{};
+    reference_5.coordinates = coords_1;
+    reference_5.approximate = true;
+    auto result_5 = parseParameters<TableParameters>("1,2;3,4?approximate=true");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK_EQUAL(reference_5.approximate, result_5->approximate);
+    CHECK_EQUAL_RANGE(reference_5.sources, result_5->sources);
+    CHECK_EQUAL_RANGE(reference_5.destinations, result_5->destinations);
+    CHECK_EQUAL_RANGE(reference_5.coordinates, result_5->coordinates);
+
+    TableParameters reference_6{};
+    reference_6.coordinates = coords_1;
+    reference_6.annotations = TableParameters::AnnotationsType::All;
+    auto result_6 = parseParameters<TableParameters>("1,2;3,4?annotations=duration,distance");
+    BOOST_CHECK(result_6);
+    BOOST_CHECK(reference_6.annotations == result_6->annotations);
+    BOOST_CHECK(result_6->HasDurations());
+    BOOST_CHECK(result_6->HasDistances());
+    CHECK_EQUAL_RANGE(reference_6.sources, result_6->sources);
+    CHECK_EQUAL_RANGE(reference_6.destinations, result_6->destinations);
+    CHECK_EQUAL_RANGE(reference_6.coordinates, result_6->coordinates);
+
+    auto result_7 = parseParameters<TableParameters>("1,2;3,4?annotations=distance");
+    BOOST_CHECK(result_7);
+    BOOST_CHECK(!result_7->HasDurations());
+    BOOST_CHECK(result_7->HasDistances());
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -350,6 +395,15 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_2.bearings, result_2->bearings);
     CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+
+    MatchParameters reference_3{};
+    reference_3.coordinates = coords_1;
+    reference_3.tidy = true;
+    auto result_3 = parseParameters<MatchParameters>("1,2;3,4?tidy=true");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK_EQUAL(reference_3.tidy, result_3->tidy);
+    CHECK_EQUAL_RANGE(reference_3.timestamps, result_3->timestamps);
+    CHECK_EQUAL_RANGE(reference_3.coordinates, result_3->coordinates);
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -386,6 +440,48 @@ BOOST_AUTO_TEST_CASE(valid_tile_urls)
     BOOST_CHECK_EQUAL(reference_1.z, result_1->z);
 }
 
+BOOST_AUTO_TEST_CASE(valid_facilities_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude(1), util::FloatLatitude(2)},
+                                              {util::FloatLongitude(3), util::FloatLatitude(4)},
+                                              {util::FloatLongitude(5), util::FloatLatitude(6)}};
+
+    FacilitiesParameters reference_1{};
+    reference_1.coordinates = coords_1;
+    reference_1.destinations = {1, 2};
+    reference_1.number_of_results = 2;
+    auto result_1 =
+        parseParameters<FacilitiesParameters>("1,2;3,4;5,6?destinations=1;2&number=2");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    BOOST_CHECK_EQUAL(reference_1.number_of_results, result_1->number_of_results);
+    BOOST_CHECK_EQUAL(reference_1.facility_set, result_1->facility_set);
+    CHECK_EQUAL_RANGE(reference_1.sources, result_1->sources);
+    CHECK_EQUAL_RANGE(reference_1.destinations, result_1->destinations);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_1->coordinates);
+
+    FacilitiesParameters reference_2{};
+    reference_2.coordinates = coords_1;
+    reference_2.sources = {0, 2};
+    reference_2.facility_set = "hospitals_2016";
+    auto result_2 = parseParameters<FacilitiesParameters>(
+        "1,2;3,4;5,6?sources=0;2&facility_set=hospitals_2016");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(result_2->IsValid());
+    BOOST_CHECK_EQUAL(reference_2.number_of_results, result_2->number_of_results);
+    BOOST_CHECK_EQUAL(reference_2.facility_set, result_2->facility_set);
+    CHECK_EQUAL_RANGE(reference_2.sources, result_2->sources);
+    CHECK_EQUAL_RANGE(reference_2.destinations, result_2->destinations);
+
+    // facilities have to come from exactly one place
+    auto result_3 = parseParameters<FacilitiesParameters>("1,2;3,4");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(!result_3->IsValid());
+    auto result_4 = parseParameters<FacilitiesParameters>("1,2;3,4?destinations=1&facility_set=a");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(!result_4->IsValid());
+}
+
 BOOST_AUTO_TEST_CASE(valid_trip_urls)
 {
     std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude(1), util::FloatLatitude(2)},
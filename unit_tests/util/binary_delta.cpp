@@ -0,0 +1,97 @@
+#include "util/binary_delta.hpp"
+#include "util/exception.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(binary_delta_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string makeRandomData(const std::size_t size, const unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string data(size, '\0');
+    for (auto &value : data)
+    {
+        value = static_cast<char>(byte(generator));
+    }
+    return data;
+}
+
+std::string roundTrip(const std::string &old_data,
+                      const std::string &new_data,
+                      const std::size_t block_size,
+                      std::size_t &delta_size)
+{
+    std::stringstream delta;
+    writeBinaryDelta(
+        old_data.data(), old_data.size(), new_data.data(), new_data.size(), delta, block_size);
+    delta_size = delta.str().size();
+
+    std::stringstream reconstructed;
+    applyBinaryDelta(old_data.data(), old_data.size(), delta, reconstructed);
+    return reconstructed.str();
+}
+}
+
+BOOST_AUTO_TEST_CASE(identical_data)
+{
+    const auto data = makeRandomData(64 * 1024, 1);
+
+    std::size_t delta_size = 0;
+    BOOST_CHECK(roundTrip(data, data, 1024, delta_size) == data);
+    // a single copy instruction
+    BOOST_CHECK_LT(delta_size, 100);
+}
+
+BOOST_AUTO_TEST_CASE(shifted_and_modified_data)
+{
+    const auto old_data = makeRandomData(64 * 1024, 2);
+    // insert a few bytes, so all following blocks are no longer aligned, and change a byte
+    auto new_data = old_data.substr(0, 10000) + "inserted" + old_data.substr(10000);
+    new_data[40000] ^= 0x55;
+
+    std::size_t delta_size = 0;
+    BOOST_CHECK(roundTrip(old_data, new_data, 1024, delta_size) == new_data);
+    BOOST_CHECK_LT(delta_size, 4 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(unrelated_and_empty_data)
+{
+    const auto old_data = makeRandomData(10000, 3);
+    const auto new_data = makeRandomData(7777, 4);
+
+    std::size_t delta_size = 0;
+    BOOST_CHECK(roundTrip(old_data, new_data, 1024, delta_size) == new_data);
+    BOOST_CHECK(roundTrip("", new_data, 1024, delta_size) == new_data);
+    BOOST_CHECK(roundTrip(old_data, "", 1024, delta_size).empty());
+}
+
+BOOST_AUTO_TEST_CASE(wrong_old_data)
+{
+    const auto old_data = makeRandomData(10000, 5);
+    const auto new_data = makeRandomData(10000, 6);
+
+    std::stringstream delta;
+    writeBinaryDelta(
+        old_data.data(), old_data.size(), new_data.data(), new_data.size(), delta, 1024);
+
+    auto other_data = old_data;
+    other_data[0] ^= 1;
+    std::stringstream reconstructed;
+    BOOST_CHECK_THROW(
+        applyBinaryDelta(other_data.data(), other_data.size(), delta, reconstructed),
+        exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
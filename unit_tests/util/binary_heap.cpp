@@ -1,4 +1,6 @@
 #include "util/binary_heap.hpp"
+#include "util/quaternary_heap.hpp"
+#include "util/radix_heap.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/mpl/list.hpp>
@@ -23,10 +25,18 @@ struct TestData
 typedef NodeID TestNodeID;
 typedef int TestKey;
 typedef int TestWeight;
-typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
-                         MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
-    storage_types;
+template <template <typename, typename, typename, typename, typename> class HeapT,
+          typename StorageT>
+using TestHeap = HeapT<TestNodeID, TestKey, TestWeight, TestData, StorageT>;
+
+typedef boost::mpl::list<TestHeap<BinaryHeap, ArrayStorage<TestNodeID, TestKey>>,
+                         TestHeap<BinaryHeap, MapStorage<TestNodeID, TestKey>>,
+                         TestHeap<BinaryHeap, UnorderedMapStorage<TestNodeID, TestKey>>,
+                         TestHeap<QuaternaryHeap, ArrayStorage<TestNodeID, TestKey>>,
+                         TestHeap<QuaternaryHeap, UnorderedMapStorage<TestNodeID, TestKey>>,
+                         TestHeap<RadixHeap, ArrayStorage<TestNodeID, TestKey>>,
+                         TestHeap<RadixHeap, UnorderedMapStorage<TestNodeID, TestKey>>>
+    heap_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
 {
@@ -54,9 +64,9 @@ template <unsigned NUM_ELEM> struct RandomDataFixture
 
 constexpr unsigned NUM_NODES = 100;
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     TestWeight min_weight = std::numeric_limits<TestWeight>::max();
     TestNodeID min_id;
@@ -87,9 +97,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, storage_types, RandomDataFixtur
     }
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     for (unsigned idx : order)
     {
@@ -109,9 +119,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, storage_types, RandomDataFi
     }
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, heap_types, RandomDataFixture<NUM_NODES>)
 {
-    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+    T heap(NUM_NODES);
 
     for (unsigned idx : order)
     {
@@ -123,9 +133,9 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, heap_types, RandomDataFixture<10>)
 {
-    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
+    T heap(10);
 
     for (unsigned idx : order)
     {
@@ -157,4 +167,51 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+// Dijkstra like workload with many equal and increasing weights, all heaps have to settle the
+// nodes with the same keys as std::priority_queue would
+BOOST_AUTO_TEST_CASE_TEMPLATE(monotone_workload_test, T, heap_types)
+{
+    constexpr unsigned NUM_WORKLOAD_NODES = 2000;
+    T heap(NUM_WORKLOAD_NODES);
+
+    // Choosen by a fair W20 dice roll
+    std::mt19937 g(7);
+    std::uniform_int_distribution<TestNodeID> node_dist(0, NUM_WORKLOAD_NODES - 1);
+    std::uniform_int_distribution<TestWeight> weight_dist(1, 50);
+
+    std::vector<TestWeight> best(NUM_WORKLOAD_NODES, std::numeric_limits<TestWeight>::max());
+    heap.Insert(0, -20, TestData{0});
+    heap.Insert(1, 0, TestData{1});
+    best[0] = -20;
+    best[1] = 0;
+
+    TestWeight last_weight = std::numeric_limits<TestWeight>::min();
+    while (!heap.Empty())
+    {
+        const auto min_weight = heap.MinKey();
+        const auto node = heap.DeleteMin();
+        BOOST_CHECK_EQUAL(heap.GetKey(node), min_weight);
+        BOOST_CHECK_EQUAL(best[node], min_weight);
+        BOOST_CHECK(heap.WasRemoved(node));
+        BOOST_CHECK_LE(last_weight, min_weight);
+        last_weight = min_weight;
+
+        for (unsigned edge = 0; edge < 3; ++edge)
+        {
+            const auto to = node_dist(g);
+            const auto to_weight = min_weight + weight_dist(g);
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_weight, TestData{to});
+                best[to] = to_weight;
+            }
+            else if (!heap.WasRemoved(to) && to_weight < heap.GetKey(to))
+            {
+                heap.DecreaseKey(to, to_weight);
+                best[to] = to_weight;
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
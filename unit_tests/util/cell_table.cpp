@@ -0,0 +1,95 @@
+#include "util/cell_table.hpp"
+#include "util/coordinate.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(cell_table_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// 3x2 grid of 1 degree cells starting at (0, 0), the middle cell of the lower row is empty
+CellTable makeCellTable()
+{
+    const CellGrid grid{0, 0, static_cast<std::int32_t>(COORDINATE_PRECISION), 3, 2};
+    std::vector<std::uint32_t> cell_ids = {0, INVALID_CELL_ID, 1, 2, 3, 4};
+    std::vector<EdgeWeight> radiuses = {10, 20, INVALID_EDGE_WEIGHT, 40, 50};
+    std::vector<EdgeWeight> durations(radiuses.size() * radiuses.size());
+    for (std::size_t index = 0; index < durations.size(); ++index)
+    {
+        durations[index] = static_cast<EdgeWeight>(index * 100);
+    }
+    return CellTable{grid, 42, std::move(cell_ids), std::move(radiuses), std::move(durations)};
+}
+}
+
+BOOST_AUTO_TEST_CASE(grid_lookup)
+{
+    const auto cell_table = makeCellTable();
+
+    BOOST_CHECK_EQUAL(cell_table.GetNumberOfCells(), 5);
+    BOOST_CHECK_EQUAL(cell_table.GetGridCell({FloatLongitude(0.5), FloatLatitude(0.5)}), 0);
+    BOOST_CHECK_EQUAL(cell_table.GetGridCell({FloatLongitude(2.5), FloatLatitude(1.5)}), 5);
+    BOOST_CHECK_EQUAL(cell_table.GetGridCell({FloatLongitude(-0.5), FloatLatitude(0.5)}),
+                      INVALID_CELL_ID);
+    BOOST_CHECK_EQUAL(cell_table.GetGridCell({FloatLongitude(3.5), FloatLatitude(0.5)}),
+                      INVALID_CELL_ID);
+    BOOST_CHECK_EQUAL(cell_table.GetGridCell({FloatLongitude(0.5), FloatLatitude(2.5)}),
+                      INVALID_CELL_ID);
+
+    BOOST_CHECK_EQUAL(cell_table.GetCell(1), INVALID_CELL_ID);
+    BOOST_CHECK_EQUAL(cell_table.GetCell(2), 1);
+    BOOST_CHECK_EQUAL(cell_table.GetCell(INVALID_CELL_ID), INVALID_CELL_ID);
+
+    BOOST_CHECK_EQUAL(cell_table.GetDuration(1, 3), 800);
+    BOOST_CHECK_EQUAL(cell_table.GetRadius(1), 20);
+    BOOST_CHECK_EQUAL(cell_table.GetRadius(2), INVALID_EDGE_WEIGHT);
+}
+
+BOOST_AUTO_TEST_CASE(neighbours)
+{
+    const auto cell_table = makeCellTable();
+
+    BOOST_CHECK(cell_table.AreNeighbours(0, 0));
+    BOOST_CHECK(cell_table.AreNeighbours(0, 1));
+    BOOST_CHECK(cell_table.AreNeighbours(0, 4));
+    BOOST_CHECK(cell_table.AreNeighbours(5, 1));
+    BOOST_CHECK(!cell_table.AreNeighbours(0, 2));
+    BOOST_CHECK(!cell_table.AreNeighbours(0, 5));
+    // the last cell of a row is not adjacent to the first cell of the next row
+    BOOST_CHECK(!cell_table.AreNeighbours(2, 3));
+}
+
+BOOST_AUTO_TEST_CASE(write_read_round_trip)
+{
+    const auto cell_table = makeCellTable();
+
+    const auto path = boost::filesystem::unique_path();
+    cell_table.Write(path);
+
+    CellTable loaded;
+    loaded.Read(path);
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(loaded.GetCheckSum(), 42);
+    BOOST_CHECK_EQUAL(loaded.GetNumberOfCells(), cell_table.GetNumberOfCells());
+    BOOST_CHECK_EQUAL(loaded.GetGridCell({FloatLongitude(2.5), FloatLatitude(1.5)}), 5);
+    for (std::uint32_t from = 0; from < cell_table.GetNumberOfCells(); ++from)
+    {
+        BOOST_CHECK_EQUAL(loaded.GetRadius(from), cell_table.GetRadius(from));
+        for (std::uint32_t to = 0; to < cell_table.GetNumberOfCells(); ++to)
+        {
+            BOOST_CHECK_EQUAL(loaded.GetDuration(from, to), cell_table.GetDuration(from, to));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
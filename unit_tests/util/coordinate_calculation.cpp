@@ -6,6 +6,8 @@
 #include <osrm/coordinate.hpp>
 
 #include <cmath>
+#include <random>
+#include <vector>
 
 using namespace osrm;
 using namespace osrm::util;
@@ -304,4 +306,83 @@ BOOST_AUTO_TEST_CASE(circleCenter)
     BOOST_CHECK(!result);
 }
 
+BOOST_AUTO_TEST_CASE(batch_distances)
+{
+    // random pairs all over the world, including antipodal and identical coordinates
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> longitude(-180 * COORDINATE_PRECISION,
+                                                 180 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<int> latitude(-85 * COORDINATE_PRECISION,
+                                                85 * COORDINATE_PRECISION);
+    std::vector<Coordinate> first, second;
+    for (int i = 0; i < 1001; ++i)
+    {
+        first.emplace_back(FixedLongitude(longitude(generator)),
+                           FixedLatitude(latitude(generator)));
+        second.emplace_back(FixedLongitude(longitude(generator)),
+                            FixedLatitude(latitude(generator)));
+    }
+    // segments of a few meters, like in road geometries
+    std::uniform_int_distribution<int> offset(-200, 200);
+    for (int i = 0; i < 1001; ++i)
+    {
+        first.push_back(first[i]);
+        second.emplace_back(first[i].lon + FixedLongitude(offset(generator)),
+                            first[i].lat + FixedLatitude(offset(generator)));
+    }
+    first.push_back(Coordinate(FloatLongitude(-179.9), FloatLatitude(10)));
+    second.push_back(Coordinate(FloatLongitude(0.1), FloatLatitude(-10)));
+    first.push_back(second.front());
+    second.push_back(second.front());
+
+    const auto tolerance = [](const double expected) { return 1e-8 + 1e-12 * expected; };
+
+    std::vector<double> distances(first.size());
+    coordinate_calculation::haversineDistances(
+        first.data(), second.data(), first.size(), distances.data());
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        const auto expected = coordinate_calculation::haversineDistance(first[i], second[i]);
+        BOOST_CHECK_SMALL(distances[i] - expected, tolerance(expected));
+    }
+
+    coordinate_calculation::greatCircleDistances(
+        first.data(), second.data(), first.size(), distances.data());
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        const auto expected = coordinate_calculation::greatCircleDistance(first[i], second[i]);
+        BOOST_CHECK_SMALL(distances[i] - expected, tolerance(expected));
+    }
+
+    // polyline
+    coordinate_calculation::haversineDistances(
+        first.data(), first.data() + 1, first.size() - 1, distances.data());
+    for (std::size_t i = 0; i + 1 < first.size(); ++i)
+    {
+        const auto expected = coordinate_calculation::haversineDistance(first[i], first[i + 1]);
+        BOOST_CHECK_SMALL(distances[i] - expected, tolerance(expected));
+    }
+
+    const Coordinate query(FloatLongitude(13.4), FloatLatitude(52.5));
+    std::vector<Coordinate> nearest_locations(first.size());
+    std::vector<double> ratios(first.size());
+    coordinate_calculation::perpendicularDistances(first.data(),
+                                                   second.data(),
+                                                   first.size(),
+                                                   query,
+                                                   distances.data(),
+                                                   nearest_locations.data(),
+                                                   ratios.data());
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        Coordinate nearest_location;
+        double ratio;
+        const auto expected = coordinate_calculation::perpendicularDistance(
+            first[i], second[i], query, nearest_location, ratio);
+        BOOST_CHECK_SMALL(distances[i] - expected, tolerance(expected));
+        BOOST_CHECK_EQUAL(nearest_locations[i], nearest_location);
+        BOOST_CHECK_EQUAL(ratios[i], ratio);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
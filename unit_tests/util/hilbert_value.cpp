@@ -0,0 +1,30 @@
+#include "util/hilbert_value.hpp"
+
+#include <osrm/coordinate.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(hilbert_value_tests)
+
+using namespace osrm;
+using namespace osrm::util;
+
+// codes computed by the bit by bit interleaving the hardware accelerated version replaced
+BOOST_AUTO_TEST_CASE(hilbert_code)
+{
+    BOOST_CHECK_EQUAL(hilbertCode(Coordinate(FloatLongitude(0), FloatLatitude(0))),
+                      67252104966624597ULL);
+    BOOST_CHECK_EQUAL(hilbertCode(Coordinate(FloatLongitude(13.388860), FloatLatitude(52.517037))),
+                      21040067432482386ULL);
+    BOOST_CHECK_EQUAL(hilbertCode(Coordinate(FloatLongitude(-180), FloatLatitude(-90))), 0ULL);
+    BOOST_CHECK_EQUAL(hilbertCode(Coordinate(FloatLongitude(180), FloatLatitude(90))),
+                      211353548811556181ULL);
+    BOOST_CHECK_EQUAL(
+        hilbertCode(Coordinate(FloatLongitude(-73.985656), FloatLatitude(40.748433))),
+        6706576857269143ULL);
+    BOOST_CHECK_EQUAL(
+        hilbertCode(Coordinate(FloatLongitude(151.215256), FloatLatitude(-33.856159))),
+        145725037241445334ULL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include "util/hub_labels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hub_labels_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+EdgeWeight naiveIntersect(const std::vector<NodeID> &forward_hubs,
+                          const std::vector<EdgeWeight> &forward_weights,
+                          const std::vector<NodeID> &backward_hubs,
+                          const std::vector<EdgeWeight> &backward_weights)
+{
+    EdgeWeight best = INVALID_EDGE_WEIGHT;
+    for (std::size_t i = 0; i < forward_hubs.size(); ++i)
+        for (std::size_t j = 0; j < backward_hubs.size(); ++j)
+            if (forward_hubs[i] == backward_hubs[j])
+                best = std::min(best, forward_weights[i] + backward_weights[j]);
+    return best;
+}
+}
+
+BOOST_AUTO_TEST_CASE(intersect_small_labels)
+{
+    const std::vector<NodeID> forward_hubs = {1, 5, 9};
+    const std::vector<EdgeWeight> forward_weights = {10, 3, 0};
+    const std::vector<NodeID> backward_hubs = {2, 5, 9};
+    const std::vector<EdgeWeight> backward_weights = {1, 4, 8};
+
+    const HubLabel forward{forward_hubs.data(), forward_weights.data(), forward_hubs.size()};
+    const HubLabel backward{backward_hubs.data(), backward_weights.data(), backward_hubs.size()};
+    BOOST_CHECK_EQUAL(intersectHubLabels(forward, backward), 7);
+
+    const std::vector<NodeID> other_hubs = {0, 2, 4};
+    const HubLabel disjoint{other_hubs.data(), backward_weights.data(), other_hubs.size()};
+    BOOST_CHECK_EQUAL(intersectHubLabels(forward, disjoint), INVALID_EDGE_WEIGHT);
+
+    const HubLabel empty{nullptr, nullptr, 0};
+    BOOST_CHECK_EQUAL(intersectHubLabels(forward, empty), INVALID_EDGE_WEIGHT);
+}
+
+// Exercises the blocked comparison with labels of different length and density
+BOOST_AUTO_TEST_CASE(intersect_random_labels)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<NodeID> hub_distribution(0, 200);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(0, 1000);
+    std::uniform_int_distribution<std::size_t> size_distribution(0, 60);
+
+    for (int round = 0; round < 500; ++round)
+    {
+        const auto make_label = [&](std::vector<NodeID> &hubs, std::vector<EdgeWeight> &weights) {
+            std::set<NodeID> unique_hubs;
+            const auto size = size_distribution(generator);
+            while (unique_hubs.size() < size)
+                unique_hubs.insert(hub_distribution(generator));
+            hubs.assign(unique_hubs.begin(), unique_hubs.end());
+            weights.clear();
+            for (std::size_t i = 0; i < hubs.size(); ++i)
+                weights.push_back(weight_distribution(generator));
+        };
+
+        std::vector<NodeID> forward_hubs, backward_hubs;
+        std::vector<EdgeWeight> forward_weights, backward_weights;
+        make_label(forward_hubs, forward_weights);
+        make_label(backward_hubs, backward_weights);
+
+        const HubLabel forward{forward_hubs.data(), forward_weights.data(), forward_hubs.size()};
+        const HubLabel backward{
+            backward_hubs.data(), backward_weights.data(), backward_hubs.size()};
+        BOOST_CHECK_EQUAL(
+            intersectHubLabels(forward, backward),
+            naiveIntersect(forward_hubs, forward_weights, backward_hubs, backward_weights));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
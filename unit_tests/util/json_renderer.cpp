@@ -0,0 +1,90 @@
+#include "util/json_renderer.hpp"
+#include "util/cast.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_renderer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string renderToString(const json::Object &object)
+{
+    std::vector<char> buffer;
+    json::render(buffer, object);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+std::string renderToStream(const json::Object &object)
+{
+    std::ostringstream out;
+    json::render(out, object);
+    return out.str();
+}
+
+Coordinate makeCoordinate(const int lon, const int lat)
+{
+    return Coordinate{FixedLongitude{lon}, FixedLatitude{lat}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(lon_lat_formatting)
+{
+    json::Object object;
+    object.values["a"] = json::LonLat{makeCoordinate(7437070, 43749247)};
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"a\":[7.43707,43.749247]}");
+    BOOST_CHECK_EQUAL(renderToStream(object), "{\"a\":[7.43707,43.749247]}");
+
+    object.values["a"] = json::LonLat{makeCoordinate(-180000000, -500)};
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"a\":[-180,-0.0005]}");
+
+    object.values["a"] = json::LonLat{makeCoordinate(0, 1)};
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"a\":[0,0.000001]}");
+}
+
+BOOST_AUTO_TEST_CASE(lon_lat_array_formatting)
+{
+    json::Object object;
+    object.values["a"] = json::LonLatArray{};
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"a\":[]}");
+    BOOST_CHECK_EQUAL(renderToStream(object), "{\"a\":[]}");
+
+    json::LonLatArray lon_lats;
+    lon_lats.values = {makeCoordinate(1000000, 2000000), makeCoordinate(-123456789, 89999999)};
+    object.values["a"] = std::move(lon_lats);
+    BOOST_CHECK_EQUAL(renderToString(object), "{\"a\":[[1,2],[-123.456789,89.999999]]}");
+    BOOST_CHECK_EQUAL(renderToStream(object), "{\"a\":[[1,2],[-123.456789,89.999999]]}");
+}
+
+// the fixed point formatting has to match the formatting of the floating point numbers it replaces
+BOOST_AUTO_TEST_CASE(lon_lat_matches_number_formatting)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> lon_distribution(-180000000, 180000000);
+    std::uniform_int_distribution<int> lat_distribution(-90000000, 90000000);
+    std::uniform_int_distribution<int> small_distribution(-1000, 1000);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto lon = lon_distribution(generator);
+        const auto lat = i % 2 == 0 ? lat_distribution(generator) : small_distribution(generator);
+        const auto coordinate = makeCoordinate(lon, lat);
+
+        json::Object object;
+        object.values["a"] = json::LonLat{coordinate};
+        const auto expected =
+            "{\"a\":[" +
+            cast::to_string_with_precision(static_cast<double>(toFloating(coordinate.lon))) + "," +
+            cast::to_string_with_precision(static_cast<double>(toFloating(coordinate.lat))) + "]}";
+        BOOST_CHECK_EQUAL(renderToString(object), expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+#include "util/cpu_features.hpp"
+#include "util/rectangle.hpp"
+#include "util/simd_kernels.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(simd_kernels_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(supported_instruction_sets)
+{
+    const auto instruction_sets = getSupportedInstructionSets();
+    BOOST_REQUIRE(!instruction_sets.empty());
+    BOOST_CHECK(instruction_sets.front() == InstructionSet::Scalar);
+    BOOST_CHECK(instruction_sets.back() == getInstructionSet());
+    BOOST_CHECK_EQUAL(&simd::getKernels(), &simd::getKernels(getInstructionSet()));
+}
+
+// Covers points inside, beside and diagonal to the rectangles, and every tail length of the
+// vector loops
+BOOST_AUTO_TEST_CASE(squared_distances_to_rectangles)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<std::int32_t> lon_distribution(-180000000, 180000000);
+    std::uniform_int_distribution<std::int32_t> lat_distribution(-85000000, 85000000);
+    std::uniform_int_distribution<std::int32_t> extent_distribution(0, 1000000);
+    std::uniform_int_distribution<std::size_t> size_distribution(0, 40);
+
+    for (int round = 0; round < 500; ++round)
+    {
+        const auto size = size_distribution(generator);
+        const std::int32_t lon = lon_distribution(generator);
+        const std::int32_t lat = lat_distribution(generator);
+
+        std::vector<std::int32_t> min_lons, max_lons, min_lats, max_lats;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            // every other rectangle is close to the point to hit the contained case
+            const std::int32_t min_lon = (i % 2 == 0) ? lon - extent_distribution(generator)
+                                                      : lon_distribution(generator);
+            const std::int32_t min_lat = (i % 2 == 0) ? lat - extent_distribution(generator)
+                                                      : lat_distribution(generator);
+            min_lons.push_back(min_lon);
+            max_lons.push_back(min_lon + extent_distribution(generator));
+            min_lats.push_back(min_lat);
+            max_lats.push_back(min_lat + extent_distribution(generator));
+        }
+
+        std::vector<std::uint64_t> expected(size);
+        simd::getKernels(InstructionSet::Scalar)
+            .squared_distances_to_rectangles(min_lons.data(),
+                                             max_lons.data(),
+                                             min_lats.data(),
+                                             max_lats.data(),
+                                             size,
+                                             lon,
+                                             lat,
+                                             expected.data());
+
+        const Coordinate location{FixedLongitude{lon}, FixedLatitude{lat}};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const RectangleInt2D rectangle{FixedLongitude{min_lons[i]},
+                                           FixedLongitude{max_lons[i]},
+                                           FixedLatitude{min_lats[i]},
+                                           FixedLatitude{max_lats[i]}};
+            BOOST_CHECK_EQUAL(expected[i], rectangle.GetMinSquaredDist(location));
+        }
+
+        for (const auto instruction_set : getSupportedInstructionSets())
+        {
+            std::vector<std::uint64_t> distances(size);
+            simd::getKernels(instruction_set)
+                .squared_distances_to_rectangles(min_lons.data(),
+                                                 max_lons.data(),
+                                                 min_lats.data(),
+                                                 max_lats.data(),
+                                                 size,
+                                                 lon,
+                                                 lat,
+                                                 distances.data());
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                distances.begin(), distances.end(), expected.begin(), expected.end());
+        }
+    }
+}
+
+// Labels of different length and density hit both the blocked comparison and the merge of the
+// remaining hubs
+BOOST_AUTO_TEST_CASE(intersect_hub_labels)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<NodeID> hub_distribution(0, 300);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(0, 1000);
+    std::uniform_int_distribution<std::size_t> size_distribution(0, 100);
+
+    for (int round = 0; round < 500; ++round)
+    {
+        const auto make_label = [&](std::vector<NodeID> &hubs, std::vector<EdgeWeight> &weights) {
+            std::set<NodeID> unique_hubs;
+            const auto size = size_distribution(generator);
+            while (unique_hubs.size() < size)
+                unique_hubs.insert(hub_distribution(generator));
+            hubs.assign(unique_hubs.begin(), unique_hubs.end());
+            weights.clear();
+            for (std::size_t i = 0; i < hubs.size(); ++i)
+                weights.push_back(weight_distribution(generator));
+        };
+
+        std::vector<NodeID> forward_hubs, backward_hubs;
+        std::vector<EdgeWeight> forward_weights, backward_weights;
+        make_label(forward_hubs, forward_weights);
+        make_label(backward_hubs, backward_weights);
+
+        EdgeWeight expected = INVALID_EDGE_WEIGHT;
+        for (std::size_t i = 0; i < forward_hubs.size(); ++i)
+            for (std::size_t j = 0; j < backward_hubs.size(); ++j)
+                if (forward_hubs[i] == backward_hubs[j])
+                    expected = std::min(expected, forward_weights[i] + backward_weights[j]);
+
+        for (const auto instruction_set : getSupportedInstructionSets())
+        {
+            BOOST_CHECK_EQUAL(simd::getKernels(instruction_set)
+                                  .intersect_hub_labels(forward_hubs.data(),
+                                                        forward_weights.data(),
+                                                        forward_hubs.size(),
+                                                        backward_hubs.data(),
+                                                        backward_weights.data(),
+                                                        backward_hubs.size()),
+                              expected);
+        }
+    }
+}
+
+// Buckets of every tail length with distinct columns in random order, some of the sums are
+// negative and some of the row entries are already smaller
+BOOST_AUTO_TEST_CASE(relax_bucket)
+{
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<EdgeWeight> entry_distribution(-50, 1000);
+    std::uniform_int_distribution<EdgeWeight> row_distribution(0, 1500);
+    std::uniform_int_distribution<std::size_t> size_distribution(0, 40);
+    const std::size_t number_of_columns = 64;
+
+    for (int round = 0; round < 500; ++round)
+    {
+        std::vector<std::int32_t> columns(number_of_columns);
+        std::iota(columns.begin(), columns.end(), 0);
+        std::shuffle(columns.begin(), columns.end(), generator);
+        columns.resize(size_distribution(generator));
+
+        std::vector<std::int32_t> entries;
+        for (const auto column : columns)
+        {
+            entries.push_back(column);
+            entries.push_back(entry_distribution(generator));
+        }
+        const EdgeWeight weight = entry_distribution(generator) / 10;
+
+        std::vector<EdgeWeight> initial_row;
+        for (std::size_t column = 0; column < number_of_columns; ++column)
+            initial_row.push_back((column % 3 == 0) ? INVALID_EDGE_WEIGHT
+                                                    : row_distribution(generator));
+
+        auto expected = initial_row;
+        bool expected_negative_sums = false;
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            const EdgeWeight sum = weight + entries[2 * i + 1];
+            if (sum < 0)
+                expected_negative_sums = true;
+            else
+                expected[columns[i]] = std::min(expected[columns[i]], sum);
+        }
+
+        for (const auto instruction_set : getSupportedInstructionSets())
+        {
+            auto row = initial_row;
+            BOOST_CHECK_EQUAL(simd::getKernels(instruction_set)
+                                  .relax_bucket(entries.data(), columns.size(), weight, row.data()),
+                              expected_negative_sums);
+            BOOST_CHECK_EQUAL_COLLECTIONS(row.begin(), row.end(), expected.begin(), expected.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
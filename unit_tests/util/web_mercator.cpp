@@ -5,6 +5,7 @@
 #include <osrm/coordinate.hpp>
 
 #include <cmath>
+#include <vector>
 
 using namespace osrm;
 using namespace osrm::util;
@@ -44,6 +45,29 @@ BOOST_AUTO_TEST_CASE(lat_to_pixel)
                       0.1);
 }
 
+BOOST_AUTO_TEST_CASE(lat_to_y_batch)
+{
+    // covers both the approximated range and the exact fallback beyond 70 degrees
+    std::vector<util::Coordinate> coordinates;
+    for (int lat = -85000; lat <= 85000; lat += 7)
+    {
+        coordinates.emplace_back(util::FloatLongitude(lat / 1000. * 2),
+                                 util::FloatLatitude(lat / 1000.));
+    }
+
+    std::vector<util::FloatCoordinate> projected(coordinates.size());
+    web_mercator::fromWGS84(coordinates.data(), coordinates.size(), projected.data());
+    for (std::size_t i = 0; i < coordinates.size(); ++i)
+    {
+        const auto expected = web_mercator::latToY(util::toFloating(coordinates[i].lat));
+        BOOST_CHECK_EQUAL(projected[i].lon, util::toFloating(coordinates[i].lon));
+        BOOST_CHECK_SMALL(static_cast<double>(projected[i].lat) - expected, 1e-11);
+        BOOST_CHECK_CLOSE(static_cast<double>(projected[i].lat),
+                          web_mercator::latToYapprox(util::toFloating(coordinates[i].lat)),
+                          1e-12);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(xyz_to_wgs84)
 {
     double minx_1;